@@ -0,0 +1,247 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of Arena.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "Arena.h"
+
+/* Round xSize up to a multiple of portBYTE_ALIGNMENT. */
+#define arenaALIGN( xSize )    ( ( ( xSize ) + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+typedef struct xARENA
+{
+    const char * pcName;
+    TaskHandle_t xOwner;
+    uint8_t * pucStart;
+    size_t xSize;
+    size_t xUsed;
+    size_t xHighWaterMark;
+    uint32_t ulAllocations;
+    uint32_t ulFailures;
+    uint32_t ulResets;
+    struct xARENA * pxNext;
+} Arena_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Remove xArena from the list of arenas.  Must be called from a critical
+ * section.
+ */
+static void prvUnlink( ArenaHandle_t xArena );
+
+/*-----------------------------------------------------------*/
+
+/* Every arena that has not been deleted, so they can be found when their
+ * owner is deleted. */
+static Arena_t * pxArenas = NULL;
+
+/* Arenas deleted because their owner was deleted. */
+static uint32_t ulReleasedWithOwner = 0;
+
+/*-----------------------------------------------------------*/
+
+ArenaHandle_t xArenaCreate( const char * pcName,
+                            size_t xSize,
+                            TaskHandle_t xOwner )
+{
+    Arena_t * pxArena;
+    size_t xHeaderSize = arenaALIGN( sizeof( Arena_t ) );
+
+    /* The state and the block are allocated together. */
+    pxArena = ( Arena_t * ) pvPortMalloc( xHeaderSize + arenaALIGN( xSize ) );
+
+    if( pxArena != NULL )
+    {
+        pxArena->pcName = pcName;
+        pxArena->xOwner = xOwner;
+        pxArena->pucStart = ( ( uint8_t * ) pxArena ) + xHeaderSize;
+        pxArena->xSize = arenaALIGN( xSize );
+        pxArena->xUsed = 0;
+        pxArena->xHighWaterMark = 0;
+        pxArena->ulAllocations = 0;
+        pxArena->ulFailures = 0;
+        pxArena->ulResets = 0;
+
+        taskENTER_CRITICAL();
+        {
+            pxArena->pxNext = pxArenas;
+            pxArenas = pxArena;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return pxArena;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaDelete( ArenaHandle_t xArena )
+{
+    configASSERT( xArena );
+
+    taskENTER_CRITICAL();
+    {
+        prvUnlink( xArena );
+    }
+    taskEXIT_CRITICAL();
+
+    vPortFree( xArena );
+}
+/*-----------------------------------------------------------*/
+
+void * pvArenaAlloc( ArenaHandle_t xArena,
+                     size_t xSize )
+{
+    void * pvReturn = NULL;
+
+    xSize = arenaALIGN( xSize );
+
+    /* Written so the sum cannot overflow. */
+    if( xSize <= ( xArena->xSize - xArena->xUsed ) )
+    {
+        pvReturn = &( xArena->pucStart[ xArena->xUsed ] );
+        xArena->xUsed += xSize;
+        xArena->ulAllocations++;
+
+        if( xArena->xUsed > xArena->xHighWaterMark )
+        {
+            xArena->xHighWaterMark = xArena->xUsed;
+        }
+    }
+    else
+    {
+        xArena->ulFailures++;
+    }
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaReset( ArenaHandle_t xArena )
+{
+    xArena->xUsed = 0;
+    xArena->ulResets++;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaGetStats( ArenaHandle_t xArena,
+                     ArenaStats_t * pxStats )
+{
+    pxStats->pcName = xArena->pcName;
+    pxStats->xSize = xArena->xSize;
+    pxStats->xUsed = xArena->xUsed;
+    pxStats->xHighWaterMark = xArena->xHighWaterMark;
+    pxStats->ulAllocations = xArena->ulAllocations;
+    pxStats->ulFailures = xArena->ulFailures;
+    pxStats->ulResets = xArena->ulResets;
+}
+/*-----------------------------------------------------------*/
+
+void vArenaTaskDeleted( void * pvTask )
+{
+    TaskHandle_t xTask = ( pvTask != NULL ) ? ( TaskHandle_t ) pvTask : xTaskGetCurrentTaskHandle();
+    Arena_t * pxArena, * pxNext, * pxReleased = NULL;
+
+    /* Most tasks own no arenas, so check before entering a critical
+     * section. */
+    if( pxArenas == NULL )
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        for( pxArena = pxArenas; pxArena != NULL; pxArena = pxNext )
+        {
+            pxNext = pxArena->pxNext;
+
+            if( pxArena->xOwner == xTask )
+            {
+                prvUnlink( pxArena );
+                pxArena->pxNext = pxReleased;
+                pxReleased = pxArena;
+                ulReleasedWithOwner++;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    /* The heap is not used from a critical section. */
+    for( pxArena = pxReleased; pxArena != NULL; pxArena = pxNext )
+    {
+        pxNext = pxArena->pxNext;
+        vPortFree( pxArena );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vArenaPrint( void )
+{
+    Arena_t * pxArena;
+
+    printf( "\r\n%-16s %-12s %10s %10s %10s %10s %8s %8s\r\n", "Arena", "Owner", "Size", "Used", "HighWater", "Allocs", "Failed", "Resets" );
+
+    for( pxArena = pxArenas; pxArena != NULL; pxArena = pxArena->pxNext )
+    {
+        printf( "%-16s %-12s %10lu %10lu %10lu %10lu %8lu %8lu\r\n",
+                pxArena->pcName,
+                ( pxArena->xOwner != NULL ) ? pcTaskGetName( pxArena->xOwner ) : "-",
+                ( unsigned long ) pxArena->xSize,
+                ( unsigned long ) pxArena->xUsed,
+                ( unsigned long ) pxArena->xHighWaterMark,
+                ( unsigned long ) pxArena->ulAllocations,
+                ( unsigned long ) pxArena->ulFailures,
+                ( unsigned long ) pxArena->ulResets );
+    }
+
+    printf( "%lu arenas deleted with their owner\r\n\r\n", ( unsigned long ) ulReleasedWithOwner );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlink( ArenaHandle_t xArena )
+{
+    Arena_t ** ppxArena;
+
+    for( ppxArena = &pxArenas; *ppxArena != NULL; ppxArena = &( ( *ppxArena )->pxNext ) )
+    {
+        if( *ppxArena == xArena )
+        {
+            *ppxArena = xArena->pxNext;
+            break;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
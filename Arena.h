@@ -0,0 +1,115 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Arenas - blocks of heap from which a task makes many small allocations and
+ * then frees them all at once.
+ *
+ * A task that allocates many small objects with pvPortMalloc() and frees them
+ * one at a time spends most of that time walking heap_5's free list, and
+ * leaves the heap regions fragmented.  An arena takes one block from the heap
+ * when it is created.  pvArenaAlloc() then allocates by advancing a pointer
+ * through the block, and vArenaReset() releases every allocation by moving the
+ * pointer back to the start - there is no per-allocation free.  A task that
+ * handles requests would reset its arena after each request.
+ *
+ * An arena can be given an owner task, in which case it is deleted
+ * automatically when the owner is deleted.  This is done through the
+ * traceENTER_vTaskDelete() macro, which is defined in FreeRTOSConfig.h when
+ * configUSE_ARENAS is 1.
+ *
+ * Each arena keeps a high water mark, so arenas can be sized from a run of the
+ * application, and counts the allocations that failed because it was full.
+ *
+ * An arena is used by one task at a time - pvArenaAlloc() and vArenaReset()
+ * are not protected against concurrent use.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct xARENA_STATS
+{
+    const char * pcName;
+    size_t xSize;               /* Bytes available for allocations. */
+    size_t xUsed;               /* Bytes allocated since the last reset. */
+    size_t xHighWaterMark;      /* The most bytes allocated between resets. */
+    uint32_t ulAllocations;
+    uint32_t ulFailures;        /* Allocations that did not fit. */
+    uint32_t ulResets;
+} ArenaStats_t;
+
+typedef struct xARENA * ArenaHandle_t;
+
+/*
+ * Create an arena with xSize bytes available for allocations.  If xOwner is
+ * not NULL the arena is deleted when xOwner is deleted.  Returns NULL if there
+ * is not enough heap.
+ */
+ArenaHandle_t xArenaCreate( const char * pcName,
+                            size_t xSize,
+                            TaskHandle_t xOwner );
+
+/*
+ * Delete an arena, returning its block to the heap.
+ */
+void vArenaDelete( ArenaHandle_t xArena );
+
+/*
+ * Allocate xSize bytes, aligned to portBYTE_ALIGNMENT.  Returns NULL if the
+ * arena does not have room.  The memory is freed by vArenaReset() or
+ * vArenaDelete().
+ */
+void * pvArenaAlloc( ArenaHandle_t xArena,
+                     size_t xSize );
+
+/*
+ * Free every allocation made from the arena.
+ */
+void vArenaReset( ArenaHandle_t xArena );
+
+/*
+ * Copy the arena's counters into pxStats.
+ */
+void vArenaGetStats( ArenaHandle_t xArena,
+                     ArenaStats_t * pxStats );
+
+/*
+ * Called by traceENTER_vTaskDelete() to delete the arenas owned by pvTask, or
+ * by the calling task if pvTask is NULL.
+ */
+void vArenaTaskDeleted( void * pvTask );
+
+/*
+ * Print the counters of every arena.  Makes Windows system calls, so must be
+ * called from a critical section.
+ */
+void vArenaPrint( void );
+
+#endif /* ARENA_H */
@@ -0,0 +1,363 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of BasicTask.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "BasicTask.h"
+
+typedef struct xBASIC_TASK
+{
+    const char * pcName;
+    BasicTaskFunction_t pxFunction;
+    void * pvParameter;
+    UBaseType_t uxPriority;
+    UBaseType_t uxMaxActivations;
+    configSTACK_DEPTH_TYPE uxStackDepth;
+    UBaseType_t uxActivations;                  /* Waiting or running. */
+    uint32_t ulActivations;
+    uint32_t ulRejected;
+    uint32_t ulRuns;
+    configRUN_TIME_COUNTER_TYPE xTotalTime;
+    configRUN_TIME_COUNTER_TYPE xMaxTime;
+    configRUN_TIME_COUNTER_TYPE xMaxLatency;
+} BasicTask_t;
+
+/* An entry in the queue of a priority's dispatcher. */
+typedef struct xBASIC_TASK_ACTIVATION
+{
+    BasicTask_t * pxBasicTask;
+    configRUN_TIME_COUNTER_TYPE xActivatedAt;
+} BasicTaskActivation_t;
+
+/* The dispatcher of one priority.  The queue has room for every activation
+ * the basic tasks of the priority can have waiting, so sending to it never
+ * fails. */
+typedef struct xBASIC_TASK_LEVEL
+{
+    QueueHandle_t xQueue;
+    UBaseType_t uxQueueLength;
+    configSTACK_DEPTH_TYPE uxStackDepth;        /* The deepest stack of the priority's basic tasks. */
+    UBaseType_t uxBasicTasks;
+} BasicTaskLevel_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The dispatcher task of one priority.  pvParameters is the priority.
+ */
+static void prvDispatcherTask( void * pvParameters );
+
+/*
+ * Count an activation of pxBasicTask.  Returns pdFAIL if it is rejected.  Must
+ * be called from a critical section.
+ */
+static BaseType_t prvCountActivation( BasicTask_t * pxBasicTask );
+
+/*-----------------------------------------------------------*/
+
+static BasicTask_t xBasicTasks[ basictaskMAX_TASKS ];
+static UBaseType_t uxBasicTaskCount = 0;
+static BasicTaskLevel_t xLevels[ configMAX_PRIORITIES ];
+
+/*-----------------------------------------------------------*/
+
+BasicTaskHandle_t xBasicTaskCreate( const char * pcName,
+                                    BasicTaskFunction_t pxFunction,
+                                    void * pvParameter,
+                                    UBaseType_t uxPriority,
+                                    UBaseType_t uxMaxActivations,
+                                    configSTACK_DEPTH_TYPE uxStackDepth )
+{
+    BasicTask_t * pxBasicTask;
+    BasicTaskLevel_t * pxLevel;
+
+    configASSERT( uxPriority < configMAX_PRIORITIES );
+    configASSERT( uxMaxActivations > 0 );
+    configASSERT( xLevels[ uxPriority ].xQueue == NULL );
+
+    if( uxBasicTaskCount >= basictaskMAX_TASKS )
+    {
+        return NULL;
+    }
+
+    pxBasicTask = &( xBasicTasks[ uxBasicTaskCount ] );
+    pxBasicTask->pcName = pcName;
+    pxBasicTask->pxFunction = pxFunction;
+    pxBasicTask->pvParameter = pvParameter;
+    pxBasicTask->uxPriority = uxPriority;
+    pxBasicTask->uxMaxActivations = uxMaxActivations;
+    pxBasicTask->uxStackDepth = uxStackDepth;
+    uxBasicTaskCount++;
+
+    pxLevel = &( xLevels[ uxPriority ] );
+    pxLevel->uxQueueLength += uxMaxActivations;
+    pxLevel->uxBasicTasks++;
+
+    if( uxStackDepth > pxLevel->uxStackDepth )
+    {
+        pxLevel->uxStackDepth = uxStackDepth;
+    }
+
+    return pxBasicTask;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBasicTaskStart( void )
+{
+    UBaseType_t uxPriority;
+    BasicTaskLevel_t * pxLevel;
+    char cName[ configMAX_TASK_NAME_LEN ];
+
+    for( uxPriority = 0; uxPriority < configMAX_PRIORITIES; uxPriority++ )
+    {
+        pxLevel = &( xLevels[ uxPriority ] );
+
+        if( ( pxLevel->uxBasicTasks == 0 ) || ( pxLevel->xQueue != NULL ) )
+        {
+            continue;
+        }
+
+        pxLevel->xQueue = xQueueCreate( pxLevel->uxQueueLength, sizeof( BasicTaskActivation_t ) );
+
+        if( pxLevel->xQueue == NULL )
+        {
+            return pdFAIL;
+        }
+
+        snprintf( cName, sizeof( cName ), "Basic%lu", ( unsigned long ) uxPriority );
+
+        if( xTaskCreate( prvDispatcherTask, cName, pxLevel->uxStackDepth, ( void * ) uxPriority, uxPriority, NULL ) != pdPASS )
+        {
+            return pdFAIL;
+        }
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBasicTaskActivate( BasicTaskHandle_t xBasicTask )
+{
+    BasicTaskActivation_t xActivation;
+    BaseType_t xReturn;
+
+    configASSERT( xLevels[ xBasicTask->uxPriority ].xQueue );
+
+    /* Only the count is protected.  The queue has room for every activation
+     * that can be counted, so the send outside the critical section cannot
+     * fail, and any task it wakes runs without the kernel being asked to yield
+     * from inside a critical section. */
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvCountActivation( xBasicTask );
+    }
+    taskEXIT_CRITICAL();
+
+    if( xReturn == pdPASS )
+    {
+        xActivation.pxBasicTask = xBasicTask;
+        xActivation.xActivatedAt = portGET_RUN_TIME_COUNTER_VALUE();
+        xReturn = xQueueSendToBack( xLevels[ xBasicTask->uxPriority ].xQueue, &xActivation, 0 );
+        configASSERT( xReturn == pdPASS );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBasicTaskActivateFromISR( BasicTaskHandle_t xBasicTask,
+                                      BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BasicTaskActivation_t xActivation;
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xReturn;
+
+    configASSERT( xLevels[ xBasicTask->uxPriority ].xQueue );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvCountActivation( xBasicTask );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xReturn == pdPASS )
+    {
+        xActivation.pxBasicTask = xBasicTask;
+        xActivation.xActivatedAt = portGET_RUN_TIME_COUNTER_VALUE();
+        xReturn = xQueueSendToBackFromISR( xLevels[ xBasicTask->uxPriority ].xQueue, &xActivation, pxHigherPriorityTaskWoken );
+        configASSERT( xReturn == pdPASS );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBasicTaskGetStats( UBaseType_t uxIndex,
+                               BasicTaskStats_t * pxStats )
+{
+    const BasicTask_t * pxBasicTask;
+
+    if( uxIndex >= uxBasicTaskCount )
+    {
+        return pdFAIL;
+    }
+
+    pxBasicTask = &( xBasicTasks[ uxIndex ] );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->pcName = pxBasicTask->pcName;
+        pxStats->uxPriority = pxBasicTask->uxPriority;
+        pxStats->ulActivations = pxBasicTask->ulActivations;
+        pxStats->ulRejected = pxBasicTask->ulRejected;
+        pxStats->ulRuns = pxBasicTask->ulRuns;
+        pxStats->ulMaxLatencyUs = ( uint32_t ) ( pxBasicTask->xMaxLatency * configUS_PER_RUN_TIME_COUNT );
+        pxStats->ulMeanTimeUs = ( pxBasicTask->ulRuns == 0 ) ? 0 : ( uint32_t ) ( ( pxBasicTask->xTotalTime * configUS_PER_RUN_TIME_COUNT ) / pxBasicTask->ulRuns );
+        pxStats->ulMaxTimeUs = ( uint32_t ) ( pxBasicTask->xMaxTime * configUS_PER_RUN_TIME_COUNT );
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vBasicTaskPrint( void )
+{
+    UBaseType_t uxIndex, uxPriority, uxDispatchers = 0;
+    BasicTaskStats_t xStats;
+    size_t xSeparateBytes = 0, xSharedBytes = 0;
+
+    printf( "\r\n%-12s %4s %10s %8s %10s %10s %8s %8s\r\n", "Basic task", "Prio", "Activated", "Rejected", "Runs", "MaxLat(us)", "Mean(us)", "Max(us)" );
+
+    for( uxIndex = 0; xBasicTaskGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        printf( "%-12s %4lu %10lu %8lu %10lu %10lu %8lu %8lu\r\n",
+                xStats.pcName,
+                ( unsigned long ) xStats.uxPriority,
+                ( unsigned long ) xStats.ulActivations,
+                ( unsigned long ) xStats.ulRejected,
+                ( unsigned long ) xStats.ulRuns,
+                ( unsigned long ) xStats.ulMaxLatencyUs,
+                ( unsigned long ) xStats.ulMeanTimeUs,
+                ( unsigned long ) xStats.ulMaxTimeUs );
+
+        /* As an ordinary task each would have its own stack and TCB. */
+        xSeparateBytes += ( xBasicTasks[ uxIndex ].uxStackDepth * sizeof( StackType_t ) ) + sizeof( StaticTask_t );
+    }
+
+    /* Each dispatcher has one stack, a TCB, and a queue. */
+    for( uxPriority = 0; uxPriority < configMAX_PRIORITIES; uxPriority++ )
+    {
+        if( xLevels[ uxPriority ].uxBasicTasks > 0 )
+        {
+            uxDispatchers++;
+            xSharedBytes += ( xLevels[ uxPriority ].uxStackDepth * sizeof( StackType_t ) ) + sizeof( StaticTask_t ) +
+                            sizeof( StaticQueue_t ) + ( xLevels[ uxPriority ].uxQueueLength * sizeof( BasicTaskActivation_t ) );
+        }
+    }
+
+    /* A dispatcher costs a TCB and a queue on top of its stack, so a priority
+     * with only one basic task uses more RAM than the ordinary task would. */
+    printf( "%lu basic tasks use %lu bytes on %lu dispatchers, against %lu bytes as ordinary tasks - %lu bytes %s\r\n\r\n",
+            ( unsigned long ) uxBasicTaskCount,
+            ( unsigned long ) xSharedBytes,
+            ( unsigned long ) uxDispatchers,
+            ( unsigned long ) xSeparateBytes,
+            ( unsigned long ) ( ( xSeparateBytes >= xSharedBytes ) ? ( xSeparateBytes - xSharedBytes ) : ( xSharedBytes - xSeparateBytes ) ),
+            ( xSeparateBytes >= xSharedBytes ) ? "saved" : "more" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDispatcherTask( void * pvParameters )
+{
+    const UBaseType_t uxPriority = ( UBaseType_t ) pvParameters;
+    BasicTaskActivation_t xActivation;
+    BasicTask_t * pxBasicTask;
+    configRUN_TIME_COUNTER_TYPE xStart, xElapsed;
+
+    for( ; ; )
+    {
+        xQueueReceive( xLevels[ uxPriority ].xQueue, &xActivation, portMAX_DELAY );
+        pxBasicTask = xActivation.pxBasicTask;
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+        pxBasicTask->pxFunction( pxBasicTask->pvParameter );
+        xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+        taskENTER_CRITICAL();
+        {
+            /* The running activation counts against the activation limit
+             * until here, so a basic task that activates itself as it
+             * completes needs a limit of at least two. */
+            pxBasicTask->uxActivations--;
+            pxBasicTask->ulRuns++;
+            pxBasicTask->xTotalTime += xElapsed;
+
+            if( xElapsed > pxBasicTask->xMaxTime )
+            {
+                pxBasicTask->xMaxTime = xElapsed;
+            }
+
+            if( ( xStart - xActivation.xActivatedAt ) > pxBasicTask->xMaxLatency )
+            {
+                pxBasicTask->xMaxLatency = xStart - xActivation.xActivatedAt;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCountActivation( BasicTask_t * pxBasicTask )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    pxBasicTask->ulActivations++;
+
+    if( pxBasicTask->uxActivations < pxBasicTask->uxMaxActivations )
+    {
+        pxBasicTask->uxActivations++;
+        xReturn = pdPASS;
+    }
+    else
+    {
+        pxBasicTask->ulRejected++;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
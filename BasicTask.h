@@ -0,0 +1,129 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Basic tasks - run to completion tasks that share one stack per priority.
+ *
+ * Every FreeRTOS task has its own stack, sized for the deepest call chain it
+ * makes, even if it is a short handler that spends almost all its time
+ * blocked waiting for the next event.  A basic task, in the style of an OSEK
+ * basic task, is a function that runs from start to finish each time it is
+ * activated, and never blocks part way through.  Basic tasks of the same
+ * priority can never preempt each other, so they can run one at a time on the
+ * same stack.  All the basic tasks of one priority are run by one dispatcher
+ * task, created by xBasicTaskStart(), whose stack is as deep as the deepest of
+ * them.  The dispatchers are ordinary tasks, so basic tasks are scheduled
+ * against the other tasks by priority as usual.
+ *
+ * A basic task is activated from a task or an interrupt.  Activations of the
+ * basic tasks of one priority are run in the order they were made.  A basic
+ * task can be activated again before it has run, up to its activation limit -
+ * further activations are rejected and counted, rather than lost silently.  A
+ * basic task that must run periodically can activate itself as it completes.
+ *
+ * A basic task must not block.  If it did it would hold up every other basic
+ * task of its priority.
+ *
+ * vBasicTaskPrint() compares the RAM the basic tasks use with the RAM they
+ * would use as ordinary tasks - a stack of the depth given when each was
+ * created, and a TCB.  In the Windows port the real stack of each task is that
+ * of its Windows thread, so the saving is that the same tasks would make on a
+ * microcontroller.  A priority with a single basic task saves nothing - its
+ * dispatcher needs a TCB and a queue as well as the stack - and is reported
+ * as using more RAM.
+ */
+
+#ifndef BASIC_TASK_H
+#define BASIC_TASK_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The most basic tasks that can be created. */
+#ifndef basictaskMAX_TASKS
+    #define basictaskMAX_TASKS    ( 16 )
+#endif
+
+typedef void (* BasicTaskFunction_t)( void * pvParameter );
+
+typedef struct xBASIC_TASK * BasicTaskHandle_t;
+
+typedef struct xBASIC_TASK_STATS
+{
+    const char * pcName;
+    UBaseType_t uxPriority;
+    uint32_t ulActivations;
+    uint32_t ulRejected;        /* Activations beyond the activation limit. */
+    uint32_t ulRuns;
+    uint32_t ulMaxLatencyUs;    /* The longest time from activation to running. */
+    uint32_t ulMeanTimeUs;
+    uint32_t ulMaxTimeUs;
+} BasicTaskStats_t;
+
+/*
+ * Create a basic task that calls pxFunction with pvParameter each time it is
+ * activated.  uxMaxActivations is the most activations that can be waiting at
+ * once, including the one that is running.  uxStackDepth is the stack, in
+ * words, pxFunction needs - the depth it would be given as an ordinary task.
+ * Must be called before xBasicTaskStart().  Returns NULL if basictaskMAX_TASKS
+ * basic tasks already exist.
+ */
+BasicTaskHandle_t xBasicTaskCreate( const char * pcName,
+                                    BasicTaskFunction_t pxFunction,
+                                    void * pvParameter,
+                                    UBaseType_t uxPriority,
+                                    UBaseType_t uxMaxActivations,
+                                    configSTACK_DEPTH_TYPE uxStackDepth );
+
+/*
+ * Create one dispatcher task for each priority that has basic tasks.  Returns
+ * pdFAIL if a dispatcher could not be created.
+ */
+BaseType_t xBasicTaskStart( void );
+
+/*
+ * Activate a basic task.  Returns pdFAIL if the activation was rejected
+ * because the basic task already has uxMaxActivations activations waiting.
+ */
+BaseType_t xBasicTaskActivate( BasicTaskHandle_t xBasicTask );
+BaseType_t xBasicTaskActivateFromISR( BasicTaskHandle_t xBasicTask,
+                                      BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Copy the statistics of the uxIndex'th basic task created into pxStats.
+ * Returns pdFAIL if there is no such basic task.
+ */
+BaseType_t xBasicTaskGetStats( UBaseType_t uxIndex,
+                               BasicTaskStats_t * pxStats );
+
+/*
+ * Print the statistics of each basic task and the RAM saved by sharing
+ * stacks.  Makes Windows system calls, so must be called from a critical
+ * section.
+ */
+void vBasicTaskPrint( void );
+
+#endif /* BASIC_TASK_H */
@@ -0,0 +1,491 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of BlockedTime.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "BlockedTime.h"
+
+#if ( configUSE_BLOCKED_TIME_STATS != 1 )
+    #error configUSE_BLOCKED_TIME_STATS must be 1 in FreeRTOSConfig.h to build BlockedTime.c
+#endif
+
+/* The thread local storage pointer that points to the call being accounted, so
+ * calls made from within it are not accounted too. */
+#define blockedTLS_INDEX           ( 0 )
+
+/* Half the slots of the hash table are left empty so probe sequences stay
+ * short. */
+#define blockedHASH_SIZE           ( blockedMAX_RECORDS * 2 )
+#define blockedEMPTY_SLOT          ( 0xFFFFU )
+
+#define blockedCOUNTS_PER_MS       ( 1000ULL / configUS_PER_RUN_TIME_COUNT )
+
+typedef struct xBLOCKED_RECORD
+{
+    TaskHandle_t xTask;
+    const void * pvObject;
+    uint32_t ulObjectType;
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    char acObjectName[ blockedOBJECT_NAME_LEN ];
+    char acHolderName[ configMAX_TASK_NAME_LEN ];
+    BaseType_t xWaiting;                            /* pdTRUE once the task has blocked in a call on the object... */
+    configRUN_TIME_COUNTER_TYPE xWaitingSince;      /* ...which was made at this time. */
+    configRUN_TIME_COUNTER_TYPE xTotalTime;
+    configRUN_TIME_COUNTER_TYPE xMaxTime;
+    configRUN_TIME_COUNTER_TYPE xInversionTime;
+    uint32_t ulCalls;
+    uint32_t ulBlocked;
+    uint32_t ulInversions;
+} BlockedRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the record of the task named pcTaskName, with handle xTask, waiting
+ * on pvObject, creating it if it does not exist.  Returns NULL if there is no
+ * room for a new record.  Must be called from a critical section.
+ */
+static BlockedRecord_t * prvFindRecord( TaskHandle_t xTask,
+                                        const char * pcTaskName,
+                                        const void * pvObject,
+                                        uint32_t ulObjectType );
+
+/*
+ * Account the end of the call pxCall, either because it returned or because
+ * its task was deleted.  Must be called from a critical section.
+ */
+static void prvEndCall( const BlockedTimeCall_t * pxCall );
+
+/*
+ * Write the name of pxRecord's object.
+ */
+static void prvNameObject( BlockedRecord_t * pxRecord );
+
+/*
+ * Copy pxRecord into pxStats, including any wait in progress at xNow.
+ */
+static void prvGetStats( const BlockedRecord_t * pxRecord,
+                         configRUN_TIME_COUNTER_TYPE xNow,
+                         BlockedTimeStats_t * pxStats );
+
+/*-----------------------------------------------------------*/
+
+static BlockedRecord_t xRecords[ blockedMAX_RECORDS ];
+static UBaseType_t uxRecordCount = 0;
+
+/* Indexes into xRecords[], or blockedEMPTY_SLOT. */
+static uint16_t usHashTable[ blockedHASH_SIZE ];
+static BaseType_t xHashTableInitialised = pdFALSE;
+
+/* Calls not accounted because xRecords[] was full. */
+static uint32_t ulDroppedCalls = 0;
+
+/*-----------------------------------------------------------*/
+
+void vBlockedTimeEnter( BlockedTimeCall_t * pxCall,
+                        uint32_t ulObjectType,
+                        const void * pvObject,
+                        int iMayBlock )
+{
+    TaskHandle_t xTask, xHolder = NULL;
+    BlockedRecord_t * pxRecord;
+    uint8_t ucQueueType;
+
+    pxCall->pvRecord = NULL;
+
+    /* Only calls that can block, made by tasks, and not made from within
+     * another call that is being accounted, are accounted. */
+    if( ( iMayBlock == 0 ) ||
+        ( xTaskGetSchedulerState() != taskSCHEDULER_RUNNING ) ||
+        ( pvTaskGetThreadLocalStoragePointer( NULL, blockedTLS_INDEX ) != NULL ) )
+    {
+        return;
+    }
+
+    xTask = xTaskGetCurrentTaskHandle();
+    pxCall->iInversion = 0;
+
+    if( ulObjectType == blockedOBJECT_QUEUE )
+    {
+        ucQueueType = ucQueueGetQueueType( ( QueueHandle_t ) pvObject );
+
+        if( ( ucQueueType == queueQUEUE_TYPE_MUTEX ) || ( ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX ) )
+        {
+            ulObjectType = blockedOBJECT_MUTEX;
+
+            /* The waiting task will raise the holder's priority, but while a
+             * lower priority task holds the mutex the wait is caused by
+             * priority inversion. */
+            xHolder = xQueueGetMutexHolder( ( QueueHandle_t ) pvObject );
+
+            if( ( xHolder != NULL ) && ( xHolder != xTask ) && ( uxTaskPriorityGet( xHolder ) < uxTaskPriorityGet( NULL ) ) )
+            {
+                pxCall->iInversion = 1;
+            }
+        }
+        else if( ( ucQueueType == queueQUEUE_TYPE_COUNTING_SEMAPHORE ) || ( ucQueueType == queueQUEUE_TYPE_BINARY_SEMAPHORE ) )
+        {
+            ulObjectType = blockedOBJECT_SEMAPHORE;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = prvFindRecord( xTask, pcTaskGetName( NULL ), pvObject, ulObjectType );
+
+        if( pxRecord != NULL )
+        {
+            pxRecord->ulCalls++;
+            pxRecord->xWaitingSince = portGET_RUN_TIME_COUNTER_VALUE();
+
+            if( pxCall->iInversion != 0 )
+            {
+                snprintf( pxRecord->acHolderName, sizeof( pxRecord->acHolderName ), "%s", pcTaskGetName( xHolder ) );
+            }
+        }
+        else
+        {
+            ulDroppedCalls++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( pxRecord != NULL )
+    {
+        /* vBlockedTimeSwitchContextEnter() finds the call through the task's
+         * thread local storage pointer if the task blocks. */
+        pxCall->pvRecord = pxRecord;
+        vTaskSetThreadLocalStoragePointer( NULL, blockedTLS_INDEX, pxCall );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vBlockedTimeReturn( BlockedTimeCall_t * pxCall )
+{
+    if( pxCall->pvRecord == NULL )
+    {
+        return;
+    }
+
+    vTaskSetThreadLocalStoragePointer( NULL, blockedTLS_INDEX, NULL );
+
+    taskENTER_CRITICAL();
+    {
+        prvEndCall( pxCall );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vBlockedTimeSwitchContextEnter( int iStillReady )
+{
+    const BlockedTimeCall_t * pxCall;
+    BlockedRecord_t * pxRecord;
+
+    /* Called by vTaskSwitchContext() before it selects the next task.  A task
+     * that is switched out while still Ready was preempted, or yielded to a
+     * task it woke, so only a task that has left its ready list blocked. */
+    if( iStillReady != 0 )
+    {
+        return;
+    }
+
+    pxCall = ( const BlockedTimeCall_t * ) pvTaskGetThreadLocalStoragePointer( NULL, blockedTLS_INDEX );
+
+    if( pxCall != NULL )
+    {
+        pxRecord = ( BlockedRecord_t * ) pxCall->pvRecord;
+
+        /* A call may block more than once, such as a send that is woken by a
+         * receive but finds the queue full again. */
+        if( pxRecord->xWaiting == pdFALSE )
+        {
+            pxRecord->xWaiting = pdTRUE;
+            pxRecord->ulBlocked++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vBlockedTimeTaskDeleted( void * pvTask )
+{
+    const BlockedTimeCall_t * pxCall;
+
+    /* A task deleted while blocked never returns from its call, so the wait
+     * ends here.  The call is on the task's stack, which is not freed until
+     * the idle task cleans up. */
+    taskENTER_CRITICAL();
+    {
+        pxCall = ( const BlockedTimeCall_t * ) pvTaskGetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, blockedTLS_INDEX );
+
+        if( pxCall != NULL )
+        {
+            prvEndCall( pxCall );
+            vTaskSetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, blockedTLS_INDEX, NULL );
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxBlockedTimeGetRanking( BlockedTimeStats_t * pxStats,
+                                     UBaseType_t uxMaxStats )
+{
+    UBaseType_t uxRecord, uxCount = 0, uxPosition;
+    BlockedTimeStats_t xStats;
+    configRUN_TIME_COUNTER_TYPE xNow;
+
+    taskENTER_CRITICAL();
+    {
+        xNow = portGET_RUN_TIME_COUNTER_VALUE();
+
+        /* An insertion sort that keeps only the uxMaxStats longest. */
+        for( uxRecord = 0; uxRecord < uxRecordCount; uxRecord++ )
+        {
+            prvGetStats( &( xRecords[ uxRecord ] ), xNow, &xStats );
+
+            for( uxPosition = uxCount; uxPosition > 0; uxPosition-- )
+            {
+                if( pxStats[ uxPosition - 1 ].ulTotalMs >= xStats.ulTotalMs )
+                {
+                    break;
+                }
+
+                if( uxPosition < uxMaxStats )
+                {
+                    pxStats[ uxPosition ] = pxStats[ uxPosition - 1 ];
+                }
+            }
+
+            if( uxPosition < uxMaxStats )
+            {
+                pxStats[ uxPosition ] = xStats;
+
+                if( uxCount < uxMaxStats )
+                {
+                    uxCount++;
+                }
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcBlockedTimeObjectTypeName( uint32_t ulObjectType )
+{
+    static const char * const pcNames[] = { "Queue", "Semaphore", "Mutex", "EventGroup", "StreamBuf", "Notify", "Delay" };
+
+    return ( ulObjectType < ( sizeof( pcNames ) / sizeof( pcNames[ 0 ] ) ) ) ? pcNames[ ulObjectType ] : "?";
+}
+/*-----------------------------------------------------------*/
+
+void vBlockedTimePrint( void )
+{
+    static BlockedTimeStats_t xStats[ blockedPRINT_COUNT ];
+    UBaseType_t uxCount, uxIndex;
+
+    uxCount = uxBlockedTimeGetRanking( xStats, blockedPRINT_COUNT );
+
+    printf( "\r\n%-*s %-*s %-10s %8s %8s %10s %8s %5s %8s %s\r\n",
+            configMAX_TASK_NAME_LEN, "Task", blockedOBJECT_NAME_LEN, "Object", "Type",
+            "Calls", "Blocked", "Total(ms)", "Max(ms)", "Inv", "Inv(ms)", "Holder" );
+
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        printf( "%-*s %-*s %-10s %8lu %8lu %10lu %8lu %5lu %8lu %s%s\r\n",
+                configMAX_TASK_NAME_LEN, xStats[ uxIndex ].acTaskName,
+                blockedOBJECT_NAME_LEN, xStats[ uxIndex ].acObjectName,
+                pcBlockedTimeObjectTypeName( xStats[ uxIndex ].ulObjectType ),
+                ( unsigned long ) xStats[ uxIndex ].ulCalls,
+                ( unsigned long ) xStats[ uxIndex ].ulBlocked,
+                ( unsigned long ) xStats[ uxIndex ].ulTotalMs,
+                ( unsigned long ) xStats[ uxIndex ].ulMaxMs,
+                ( unsigned long ) xStats[ uxIndex ].ulInversions,
+                ( unsigned long ) xStats[ uxIndex ].ulInversionMs,
+                xStats[ uxIndex ].acHolderName,
+                ( xStats[ uxIndex ].xWaiting != pdFALSE ) ? " (waiting)" : "" );
+    }
+
+    printf( "%lu task and object pairs recorded, %lu calls not recorded\r\n\r\n", ( unsigned long ) uxRecordCount, ( unsigned long ) ulDroppedCalls );
+}
+/*-----------------------------------------------------------*/
+
+static BlockedRecord_t * prvFindRecord( TaskHandle_t xTask,
+                                        const char * pcTaskName,
+                                        const void * pvObject,
+                                        uint32_t ulObjectType )
+{
+    UBaseType_t uxSlot;
+    BlockedRecord_t * pxRecord;
+
+    if( xHashTableInitialised == pdFALSE )
+    {
+        memset( usHashTable, 0xFF, sizeof( usHashTable ) );
+        xHashTableInitialised = pdTRUE;
+    }
+
+    uxSlot = ( UBaseType_t ) ( ( ( ( uintptr_t ) xTask >> 4 ) * 31U ) ^ ( ( uintptr_t ) pvObject >> 2 ) ^ ulObjectType ) % blockedHASH_SIZE;
+
+    /* A new task may be given the handle of one that was deleted, so the name
+     * is compared too. */
+    while( usHashTable[ uxSlot ] != blockedEMPTY_SLOT )
+    {
+        pxRecord = &( xRecords[ usHashTable[ uxSlot ] ] );
+
+        if( ( pxRecord->xTask == xTask ) && ( pxRecord->pvObject == pvObject ) &&
+            ( pxRecord->ulObjectType == ulObjectType ) && ( strcmp( pxRecord->acTaskName, pcTaskName ) == 0 ) )
+        {
+            return pxRecord;
+        }
+
+        uxSlot = ( uxSlot + 1 ) % blockedHASH_SIZE;
+    }
+
+    if( uxRecordCount >= blockedMAX_RECORDS )
+    {
+        return NULL;
+    }
+
+    pxRecord = &( xRecords[ uxRecordCount ] );
+    pxRecord->xTask = xTask;
+    pxRecord->pvObject = pvObject;
+    pxRecord->ulObjectType = ulObjectType;
+    snprintf( pxRecord->acTaskName, sizeof( pxRecord->acTaskName ), "%s", pcTaskName );
+    prvNameObject( pxRecord );
+
+    usHashTable[ uxSlot ] = ( uint16_t ) uxRecordCount;
+    uxRecordCount++;
+
+    return pxRecord;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEndCall( const BlockedTimeCall_t * pxCall )
+{
+    BlockedRecord_t * pxRecord = ( BlockedRecord_t * ) pxCall->pvRecord;
+    configRUN_TIME_COUNTER_TYPE xElapsed;
+
+    if( pxRecord->xWaiting != pdFALSE )
+    {
+        pxRecord->xWaiting = pdFALSE;
+        xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - pxRecord->xWaitingSince;
+        pxRecord->xTotalTime += xElapsed;
+
+        if( xElapsed > pxRecord->xMaxTime )
+        {
+            pxRecord->xMaxTime = xElapsed;
+        }
+
+        if( pxCall->iInversion != 0 )
+        {
+            pxRecord->ulInversions++;
+            pxRecord->xInversionTime += xElapsed;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvNameObject( BlockedRecord_t * pxRecord )
+{
+    const char * pcName = NULL;
+
+    switch( pxRecord->ulObjectType )
+    {
+        case blockedOBJECT_QUEUE:
+        case blockedOBJECT_SEMAPHORE:
+        case blockedOBJECT_MUTEX:
+            pcName = pcQueueGetName( ( QueueHandle_t ) pxRecord->pvObject );
+            break;
+
+        case blockedOBJECT_NOTIFICATION:
+            snprintf( pxRecord->acObjectName, sizeof( pxRecord->acObjectName ), "Index %lu", ( unsigned long ) ( uintptr_t ) pxRecord->pvObject );
+            return;
+
+        case blockedOBJECT_DELAY:
+            pcName = "-";
+            break;
+
+        default:
+            break;
+    }
+
+    /* Objects that are not in the queue registry are named by address. */
+    if( pcName != NULL )
+    {
+        snprintf( pxRecord->acObjectName, sizeof( pxRecord->acObjectName ), "%s", pcName );
+    }
+    else
+    {
+        snprintf( pxRecord->acObjectName, sizeof( pxRecord->acObjectName ), "%p", pxRecord->pvObject );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetStats( const BlockedRecord_t * pxRecord,
+                         configRUN_TIME_COUNTER_TYPE xNow,
+                         BlockedTimeStats_t * pxStats )
+{
+    configRUN_TIME_COUNTER_TYPE xTotal = pxRecord->xTotalTime, xMax = pxRecord->xMaxTime, xWaited;
+
+    if( pxRecord->xWaiting != pdFALSE )
+    {
+        xWaited = xNow - pxRecord->xWaitingSince;
+        xTotal += xWaited;
+
+        if( xWaited > xMax )
+        {
+            xMax = xWaited;
+        }
+    }
+
+    memcpy( pxStats->acTaskName, pxRecord->acTaskName, sizeof( pxStats->acTaskName ) );
+    memcpy( pxStats->acObjectName, pxRecord->acObjectName, sizeof( pxStats->acObjectName ) );
+    memcpy( pxStats->acHolderName, pxRecord->acHolderName, sizeof( pxStats->acHolderName ) );
+    pxStats->ulObjectType = pxRecord->ulObjectType;
+    pxStats->ulCalls = pxRecord->ulCalls;
+    pxStats->ulBlocked = pxRecord->ulBlocked;
+    pxStats->ulTotalMs = ( uint32_t ) ( xTotal / blockedCOUNTS_PER_MS );
+    pxStats->ulMaxMs = ( uint32_t ) ( xMax / blockedCOUNTS_PER_MS );
+    pxStats->ulInversions = pxRecord->ulInversions;
+    pxStats->ulInversionMs = ( uint32_t ) ( pxRecord->xInversionTime / blockedCOUNTS_PER_MS );
+    pxStats->xWaiting = pxRecord->xWaiting;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,118 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Attribution of the time tasks spend blocked to the objects they block on.
+ *
+ * Run time stats only count the time a task spends Running, so they cannot say
+ * what a slow task is waiting for.  When configUSE_BLOCKED_TIME_STATS is 1 the
+ * traceENTER_ and traceRETURN_ macros of the API functions that can block are
+ * defined in FreeRTOSConfig.h to call vBlockedTimeEnter() and
+ * vBlockedTimeReturn(), and the traceENTER_ macro of vTaskSwitchContext() to
+ * call vBlockedTimeSwitchContextEnter(), which keep a record for each task and
+ * each object it waits on - a queue, semaphore, mutex, event group, stream or message buffer,
+ * notification index, or a delay.  Each record holds:
+ *
+ * - The calls that could have blocked (those with a non-zero block time), and
+ *   how many of them did block.
+ * - The total and longest time from such a call to its return, counting only
+ *   the calls that blocked - those during which the task was switched out
+ *   after the kernel removed it from its ready list.  A call that only yields
+ *   to a higher priority task it woke did not block.  The time includes the
+ *   time the task spent Ready, after being unblocked, before it ran again.
+ * - For mutexes, the waits that were caused by priority inversion - those
+ *   during which the mutex was held by a task of lower priority than the
+ *   waiting task - their total time, and the task that last held the mutex.
+ *
+ * A wait that is in progress is included in the total, so tasks that block
+ * indefinitely are seen too.  Calls made from inside another API function that
+ * is being accounted, such as the notification a stream buffer waits on, are
+ * counted against the outer call's object.
+ *
+ * uxBlockedTimeGetRanking() returns the records with the most blocked time,
+ * so the objects that hold up each task can be seen at a glance.
+ *
+ * Records are keyed by task handle, so the records of deleted tasks remain,
+ * under the names the tasks had.  The traceENTER_ macro of vTaskDelete() calls
+ * vBlockedTimeTaskDeleted(), which ends the wait of a task deleted while it
+ * was blocked.
+ */
+
+#ifndef BLOCKED_TIME_H
+#define BLOCKED_TIME_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The most task and object pairs that can be recorded. */
+#ifndef blockedMAX_RECORDS
+    #define blockedMAX_RECORDS    ( 256 )
+#endif
+
+/* The longest object name kept, including the terminator. */
+#ifndef blockedOBJECT_NAME_LEN
+    #define blockedOBJECT_NAME_LEN    ( 20 )
+#endif
+
+/* The records printed by vBlockedTimePrint(). */
+#ifndef blockedPRINT_COUNT
+    #define blockedPRINT_COUNT    ( 30 )
+#endif
+
+typedef struct xBLOCKED_TIME_STATS
+{
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    char acObjectName[ blockedOBJECT_NAME_LEN ];
+    char acHolderName[ configMAX_TASK_NAME_LEN ];   /* The last lower priority holder of a mutex, or an empty string. */
+    uint32_t ulObjectType;                          /* One of the blockedOBJECT_ values in FreeRTOSConfig.h. */
+    uint32_t ulCalls;                               /* Calls that could have blocked... */
+    uint32_t ulBlocked;                             /* ...and that did. */
+    uint32_t ulTotalMs;                             /* Including any wait in progress. */
+    uint32_t ulMaxMs;
+    uint32_t ulInversions;                          /* Mutex waits caused by priority inversion, and their total time. */
+    uint32_t ulInversionMs;
+    BaseType_t xWaiting;                            /* pdTRUE if the task is waiting on the object now. */
+} BlockedTimeStats_t;
+
+/*
+ * Copy the uxMaxStats records with the most blocked time into pxStats, most
+ * first.  Returns the number of records copied.
+ */
+UBaseType_t uxBlockedTimeGetRanking( BlockedTimeStats_t * pxStats,
+                                     UBaseType_t uxMaxStats );
+
+/*
+ * Return the name of an object type, such as "Mutex".
+ */
+const char * pcBlockedTimeObjectTypeName( uint32_t ulObjectType );
+
+/*
+ * Print the blockedPRINT_COUNT records with the most blocked time.  Makes
+ * Windows system calls, so must be called from a critical section.
+ */
+void vBlockedTimePrint( void );
+
+#endif /* BLOCKED_TIME_H */
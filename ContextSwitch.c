@@ -0,0 +1,486 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of ContextSwitch.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "ContextSwitch.h"
+
+#if ( configUSE_CONTEXT_SWITCH_STATS != 1 )
+    #error configUSE_CONTEXT_SWITCH_STATS must be 1 in FreeRTOSConfig.h to build ContextSwitch.c
+#endif
+
+/* The thread local storage pointer that points to the task's record.  Indexes
+ * 0 and 1 are used by BlockedTime.c and WakeupStats.c. */
+#define ctxswitchTLS_INDEX                ( 2 )
+
+#define ctxswitchCOUNTS_PER_SECOND        ( 1000000ULL / configUS_PER_RUN_TIME_COUNT )
+
+typedef struct xCONTEXT_SWITCH_RECORD
+{
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    TaskHandle_t xTask;                             /* NULL once the task has been deleted. */
+    BaseType_t xDelaying;                           /* pdTRUE while the task is in vTaskDelay() or xTaskDelayUntil(). */
+    BaseType_t xSuspending;                         /* pdTRUE from the task calling vTaskSuspend() on itself until it is switched out. */
+    BaseType_t xReadyPending;                       /* pdTRUE from the task being made ready until it is switched in... */
+    BaseType_t xReadiedFromISR;                     /* ...pdTRUE if it was made ready by an interrupt... */
+    configRUN_TIME_COUNTER_TYPE xReadySince;        /* ...and the time it was made ready. */
+    uint32_t ulSwitchIns;
+    uint32_t ulSwitchOuts[ eSwitchCauseCount ];
+    configRUN_TIME_COUNTER_TYPE xTotalLatency;
+    configRUN_TIME_COUNTER_TYPE xMaxLatency;
+    uint32_t ulLatencySamples;
+    uint32_t ulLatencyHistogram[ ctxswitchLATENCY_BUCKETS ];
+} ContextSwitchRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the record of xTask, creating it if xCreate is pdTRUE and it does not
+ * exist.  A new task takes the record of a deleted task with the same name, so
+ * the switches of tasks that are created and deleted repeatedly are added
+ * together, then an unused record, then the record of any deleted task.
+ * Returns NULL if there is no record.  Records are only created from a
+ * critical section, or from vTaskSwitchContext().
+ */
+static ContextSwitchRecord_t * prvGetRecord( TaskHandle_t xTask,
+                                             BaseType_t xCreate );
+
+/*
+ * Return the latency histogram bucket of xLatency, which is in run time stats
+ * counter units.
+ */
+static UBaseType_t prvGetLatencyBucket( configRUN_TIME_COUNTER_TYPE xLatency );
+
+/*-----------------------------------------------------------*/
+
+static ContextSwitchRecord_t xRecords[ ctxswitchMAX_TASKS ];
+static UBaseType_t uxRecordCount = 0;
+
+/* The task being switched out by vTaskSwitchContext(), its record, its
+ * priority, and whether it was still Ready or had been deleted. */
+static TaskHandle_t xSwitchingOutTask = NULL;
+static ContextSwitchRecord_t * pxSwitchingOut = NULL;
+static uint32_t ulSwitchingOutPriority = 0;
+static int iSwitchingOutReady = 0;
+static int iSwitchingOutDeleted = 0;
+
+/* pdTRUE if the last tick interrupt asked for a context switch. */
+static BaseType_t xTickSwitchRequired = pdFALSE;
+
+/* The time of the first context switch, from which the rates are
+ * calculated. */
+static configRUN_TIME_COUNTER_TYPE xFirstSwitchTime = 0;
+static BaseType_t xFirstSwitchDone = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vContextSwitchEnter( int iStillReady,
+                          int iDeleted,
+                          uint32_t ulPriority )
+{
+    /* Called by vTaskSwitchContext() before it selects the next task. */
+    xSwitchingOutTask = xTaskGetCurrentTaskHandle();
+    pxSwitchingOut = prvGetRecord( xSwitchingOutTask, pdTRUE );
+    ulSwitchingOutPriority = ulPriority;
+    iSwitchingOutReady = iStillReady;
+    iSwitchingOutDeleted = iDeleted;
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchReturn( uint32_t ulPriority )
+{
+    ContextSwitchRecord_t * pxSwitchingIn;
+    configRUN_TIME_COUNTER_TYPE xNow, xLatency;
+    eContextSwitchCause eCause;
+
+    /* vTaskSwitchContext() does not switch tasks while the scheduler is
+     * suspended, and may select the task that was already running. */
+    if( xTaskGetCurrentTaskHandle() == xSwitchingOutTask )
+    {
+        xTickSwitchRequired = pdFALSE;
+        return;
+    }
+
+    xNow = portGET_RUN_TIME_COUNTER_VALUE();
+    pxSwitchingIn = prvGetRecord( xTaskGetCurrentTaskHandle(), pdTRUE );
+
+    if( xFirstSwitchDone == pdFALSE )
+    {
+        xFirstSwitchDone = pdTRUE;
+        xFirstSwitchTime = xNow;
+    }
+
+    if( pxSwitchingOut != NULL )
+    {
+        if( iSwitchingOutReady != 0 )
+        {
+            /* The task could have kept running, so was preempted, or gave way
+             * to a task of its own priority. */
+            if( ulPriority > ulSwitchingOutPriority )
+            {
+                eCause = ( ( pxSwitchingIn != NULL ) && ( pxSwitchingIn->xReadiedFromISR != pdFALSE ) ) ? eSwitchPreemptedFromISR : eSwitchPreempted;
+            }
+            else if( xTickSwitchRequired != pdFALSE )
+            {
+                eCause = eSwitchTimeSlice;
+            }
+            else
+            {
+                eCause = eSwitchYielded;
+            }
+        }
+        else if( iSwitchingOutDeleted != 0 )
+        {
+            eCause = eSwitchDeleted;
+        }
+        else if( pxSwitchingOut->xDelaying != pdFALSE )
+        {
+            eCause = eSwitchDelayed;
+        }
+        else if( pxSwitchingOut->xSuspending != pdFALSE )
+        {
+            eCause = eSwitchSuspended;
+        }
+        else
+        {
+            eCause = eSwitchBlocked;
+        }
+
+        pxSwitchingOut->ulSwitchOuts[ eCause ]++;
+        pxSwitchingOut->xSuspending = pdFALSE;
+    }
+
+    if( pxSwitchingIn != NULL )
+    {
+        pxSwitchingIn->ulSwitchIns++;
+
+        if( pxSwitchingIn->xReadyPending != pdFALSE )
+        {
+            xLatency = xNow - pxSwitchingIn->xReadySince;
+            pxSwitchingIn->xTotalLatency += xLatency;
+            pxSwitchingIn->ulLatencySamples++;
+
+            if( xLatency > pxSwitchingIn->xMaxLatency )
+            {
+                pxSwitchingIn->xMaxLatency = xLatency;
+            }
+
+            pxSwitchingIn->ulLatencyHistogram[ prvGetLatencyBucket( xLatency ) ]++;
+        }
+
+        pxSwitchingIn->xReadyPending = pdFALSE;
+        pxSwitchingIn->xReadiedFromISR = pdFALSE;
+    }
+
+    xTickSwitchRequired = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchTaskReady( void * pvTask )
+{
+    ContextSwitchRecord_t * pxRecord;
+
+    /* Called whenever a task is added to a ready list, which includes a
+     * running task whose priority is changed. */
+    if( ( TaskHandle_t ) pvTask == xTaskGetCurrentTaskHandle() )
+    {
+        return;
+    }
+
+    /* This can be called from an interrupt, so records are not created
+     * here.  A task's first latency is lost if it has not yet run. */
+    pxRecord = prvGetRecord( ( TaskHandle_t ) pvTask, pdFALSE );
+
+    if( ( pxRecord != NULL ) && ( pxRecord->xReadyPending == pdFALSE ) )
+    {
+        pxRecord->xReadyPending = pdTRUE;
+        pxRecord->xReadiedFromISR = xPortIsInsideInterrupt();
+        pxRecord->xReadySince = portGET_RUN_TIME_COUNTER_VALUE();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchTick( int iSwitchRequired )
+{
+    if( iSwitchRequired != 0 )
+    {
+        xTickSwitchRequired = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchDelay( int iDelaying )
+{
+    ContextSwitchRecord_t * pxRecord;
+
+    if( xTaskGetSchedulerState() != taskSCHEDULER_RUNNING )
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = prvGetRecord( xTaskGetCurrentTaskHandle(), pdTRUE );
+
+        if( pxRecord != NULL )
+        {
+            pxRecord->xDelaying = ( iDelaying != 0 ) ? pdTRUE : pdFALSE;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchSuspend( void * pvTask )
+{
+    ContextSwitchRecord_t * pxRecord;
+
+    if( ( xTaskGetSchedulerState() != taskSCHEDULER_RUNNING ) ||
+        ( ( pvTask != NULL ) && ( ( TaskHandle_t ) pvTask != xTaskGetCurrentTaskHandle() ) ) )
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = prvGetRecord( xTaskGetCurrentTaskHandle(), pdTRUE );
+
+        if( pxRecord != NULL )
+        {
+            pxRecord->xSuspending = pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchTaskDeleted( void * pvTask )
+{
+    ContextSwitchRecord_t * pxRecord;
+
+    /* Called from vTaskDelete() before the task is deleted, where NULL is the
+     * calling task.  Records are not created here, as the task may never have
+     * run.  A task that deletes itself keeps its pointer to the record until it
+     * is switched out for the last time, so that switch is counted. */
+    taskENTER_CRITICAL();
+    {
+        pxRecord = prvGetRecord( ( TaskHandle_t ) pvTask, pdFALSE );
+
+        if( pxRecord != NULL )
+        {
+            pxRecord->xTask = NULL;
+
+            if( ( pvTask != NULL ) && ( ( TaskHandle_t ) pvTask != xTaskGetCurrentTaskHandle() ) )
+            {
+                vTaskSetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, ctxswitchTLS_INDEX, NULL );
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xContextSwitchGetStats( UBaseType_t uxIndex,
+                                   ContextSwitchStats_t * pxStats )
+{
+    const ContextSwitchRecord_t * pxRecord;
+
+    if( uxIndex >= uxRecordCount )
+    {
+        return pdFAIL;
+    }
+
+    pxRecord = &( xRecords[ uxIndex ] );
+
+    taskENTER_CRITICAL();
+    {
+        memcpy( pxStats->acTaskName, pxRecord->acTaskName, sizeof( pxStats->acTaskName ) );
+        pxStats->xTask = pxRecord->xTask;
+        memcpy( pxStats->ulSwitchOuts, pxRecord->ulSwitchOuts, sizeof( pxStats->ulSwitchOuts ) );
+        pxStats->ulSwitchIns = pxRecord->ulSwitchIns;
+        pxStats->ulMeanLatencyUs = ( pxRecord->ulLatencySamples == 0 ) ? 0 :
+                                   ( uint32_t ) ( ( pxRecord->xTotalLatency * configUS_PER_RUN_TIME_COUNT ) / pxRecord->ulLatencySamples );
+        pxStats->ulMaxLatencyUs = ( uint32_t ) ( pxRecord->xMaxLatency * configUS_PER_RUN_TIME_COUNT );
+        memcpy( pxStats->ulLatencyHistogram, pxRecord->ulLatencyHistogram, sizeof( pxStats->ulLatencyHistogram ) );
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcContextSwitchCauseName( eContextSwitchCause eCause )
+{
+    static const char * const pcNames[] = { "Preempt", "PreemptISR", "Blocked", "Yield", "TimeSlice", "Delay", "Suspend", "Delete" };
+
+    return ( ( UBaseType_t ) eCause < ( sizeof( pcNames ) / sizeof( pcNames[ 0 ] ) ) ) ? pcNames[ eCause ] : "?";
+}
+/*-----------------------------------------------------------*/
+
+void vContextSwitchPrint( void )
+{
+    ContextSwitchStats_t xStats;
+    UBaseType_t uxIndex;
+    eContextSwitchCause eCause;
+    uint32_t ulTotals[ eSwitchCauseCount ] = { 0 };
+    uint32_t ulTotalSwitches = 0;
+    configRUN_TIME_COUNTER_TYPE xElapsed;
+
+    printf( "\r\n%-*s %8s", configMAX_TASK_NAME_LEN, "Task", "In" );
+
+    for( eCause = eSwitchPreempted; eCause < eSwitchCauseCount; eCause++ )
+    {
+        printf( " %10s", pcContextSwitchCauseName( eCause ) );
+    }
+
+    printf( " %9s %9s\r\n", "Lat(us)", "MaxLat" );
+
+    for( uxIndex = 0; xContextSwitchGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        printf( "%-*s %8lu", configMAX_TASK_NAME_LEN, xStats.acTaskName, ( unsigned long ) xStats.ulSwitchIns );
+
+        for( eCause = eSwitchPreempted; eCause < eSwitchCauseCount; eCause++ )
+        {
+            printf( " %10lu", ( unsigned long ) xStats.ulSwitchOuts[ eCause ] );
+            ulTotals[ eCause ] += xStats.ulSwitchOuts[ eCause ];
+        }
+
+        printf( " %9lu %9lu\r\n", ( unsigned long ) xStats.ulMeanLatencyUs, ( unsigned long ) xStats.ulMaxLatencyUs );
+        ulTotalSwitches += xStats.ulSwitchIns;
+    }
+
+    /* The rates are per second since the first context switch. */
+    xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xFirstSwitchTime;
+
+    if( ( xFirstSwitchDone != pdFALSE ) && ( xElapsed > 0 ) )
+    {
+        printf( "%-*s %8lu", configMAX_TASK_NAME_LEN, "Per second", ( unsigned long ) ( ( ulTotalSwitches * ( configRUN_TIME_COUNTER_TYPE ) ctxswitchCOUNTS_PER_SECOND ) / xElapsed ) );
+
+        for( eCause = eSwitchPreempted; eCause < eSwitchCauseCount; eCause++ )
+        {
+            printf( " %10lu", ( unsigned long ) ( ( ulTotals[ eCause ] * ( configRUN_TIME_COUNTER_TYPE ) ctxswitchCOUNTS_PER_SECOND ) / xElapsed ) );
+        }
+
+        printf( "\r\n" );
+    }
+
+    printf( "%lu tasks recorded\r\n\r\n", ( unsigned long ) uxRecordCount );
+}
+/*-----------------------------------------------------------*/
+
+static ContextSwitchRecord_t * prvGetRecord( TaskHandle_t xTask,
+                                             BaseType_t xCreate )
+{
+    ContextSwitchRecord_t * pxRecord, * pxDeleted = NULL;
+    const char * pcTaskName;
+    UBaseType_t uxIndex;
+
+    pxRecord = ( ContextSwitchRecord_t * ) pvTaskGetThreadLocalStoragePointer( xTask, ctxswitchTLS_INDEX );
+
+    if( ( pxRecord != NULL ) || ( xCreate == pdFALSE ) )
+    {
+        return pxRecord;
+    }
+
+    pcTaskName = pcTaskGetName( xTask );
+
+    for( uxIndex = 0; uxIndex < uxRecordCount; uxIndex++ )
+    {
+        if( xRecords[ uxIndex ].xTask == NULL )
+        {
+            if( strcmp( xRecords[ uxIndex ].acTaskName, pcTaskName ) == 0 )
+            {
+                pxRecord = &( xRecords[ uxIndex ] );
+                break;
+            }
+
+            /* The record of a task that deleted itself is still in use until
+             * the task has been switched out. */
+            if( ( pxDeleted == NULL ) && ( &( xRecords[ uxIndex ] ) != pxSwitchingOut ) )
+            {
+                pxDeleted = &( xRecords[ uxIndex ] );
+            }
+        }
+    }
+
+    if( pxRecord == NULL )
+    {
+        if( uxRecordCount < ctxswitchMAX_TASKS )
+        {
+            pxRecord = &( xRecords[ uxRecordCount ] );
+            uxRecordCount++;
+        }
+        else if( pxDeleted != NULL )
+        {
+            pxRecord = pxDeleted;
+            memset( pxRecord, 0x00, sizeof( *pxRecord ) );
+        }
+        else
+        {
+            return NULL;
+        }
+
+        snprintf( pxRecord->acTaskName, sizeof( pxRecord->acTaskName ), "%s", pcTaskName );
+    }
+
+    /* A reused record keeps its counts, but not the state of the deleted
+     * task. */
+    pxRecord->xDelaying = pdFALSE;
+    pxRecord->xSuspending = pdFALSE;
+    pxRecord->xReadyPending = pdFALSE;
+    pxRecord->xReadiedFromISR = pdFALSE;
+    pxRecord->xTask = ( xTask == NULL ) ? xTaskGetCurrentTaskHandle() : xTask;
+    vTaskSetThreadLocalStoragePointer( xTask, ctxswitchTLS_INDEX, pxRecord );
+
+    return pxRecord;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetLatencyBucket( configRUN_TIME_COUNTER_TYPE xLatency )
+{
+    UBaseType_t uxBucket = 0;
+    configRUN_TIME_COUNTER_TYPE xLimit = ctxswitchFIRST_LATENCY_BUCKET_US / configUS_PER_RUN_TIME_COUNT;
+
+    while( ( uxBucket < ( ctxswitchLATENCY_BUCKETS - 1 ) ) && ( xLatency >= xLimit ) )
+    {
+        uxBucket++;
+        xLimit *= 2U;
+    }
+
+    return uxBucket;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,126 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Accounting of why tasks are switched out, and how long they wait to be
+ * switched in.
+ *
+ * Run time stats show how much processor time each task used, but not why it
+ * stopped running.  When configUSE_CONTEXT_SWITCH_STATS is 1, trace macros
+ * defined in FreeRTOSConfig.h count, for each task, the times it was switched
+ * out because it:
+ *
+ * - Was preempted by a higher priority task that was made ready by a task...
+ * - ...or by an interrupt, including the tick interrupt.
+ * - Blocked on a queue, semaphore, event group, stream buffer or
+ *   notification.
+ * - Yielded to a task of equal priority.
+ * - Reached the end of its time slice.
+ * - Delayed itself with vTaskDelay() or xTaskDelayUntil().
+ * - Suspended itself.
+ * - Deleted itself.
+ *
+ * The switch in latency of each task - the time from being made ready, by
+ * being unblocked, resumed or created, until it runs - is recorded too, as a
+ * mean, a maximum and a histogram.
+ * vContextSwitchPrint() prints the counts and latencies of each task, and the
+ * rate of each cause across the system, so tasks that switch excessively, and
+ * the tasks and interrupts that make them, can be found.
+ *
+ * A task is recorded from the first time it is switched in.  The record of a
+ * deleted task no longer refers to the task, and is kept until it is needed.
+ * A new task takes the record of a deleted task of the same name, adding to
+ * its counts, so tasks that are created and deleted repeatedly do not fill the
+ * ctxswitchMAX_TASKS records, and keep appearing in the trace stats.
+ */
+
+#ifndef CONTEXT_SWITCH_H
+#define CONTEXT_SWITCH_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The most tasks that can be recorded. */
+#ifndef ctxswitchMAX_TASKS
+    #define ctxswitchMAX_TASKS    ( 96 )
+#endif
+
+/* Switch in latencies are also counted in a histogram.  The first bucket holds
+ * latencies below ctxswitchFIRST_LATENCY_BUCKET_US, each later bucket's limit
+ * is double the one before, and the last bucket holds everything above. */
+#ifndef ctxswitchLATENCY_BUCKETS
+    #define ctxswitchLATENCY_BUCKETS    ( 10 )
+#endif
+
+#ifndef ctxswitchFIRST_LATENCY_BUCKET_US
+    #define ctxswitchFIRST_LATENCY_BUCKET_US    ( 10UL )
+#endif
+
+/* The reasons a task is switched out. */
+typedef enum
+{
+    eSwitchPreempted = 0,
+    eSwitchPreemptedFromISR,
+    eSwitchBlocked,
+    eSwitchYielded,
+    eSwitchTimeSlice,
+    eSwitchDelayed,
+    eSwitchSuspended,
+    eSwitchDeleted,
+    eSwitchCauseCount
+} eContextSwitchCause;
+
+typedef struct xCONTEXT_SWITCH_STATS
+{
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    TaskHandle_t xTask;         /* NULL once the task has been deleted, until another task of the same name takes the record. */
+    uint32_t ulSwitchIns;
+    uint32_t ulSwitchOuts[ eSwitchCauseCount ];
+    uint32_t ulMeanLatencyUs;   /* From being made ready to running. */
+    uint32_t ulMaxLatencyUs;
+    uint32_t ulLatencyHistogram[ ctxswitchLATENCY_BUCKETS ];
+} ContextSwitchStats_t;
+
+/*
+ * Copy the statistics of the uxIndex'th task recorded into pxStats.  Returns
+ * pdFAIL if there is no such task.
+ */
+BaseType_t xContextSwitchGetStats( UBaseType_t uxIndex,
+                                   ContextSwitchStats_t * pxStats );
+
+/*
+ * Return the name of a cause, such as "TimeSlice".
+ */
+const char * pcContextSwitchCauseName( eContextSwitchCause eCause );
+
+/*
+ * Print the switches of each task, and the rate of each cause across the
+ * system since the scheduler started.  Makes Windows system calls, so must be
+ * called from a critical section.
+ */
+void vContextSwitchPrint( void );
+
+#endif /* CONTEXT_SWITCH_H */
@@ -0,0 +1,445 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of ControlSocket.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Windows includes.  afunix.h must follow winsock2.h. */
+#include <winsock2.h>
+#include <afunix.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "ControlSocket.h"
+
+/* Space for the reply wrapped around a command's result. */
+#define ctrlMAX_REPLY_LENGTH    ( ctrlMAX_RESULT_LENGTH + 64 )
+
+/* How often the interrupt is generated again while a request is waiting to
+ * execute.  The port drops interrupts generated before the scheduler starts,
+ * so a request sent then would otherwise never execute. */
+#define ctrlRETRY_INTERVAL_MS   ( 50 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The Windows thread that accepts connections and reads requests.
+ */
+static DWORD WINAPI prvControlSocketThread( void * pvParam );
+
+/*
+ * Pass one request into the simulator, wait for it to execute, and send the
+ * reply to xClient.
+ */
+static void prvExecuteRequest( SOCKET xClient,
+                               const char * pcRequest );
+
+/*
+ * Wait up to ctrlREQUEST_TIMEOUT_MS for the reply to request number
+ * ulRequest, generating the interrupt again every ctrlRETRY_INTERVAL_MS until
+ * it arrives.  Returns pdFAIL if it did not arrive in time.
+ */
+static BaseType_t prvWaitForReply( uint32_t ulRequest );
+
+/*
+ * The simulated interrupt that executes the pending request.
+ */
+static uint32_t prvControlInterruptHandler( void );
+
+/*
+ * The "help" command.
+ */
+static BaseType_t prvHelpCommand( const char * pcArguments,
+                                  char * pcResult,
+                                  size_t xResultLength );
+
+/*
+ * Append pcText to pcBuffer as the contents of a JSON string, escaping any
+ * characters that need it.  Returns the new length of the text in pcBuffer.
+ */
+static size_t prvAppendEscaped( char * pcBuffer,
+                                size_t xLength,
+                                size_t xBufferLength,
+                                const char * pcText );
+
+/*-----------------------------------------------------------*/
+
+static const ControlCommand_t xHelpCommand =
+{
+    "help",
+    "List the commands",
+    prvHelpCommand
+};
+
+/* The registered commands. */
+static const ControlCommand_t * pxCommands[ ctrlMAX_COMMANDS ] = { &xHelpCommand };
+static UBaseType_t uxCommandCount = 1;
+
+/* The request being executed, and its reply.  The Windows thread writes the
+ * request and increments ulRequestNumber before generating the interrupt.  The
+ * interrupt writes the reply then sets ulReplyNumber to match. */
+static char cRequest[ ctrlMAX_REQUEST_LENGTH ];
+static char cReply[ ctrlMAX_REPLY_LENGTH ];
+static volatile uint32_t ulRequestNumber = 0;
+static volatile uint32_t ulReplyNumber = 0;
+static HANDLE xReplyEvent = NULL;
+
+static SOCKET xListenSocket = INVALID_SOCKET;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xControlSocketRegister( const ControlCommand_t * pxCommand )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    configASSERT( pxCommand );
+    configASSERT( pxCommand->pxFunction );
+
+    taskENTER_CRITICAL();
+    {
+        if( uxCommandCount < ctrlMAX_COMMANDS )
+        {
+            pxCommands[ uxCommandCount ] = pxCommand;
+            uxCommandCount++;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xControlSocketStart( void )
+{
+    WSADATA xWSAData;
+    SOCKADDR_UN xAddress;
+    HANDLE xThread;
+    BaseType_t xReturn = pdFAIL;
+
+    xReplyEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+    if( ( xReplyEvent != NULL ) && ( WSAStartup( MAKEWORD( 2, 2 ), &xWSAData ) == 0 ) )
+    {
+        xListenSocket = socket( AF_UNIX, SOCK_STREAM, 0 );
+
+        if( xListenSocket != INVALID_SOCKET )
+        {
+            memset( &xAddress, 0x00, sizeof( xAddress ) );
+            xAddress.sun_family = AF_UNIX;
+            strncpy( xAddress.sun_path, ctrlSOCKET_PATH, sizeof( xAddress.sun_path ) - 1 );
+
+            /* A socket file left by a previous run prevents the bind. */
+            DeleteFileA( ctrlSOCKET_PATH );
+
+            if( ( bind( xListenSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) == 0 ) &&
+                ( listen( xListenSocket, 1 ) == 0 ) )
+            {
+                vPortSetInterruptHandler( ctrlINTERRUPT_NUMBER, prvControlInterruptHandler );
+
+                xThread = CreateThread( NULL, 0, prvControlSocketThread, NULL, 0, NULL );
+
+                if( xThread != NULL )
+                {
+                    /* Use the cores that are not used by the FreeRTOS tasks. */
+                    SetThreadAffinityMask( xThread, ~0x01u );
+                    xReturn = pdPASS;
+                }
+            }
+
+            if( xReturn != pdPASS )
+            {
+                closesocket( xListenSocket );
+                xListenSocket = INVALID_SOCKET;
+            }
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static DWORD WINAPI prvControlSocketThread( void * pvParam )
+{
+    static const char cTooLongReply[] = "{\"ok\":false,\"error\":\"request too long\"}\n";
+    static char cReceived[ ctrlMAX_REQUEST_LENGTH ];
+    SOCKET xClient;
+    size_t xUsed;
+    int iReceived;
+    char * pcEnd;
+
+    ( void ) pvParam;
+
+    for( ; ; )
+    {
+        /* One client at a time. */
+        xClient = accept( xListenSocket, NULL, NULL );
+
+        if( xClient == INVALID_SOCKET )
+        {
+            continue;
+        }
+
+        xUsed = 0;
+
+        while( ( iReceived = recv( xClient, &( cReceived[ xUsed ] ), ( int ) ( sizeof( cReceived ) - xUsed - 1 ), 0 ) ) > 0 )
+        {
+            xUsed += ( size_t ) iReceived;
+            cReceived[ xUsed ] = '\0';
+
+            /* Execute every complete line received so far. */
+            while( ( pcEnd = strchr( cReceived, '\n' ) ) != NULL )
+            {
+                *pcEnd = '\0';
+
+                if( ( pcEnd > cReceived ) && ( *( pcEnd - 1 ) == '\r' ) )
+                {
+                    *( pcEnd - 1 ) = '\0';
+                }
+
+                prvExecuteRequest( xClient, cReceived );
+
+                xUsed -= ( size_t ) ( pcEnd + 1 - cReceived );
+                memmove( cReceived, pcEnd + 1, xUsed + 1 );
+            }
+
+            if( xUsed == ( sizeof( cReceived ) - 1 ) )
+            {
+                /* No room left for the end of the line. */
+                send( xClient, cTooLongReply, ( int ) strlen( cTooLongReply ), 0 );
+                xUsed = 0;
+            }
+        }
+
+        closesocket( xClient );
+    }
+
+    /* Should not get here. */
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvExecuteRequest( SOCKET xClient,
+                               const char * pcRequest )
+{
+    static const char cTimeoutReply[] = "{\"ok\":false,\"error\":\"timed out\"}\n";
+    uint32_t ulThisRequest;
+
+    if( *pcRequest == '\0' )
+    {
+        return;
+    }
+
+    /* A request that timed out may still be waiting to execute, so wait for
+     * its reply before reusing the buffers. */
+    if( prvWaitForReply( ulRequestNumber ) != pdPASS )
+    {
+        send( xClient, cTimeoutReply, ( int ) strlen( cTimeoutReply ), 0 );
+        return;
+    }
+
+    strncpy( cRequest, pcRequest, sizeof( cRequest ) - 1 );
+    cRequest[ sizeof( cRequest ) - 1 ] = '\0';
+    ulThisRequest = ulRequestNumber + 1;
+
+    /* The request must be visible to the interrupt before the new number
+     * is. */
+    MemoryBarrier();
+    ulRequestNumber = ulThisRequest;
+
+    if( prvWaitForReply( ulThisRequest ) != pdPASS )
+    {
+        send( xClient, cTimeoutReply, ( int ) strlen( cTimeoutReply ), 0 );
+        return;
+    }
+
+    /* Read the reply only after reading the number. */
+    MemoryBarrier();
+    send( xClient, cReply, ( int ) strlen( cReply ), 0 );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForReply( uint32_t ulRequest )
+{
+    DWORD ulStart = GetTickCount();
+
+    while( ulReplyNumber != ulRequest )
+    {
+        if( ( GetTickCount() - ulStart ) >= ctrlREQUEST_TIMEOUT_MS )
+        {
+            return pdFAIL;
+        }
+
+        /* The interrupt handler does nothing if the request has already
+         * executed, so generating it more than once is harmless. */
+        vPortGenerateSimulatedInterruptFromWindowsThread( ctrlINTERRUPT_NUMBER );
+        ( void ) WaitForSingleObject( xReplyEvent, ctrlRETRY_INTERVAL_MS );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvControlInterruptHandler( void )
+{
+    static char cResult[ ctrlMAX_RESULT_LENGTH ];
+    const ControlCommand_t * pxCommand = NULL;
+    const char * pcArguments;
+    size_t xNameLength, xLength;
+    UBaseType_t uxIndex;
+    BaseType_t xPassed;
+    uint32_t ulThisRequest;
+
+    ulThisRequest = ulRequestNumber;
+
+    if( ulThisRequest == ulReplyNumber )
+    {
+        /* Nothing pending. */
+        return pdFALSE;
+    }
+
+    MemoryBarrier();
+
+    /* Split the request into the command name and its arguments. */
+    xNameLength = strcspn( cRequest, " " );
+    pcArguments = &( cRequest[ xNameLength ] );
+
+    while( *pcArguments == ' ' )
+    {
+        pcArguments++;
+    }
+
+    for( uxIndex = 0; uxIndex < uxCommandCount; uxIndex++ )
+    {
+        if( ( strncmp( pxCommands[ uxIndex ]->pcCommand, cRequest, xNameLength ) == 0 ) &&
+            ( pxCommands[ uxIndex ]->pcCommand[ xNameLength ] == '\0' ) )
+        {
+            pxCommand = pxCommands[ uxIndex ];
+            break;
+        }
+    }
+
+    cResult[ 0 ] = '\0';
+
+    if( pxCommand != NULL )
+    {
+        xPassed = pxCommand->pxFunction( pcArguments, cResult, sizeof( cResult ) );
+    }
+    else
+    {
+        snprintf( cResult, sizeof( cResult ), "unknown command, try help" );
+        xPassed = pdFAIL;
+    }
+
+    if( xPassed != pdFAIL )
+    {
+        snprintf( cReply, sizeof( cReply ), "{\"ok\":true,\"result\":%s}\n", ( cResult[ 0 ] != '\0' ) ? cResult : "null" );
+    }
+    else
+    {
+        xLength = ( size_t ) snprintf( cReply, sizeof( cReply ), "{\"ok\":false,\"error\":\"" );
+        xLength = prvAppendEscaped( cReply, xLength, sizeof( cReply ), cResult );
+        snprintf( &( cReply[ xLength ] ), sizeof( cReply ) - xLength, "\"}\n" );
+    }
+
+    MemoryBarrier();
+    ulReplyNumber = ulThisRequest;
+    SetEvent( xReplyEvent );
+
+    /* The command may have unblocked a task. */
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHelpCommand( const char * pcArguments,
+                                  char * pcResult,
+                                  size_t xResultLength )
+{
+    UBaseType_t uxIndex;
+    size_t xLength = 0;
+
+    ( void ) pcArguments;
+
+    pcResult[ xLength++ ] = '[';
+
+    for( uxIndex = 0; uxIndex < uxCommandCount; uxIndex++ )
+    {
+        /* The most space the entry can take once escaped, plus the closing
+         * bracket. */
+        if( ( xLength + ( 2 * ( strlen( pxCommands[ uxIndex ]->pcCommand ) + strlen( pxCommands[ uxIndex ]->pcHelp ) ) ) + 32 ) > xResultLength )
+        {
+            snprintf( pcResult, xResultLength, "too many commands to list" );
+            return pdFAIL;
+        }
+
+        xLength += ( size_t ) snprintf( &( pcResult[ xLength ] ), xResultLength - xLength, "%s{\"command\":\"", ( uxIndex == 0 ) ? "" : "," );
+        xLength = prvAppendEscaped( pcResult, xLength, xResultLength, pxCommands[ uxIndex ]->pcCommand );
+        xLength += ( size_t ) snprintf( &( pcResult[ xLength ] ), xResultLength - xLength, "\",\"help\":\"" );
+        xLength = prvAppendEscaped( pcResult, xLength, xResultLength, pxCommands[ uxIndex ]->pcHelp );
+        xLength += ( size_t ) snprintf( &( pcResult[ xLength ] ), xResultLength - xLength, "\"}" );
+    }
+
+    pcResult[ xLength++ ] = ']';
+    pcResult[ xLength ] = '\0';
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvAppendEscaped( char * pcBuffer,
+                                size_t xLength,
+                                size_t xBufferLength,
+                                const char * pcText )
+{
+    /* Leave room for an escaped character and the terminator. */
+    while( ( *pcText != '\0' ) && ( ( xLength + 3 ) < xBufferLength ) )
+    {
+        if( ( *pcText == '"' ) || ( *pcText == '\\' ) )
+        {
+            pcBuffer[ xLength++ ] = '\\';
+            pcBuffer[ xLength++ ] = *pcText;
+        }
+        else if( ( unsigned char ) *pcText >= ' ' )
+        {
+            pcBuffer[ xLength++ ] = *pcText;
+        }
+
+        pcText++;
+    }
+
+    pcBuffer[ xLength ] = '\0';
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
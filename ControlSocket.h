@@ -0,0 +1,124 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A control socket through which scripts can drive a running demo.
+ *
+ * The keyboard commands read in main.c cannot be scripted and take no
+ * arguments.  The control socket is a Unix domain (AF_UNIX) stream socket,
+ * created at ctrlSOCKET_PATH in the working directory, served by a Windows
+ * thread that runs outside the simulator.  AF_UNIX sockets need Windows 10
+ * version 1803 or later.
+ *
+ * Each request is one line of text - a command name followed by its
+ * arguments, separated by spaces.  Each request receives one line in reply,
+ * a JSON object that is either:
+ *
+ *   {"ok":true,"result":<the JSON value written by the command>}
+ *
+ * or:
+ *
+ *   {"ok":false,"error":"<the text written by the command>"}
+ *
+ * Requests are executed one at a time, in order.  A client may send several
+ * requests without waiting for the replies.
+ *
+ * Commands are registered with xControlSocketRegister().  The Windows thread
+ * passes each request into the simulator by generating a simulated interrupt,
+ * so the command functions execute in the interrupt handler.  They must only
+ * use the FreeRTOS API functions that end in "FromISR", and must make any
+ * Windows system calls from a critical section.  The "help" command, which
+ * lists the registered commands, is always available.
+ */
+
+#ifndef CONTROL_SOCKET_H
+#define CONTROL_SOCKET_H
+
+#include "FreeRTOS.h"
+
+/* The simulated interrupt used to execute requests.  Interrupt 3 is used by
+ * the keyboard in main.c, and interrupt 4 by HostIO.c. */
+#ifndef ctrlINTERRUPT_NUMBER
+    #define ctrlINTERRUPT_NUMBER    ( 5 )
+#endif
+
+#ifndef ctrlSOCKET_PATH
+    #define ctrlSOCKET_PATH    "FreeRTOS-demo.sock"
+#endif
+
+/* The most commands that can be registered. */
+#ifndef ctrlMAX_COMMANDS
+    #define ctrlMAX_COMMANDS    ( 24 )
+#endif
+
+/* The longest request, and the longest result or error a command can write,
+ * in bytes. */
+#ifndef ctrlMAX_REQUEST_LENGTH
+    #define ctrlMAX_REQUEST_LENGTH    ( 256 )
+#endif
+
+#ifndef ctrlMAX_RESULT_LENGTH
+    #define ctrlMAX_RESULT_LENGTH    ( 1024 )
+#endif
+
+/* How long the Windows thread waits for a request to execute before replying
+ * with an error, for example because the scheduler has not started. */
+#ifndef ctrlREQUEST_TIMEOUT_MS
+    #define ctrlREQUEST_TIMEOUT_MS    ( 1000 )
+#endif
+
+/*
+ * The function that implements a command.  pcArguments is the text that
+ * followed the command name, with leading spaces removed.  The function writes
+ * its result as a JSON value, or an error message, to pcResult, which is
+ * xResultLength bytes long, and returns pdPASS or pdFAIL respectively.
+ */
+typedef BaseType_t (* ControlCommandFunction_t)( const char * pcArguments,
+                                                 char * pcResult,
+                                                 size_t xResultLength );
+
+typedef struct xCONTROL_COMMAND
+{
+    const char * pcCommand;                 /* The command name, without spaces. */
+    const char * pcHelp;                    /* Returned by the "help" command. */
+    ControlCommandFunction_t pxFunction;
+} ControlCommand_t;
+
+/*
+ * Add a command.  Only a pointer to pxCommand is kept, so it must remain
+ * valid - normally it is declared static const.  Returns pdFAIL if
+ * ctrlMAX_COMMANDS commands are already registered.
+ */
+BaseType_t xControlSocketRegister( const ControlCommand_t * pxCommand );
+
+/*
+ * Create the socket and the Windows thread that serves it, and install the
+ * interrupt handler that executes requests.  Call from main() before the
+ * scheduler is started.  Returns pdFAIL if the socket could not be created.
+ */
+BaseType_t xControlSocketStart( void );
+
+#endif /* CONTROL_SOCKET_H */
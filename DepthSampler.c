@@ -0,0 +1,376 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of DepthSampler.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* Demo includes. */
+#include "DepthSampler.h"
+
+/* The largest depth the timeline can record.  Deeper samples are recorded as
+ * this value. */
+#define depthMAX_TIMELINE_DEPTH    ( 0xFFFFU )
+
+typedef struct xDEPTH_OBJECT
+{
+    const char * pcName;
+    QueueHandle_t xQueue;                   /* NULL if the object is a stream buffer... */
+    StreamBufferHandle_t xStreamBuffer;     /* ...NULL if it is a queue. */
+    size_t xLength;
+    size_t xDepth;
+    size_t xHighWaterMark;
+    uint64_t ullDepthSum;
+    uint32_t ulSamples;
+    uint32_t ulSamplesFull;
+    uint32_t ulSamplesEmpty;
+    uint32_t ulFirstEntry;                  /* The value of ulEntryCount when the object was added. */
+    uint16_t usDeepest;                     /* The deepest sample since the last timeline entry. */
+    uint16_t usTimeline[ depthTIMELINE_LENGTH ];
+} DepthObject_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Add an object, one of xQueue and xStreamBuffer being NULL.
+ */
+static BaseType_t prvAddObject( const char * pcName,
+                                QueueHandle_t xQueue,
+                                StreamBufferHandle_t xStreamBuffer,
+                                size_t xLength );
+
+/*
+ * Returns the current depth of pxObject.
+ */
+static size_t prvGetDepth( const DepthObject_t * pxObject );
+
+/*-----------------------------------------------------------*/
+
+/* The objects added.  The tick hook reads uxObjectCount, so an object is
+ * filled in before the count is incremented. */
+static DepthObject_t xObjects[ depthMAX_OBJECTS ];
+static volatile UBaseType_t uxObjectCount = 0;
+
+/* The tick count at the end of each timeline entry, the number of entries
+ * made, and the samples taken since the last entry.  Entry n is at index
+ * n % depthTIMELINE_LENGTH. */
+static TickType_t xEntryTicks[ depthTIMELINE_LENGTH ];
+static uint32_t ulEntryCount = 0;
+static uint32_t ulSamplesInEntry = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xDepthSamplerAddQueue( const char * pcName,
+                                  QueueHandle_t xQueue )
+{
+    configASSERT( xQueue );
+
+    return prvAddObject( pcName, xQueue, NULL, uxQueueMessagesWaiting( xQueue ) + uxQueueSpacesAvailable( xQueue ) );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDepthSamplerAddStreamBuffer( const char * pcName,
+                                         StreamBufferHandle_t xStreamBuffer )
+{
+    configASSERT( xStreamBuffer );
+
+    return prvAddObject( pcName, NULL, xStreamBuffer, xStreamBufferBytesAvailable( xStreamBuffer ) + xStreamBufferSpacesAvailable( xStreamBuffer ) );
+}
+/*-----------------------------------------------------------*/
+
+void vDepthSamplerTickHook( void )
+{
+    static TickType_t xTicksToNextSample = 0;
+    DepthObject_t * pxObject;
+    UBaseType_t uxIndex, uxCount;
+    size_t xDepth;
+    uint16_t usDepth;
+    uint32_t ulSlot;
+    BaseType_t xEndOfEntry;
+
+    if( xTicksToNextSample > 0 )
+    {
+        xTicksToNextSample--;
+        return;
+    }
+
+    xTicksToNextSample = depthSAMPLE_PERIOD_TICKS - 1;
+    uxCount = uxObjectCount;
+
+    if( uxCount == 0 )
+    {
+        return;
+    }
+
+    ulSamplesInEntry++;
+    xEndOfEntry = ( ulSamplesInEntry >= depthTIMELINE_DECIMATION ) ? pdTRUE : pdFALSE;
+    ulSlot = ulEntryCount % depthTIMELINE_LENGTH;
+
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        pxObject = &( xObjects[ uxIndex ] );
+        xDepth = prvGetDepth( pxObject );
+
+        pxObject->xDepth = xDepth;
+        pxObject->ullDepthSum += xDepth;
+        pxObject->ulSamples++;
+
+        if( xDepth > pxObject->xHighWaterMark )
+        {
+            pxObject->xHighWaterMark = xDepth;
+        }
+
+        if( xDepth == 0 )
+        {
+            pxObject->ulSamplesEmpty++;
+        }
+        else if( xDepth >= pxObject->xLength )
+        {
+            pxObject->ulSamplesFull++;
+        }
+
+        usDepth = ( uint16_t ) ( ( xDepth > depthMAX_TIMELINE_DEPTH ) ? depthMAX_TIMELINE_DEPTH : xDepth );
+
+        if( usDepth > pxObject->usDeepest )
+        {
+            pxObject->usDeepest = usDepth;
+        }
+
+        if( xEndOfEntry != pdFALSE )
+        {
+            pxObject->usTimeline[ ulSlot ] = pxObject->usDeepest;
+            pxObject->usDeepest = 0;
+        }
+    }
+
+    if( xEndOfEntry != pdFALSE )
+    {
+        xEntryTicks[ ulSlot ] = xTaskGetTickCountFromISR();
+        ulEntryCount++;
+        ulSamplesInEntry = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxDepthSamplerGetObjectCount( void )
+{
+    return uxObjectCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDepthSamplerGetStats( UBaseType_t uxIndex,
+                                  DepthStats_t * pxStats )
+{
+    const DepthObject_t * pxObject;
+
+    if( uxIndex >= uxObjectCount )
+    {
+        return pdFAIL;
+    }
+
+    pxObject = &( xObjects[ uxIndex ] );
+
+    /* The tick hook updates the counters.  In the Windows port a critical
+     * section can be entered from both tasks and interrupts. */
+    taskENTER_CRITICAL();
+    {
+        pxStats->pcName = pxObject->pcName;
+        pxStats->xLength = pxObject->xLength;
+        pxStats->xDepth = pxObject->xDepth;
+        pxStats->xHighWaterMark = pxObject->xHighWaterMark;
+        pxStats->ulSamples = pxObject->ulSamples;
+        pxStats->ulTicksFull = pxObject->ulSamplesFull * depthSAMPLE_PERIOD_TICKS;
+        pxStats->ulTicksEmpty = pxObject->ulSamplesEmpty * depthSAMPLE_PERIOD_TICKS;
+        pxStats->ulMeanDepth = ( pxObject->ulSamples == 0 ) ? 0 : ( uint32_t ) ( ( pxObject->ullDepthSum * 10ULL ) / pxObject->ulSamples );
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vDepthSamplerPrint( void )
+{
+    UBaseType_t uxIndex;
+    DepthStats_t xStats;
+    uint32_t ulFullPercent, ulEmptyPercent;
+
+    printf( "\r\n%-16s %7s %7s %7s %8s %7s %7s %8s\r\n", "Object", "Length", "Depth", "HWM", "Mean", "Full%", "Empty%", "Suggest" );
+
+    for( uxIndex = 0; xDepthSamplerGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        ulFullPercent = 0;
+        ulEmptyPercent = 0;
+
+        if( xStats.ulSamples != 0 )
+        {
+            ulFullPercent = ( uint32_t ) ( ( ( uint64_t ) xStats.ulTicksFull * 100ULL ) / ( ( uint64_t ) xStats.ulSamples * depthSAMPLE_PERIOD_TICKS ) );
+            ulEmptyPercent = ( uint32_t ) ( ( ( uint64_t ) xStats.ulTicksEmpty * 100ULL ) / ( ( uint64_t ) xStats.ulSamples * depthSAMPLE_PERIOD_TICKS ) );
+        }
+
+        printf( "%-16s %7lu %7lu %7lu %6lu.%lu %7lu %7lu ",
+                xStats.pcName,
+                ( unsigned long ) xStats.xLength,
+                ( unsigned long ) xStats.xDepth,
+                ( unsigned long ) xStats.xHighWaterMark,
+                ( unsigned long ) ( xStats.ulMeanDepth / 10UL ),
+                ( unsigned long ) ( xStats.ulMeanDepth % 10UL ),
+                ( unsigned long ) ulFullPercent,
+                ( unsigned long ) ulEmptyPercent );
+
+        /* An object that has been full may have needed to be longer, so only
+         * suggest a length for objects that never were. */
+        if( xStats.ulTicksFull != 0 )
+        {
+            printf( "%8s\r\n", "longer?" );
+        }
+        else
+        {
+            printf( "%8lu\r\n", ( unsigned long ) ( ( xStats.xHighWaterMark == 0 ) ? 1 : xStats.xHighWaterMark ) );
+        }
+    }
+
+    printf( "\r\nSampled every %lu tick(s), %lu timeline entries of %lu samples\r\n\r\n",
+            ( unsigned long ) depthSAMPLE_PERIOD_TICKS,
+            ( unsigned long ) ulEntryCount,
+            ( unsigned long ) depthTIMELINE_DECIMATION );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDepthSamplerSaveTimeline( const char * pcFileName )
+{
+    FILE * pxOutputFile;
+    UBaseType_t uxIndex, uxCount = uxObjectCount;
+    uint32_t ulEntry, ulFirst, ulSlot;
+
+    pxOutputFile = fopen( pcFileName, "w" );
+
+    if( pxOutputFile == NULL )
+    {
+        return pdFAIL;
+    }
+
+    fprintf( pxOutputFile, "tick" );
+
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        fprintf( pxOutputFile, ",%s", xObjects[ uxIndex ].pcName );
+    }
+
+    fprintf( pxOutputFile, "\n" );
+
+    /* Only the last depthTIMELINE_LENGTH entries are still in the ring. */
+    ulFirst = ( ulEntryCount > depthTIMELINE_LENGTH ) ? ( ulEntryCount - depthTIMELINE_LENGTH ) : 0;
+
+    for( ulEntry = ulFirst; ulEntry < ulEntryCount; ulEntry++ )
+    {
+        ulSlot = ulEntry % depthTIMELINE_LENGTH;
+        fprintf( pxOutputFile, "%lu", ( unsigned long ) xEntryTicks[ ulSlot ] );
+
+        for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+        {
+            /* Leave the cell empty for entries made before the object was
+             * added. */
+            if( ulEntry < xObjects[ uxIndex ].ulFirstEntry )
+            {
+                fprintf( pxOutputFile, "," );
+            }
+            else
+            {
+                fprintf( pxOutputFile, ",%u", ( unsigned ) xObjects[ uxIndex ].usTimeline[ ulSlot ] );
+            }
+        }
+
+        fprintf( pxOutputFile, "\n" );
+    }
+
+    fclose( pxOutputFile );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAddObject( const char * pcName,
+                                QueueHandle_t xQueue,
+                                StreamBufferHandle_t xStreamBuffer,
+                                size_t xLength )
+{
+    DepthObject_t * pxObject;
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        if( uxObjectCount < depthMAX_OBJECTS )
+        {
+            pxObject = &( xObjects[ uxObjectCount ] );
+            pxObject->pcName = pcName;
+            pxObject->xQueue = xQueue;
+            pxObject->xStreamBuffer = xStreamBuffer;
+            pxObject->xLength = xLength;
+            pxObject->xDepth = 0;
+            pxObject->xHighWaterMark = 0;
+            pxObject->ullDepthSum = 0;
+            pxObject->ulSamples = 0;
+            pxObject->ulSamplesFull = 0;
+            pxObject->ulSamplesEmpty = 0;
+            pxObject->usDeepest = 0;
+            pxObject->ulFirstEntry = ulEntryCount;
+
+            uxObjectCount++;
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetDepth( const DepthObject_t * pxObject )
+{
+    size_t xDepth;
+
+    if( pxObject->xQueue != NULL )
+    {
+        xDepth = ( size_t ) uxQueueMessagesWaitingFromISR( pxObject->xQueue );
+    }
+    else
+    {
+        xDepth = xStreamBufferBytesAvailable( pxObject->xStreamBuffer );
+    }
+
+    return xDepth;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,129 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Occupancy timelines for queues, stream buffers and message buffers.
+ *
+ * uxQueueMessagesWaiting() and friends say how full an object is at the
+ * moment they are called, which says little about how long the object needs
+ * to be.  Objects added to the depth sampler have their depth sampled every
+ * depthSAMPLE_PERIOD_TICKS ticks from the tick hook, and the sampler keeps for
+ * each:
+ *
+ * - The high water mark - the most items (queues) or bytes (stream and message
+ *   buffers) seen at once.
+ * - The mean depth, and the number of ticks spent full and spent empty.
+ * - A timeline of the deepest sample in each run of depthTIMELINE_DECIMATION
+ *   samples.  The last depthTIMELINE_LENGTH entries are kept in a ring, which
+ *   can be saved as a CSV file with one row per entry and one column per
+ *   object.  With the default settings and a 1kHz tick the timeline covers the
+ *   last 10 seconds, in 20 millisecond steps.
+ *
+ * An object that is never seen full and whose high water mark is well below its
+ * length is longer than it needs to be, and one that is often full may be too
+ * short.  Note that a depth that rises and falls between two ticks is not seen,
+ * so the high water mark is a lower bound.
+ *
+ * Message buffers are stream buffers, so are added with
+ * xDepthSamplerAddStreamBuffer().  Their depth includes the length stored with
+ * each message.
+ */
+
+#ifndef DEPTH_SAMPLER_H
+#define DEPTH_SAMPLER_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* The ticks between samples. */
+#ifndef depthSAMPLE_PERIOD_TICKS
+    #define depthSAMPLE_PERIOD_TICKS    ( 1 )
+#endif
+
+/* The most objects that can be added. */
+#ifndef depthMAX_OBJECTS
+    #define depthMAX_OBJECTS    ( 16 )
+#endif
+
+/* The timeline entries kept for each object.  Each entry is two bytes per
+ * object. */
+#ifndef depthTIMELINE_LENGTH
+    #define depthTIMELINE_LENGTH    ( 512 )
+#endif
+
+/* The samples summarised by each timeline entry.  The entry records the
+ * deepest of them, so short peaks are not lost. */
+#ifndef depthTIMELINE_DECIMATION
+    #define depthTIMELINE_DECIMATION    ( 20 )
+#endif
+
+typedef struct xDEPTH_STATS
+{
+    const char * pcName;
+    size_t xLength;             /* Items the queue, or bytes the buffer, can hold. */
+    size_t xDepth;              /* At the last sample. */
+    size_t xHighWaterMark;      /* The most seen at any sample. */
+    uint32_t ulMeanDepth;       /* In tenths of an item or byte. */
+    uint32_t ulSamples;
+    uint32_t ulTicksFull;
+    uint32_t ulTicksEmpty;
+} DepthStats_t;
+
+/*
+ * Start sampling xQueue or xStreamBuffer.  pcName must remain valid, and the
+ * object must not be deleted while the demo runs.  Returns pdFAIL if
+ * depthMAX_OBJECTS objects have already been added.
+ */
+BaseType_t xDepthSamplerAddQueue( const char * pcName,
+                                  QueueHandle_t xQueue );
+BaseType_t xDepthSamplerAddStreamBuffer( const char * pcName,
+                                         StreamBufferHandle_t xStreamBuffer );
+
+/*
+ * Takes the samples.  Call from vApplicationTickHook().
+ */
+void vDepthSamplerTickHook( void );
+
+/*
+ * Returns the number of objects added, and copies the statistics of the
+ * uxIndex'th into pxStats.  xDepthSamplerGetStats() returns pdFAIL if uxIndex
+ * is out of range.  Both can be called from tasks and interrupts.
+ */
+UBaseType_t uxDepthSamplerGetObjectCount( void );
+BaseType_t xDepthSamplerGetStats( UBaseType_t uxIndex,
+                                  DepthStats_t * pxStats );
+
+/*
+ * Print the statistics of every object, with a suggested length for those
+ * that were never full, and write the timeline to pcFileName.  Both make
+ * Windows system calls, so must be called from a critical section.
+ * xDepthSamplerSaveTimeline() returns pdFAIL if the file could not be created.
+ */
+void vDepthSamplerPrint( void );
+BaseType_t xDepthSamplerSaveTimeline( const char * pcFileName );
+
+#endif /* DEPTH_SAMPLER_H */
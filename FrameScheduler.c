@@ -0,0 +1,388 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of FrameScheduler.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "FrameScheduler.h"
+
+/* The phases are balanced over the least common multiple of the periods (the
+ * hyperperiod), up to this many frames.  Beyond that the balance is
+ * approximate. */
+#define frameschedMAX_HYPERPERIOD          ( 240 )
+
+typedef struct xFRAME_RUNNABLE
+{
+    const char * pcName;
+    FrameRunnableFunction_t pxRunnable;
+    void * pvParameter;
+    UBaseType_t uxPeriodFrames;
+    UBaseType_t uxPhase;
+    uint32_t ulRuns;
+    configRUN_TIME_COUNTER_TYPE xTotalTime;
+    configRUN_TIME_COUNTER_TYPE xMaxTime;
+} FrameRunnable_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The dispatcher task.
+ */
+static void prvDispatcherTask( void * pvParameters );
+
+/*
+ * Sort the runnables into dispatch order, highest rate first, then give each
+ * one a phase.
+ */
+static void prvAssignPhases( void );
+
+/*
+ * Return the number of frames from ulFrame to the next frame in which at least
+ * one runnable is due, or 1 if there are no runnables.
+ */
+static uint32_t prvFramesToNextDue( uint32_t ulFrame );
+
+/*
+ * Greatest common divisor, used to find the hyperperiod.
+ */
+static UBaseType_t prvGCD( UBaseType_t uxA,
+                           UBaseType_t uxB );
+
+/*-----------------------------------------------------------*/
+
+/* The registered runnables, in dispatch order once the scheduler has
+ * started. */
+static FrameRunnable_t xRunnables[ frameschedMAX_RUNNABLES ];
+static UBaseType_t uxRunnableCount = 0;
+
+/* The base frame, and whether the dispatcher has been created. */
+static TickType_t xFrameTicks = 0;
+static BaseType_t xStarted = pdFALSE;
+
+/* Frame statistics. */
+static volatile uint32_t ulFrames = 0;
+static volatile uint32_t ulOverruns = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerRegister( const char * pcName,
+                                    FrameRunnableFunction_t pxRunnable,
+                                    void * pvParameter,
+                                    UBaseType_t uxPeriodFrames )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    /* The phases are assigned when the scheduler starts. */
+    configASSERT( xStarted == pdFALSE );
+    configASSERT( pxRunnable );
+    configASSERT( uxPeriodFrames > 0 );
+
+    if( uxRunnableCount < frameschedMAX_RUNNABLES )
+    {
+        xRunnables[ uxRunnableCount ].pcName = pcName;
+        xRunnables[ uxRunnableCount ].pxRunnable = pxRunnable;
+        xRunnables[ uxRunnableCount ].pvParameter = pvParameter;
+        xRunnables[ uxRunnableCount ].uxPeriodFrames = uxPeriodFrames;
+        xRunnables[ uxRunnableCount ].uxPhase = 0;
+        xRunnables[ uxRunnableCount ].ulRuns = 0;
+        xRunnables[ uxRunnableCount ].xTotalTime = 0;
+        xRunnables[ uxRunnableCount ].xMaxTime = 0;
+        uxRunnableCount++;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerStart( TickType_t xFramePeriod,
+                                 UBaseType_t uxPriority )
+{
+    BaseType_t xReturn;
+
+    configASSERT( xStarted == pdFALSE );
+    configASSERT( xFramePeriod > 0 );
+
+    xFrameTicks = xFramePeriod;
+    prvAssignPhases();
+
+    xReturn = xTaskCreate( prvDispatcherTask, "Frame", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+
+    if( xReturn == pdPASS )
+    {
+        xStarted = pdTRUE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulFrameSchedulerGetFrameCount( void )
+{
+    return ulFrames;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulFrameSchedulerGetOverrunCount( void )
+{
+    return ulOverruns;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerGetRunnableStats( UBaseType_t uxIndex,
+                                            FrameRunnableStats_t * pxStats )
+{
+    FrameRunnable_t * pxRunnable;
+    BaseType_t xReturn = pdFAIL;
+
+    if( uxIndex < uxRunnableCount )
+    {
+        pxRunnable = &( xRunnables[ uxIndex ] );
+
+        taskENTER_CRITICAL();
+        {
+            pxStats->pcName = pxRunnable->pcName;
+            pxStats->uxPeriodFrames = pxRunnable->uxPeriodFrames;
+            pxStats->uxPhase = pxRunnable->uxPhase;
+            pxStats->ulRuns = pxRunnable->ulRuns;
+            pxStats->ulMaxTimeUs = ( uint32_t ) ( pxRunnable->xMaxTime * configUS_PER_RUN_TIME_COUNT );
+            pxStats->ulMeanTimeUs = 0;
+
+            if( pxRunnable->ulRuns != 0 )
+            {
+                pxStats->ulMeanTimeUs = ( uint32_t ) ( ( pxRunnable->xTotalTime * configUS_PER_RUN_TIME_COUNT ) / pxRunnable->ulRuns );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vFrameSchedulerPrint( void )
+{
+    FrameRunnableStats_t xStats;
+    UBaseType_t uxIndex;
+
+    printf( "\r\n%lu frames of %lu ticks dispatched, %lu overrun(s)\r\n", ( unsigned long ) ulFrames, ( unsigned long ) xFrameTicks, ( unsigned long ) ulOverruns );
+    printf( "%-16s %8s %8s %10s %10s %10s\r\n", "Runnable", "Period", "Phase", "Runs", "Mean(us)", "Max(us)" );
+
+    for( uxIndex = 0; xFrameSchedulerGetRunnableStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        printf( "%-16s %8lu %8lu %10lu %10lu %10lu\r\n",
+                xStats.pcName,
+                ( unsigned long ) xStats.uxPeriodFrames,
+                ( unsigned long ) xStats.uxPhase,
+                ( unsigned long ) xStats.ulRuns,
+                ( unsigned long ) xStats.ulMeanTimeUs,
+                ( unsigned long ) xStats.ulMaxTimeUs );
+    }
+
+    printf( "\r\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDispatcherTask( void * pvParameters )
+{
+    TickType_t xFrameStart;
+    UBaseType_t uxIndex;
+    uint32_t ulFrame = 0, ulFramesToWait;
+    FrameRunnable_t * pxRunnable;
+    configRUN_TIME_COUNTER_TYPE xStart, xElapsed;
+
+    /* Prevent the compiler warning about the unused parameter. */
+    ( void ) pvParameters;
+
+    xFrameStart = xTaskGetTickCount();
+
+    for( ; ; )
+    {
+        /* Frames are numbered from 1, so a runnable first runs one full period
+         * after the scheduler starts, as it would if it were a task that called
+         * xTaskDelayUntil() before doing its work.  Frames in which nothing is
+         * due are skipped, so the dispatcher only wakes when it has work to
+         * do.  xTaskDelayUntil() returns pdFALSE without blocking if the frame
+         * is already due, which means the previous frame overran. */
+        ulFramesToWait = prvFramesToNextDue( ulFrame );
+
+        if( xTaskDelayUntil( &xFrameStart, ( TickType_t ) ( xFrameTicks * ulFramesToWait ) ) == pdFALSE )
+        {
+            ulOverruns++;
+        }
+
+        ulFrame += ulFramesToWait;
+
+        for( uxIndex = 0; uxIndex < uxRunnableCount; uxIndex++ )
+        {
+            pxRunnable = &( xRunnables[ uxIndex ] );
+
+            if( ( ulFrame % pxRunnable->uxPeriodFrames ) == pxRunnable->uxPhase )
+            {
+                xStart = portGET_RUN_TIME_COUNTER_VALUE();
+                pxRunnable->pxRunnable( pxRunnable->pvParameter );
+                xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+                taskENTER_CRITICAL();
+                {
+                    pxRunnable->ulRuns++;
+                    pxRunnable->xTotalTime += xElapsed;
+
+                    if( xElapsed > pxRunnable->xMaxTime )
+                    {
+                        pxRunnable->xMaxTime = xElapsed;
+                    }
+                }
+                taskEXIT_CRITICAL();
+            }
+        }
+
+        ulFrames++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAssignPhases( void )
+{
+    static uint16_t usLoad[ frameschedMAX_HYPERPERIOD ];
+    FrameRunnable_t xTemp;
+    UBaseType_t uxIndex, uxOther, uxPhase, uxFrame, uxHyperperiod = 1;
+    UBaseType_t uxPeak, uxBestPeak, uxBestPhase;
+
+    /* Sort by period, shortest first, so the runnables with the least choice
+     * of phase are placed first, and the highest rate runnables run first in
+     * each frame.  The sort is stable so registration order breaks ties. */
+    for( uxIndex = 1; uxIndex < uxRunnableCount; uxIndex++ )
+    {
+        xTemp = xRunnables[ uxIndex ];
+
+        for( uxOther = uxIndex; ( uxOther > 0 ) && ( xRunnables[ uxOther - 1 ].uxPeriodFrames > xTemp.uxPeriodFrames ); uxOther-- )
+        {
+            xRunnables[ uxOther ] = xRunnables[ uxOther - 1 ];
+        }
+
+        xRunnables[ uxOther ] = xTemp;
+    }
+
+    for( uxIndex = 0; uxIndex < uxRunnableCount; uxIndex++ )
+    {
+        uxHyperperiod = ( uxHyperperiod / prvGCD( uxHyperperiod, xRunnables[ uxIndex ].uxPeriodFrames ) ) * xRunnables[ uxIndex ].uxPeriodFrames;
+
+        if( uxHyperperiod > frameschedMAX_HYPERPERIOD )
+        {
+            uxHyperperiod = frameschedMAX_HYPERPERIOD;
+        }
+    }
+
+    for( uxFrame = 0; uxFrame < uxHyperperiod; uxFrame++ )
+    {
+        usLoad[ uxFrame ] = 0;
+    }
+
+    /* Give each runnable the phase that minimises the most runnables that run
+     * in any one frame, counting those already placed, then account for it. */
+    for( uxIndex = 0; uxIndex < uxRunnableCount; uxIndex++ )
+    {
+        uxBestPeak = ~( ( UBaseType_t ) 0 );
+        uxBestPhase = 0;
+
+        for( uxPhase = 0; ( uxPhase < xRunnables[ uxIndex ].uxPeriodFrames ) && ( uxPhase < uxHyperperiod ); uxPhase++ )
+        {
+            uxPeak = 0;
+
+            for( uxFrame = uxPhase; uxFrame < uxHyperperiod; uxFrame += xRunnables[ uxIndex ].uxPeriodFrames )
+            {
+                if( usLoad[ uxFrame ] > uxPeak )
+                {
+                    uxPeak = usLoad[ uxFrame ];
+                }
+            }
+
+            if( uxPeak < uxBestPeak )
+            {
+                uxBestPeak = uxPeak;
+                uxBestPhase = uxPhase;
+            }
+        }
+
+        xRunnables[ uxIndex ].uxPhase = uxBestPhase;
+
+        for( uxFrame = uxBestPhase; uxFrame < uxHyperperiod; uxFrame += xRunnables[ uxIndex ].uxPeriodFrames )
+        {
+            usLoad[ uxFrame ]++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvFramesToNextDue( uint32_t ulFrame )
+{
+    UBaseType_t uxIndex;
+    uint32_t ulPeriod, ulFrames, ulFewestFrames = 1UL;
+
+    for( uxIndex = 0; uxIndex < uxRunnableCount; uxIndex++ )
+    {
+        /* The runnable is next due in the first frame after ulFrame whose
+         * number, modulo the period, equals the phase. */
+        ulPeriod = ( uint32_t ) xRunnables[ uxIndex ].uxPeriodFrames;
+        ulFrames = ( ( ( uint32_t ) xRunnables[ uxIndex ].uxPhase + ulPeriod - ( ( ulFrame + 1UL ) % ulPeriod ) ) % ulPeriod ) + 1UL;
+
+        if( ( uxIndex == 0 ) || ( ulFrames < ulFewestFrames ) )
+        {
+            ulFewestFrames = ulFrames;
+        }
+    }
+
+    return ulFewestFrames;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGCD( UBaseType_t uxA,
+                           UBaseType_t uxB )
+{
+    UBaseType_t uxRemainder;
+
+    while( uxB != 0 )
+    {
+        uxRemainder = uxA % uxB;
+        uxA = uxB;
+        uxB = uxRemainder;
+    }
+
+    return uxA;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,108 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A multi-rate frame scheduler (cyclic executive).
+ *
+ * Periodic tasks that each call vTaskDelayUntil() with their own period wake
+ * on separate ticks and drift relative to each other.  Instead, periodic work
+ * can be registered as runnables - functions that run to completion - each
+ * with a period that is a whole number of base frames.  One dispatcher task
+ * calls the runnables that are due in each frame, highest rate first.  It uses
+ * xTaskDelayUntil() to sleep straight to the next frame in which a runnable is
+ * due, so frames with nothing to do cost no wake up.
+ *
+ * When the scheduler is started each runnable is given a phase (the frame
+ * within its period in which it runs) chosen so the runnables are spread as
+ * evenly as possible across the frames, rather than all running in frame 0.
+ *
+ * The time each runnable takes is measured with the run time stats counter,
+ * and a frame in which the runnables did not finish before the next frame was
+ * due is counted as an overrun.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The most runnables that can be registered. */
+#ifndef frameschedMAX_RUNNABLES
+    #define frameschedMAX_RUNNABLES    ( 16 )
+#endif
+
+typedef void (* FrameRunnableFunction_t)( void * pvParameter );
+
+typedef struct xFRAME_RUNNABLE_STATS
+{
+    const char * pcName;
+    UBaseType_t uxPeriodFrames;     /* The runnable runs once every uxPeriodFrames frames... */
+    UBaseType_t uxPhase;            /* ...in the frames where the frame number modulo the period equals uxPhase. */
+    uint32_t ulRuns;
+    uint32_t ulMeanTimeUs;
+    uint32_t ulMaxTimeUs;
+} FrameRunnableStats_t;
+
+/*
+ * Register a runnable that is called with pvParameter once every
+ * uxPeriodFrames frames.  Must be called before xFrameSchedulerStart().
+ * Returns pdFAIL if frameschedMAX_RUNNABLES runnables are already registered.
+ */
+BaseType_t xFrameSchedulerRegister( const char * pcName,
+                                    FrameRunnableFunction_t pxRunnable,
+                                    void * pvParameter,
+                                    UBaseType_t uxPeriodFrames );
+
+/*
+ * Assign each runnable its phase and create the dispatcher task, which will
+ * run at uxPriority with a base frame of xFramePeriod ticks.  Returns pdFAIL
+ * if the task could not be created.
+ */
+BaseType_t xFrameSchedulerStart( TickType_t xFramePeriod,
+                                 UBaseType_t uxPriority );
+
+/*
+ * Return the number of frames dispatched - those in which at least one
+ * runnable was due - and the number of those frames that overran.
+ */
+uint32_t ulFrameSchedulerGetFrameCount( void );
+uint32_t ulFrameSchedulerGetOverrunCount( void );
+
+/*
+ * Copy the statistics of the uxIndex'th registered runnable into pxStats.
+ * Returns pdFAIL if there is no such runnable.
+ */
+BaseType_t xFrameSchedulerGetRunnableStats( UBaseType_t uxIndex,
+                                            FrameRunnableStats_t * pxStats );
+
+/*
+ * Print the frame and runnable statistics.  Makes Windows system calls, so
+ * must be called from a critical section.
+ */
+void vFrameSchedulerPrint( void );
+
+#endif /* FRAME_SCHEDULER_H */
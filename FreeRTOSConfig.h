@@ -47,6 +47,7 @@
 #define configTICK_RATE_HZ						( 1000 ) /* In this non-real time simulated environment the tick frequency has to be at least a multiple of the Win32 tick frequency, and therefore very slow. */
 #define configMINIMAL_STACK_SIZE				( ( unsigned short ) 70 ) /* In this simulated case, the stack only has to hold one small structure as the real stack is part of the win32 thread. */
 #define configTOTAL_HEAP_SIZE					( ( size_t ) ( 490 * 1024 ) ) /* This demo tests heap_5 so places multiple blocks within this total heap size.  See mainREGION_1_SIZE to mainREGION_3_SIZE definitions in main.c. */
+#define configUSE_LARGE_PAGES					0 /* Set to 1 to back the heap and the trace recorder buffer with large pages, see Large-page-utils.c. */
 #define configMAX_TASK_NAME_LEN					( 12 )
 #define configUSE_TRACE_FACILITY				1
 #define configIDLE_SHOULD_YIELD					1
@@ -64,6 +65,11 @@
 #define configSUPPORT_STATIC_ALLOCATION			1
 #define configINITIAL_TICK_COUNT				( ( TickType_t ) 0 ) /* For test. */
 #define configSTREAM_BUFFER_TRIGGER_LEVEL_TEST_MARGIN 1 /* As there are a lot of tasks running. */
+#define configUSE_BLOCKED_TIME_STATS			1 /* Set to 1 to attribute the time tasks spend blocked to the objects they block on, see BlockedTime.h. */
+#define configUSE_WAKEUP_STATS					1 /* Set to 1 to count why tasks wake up, and the wake ups that do no work, see WakeupStats.h. */
+#define configUSE_CONTEXT_SWITCH_STATS			1 /* Set to 1 to count why each task is switched out, see ContextSwitch.h. */
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS	3 /* Used by BlockedTime.c, WakeupStats.c and ContextSwitch.c. */
+#define configUSE_ARENAS						1 /* Set to 1 to delete the arenas a task owns when the task is deleted, see Arena.h. */
 
  /* Tick type width is defined based on the target platform(32bit or 64bit). */
 #ifdef _M_X64
@@ -88,6 +94,11 @@ void vConfigureTimerForRunTimeStats( void );	/* Prototype of function that initi
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
 
+/* The run time counter counts in 1/100ths of a millisecond, see
+Run-time-stats-utils.c.  Use this rather than the literal when converting
+counter values to or from real time. */
+#define configUS_PER_RUN_TIME_COUNT				( 10ULL )
+
 /* Co-routine related configuration options. */
 #define configUSE_CO_ROUTINES 					1
 #define configMAX_CO_ROUTINE_PRIORITIES			( 2 )
@@ -142,4 +153,167 @@ extern void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
 /* Include the FreeRTOS+Trace FreeRTOS trace macro definitions. */
 #include "trcRecorder.h"
 
+/* FreeRTOS+Trace does not use the traceENTER_ and traceRETURN_ macros, so they
+ * are free for the demo's own use.  BlockedTime.c and WakeupStats.c keep the
+ * state of each call in variables declared by traceENTER_, which is the first
+ * statement of each API function.  ContextSwitch.c uses the delay calls to
+ * tell delays from other blocking. */
+/* Expanded inside vTaskSwitchContext(), where it is non-zero if the task being
+ * switched out is still in its ready list - it was preempted or yielded, rather
+ * than blocked, suspended or deleted. */
+#define switchCURRENT_TASK_READY()    ( listLIST_ITEM_CONTAINER( &( pxCurrentTCB->xStateListItem ) ) == &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) )
+
+#if ( ( configUSE_BLOCKED_TIME_STATS == 1 ) || ( configUSE_WAKEUP_STATS == 1 ) )
+    #define blockedOBJECT_QUEUE            ( 0UL ) /* Resolved to one of the next two from the queue type. */
+    #define blockedOBJECT_SEMAPHORE        ( 1UL )
+    #define blockedOBJECT_MUTEX            ( 2UL )
+    #define blockedOBJECT_EVENT_GROUP      ( 3UL )
+    #define blockedOBJECT_STREAM_BUFFER    ( 4UL )
+    #define blockedOBJECT_NOTIFICATION     ( 5UL ) /* The object is the notification index. */
+    #define blockedOBJECT_DELAY            ( 6UL )
+#endif
+
+#if ( configUSE_BLOCKED_TIME_STATS == 1 )
+    typedef struct xBLOCKED_TIME_CALL
+    {
+        void * pvRecord;    /* NULL if the call is not accounted. */
+        int iInversion;     /* Non-zero if a lower priority task held the mutex. */
+    } BlockedTimeCall_t;
+
+    void vBlockedTimeEnter( BlockedTimeCall_t * pxCall,
+                            uint32_t ulObjectType,
+                            const void * pvObject,
+                            int iMayBlock );
+    void vBlockedTimeReturn( BlockedTimeCall_t * pxCall );
+    void vBlockedTimeSwitchContextEnter( int iStillReady );
+    void vBlockedTimeTaskDeleted( void * pvTask );
+
+    #define blockedENTER( ulObjectType, pvObject, xTicksToWait ) \
+        BlockedTimeCall_t xBlockedTimeCall;                      \
+        vBlockedTimeEnter( &xBlockedTimeCall, ( ulObjectType ), ( const void * ) ( pvObject ), ( ( xTicksToWait ) != 0 ) )
+    #define blockedRETURN()    vBlockedTimeReturn( &xBlockedTimeCall )
+
+    /* FreeRTOS+Trace defines the traceBLOCKING_ON_ macros, so the kernel's
+     * decision to block a task is seen instead when vTaskSwitchContext()
+     * switches out a task that is no longer in its ready list. */
+    #define blockedSWITCH_ENTER()           vBlockedTimeSwitchContextEnter( switchCURRENT_TASK_READY() )
+    #define blockedTASK_DELETED( xTask )    vBlockedTimeTaskDeleted( ( void * ) ( xTask ) )
+#else
+    #define blockedENTER( ulObjectType, pvObject, xTicksToWait )
+    #define blockedRETURN()
+    #define blockedSWITCH_ENTER()
+    #define blockedTASK_DELETED( xTask )
+#endif /* configUSE_BLOCKED_TIME_STATS */
+
+#if ( configUSE_WAKEUP_STATS == 1 )
+    int iWakeupStatsEnter( uint32_t ulObjectType,
+                           const void * pvObject,
+                           int iMayBlock );
+    void vWakeupStatsReturn( int iCall,
+                             int iSucceeded );
+    void vWakeupStatsSwitchContextEnter( int iStillReady );
+    void vWakeupStatsSwitchContextReturn( void );
+    void vWakeupStatsTaskDeleted( void * pvTask );
+
+    /* wakeupENTER() declares a variable, so comes before blockedENTER(). */
+    #define wakeupENTER( ulObjectType, pvObject, xTicksToWait ) \
+        int iWakeupStatsCall = iWakeupStatsEnter( ( ulObjectType ), ( const void * ) ( pvObject ), ( ( xTicksToWait ) != 0 ) )
+    #define wakeupRETURN( xSucceeded )    vWakeupStatsReturn( iWakeupStatsCall, ( ( xSucceeded ) != 0 ) )
+
+    #define wakeupSWITCH_ENTER()           vWakeupStatsSwitchContextEnter( switchCURRENT_TASK_READY() )
+    #define wakeupSWITCH_RETURN()          vWakeupStatsSwitchContextReturn()
+    #define wakeupTASK_DELETED( xTask )    vWakeupStatsTaskDeleted( ( void * ) ( xTask ) )
+#else
+    #define wakeupENTER( ulObjectType, pvObject, xTicksToWait )
+    #define wakeupRETURN( xSucceeded )
+    #define wakeupSWITCH_ENTER()
+    #define wakeupSWITCH_RETURN()
+    #define wakeupTASK_DELETED( xTask )
+#endif /* configUSE_WAKEUP_STATS */
+
+/* The macros called by vTaskSwitchContext() and prvAddTaskToReadyList() are
+ * expanded inside tasks.c, so can pass ContextSwitch.c the state of the task
+ * control blocks. */
+#if ( configUSE_CONTEXT_SWITCH_STATS == 1 )
+    void vContextSwitchEnter( int iStillReady,
+                              int iDeleted,
+                              uint32_t ulPriority );
+    void vContextSwitchReturn( uint32_t ulPriority );
+    void vContextSwitchTaskReady( void * pvTask );
+    void vContextSwitchTick( int iSwitchRequired );
+    void vContextSwitchDelay( int iDelaying );
+    void vContextSwitchSuspend( void * pvTask );
+    void vContextSwitchTaskDeleted( void * pvTask );
+
+    #define ctxswitchSWITCH_ENTER()                                                                                                              \
+        vContextSwitchEnter( switchCURRENT_TASK_READY(),                                                                                         \
+                             listLIST_ITEM_CONTAINER( &( pxCurrentTCB->xStateListItem ) ) == &xTasksWaitingTermination,                          \
+                             ( uint32_t ) pxCurrentTCB->uxPriority )
+    #define ctxswitchSWITCH_RETURN()                           vContextSwitchReturn( ( uint32_t ) pxCurrentTCB->uxPriority )
+    #define ctxswitchDELAY( iDelaying )                        vContextSwitchDelay( iDelaying )
+    #define ctxswitchTASK_DELETED( xTask )                     vContextSwitchTaskDeleted( ( void * ) ( xTask ) )
+
+    #define tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )       vContextSwitchTaskReady( ( void * ) ( pxTCB ) )
+    #define traceRETURN_xTaskIncrementTick( xSwitchRequired )  vContextSwitchTick( ( xSwitchRequired ) != pdFALSE )
+    #define traceENTER_vTaskSuspend( xTaskToSuspend )          vContextSwitchSuspend( ( void * ) ( xTaskToSuspend ) )
+#else
+    #define ctxswitchSWITCH_ENTER()
+    #define ctxswitchSWITCH_RETURN()
+    #define ctxswitchDELAY( iDelaying )
+    #define ctxswitchTASK_DELETED( xTask )
+#endif /* configUSE_CONTEXT_SWITCH_STATS */
+
+#if ( ( configUSE_BLOCKED_TIME_STATS == 1 ) || ( configUSE_WAKEUP_STATS == 1 ) || ( configUSE_CONTEXT_SWITCH_STATS == 1 ) )
+    #define traceENTER_vTaskSwitchContext()     blockedSWITCH_ENTER(); wakeupSWITCH_ENTER(); ctxswitchSWITCH_ENTER()
+    #define traceRETURN_vTaskSwitchContext()    wakeupSWITCH_RETURN(); ctxswitchSWITCH_RETURN()
+#endif
+
+/* The return value of each call says whether it succeeded or timed out.  The
+ * event group calls return the bits whether or not they timed out, so the bits
+ * are compared with the parameters the calls were made with. */
+#if ( ( configUSE_BLOCKED_TIME_STATS == 1 ) || ( configUSE_WAKEUP_STATS == 1 ) || ( configUSE_CONTEXT_SWITCH_STATS == 1 ) )
+    #define traceENTER_xQueueReceive( xQueue, pvBuffer, xTicksToWait )                                                           wakeupENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait ); blockedENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait )
+    #define traceRETURN_xQueueReceive( xReturn )                                                                                 blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_xQueuePeek( xQueue, pvBuffer, xTicksToWait )                                                              wakeupENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait ); blockedENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait )
+    #define traceRETURN_xQueuePeek( xReturn )                                                                                    blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_xQueueSemaphoreTake( xQueue, xTicksToWait )                                                               wakeupENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait ); blockedENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait )
+    #define traceRETURN_xQueueSemaphoreTake( xReturn )                                                                           blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_xQueueGenericSend( xQueue, pvItemToQueue, xTicksToWait, xCopyPosition )                                   wakeupENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait ); blockedENTER( blockedOBJECT_QUEUE, xQueue, xTicksToWait )
+    #define traceRETURN_xQueueGenericSend( xReturn )                                                                             blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_xEventGroupWaitBits( xEventGroup, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, xTicksToWait ) \
+        wakeupENTER( blockedOBJECT_EVENT_GROUP, xEventGroup, xTicksToWait ); blockedENTER( blockedOBJECT_EVENT_GROUP, xEventGroup, xTicksToWait )
+    #define traceRETURN_xEventGroupWaitBits( uxReturn ) \
+        blockedRETURN(); wakeupRETURN( ( xWaitForAllBits != pdFALSE ) ? ( ( ( uxReturn ) & uxBitsToWaitFor ) == uxBitsToWaitFor ) : ( ( ( uxReturn ) & uxBitsToWaitFor ) != 0 ) )
+    #define traceENTER_xEventGroupSync( xEventGroup, uxBitsToSet, uxBitsToWaitFor, xTicksToWait )                                wakeupENTER( blockedOBJECT_EVENT_GROUP, xEventGroup, xTicksToWait ); blockedENTER( blockedOBJECT_EVENT_GROUP, xEventGroup, xTicksToWait )
+    #define traceRETURN_xEventGroupSync( uxReturn )                                                                              blockedRETURN(); wakeupRETURN( ( ( uxReturn ) & uxBitsToWaitFor ) == uxBitsToWaitFor )
+    #define traceENTER_xStreamBufferSend( xStreamBuffer, pvTxData, xDataLengthBytes, xTicksToWait )                              wakeupENTER( blockedOBJECT_STREAM_BUFFER, xStreamBuffer, xTicksToWait ); blockedENTER( blockedOBJECT_STREAM_BUFFER, xStreamBuffer, xTicksToWait )
+    #define traceRETURN_xStreamBufferSend( xReturn )                                                                             blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_xStreamBufferReceive( xStreamBuffer, pvRxData, xBufferLengthBytes, xTicksToWait )                         wakeupENTER( blockedOBJECT_STREAM_BUFFER, xStreamBuffer, xTicksToWait ); blockedENTER( blockedOBJECT_STREAM_BUFFER, xStreamBuffer, xTicksToWait )
+    #define traceRETURN_xStreamBufferReceive( xReceivedLength )                                                                  blockedRETURN(); wakeupRETURN( xReceivedLength )
+    #define traceENTER_xTaskGenericNotifyWait( uxIndexToWaitOn, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) \
+        wakeupENTER( blockedOBJECT_NOTIFICATION, ( uintptr_t ) ( uxIndexToWaitOn ), xTicksToWait ); blockedENTER( blockedOBJECT_NOTIFICATION, ( uintptr_t ) ( uxIndexToWaitOn ), xTicksToWait )
+    #define traceRETURN_xTaskGenericNotifyWait( xReturn )                                                                        blockedRETURN(); wakeupRETURN( xReturn )
+    #define traceENTER_ulTaskGenericNotifyTake( uxIndexToWaitOn, xClearCountOnExit, xTicksToWait ) \
+        wakeupENTER( blockedOBJECT_NOTIFICATION, ( uintptr_t ) ( uxIndexToWaitOn ), xTicksToWait ); blockedENTER( blockedOBJECT_NOTIFICATION, ( uintptr_t ) ( uxIndexToWaitOn ), xTicksToWait )
+    #define traceRETURN_ulTaskGenericNotifyTake( ulReturn )                                                                      blockedRETURN(); wakeupRETURN( ulReturn )
+    #define traceENTER_vTaskDelay( xTicksToDelay ) \
+        wakeupENTER( blockedOBJECT_DELAY, NULL, xTicksToDelay ); blockedENTER( blockedOBJECT_DELAY, NULL, xTicksToDelay ); ctxswitchDELAY( 1 )
+    #define traceRETURN_vTaskDelay()                                                                                             blockedRETURN(); wakeupRETURN( 0 ); ctxswitchDELAY( 0 )
+    #define traceENTER_xTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement ) \
+        wakeupENTER( blockedOBJECT_DELAY, NULL, xTimeIncrement ); blockedENTER( blockedOBJECT_DELAY, NULL, xTimeIncrement ); ctxswitchDELAY( 1 )
+    #define traceRETURN_xTaskDelayUntil( xShouldDelay )                                                                          blockedRETURN(); wakeupRETURN( 0 ); ctxswitchDELAY( 0 )
+#endif /* configUSE_BLOCKED_TIME_STATS || configUSE_WAKEUP_STATS || configUSE_CONTEXT_SWITCH_STATS */
+
+#if ( configUSE_ARENAS == 1 )
+    void vArenaTaskDeleted( void * pvTask );
+    #define arenaTASK_DELETED( xTask )    vArenaTaskDeleted( ( void * ) ( xTask ) )
+#else
+    #define arenaTASK_DELETED( xTask )
+#endif /* configUSE_ARENAS */
+
+#if ( ( configUSE_ARENAS == 1 ) || ( configUSE_BLOCKED_TIME_STATS == 1 ) || ( configUSE_WAKEUP_STATS == 1 ) || ( configUSE_CONTEXT_SWITCH_STATS == 1 ) )
+    #define traceENTER_vTaskDelete( xTaskToDelete ) \
+        arenaTASK_DELETED( xTaskToDelete ); blockedTASK_DELETED( xTaskToDelete ); wakeupTASK_DELETED( xTaskToDelete ); ctxswitchTASK_DELETED( xTaskToDelete )
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
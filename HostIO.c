@@ -0,0 +1,621 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of HostIO.h.
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "HostIO.h"
+
+#define hostioQUEUE_MASK    ( hostioQUEUE_LENGTH - 1U )
+#define hostioLOG_MASK      ( hostioLOG_BUFFER_SIZE - 1U )
+
+/* The operations a request can hold. */
+#define hostioOPEN          ( 0 )
+#define hostioCLOSE         ( 1 )
+#define hostioWRITE         ( 2 )
+#define hostioREAD          ( 3 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Queue a request for the Windows thread.  Returns pdFAIL if too many requests
+ * are outstanding.
+ */
+static BaseType_t prvSubmit( HostIORequest_t * pxRequest );
+
+/*
+ * As prvSubmit(), but wait for the request to complete.
+ */
+static int32_t prvSubmitAndWait( HostIORequest_t * pxRequest );
+
+/*
+ * The Windows thread, and the functions it uses to carry out requests and
+ * write the log buffer to the console.
+ */
+static DWORD WINAPI prvHostIOThread( void * pvParam );
+static void prvProcessRequests( void );
+static UBaseType_t prvWriteBatch( UBaseType_t uxFirst,
+                                  UBaseType_t uxAvailable );
+static void prvComplete( HostIORequest_t * pxRequest,
+                         int32_t lResult );
+static void prvDrainLog( void );
+
+/*
+ * The simulated interrupt generated by the Windows thread when requests have
+ * completed.
+ */
+static uint32_t prvCompletionInterruptHandler( void );
+
+/*-----------------------------------------------------------*/
+
+/* The requests waiting for the Windows thread.  Written by the tasks, read by
+ * the Windows thread. */
+static HostIORequest_t * volatile pxRequestQueue[ hostioQUEUE_LENGTH ];
+static volatile UBaseType_t uxRequestHead = 0;
+static volatile UBaseType_t uxRequestTail = 0;
+
+/* The completed requests.  Written by the Windows thread, read by the
+ * completion interrupt. */
+static HostIORequest_t * volatile pxCompletedQueue[ hostioQUEUE_LENGTH ];
+static volatile UBaseType_t uxCompletedHead = 0;
+static volatile UBaseType_t uxCompletedTail = 0;
+
+/* Requests that have been submitted but not yet signalled as complete.  Never
+ * more than hostioQUEUE_LENGTH, so neither queue can overflow. */
+static UBaseType_t uxInFlight = 0;
+
+/* Console output waiting to be written. */
+static char cLogBuffer[ hostioLOG_BUFFER_SIZE ];
+static volatile UBaseType_t uxLogHead = 0;
+static volatile UBaseType_t uxLogTail = 0;
+
+/* Consecutive writes are copied into here. */
+static uint8_t ucBatchBuffer[ hostioBATCH_SIZE ];
+
+/* Set when there is work for the Windows thread. */
+static HANDLE xWorkEvent = NULL;
+static HANDLE xStdOut = NULL;
+
+static volatile HostIOStats_t xStats = { 0 };
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xHostIOStart( void )
+{
+    HANDLE xThread;
+    BaseType_t xReturn = pdFAIL;
+
+    xStdOut = GetStdHandle( STD_OUTPUT_HANDLE );
+    xWorkEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+    if( xWorkEvent != NULL )
+    {
+        vPortSetInterruptHandler( hostioINTERRUPT_NUMBER, prvCompletionInterruptHandler );
+
+        xThread = CreateThread( NULL, 0, prvHostIOThread, NULL, 0, NULL );
+
+        if( xThread != NULL )
+        {
+            /* Use the cores that are not used by the FreeRTOS tasks, as the
+             * keyboard thread in main.c does. */
+            SetThreadAffinityMask( xThread, ~0x01u );
+            xReturn = pdPASS;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xHostIOOpen( HostIOFile_t * pxFile,
+                        const char * pcFileName,
+                        BaseType_t xAppend )
+{
+    HostIORequest_t xRequest;
+    BaseType_t xReturn = pdFAIL;
+
+    xRequest.ucOperation = hostioOPEN;
+    xRequest.pvBuffer = ( void * ) pcFileName;
+    xRequest.xLength = ( size_t ) xAppend;
+
+    if( prvSubmitAndWait( &xRequest ) == 0 )
+    {
+        *pxFile = xRequest.xFile;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vHostIOClose( HostIOFile_t xFile )
+{
+    HostIORequest_t xRequest;
+
+    xRequest.ucOperation = hostioCLOSE;
+    xRequest.xFile = xFile;
+    ( void ) prvSubmitAndWait( &xRequest );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xHostIOWriteAsync( HostIORequest_t * pxRequest,
+                              HostIOFile_t xFile,
+                              const void * pvData,
+                              size_t xLength )
+{
+    pxRequest->ucOperation = hostioWRITE;
+    pxRequest->xFile = xFile;
+    pxRequest->pvBuffer = ( void * ) pvData;
+    pxRequest->xLength = xLength;
+
+    return prvSubmit( pxRequest );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xHostIOReadAsync( HostIORequest_t * pxRequest,
+                             HostIOFile_t xFile,
+                             void * pvBuffer,
+                             size_t xLength )
+{
+    pxRequest->ucOperation = hostioREAD;
+    pxRequest->xFile = xFile;
+    pxRequest->pvBuffer = pvBuffer;
+    pxRequest->xLength = xLength;
+
+    return prvSubmit( pxRequest );
+}
+/*-----------------------------------------------------------*/
+
+int32_t lHostIOWait( HostIORequest_t * pxRequest,
+                     TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+
+    configASSERT( pxRequest->xTaskToNotify == xTaskGetCurrentTaskHandle() );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    /* The notification is shared by all the calling task's requests, so may
+     * be for a different request. */
+    while( pxRequest->xComplete == pdFALSE )
+    {
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            return hostioPENDING;
+        }
+
+        ( void ) ulTaskNotifyTakeIndexed( hostioNOTIFICATION_INDEX, pdTRUE, xTicksToWait );
+    }
+
+    return pxRequest->lResult;
+}
+/*-----------------------------------------------------------*/
+
+int32_t lHostIOWrite( HostIOFile_t xFile,
+                      const void * pvData,
+                      size_t xLength )
+{
+    HostIORequest_t xRequest;
+
+    xRequest.ucOperation = hostioWRITE;
+    xRequest.xFile = xFile;
+    xRequest.pvBuffer = ( void * ) pvData;
+    xRequest.xLength = xLength;
+
+    return prvSubmitAndWait( &xRequest );
+}
+/*-----------------------------------------------------------*/
+
+int32_t lHostIORead( HostIOFile_t xFile,
+                     void * pvBuffer,
+                     size_t xLength )
+{
+    HostIORequest_t xRequest;
+
+    xRequest.ucOperation = hostioREAD;
+    xRequest.xFile = xFile;
+    xRequest.pvBuffer = pvBuffer;
+    xRequest.xLength = xLength;
+
+    return prvSubmitAndWait( &xRequest );
+}
+/*-----------------------------------------------------------*/
+
+void vHostIOPrintf( const char * pcFormat,
+                    ... )
+{
+    char cLine[ hostioMAX_LOG_LINE ];
+    va_list xArgs;
+    int iLength;
+    UBaseType_t uxHead, uxIndex, uxFirstPart;
+
+    taskENTER_CRITICAL();
+    {
+        /* vsnprintf() is part of the C run time library, which can take locks
+         * that a Windows thread outside the simulator holds, so it is called
+         * from the critical section too.  Only the host's console write is
+         * moved to the Windows thread. */
+        va_start( xArgs, pcFormat );
+        iLength = vsnprintf( cLine, sizeof( cLine ), pcFormat, xArgs );
+        va_end( xArgs );
+
+        if( iLength >= ( int ) sizeof( cLine ) )
+        {
+            /* Truncated. */
+            iLength = ( int ) sizeof( cLine ) - 1;
+        }
+
+        if( iLength > 0 )
+        {
+            uxHead = uxLogHead;
+
+            if( ( hostioLOG_BUFFER_SIZE - ( uxHead - uxLogTail ) ) >= ( UBaseType_t ) iLength )
+            {
+                uxIndex = uxHead & hostioLOG_MASK;
+                uxFirstPart = hostioLOG_BUFFER_SIZE - uxIndex;
+
+                if( uxFirstPart > ( UBaseType_t ) iLength )
+                {
+                    uxFirstPart = ( UBaseType_t ) iLength;
+                }
+
+                memcpy( &( cLogBuffer[ uxIndex ] ), cLine, uxFirstPart );
+                memcpy( cLogBuffer, &( cLine[ uxFirstPart ] ), ( size_t ) iLength - uxFirstPart );
+
+                /* The text must be visible to the Windows thread before the new
+                 * head is. */
+                MemoryBarrier();
+                uxLogHead = uxHead + ( UBaseType_t ) iLength;
+
+                SetEvent( xWorkEvent );
+            }
+            else
+            {
+                xStats.ulLogBytesDropped += ( uint32_t ) iLength;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vHostIOGetStats( HostIOStats_t * pxStats )
+{
+    /* Each count is written by only one side, so a torn read is not possible,
+     * but the counts may be from slightly different moments. */
+    pxStats->ulRequests = xStats.ulRequests;
+    pxStats->ulWriteCalls = xStats.ulWriteCalls;
+    pxStats->ulBytesWritten = xStats.ulBytesWritten;
+    pxStats->ulLogBytesWritten = xStats.ulLogBytesWritten;
+    pxStats->ulLogBytesDropped = xStats.ulLogBytesDropped;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSubmit( HostIORequest_t * pxRequest )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    pxRequest->xTaskToNotify = xTaskGetCurrentTaskHandle();
+    pxRequest->lResult = 0;
+    pxRequest->xComplete = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if( uxInFlight < hostioQUEUE_LENGTH )
+        {
+            uxInFlight++;
+            pxRequestQueue[ uxRequestHead & hostioQUEUE_MASK ] = pxRequest;
+
+            /* The request must be visible to the Windows thread before the new
+             * head is. */
+            MemoryBarrier();
+            uxRequestHead++;
+
+            /* Still a system call, but one that does not wait for the host. */
+            SetEvent( xWorkEvent );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static int32_t prvSubmitAndWait( HostIORequest_t * pxRequest )
+{
+    int32_t lResult = -1;
+
+    if( prvSubmit( pxRequest ) == pdPASS )
+    {
+        lResult = lHostIOWait( pxRequest, portMAX_DELAY );
+    }
+
+    return lResult;
+}
+/*-----------------------------------------------------------*/
+
+static DWORD WINAPI prvHostIOThread( void * pvParam )
+{
+    ( void ) pvParam;
+
+    for( ; ; )
+    {
+        /* The event is set after anything is added, so everything added
+         * before it was last set is processed before waiting again. */
+        WaitForSingleObject( xWorkEvent, INFINITE );
+
+        prvDrainLog();
+        prvProcessRequests();
+    }
+
+    /* Should not get here. */
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessRequests( void )
+{
+    HostIORequest_t * pxRequest;
+    UBaseType_t uxTail, uxAvailable, uxProcessed;
+    HANDLE xFile;
+    DWORD ulTransferred;
+    BOOL xSuccess;
+
+    uxTail = uxRequestTail;
+    uxAvailable = uxRequestHead - uxTail;
+
+    if( uxAvailable == 0 )
+    {
+        return;
+    }
+
+    /* Read the requests only after reading the head. */
+    MemoryBarrier();
+
+    while( uxAvailable > 0 )
+    {
+        pxRequest = pxRequestQueue[ uxTail & hostioQUEUE_MASK ];
+        xFile = ( HANDLE ) pxRequest->xFile;
+        uxProcessed = 1;
+
+        switch( pxRequest->ucOperation )
+        {
+            case hostioOPEN:
+                xFile = CreateFileA( ( const char * ) pxRequest->pvBuffer,
+                                     GENERIC_READ | GENERIC_WRITE,
+                                     FILE_SHARE_READ,
+                                     NULL,
+                                     ( pxRequest->xLength != 0 ) ? OPEN_ALWAYS : CREATE_ALWAYS,
+                                     FILE_ATTRIBUTE_NORMAL,
+                                     NULL );
+
+                if( xFile != INVALID_HANDLE_VALUE )
+                {
+                    if( pxRequest->xLength != 0 )
+                    {
+                        SetFilePointer( xFile, 0, NULL, FILE_END );
+                    }
+
+                    pxRequest->xFile = ( HostIOFile_t ) xFile;
+                    prvComplete( pxRequest, 0 );
+                }
+                else
+                {
+                    prvComplete( pxRequest, -1 );
+                }
+
+                break;
+
+            case hostioCLOSE:
+                prvComplete( pxRequest, ( CloseHandle( xFile ) != FALSE ) ? 0 : -1 );
+                break;
+
+            case hostioWRITE:
+                uxProcessed = prvWriteBatch( uxTail, uxAvailable );
+                break;
+
+            case hostioREAD:
+                xSuccess = ReadFile( xFile, pxRequest->pvBuffer, ( DWORD ) pxRequest->xLength, &ulTransferred, NULL );
+                prvComplete( pxRequest, ( xSuccess != FALSE ) ? ( int32_t ) ulTransferred : -1 );
+                break;
+
+            default:
+                prvComplete( pxRequest, -1 );
+                break;
+        }
+
+        uxTail += uxProcessed;
+        uxAvailable -= uxProcessed;
+    }
+
+    /* Finish reading the requests before the tasks can reuse their slots. */
+    MemoryBarrier();
+    uxRequestTail = uxTail;
+
+    vPortGenerateSimulatedInterruptFromWindowsThread( hostioINTERRUPT_NUMBER );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvWriteBatch( UBaseType_t uxFirst,
+                                  UBaseType_t uxAvailable )
+{
+    HostIORequest_t * pxFirst, * pxRequest;
+    UBaseType_t uxCount, uxIndex;
+    size_t xTotal;
+    DWORD ulWritten;
+    BOOL xSuccess;
+
+    pxFirst = pxRequestQueue[ uxFirst & hostioQUEUE_MASK ];
+    xTotal = pxFirst->xLength;
+
+    /* Find the writes that follow the first to the same file and fit in the
+     * batch buffer along with it. */
+    for( uxCount = 1; uxCount < uxAvailable; uxCount++ )
+    {
+        pxRequest = pxRequestQueue[ ( uxFirst + uxCount ) & hostioQUEUE_MASK ];
+
+        if( ( pxRequest->ucOperation != hostioWRITE ) ||
+            ( pxRequest->xFile != pxFirst->xFile ) ||
+            ( ( xTotal + pxRequest->xLength ) > sizeof( ucBatchBuffer ) ) )
+        {
+            break;
+        }
+
+        xTotal += pxRequest->xLength;
+    }
+
+    if( uxCount == 1 )
+    {
+        /* Nothing to coalesce, so write straight from the task's buffer. */
+        xSuccess = WriteFile( ( HANDLE ) pxFirst->xFile, pxFirst->pvBuffer, ( DWORD ) xTotal, &ulWritten, NULL );
+    }
+    else
+    {
+        xTotal = 0;
+
+        for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+        {
+            pxRequest = pxRequestQueue[ ( uxFirst + uxIndex ) & hostioQUEUE_MASK ];
+            memcpy( &( ucBatchBuffer[ xTotal ] ), pxRequest->pvBuffer, pxRequest->xLength );
+            xTotal += pxRequest->xLength;
+        }
+
+        xSuccess = WriteFile( ( HANDLE ) pxFirst->xFile, ucBatchBuffer, ( DWORD ) xTotal, &ulWritten, NULL );
+    }
+
+    xStats.ulWriteCalls++;
+
+    if( xSuccess != FALSE )
+    {
+        xStats.ulBytesWritten += ulWritten;
+    }
+
+    /* Each request is reported as written only if all of its bytes were. */
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        pxRequest = pxRequestQueue[ ( uxFirst + uxIndex ) & hostioQUEUE_MASK ];
+
+        if( ( xSuccess != FALSE ) && ( ulWritten >= pxRequest->xLength ) )
+        {
+            ulWritten -= ( DWORD ) pxRequest->xLength;
+            prvComplete( pxRequest, ( int32_t ) pxRequest->xLength );
+        }
+        else
+        {
+            xSuccess = FALSE;
+            prvComplete( pxRequest, -1 );
+        }
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvComplete( HostIORequest_t * pxRequest,
+                         int32_t lResult )
+{
+    pxRequest->lResult = lResult;
+    pxCompletedQueue[ uxCompletedHead & hostioQUEUE_MASK ] = pxRequest;
+
+    /* The result must be visible to the interrupt before the new head is. */
+    MemoryBarrier();
+    uxCompletedHead++;
+    xStats.ulRequests++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDrainLog( void )
+{
+    UBaseType_t uxHead, uxTail, uxIndex, uxLength;
+    DWORD ulWritten;
+
+    uxHead = uxLogHead;
+    uxTail = uxLogTail;
+
+    /* Read the text only after reading the head. */
+    MemoryBarrier();
+
+    /* All the text is written in at most two calls, one either side of the
+     * end of the buffer. */
+    while( uxTail != uxHead )
+    {
+        uxIndex = uxTail & hostioLOG_MASK;
+        uxLength = uxHead - uxTail;
+
+        if( uxLength > ( hostioLOG_BUFFER_SIZE - uxIndex ) )
+        {
+            uxLength = hostioLOG_BUFFER_SIZE - uxIndex;
+        }
+
+        WriteFile( xStdOut, &( cLogBuffer[ uxIndex ] ), ( DWORD ) uxLength, &ulWritten, NULL );
+        xStats.ulLogBytesWritten += ( uint32_t ) uxLength;
+        uxTail += uxLength;
+    }
+
+    /* Finish reading the text before the tasks can overwrite it. */
+    MemoryBarrier();
+    uxLogTail = uxTail;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvCompletionInterruptHandler( void )
+{
+    HostIORequest_t * pxRequest;
+    TaskHandle_t xTaskToNotify;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    while( uxCompletedTail != uxCompletedHead )
+    {
+        /* Read the request only after reading the head. */
+        MemoryBarrier();
+
+        pxRequest = pxCompletedQueue[ uxCompletedTail & hostioQUEUE_MASK ];
+        uxCompletedTail++;
+        uxInFlight--;
+
+        /* The request may be reused as soon as it is marked complete, so read
+         * the task first. */
+        xTaskToNotify = pxRequest->xTaskToNotify;
+        pxRequest->xComplete = pdTRUE;
+
+        vTaskNotifyGiveIndexedFromISR( xTaskToNotify, hostioNOTIFICATION_INDEX, &xHigherPriorityTaskWoken );
+    }
+
+    return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
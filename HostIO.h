@@ -0,0 +1,192 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Asynchronous host file and console I/O.
+ *
+ * Windows system calls made from a FreeRTOS task can deadlock the Windows
+ * port, so the demo makes them from critical sections, which stops every other
+ * task and interrupt for as long as the host takes to complete the call.
+ * Instead, tasks can pass I/O requests to a Windows thread that runs outside
+ * the simulator:
+ *
+ * - Requests are passed through a ring buffer that the tasks write and the
+ *   Windows thread reads.  Neither side takes a lock the other side holds -
+ *   the tasks only enter a FreeRTOS critical section, which the Windows thread
+ *   does not use.
+ * - Consecutive writes to the same file are copied into one buffer and written
+ *   with a single WriteFile() call.
+ * - When a request completes the Windows thread generates a simulated
+ *   interrupt, and the interrupt handler notifies the task that made the
+ *   request, using the task notification at index hostioNOTIFICATION_INDEX.
+ *
+ * vHostIOPrintf() writes formatted text to the console through the same
+ * thread.  The text is formatted and copied into a log buffer from within a
+ * short critical section of its own, and the call never blocks, so it can be
+ * used in place of printf() without the caller entering a critical section.
+ */
+
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The simulated interrupt used to signal completed requests.  Interrupt 3 is
+ * used by the keyboard in main.c. */
+#ifndef hostioINTERRUPT_NUMBER
+    #define hostioINTERRUPT_NUMBER    ( 4 )
+#endif
+
+/* The task notification used to signal completed requests. */
+#ifndef hostioNOTIFICATION_INDEX
+    #define hostioNOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 2 )
+#endif
+
+/* The most requests that can be outstanding at once.  Must be a power of
+ * two. */
+#ifndef hostioQUEUE_LENGTH
+    #define hostioQUEUE_LENGTH    ( 16 )
+#endif
+
+/* The size of the buffer consecutive writes are coalesced into. */
+#ifndef hostioBATCH_SIZE
+    #define hostioBATCH_SIZE    ( 4096 )
+#endif
+
+/* The size of the console log buffer, which must be a power of two, and the
+ * longest line vHostIOPrintf() can write. */
+#ifndef hostioLOG_BUFFER_SIZE
+    #define hostioLOG_BUFFER_SIZE    ( 8192 )
+#endif
+
+#ifndef hostioMAX_LOG_LINE
+    #define hostioMAX_LOG_LINE    ( 256 )
+#endif
+
+#if ( ( hostioQUEUE_LENGTH & ( hostioQUEUE_LENGTH - 1 ) ) != 0 ) || ( ( hostioLOG_BUFFER_SIZE & ( hostioLOG_BUFFER_SIZE - 1 ) ) != 0 )
+    #error hostioQUEUE_LENGTH and hostioLOG_BUFFER_SIZE must be powers of two
+#endif
+
+/* Returned by lHostIOWait() if the request did not complete in time. */
+#define hostioPENDING    ( -2 )
+
+typedef void * HostIOFile_t;
+
+/*
+ * The structure used to hold a request.  Only visible so requests can be
+ * allocated by the caller - its members must not be accessed directly.  A
+ * request, and the buffer passed with it, must remain valid until
+ * lHostIOWait() returns a result other than hostioPENDING.
+ */
+typedef struct xHOST_IO_REQUEST
+{
+    uint8_t ucOperation;
+    HostIOFile_t xFile;
+    void * pvBuffer;
+    size_t xLength;
+    TaskHandle_t xTaskToNotify;
+    volatile int32_t lResult;
+    volatile BaseType_t xComplete;
+} HostIORequest_t;
+
+typedef struct xHOST_IO_STATS
+{
+    uint32_t ulRequests;            /* Requests completed. */
+    uint32_t ulWriteCalls;          /* WriteFile() calls made for the writes in those requests. */
+    uint32_t ulBytesWritten;
+    uint32_t ulLogBytesWritten;
+    uint32_t ulLogBytesDropped;     /* Console output lost because the log buffer was full. */
+} HostIOStats_t;
+
+/*
+ * Create the Windows thread and install the completion interrupt handler.
+ * Call from main() before the scheduler is started.
+ */
+BaseType_t xHostIOStart( void );
+
+/*
+ * Open a file, truncating it unless xAppend is pdTRUE.  Blocks the calling
+ * task until the file is open.  Returns pdFAIL if the file could not be
+ * opened.
+ */
+BaseType_t xHostIOOpen( HostIOFile_t * pxFile,
+                        const char * pcFileName,
+                        BaseType_t xAppend );
+
+/*
+ * Close a file, blocking the calling task until it is closed.
+ */
+void vHostIOClose( HostIOFile_t xFile );
+
+/*
+ * Start writing xLength bytes from pvData to, or reading up to xLength bytes
+ * from xFile into pvBuffer, at the current file position.  Returns
+ * immediately.  Returns pdFAIL if hostioQUEUE_LENGTH requests are already
+ * outstanding.
+ */
+BaseType_t xHostIOWriteAsync( HostIORequest_t * pxRequest,
+                              HostIOFile_t xFile,
+                              const void * pvData,
+                              size_t xLength );
+BaseType_t xHostIOReadAsync( HostIORequest_t * pxRequest,
+                             HostIOFile_t xFile,
+                             void * pvBuffer,
+                             size_t xLength );
+
+/*
+ * Wait up to xTicksToWait ticks for a request started by the calling task to
+ * complete.  Returns the number of bytes transferred, -1 if the request
+ * failed, or hostioPENDING if it has not completed.
+ */
+int32_t lHostIOWait( HostIORequest_t * pxRequest,
+                     TickType_t xTicksToWait );
+
+/*
+ * As xHostIOWriteAsync() and xHostIOReadAsync(), but block until the request
+ * completes.  Return the number of bytes transferred, or -1 on failure.
+ */
+int32_t lHostIOWrite( HostIOFile_t xFile,
+                      const void * pvData,
+                      size_t xLength );
+int32_t lHostIORead( HostIOFile_t xFile,
+                     void * pvBuffer,
+                     size_t xLength );
+
+/*
+ * Format text as printf() and write it to the console from the Windows
+ * thread.  Never blocks.  Output that does not fit in the log buffer is
+ * dropped and counted.  Must be called from a task.
+ */
+void vHostIOPrintf( const char * pcFormat,
+                    ... );
+
+/*
+ * Copy the service's statistics into pxStats.
+ */
+void vHostIOGetStats( HostIOStats_t * pxStats );
+
+#endif /* HOST_IO_H */
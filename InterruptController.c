@@ -0,0 +1,582 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of InterruptController.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <intrin.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "InterruptController.h"
+
+#define intctrlNUM_WORDS           ( intctrlNUM_LINES / 32 )
+
+/* The value of uxRunningLevel when no line's handler is running.  Otherwise it
+ * is one more than the priority of the running handler. */
+#define intctrlNOT_RUNNING         ( 0 )
+
+typedef struct xINTCTRL_LINE
+{
+    IntCtrlHandler_t pxHandler;
+    UBaseType_t uxPriority;
+    BaseType_t xEnabled;
+    BaseType_t xPending;
+    configRUN_TIME_COUNTER_TYPE xRaisedAt;          /* When the line last became pending. */
+    configRUN_TIME_COUNTER_TYPE xTotalTime;
+    configRUN_TIME_COUNTER_TYPE xMaxTime;
+    configRUN_TIME_COUNTER_TYPE xMaxLatency;
+    configRUN_TIME_COUNTER_TYPE xLoadExecutionTime; /* For lines driven by the load thread. */
+    uint32_t ulRaised;
+    uint32_t ulCoalesced;
+    uint32_t ulHandled;
+    uint32_t ulPreemptions;
+} IntCtrlLine_t;
+
+typedef struct xINTCTRL_LOAD_SOURCE
+{
+    uint32_t ulLine;
+    configRUN_TIME_COUNTER_TYPE xPeriod;
+    configRUN_TIME_COUNTER_TYPE xNextRaise;
+} IntCtrlLoadSource_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The handler of the port interrupt.  Runs the handlers of the pending lines.
+ */
+static uint32_t prvPortInterruptHandler( void );
+
+/*
+ * Run the handlers of pending lines, highest priority first, until none is
+ * pending whose priority is above the one represented by uxLevel.
+ */
+static void prvServicePending( UBaseType_t uxLevel,
+                               BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Mark ulLine as pending and count the raise.  Returns pdFALSE if the line is
+ * disabled.  Must be called with the lock held.
+ */
+static BaseType_t prvSetPending( uint32_t ulLine );
+
+/*
+ * Clear ulLine's pending bits.  Must be called with the lock held.
+ */
+static void prvClearPending( uint32_t ulLine );
+
+/*
+ * The lock that protects the pending bitmap against the load thread.  The
+ * tasks and interrupt handlers hold the simulator's critical section while
+ * taking it, so the Windows port cannot suspend them while they hold it.
+ */
+static void prvLock( void );
+static void prvUnlock( void );
+
+/*
+ * The handler of lines driven by the load thread, and the thread itself.
+ */
+static void prvLoadHandler( uint32_t ulLine,
+                            BaseType_t * pxHigherPriorityTaskWoken );
+static DWORD WINAPI prvLoadThread( void * pvParam );
+
+/*-----------------------------------------------------------*/
+
+static IntCtrlLine_t xLines[ intctrlNUM_LINES ];
+
+/* The pending bitmap.  Bit b of ulPendingLines[ p ][ w ] is set if line
+ * ( w * 32 ) + b, which has priority p, is pending.  Bit w of
+ * ulPendingWords[ p ] is set if ulPendingLines[ p ][ w ] is not zero, and bit
+ * p of ulPendingPriorities is set if ulPendingWords[ p ] is not zero. */
+static uint32_t ulPendingLines[ intctrlNUM_PRIORITIES ][ intctrlNUM_WORDS ];
+static uint32_t ulPendingWords[ intctrlNUM_PRIORITIES ];
+static uint32_t ulPendingPriorities = 0;
+
+static volatile LONG lLock = 0;
+
+/* Only accessed by the thread that runs the simulated interrupts. */
+static UBaseType_t uxRunningLevel = intctrlNOT_RUNNING;
+static configRUN_TIME_COUNTER_TYPE xPreemptedTime = 0;
+
+static IntCtrlLoadSource_t xLoadSources[ intctrlMAX_LOAD_SOURCES ];
+static volatile UBaseType_t uxLoadSourceCount = 0;
+
+/*-----------------------------------------------------------*/
+
+void vIntCtrlInit( void )
+{
+    vPortSetInterruptHandler( intctrlPORT_INTERRUPT_NUMBER, prvPortInterruptHandler );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIntCtrlSetHandler( uint32_t ulLine,
+                               UBaseType_t uxPriority,
+                               IntCtrlHandler_t pxHandler )
+{
+    if( ( ulLine >= intctrlNUM_LINES ) || ( uxPriority >= intctrlNUM_PRIORITIES ) || ( pxHandler == NULL ) )
+    {
+        return pdFAIL;
+    }
+
+    portENTER_CRITICAL();
+    prvLock();
+    {
+        /* The line's bit is in the bitmap for its priority, so it cannot
+         * change priority while pending. */
+        prvClearPending( ulLine );
+        xLines[ ulLine ].pxHandler = pxHandler;
+        xLines[ ulLine ].uxPriority = uxPriority;
+        xLines[ ulLine ].xEnabled = pdTRUE;
+    }
+    prvUnlock();
+    portEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vIntCtrlEnable( uint32_t ulLine,
+                     BaseType_t xEnable )
+{
+    configASSERT( ulLine < intctrlNUM_LINES );
+
+    portENTER_CRITICAL();
+    prvLock();
+    {
+        if( xEnable == pdFALSE )
+        {
+            prvClearPending( ulLine );
+        }
+
+        xLines[ ulLine ].xEnabled = ( ( xEnable != pdFALSE ) && ( xLines[ ulLine ].pxHandler != NULL ) ) ? pdTRUE : pdFALSE;
+    }
+    prvUnlock();
+    portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vIntCtrlRaise( uint32_t ulLine )
+{
+    BaseType_t xPending;
+
+    configASSERT( ulLine < intctrlNUM_LINES );
+
+    portENTER_CRITICAL();
+    prvLock();
+    {
+        xPending = prvSetPending( ulLine );
+    }
+    prvUnlock();
+    portEXIT_CRITICAL();
+
+    /* Called from a task, which waits here until the handlers have run. */
+    if( xPending != pdFALSE )
+    {
+        vPortGenerateSimulatedInterrupt( intctrlPORT_INTERRUPT_NUMBER );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vIntCtrlRaiseFromISR( uint32_t ulLine,
+                           BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BaseType_t xPending, xDummy = pdFALSE;
+
+    configASSERT( ulLine < intctrlNUM_LINES );
+
+    if( pxHigherPriorityTaskWoken == NULL )
+    {
+        pxHigherPriorityTaskWoken = &xDummy;
+    }
+
+    prvLock();
+    {
+        xPending = prvSetPending( ulLine );
+    }
+    prvUnlock();
+
+    /* Preempt the running handler, if any, if the line has a higher priority.
+     * Otherwise the line is found by the loop in prvServicePending() when the
+     * running handler returns. */
+    if( ( xPending != pdFALSE ) && ( ( xLines[ ulLine ].uxPriority + 1 ) > uxRunningLevel ) )
+    {
+        prvServicePending( uxRunningLevel, pxHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIntCtrlAddLoad( uint32_t ulLine,
+                            UBaseType_t uxPriority,
+                            uint32_t ulPeriodUs,
+                            uint32_t ulExecutionUs )
+{
+    HANDLE xThread;
+    IntCtrlLoadSource_t * pxSource;
+
+    configASSERT( ulPeriodUs > 0 );
+
+    if( uxLoadSourceCount >= intctrlMAX_LOAD_SOURCES )
+    {
+        return pdFAIL;
+    }
+
+    if( xIntCtrlSetHandler( ulLine, uxPriority, prvLoadHandler ) == pdFAIL )
+    {
+        return pdFAIL;
+    }
+
+    xLines[ ulLine ].xLoadExecutionTime = ulExecutionUs / configUS_PER_RUN_TIME_COUNT;
+
+    pxSource = &( xLoadSources[ uxLoadSourceCount ] );
+    pxSource->ulLine = ulLine;
+    pxSource->xPeriod = ( ulPeriodUs + configUS_PER_RUN_TIME_COUNT - 1 ) / configUS_PER_RUN_TIME_COUNT;
+    pxSource->xNextRaise = 0;
+
+    /* The load thread only reads sources below the count. */
+    MemoryBarrier();
+    uxLoadSourceCount++;
+
+    if( uxLoadSourceCount == 1 )
+    {
+        xThread = CreateThread( NULL, 0, prvLoadThread, NULL, 0, NULL );
+
+        if( xThread == NULL )
+        {
+            return pdFAIL;
+        }
+
+        /* Use the cores that are not used by the FreeRTOS tasks, as the
+         * keyboard thread in main.c does. */
+        SetThreadAffinityMask( xThread, ~0x01u );
+        SetThreadPriority( xThread, THREAD_PRIORITY_TIME_CRITICAL );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xIntCtrlGetLineStats( uint32_t ulLine,
+                                 IntCtrlLineStats_t * pxStats )
+{
+    const IntCtrlLine_t * pxLine;
+
+    if( ulLine >= intctrlNUM_LINES )
+    {
+        return pdFAIL;
+    }
+
+    pxLine = &( xLines[ ulLine ] );
+
+    /* The handlers update the counters. */
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulRaised = pxLine->ulRaised;
+        pxStats->ulCoalesced = pxLine->ulCoalesced;
+        pxStats->ulHandled = pxLine->ulHandled;
+        pxStats->ulPreemptions = pxLine->ulPreemptions;
+        pxStats->ulMaxLatencyUs = ( uint32_t ) ( pxLine->xMaxLatency * configUS_PER_RUN_TIME_COUNT );
+        pxStats->ulMeanTimeUs = ( pxLine->ulHandled == 0 ) ? 0 : ( uint32_t ) ( ( pxLine->xTotalTime * configUS_PER_RUN_TIME_COUNT ) / pxLine->ulHandled );
+        pxStats->ulMaxTimeUs = ( uint32_t ) ( pxLine->xMaxTime * configUS_PER_RUN_TIME_COUNT );
+    }
+    taskEXIT_CRITICAL();
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vIntCtrlPrint( void )
+{
+    uint32_t ulLine;
+    IntCtrlLineStats_t xStats;
+
+    printf( "\r\n%-5s %4s %10s %10s %10s %8s %10s %10s %10s\r\n", "Line", "Prio", "Raised", "Coalesced", "Handled", "Preempt", "MaxLat(us)", "Mean(us)", "Max(us)" );
+
+    for( ulLine = 0; ulLine < intctrlNUM_LINES; ulLine++ )
+    {
+        if( xLines[ ulLine ].pxHandler != NULL )
+        {
+            xIntCtrlGetLineStats( ulLine, &xStats );
+
+            printf( "%-5lu %4lu %10lu %10lu %10lu %8lu %10lu %10lu %10lu%s\r\n",
+                    ( unsigned long ) ulLine,
+                    ( unsigned long ) xLines[ ulLine ].uxPriority,
+                    ( unsigned long ) xStats.ulRaised,
+                    ( unsigned long ) xStats.ulCoalesced,
+                    ( unsigned long ) xStats.ulHandled,
+                    ( unsigned long ) xStats.ulPreemptions,
+                    ( unsigned long ) xStats.ulMaxLatencyUs,
+                    ( unsigned long ) xStats.ulMeanTimeUs,
+                    ( unsigned long ) xStats.ulMaxTimeUs,
+                    ( xLines[ ulLine ].xEnabled == pdFALSE ) ? " (disabled)" : "" );
+        }
+    }
+
+    printf( "\r\n" );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPortInterruptHandler( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    prvServicePending( intctrlNOT_RUNNING, &xHigherPriorityTaskWoken );
+
+    return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvServicePending( UBaseType_t uxLevel,
+                               BaseType_t * pxHigherPriorityTaskWoken )
+{
+    unsigned long ulPriority, ulWord, ulBit;
+    uint32_t ulLine;
+    IntCtrlLine_t * pxLine;
+    UBaseType_t uxPreviousLevel = uxRunningLevel;
+    configRUN_TIME_COUNTER_TYPE xStart, xElapsed, xPreviousPreemptedTime;
+
+    for( ; ; )
+    {
+        prvLock();
+        {
+            /* The highest pending priority, then the lowest numbered pending
+             * line of that priority. */
+            if( ( _BitScanReverse( &ulPriority, ulPendingPriorities ) == 0 ) || ( ( ulPriority + 1 ) <= uxLevel ) )
+            {
+                prvUnlock();
+                break;
+            }
+
+            ( void ) _BitScanForward( &ulWord, ulPendingWords[ ulPriority ] );
+            ( void ) _BitScanForward( &ulBit, ulPendingLines[ ulPriority ][ ulWord ] );
+            ulLine = ( uint32_t ) ( ( ulWord * 32 ) + ulBit );
+            prvClearPending( ulLine );
+        }
+        prvUnlock();
+
+        pxLine = &( xLines[ ulLine ] );
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        if( ( xStart - pxLine->xRaisedAt ) > pxLine->xMaxLatency )
+        {
+            pxLine->xMaxLatency = xStart - pxLine->xRaisedAt;
+        }
+
+        if( uxPreviousLevel != intctrlNOT_RUNNING )
+        {
+            pxLine->ulPreemptions++;
+        }
+
+        /* Run the handler at its own priority, keeping the time spent in any
+         * handlers that preempt it apart from its own. */
+        xPreviousPreemptedTime = xPreemptedTime;
+        xPreemptedTime = 0;
+        uxRunningLevel = ( UBaseType_t ) ulPriority + 1;
+
+        pxLine->pxHandler( ulLine, pxHigherPriorityTaskWoken );
+
+        uxRunningLevel = uxPreviousLevel;
+        xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+        pxLine->ulHandled++;
+        pxLine->xTotalTime += xElapsed - xPreemptedTime;
+
+        if( ( xElapsed - xPreemptedTime ) > pxLine->xMaxTime )
+        {
+            pxLine->xMaxTime = xElapsed - xPreemptedTime;
+        }
+
+        /* All of this handler's time, including the handlers that preempted
+         * it, is preemption time for the handler it preempted. */
+        xPreemptedTime = xPreviousPreemptedTime + xElapsed;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSetPending( uint32_t ulLine )
+{
+    IntCtrlLine_t * pxLine = &( xLines[ ulLine ] );
+    uint32_t ulWord = ulLine / 32;
+    UBaseType_t uxPriority = pxLine->uxPriority;
+
+    if( pxLine->xEnabled == pdFALSE )
+    {
+        return pdFALSE;
+    }
+
+    pxLine->ulRaised++;
+
+    if( pxLine->xPending != pdFALSE )
+    {
+        pxLine->ulCoalesced++;
+    }
+    else
+    {
+        pxLine->xPending = pdTRUE;
+        pxLine->xRaisedAt = portGET_RUN_TIME_COUNTER_VALUE();
+        ulPendingLines[ uxPriority ][ ulWord ] |= ( 1UL << ( ulLine % 32 ) );
+        ulPendingWords[ uxPriority ] |= ( 1UL << ulWord );
+        ulPendingPriorities |= ( 1UL << uxPriority );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvClearPending( uint32_t ulLine )
+{
+    IntCtrlLine_t * pxLine = &( xLines[ ulLine ] );
+    uint32_t ulWord = ulLine / 32;
+    UBaseType_t uxPriority = pxLine->uxPriority;
+
+    if( pxLine->xPending != pdFALSE )
+    {
+        pxLine->xPending = pdFALSE;
+        ulPendingLines[ uxPriority ][ ulWord ] &= ~( 1UL << ( ulLine % 32 ) );
+
+        if( ulPendingLines[ uxPriority ][ ulWord ] == 0 )
+        {
+            ulPendingWords[ uxPriority ] &= ~( 1UL << ulWord );
+
+            if( ulPendingWords[ uxPriority ] == 0 )
+            {
+                ulPendingPriorities &= ~( 1UL << uxPriority );
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvLock( void )
+{
+    while( InterlockedCompareExchange( &lLock, 1, 0 ) != 0 )
+    {
+        /* Only held for a few instructions. */
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlock( void )
+{
+    InterlockedExchange( &lLock, 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadHandler( uint32_t ulLine,
+                            BaseType_t * pxHigherPriorityTaskWoken )
+{
+    configRUN_TIME_COUNTER_TYPE xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    /* Stand in for the work a real handler would do.  The load thread raises
+     * lines without running them, so poll for higher priority lines and run
+     * them nested inside this handler, as a real interrupt would preempt it.
+     * xPreemptedTime is the time spent in those handlers, which does not
+     * count towards this handler's own execution time. */
+    while( ( portGET_RUN_TIME_COUNTER_VALUE() - xStart - xPreemptedTime ) < xLines[ ulLine ].xLoadExecutionTime )
+    {
+        prvServicePending( uxRunningLevel, pxHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static DWORD WINAPI prvLoadThread( void * pvParam )
+{
+    HANDLE xTimer;
+    LARGE_INTEGER xDueTime;
+    UBaseType_t uxSource, uxRaised;
+    configRUN_TIME_COUNTER_TYPE xNow;
+    IntCtrlLoadSource_t * pxSource;
+
+    ( void ) pvParam;
+
+    /* A high resolution timer, where available, wakes the thread more
+     * accurately than Sleep(). */
+    xTimer = CreateWaitableTimerExW( NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS );
+
+    /* Relative times are negative, in 100ns units. */
+    xDueTime.QuadPart = -( ( LONGLONG ) intctrlLOAD_RESOLUTION_US * 10LL );
+
+    for( ; ; )
+    {
+        if( xTimer != NULL )
+        {
+            SetWaitableTimer( xTimer, &xDueTime, 0, NULL, NULL, FALSE );
+            WaitForSingleObject( xTimer, INFINITE );
+        }
+        else
+        {
+            Sleep( ( intctrlLOAD_RESOLUTION_US + 999 ) / 1000 );
+        }
+
+        /* Simulated interrupts cannot be generated until the scheduler is
+         * running. */
+        if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+        {
+            continue;
+        }
+
+        xNow = portGET_RUN_TIME_COUNTER_VALUE();
+        uxRaised = 0;
+
+        prvLock();
+        {
+            for( uxSource = 0; uxSource < uxLoadSourceCount; uxSource++ )
+            {
+                pxSource = &( xLoadSources[ uxSource ] );
+
+                if( xNow >= pxSource->xNextRaise )
+                {
+                    uxRaised += ( UBaseType_t ) prvSetPending( pxSource->ulLine );
+
+                    /* Keep to the period, unless the thread has fallen more
+                     * than a period behind, in which case the missed raises
+                     * are lost, as they would be coalesced anyway. */
+                    pxSource->xNextRaise += pxSource->xPeriod;
+
+                    if( pxSource->xNextRaise <= xNow )
+                    {
+                        pxSource->xNextRaise = xNow + pxSource->xPeriod;
+                    }
+                }
+            }
+        }
+        prvUnlock();
+
+        /* This is a Windows thread, not a FreeRTOS task. */
+        if( uxRaised != 0 )
+        {
+            vPortGenerateSimulatedInterruptFromWindowsThread( intctrlPORT_INTERRUPT_NUMBER );
+        }
+    }
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
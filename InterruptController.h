@@ -0,0 +1,173 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A model of an interrupt controller with many prioritised lines.
+ *
+ * The Windows port supports a few simulated interrupt numbers, all processed
+ * one at a time, in number order, by one Windows thread.  That is enough to
+ * drive the keyboard, but not to model the interrupt load of a real device,
+ * where dozens of sources at different priorities preempt each other.  The
+ * interrupt controller multiplexes intctrlNUM_LINES lines onto the single
+ * simulated interrupt intctrlPORT_INTERRUPT_NUMBER, and adds:
+ *
+ * - A priority for each line, from 0 to intctrlNUM_PRIORITIES - 1.  Higher
+ *   numbers are higher priorities, as for FreeRTOS tasks.
+ * - Preemption.  A line raised while the handler of a lower priority line is
+ *   running has its handler run at once, nested inside the lower priority
+ *   handler, and a line raised while a handler of the same or higher priority
+ *   is running is held pending until that handler returns.  Lines raised from
+ *   the handlers of the other simulated interrupts (the tick hook, for example)
+ *   are handled before the raise returns.
+ * - A pending bitmap, with one bit per line for each priority, a summary bit
+ *   for each word and one for each priority, so the highest priority pending
+ *   line is found with two bit scans whatever the number of lines.
+ * - Counters for each line: raises, raises that found the line already
+ *   pending, preemptions, the latency from raise to handler, and the handler's
+ *   own execution time, excluding the time spent in handlers that preempted it.
+ *
+ * Lines can also be driven by a Windows thread that raises them periodically,
+ * with a handler that busy waits for a given time of its own, during which
+ * higher priority lines preempt it, so the interrupt load of a device can be
+ * described by a table of lines, priorities, rates and execution times, and
+ * its effect on the tasks observed.
+ */
+
+#ifndef INTERRUPT_CONTROLLER_H
+#define INTERRUPT_CONTROLLER_H
+
+#include "FreeRTOS.h"
+
+/* The simulated interrupt the lines are multiplexed onto.  Interrupts 3 to 5
+ * are used by main.c, HostIO.c and ControlSocket.c. */
+#ifndef intctrlPORT_INTERRUPT_NUMBER
+    #define intctrlPORT_INTERRUPT_NUMBER    ( 6 )
+#endif
+
+/* Must be a multiple of 32, and no more than 1024. */
+#ifndef intctrlNUM_LINES
+    #define intctrlNUM_LINES    ( 256 )
+#endif
+
+/* No more than 32. */
+#ifndef intctrlNUM_PRIORITIES
+    #define intctrlNUM_PRIORITIES    ( 32 )
+#endif
+
+/* The most lines that can be driven by the load thread, and how often the
+ * load thread wakes to raise them, in microseconds.  Windows timers have a
+ * resolution of about 500 microseconds at best. */
+#ifndef intctrlMAX_LOAD_SOURCES
+    #define intctrlMAX_LOAD_SOURCES    ( 16 )
+#endif
+
+#ifndef intctrlLOAD_RESOLUTION_US
+    #define intctrlLOAD_RESOLUTION_US    ( 500 )
+#endif
+
+#if ( ( intctrlNUM_LINES % 32 ) != 0 ) || ( intctrlNUM_LINES > 1024 )
+    #error intctrlNUM_LINES must be a multiple of 32, and no more than 1024
+#endif
+
+#if ( intctrlNUM_PRIORITIES > 32 )
+    #error intctrlNUM_PRIORITIES must be no more than 32
+#endif
+
+/*
+ * A line's handler.  Called in interrupt context, so can only use the FreeRTOS
+ * API functions that end in "FromISR", and must set *pxHigherPriorityTaskWoken
+ * to pdTRUE if it unblocks a task that should run when the interrupt exits.
+ */
+typedef void (* IntCtrlHandler_t)( uint32_t ulLine,
+                                   BaseType_t * pxHigherPriorityTaskWoken );
+
+typedef struct xINTCTRL_LINE_STATS
+{
+    uint32_t ulRaised;          /* Times the line was raised while enabled. */
+    uint32_t ulCoalesced;       /* Raises that found the line already pending. */
+    uint32_t ulHandled;         /* Times the handler ran. */
+    uint32_t ulPreemptions;     /* Times the handler ran nested inside another. */
+    uint32_t ulMaxLatencyUs;    /* Longest time from raise to handler. */
+    uint32_t ulMeanTimeUs;      /* Mean and longest execution time of the handler... */
+    uint32_t ulMaxTimeUs;       /* ...excluding handlers that preempted it. */
+} IntCtrlLineStats_t;
+
+/*
+ * Install the handler of the port interrupt the lines are multiplexed onto.
+ * Call from main() before the scheduler is started.
+ */
+void vIntCtrlInit( void );
+
+/*
+ * Set the handler and priority of ulLine, and enable it.  Returns pdFAIL if
+ * ulLine or uxPriority is out of range.
+ */
+BaseType_t xIntCtrlSetHandler( uint32_t ulLine,
+                               UBaseType_t uxPriority,
+                               IntCtrlHandler_t pxHandler );
+
+/*
+ * Enable or disable ulLine.  Raising a disabled line has no effect, and
+ * disabling a pending line discards the pending raise.
+ */
+void vIntCtrlEnable( uint32_t ulLine,
+                     BaseType_t xEnable );
+
+/*
+ * Raise ulLine.  vIntCtrlRaise() is called from tasks, and
+ * vIntCtrlRaiseFromISR() from interrupt handlers, including the handlers of
+ * other lines.
+ */
+void vIntCtrlRaise( uint32_t ulLine );
+void vIntCtrlRaiseFromISR( uint32_t ulLine,
+                           BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Have the load thread raise ulLine every ulPeriodUs microseconds, with a
+ * handler that runs for ulExecutionUs microseconds.  The first call creates
+ * the load thread, so call from main() before the scheduler is started.
+ * Returns pdFAIL if the line is out of range, or intctrlMAX_LOAD_SOURCES lines
+ * already have load.
+ */
+BaseType_t xIntCtrlAddLoad( uint32_t ulLine,
+                            UBaseType_t uxPriority,
+                            uint32_t ulPeriodUs,
+                            uint32_t ulExecutionUs );
+
+/*
+ * Copy the counters of ulLine into pxStats.  Returns pdFAIL if ulLine is out
+ * of range.
+ */
+BaseType_t xIntCtrlGetLineStats( uint32_t ulLine,
+                                 IntCtrlLineStats_t * pxStats );
+
+/*
+ * Print the counters of every line that has a handler.  Makes Windows system
+ * calls, so must be called from a critical section.
+ */
+void vIntCtrlPrint( void );
+
+#endif /* INTERRUPT_CONTROLLER_H */
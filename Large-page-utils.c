@@ -0,0 +1,140 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Utility functions that back large simulator buffers with large pages.
+ *
+ * When configUSE_LARGE_PAGES is set to 1 in FreeRTOSConfig.h the heap_5
+ * regions and the trace recorder buffer are allocated here instead of being
+ * static arrays.  Large pages cut the number of TLB entries needed to cover
+ * big heaps and trace buffers, which shows up when configTOTAL_HEAP_SIZE and
+ * TRC_CFG_EVENT_BUFFER_SIZE are scaled up for long simulations.
+ *
+ * Windows only grants large pages to accounts that hold the "Lock pages in
+ * memory" user right.  If the right is missing, or no large pages are free,
+ * the allocation falls back to normal pages so the demo still runs - use
+ * xLargePagesInUse() to find out which was used.
+ *
+ * These functions are called before the scheduler is started, so can make
+ * Windows system calls directly.
+*/
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Try to enable the privilege needed to allocate large pages.
+ */
+static BaseType_t prvEnableLockMemoryPrivilege( void );
+
+/*-----------------------------------------------------------*/
+
+/* Set to pdFALSE as soon as one allocation has to fall back to normal
+pages. */
+static BaseType_t xAllAllocationsUsedLargePages = pdTRUE;
+
+/* Only try to obtain the privilege once. */
+static BaseType_t xPrivilegeChecked = pdFALSE, xPrivilegeHeld = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void *pvLargePageAlloc( size_t xSize )
+{
+void *pvReturn = NULL;
+SIZE_T xLargePageSize;
+
+	if( xPrivilegeChecked == pdFALSE )
+	{
+		xPrivilegeHeld = prvEnableLockMemoryPrivilege();
+		xPrivilegeChecked = pdTRUE;
+	}
+
+	xLargePageSize = GetLargePageMinimum();
+
+	if( ( xPrivilegeHeld != pdFALSE ) && ( xLargePageSize != 0 ) )
+	{
+		/* Large page allocations must be a multiple of the large page
+		size. */
+		xSize = ( xSize + xLargePageSize - 1 ) & ~( xLargePageSize - 1 );
+		pvReturn = VirtualAlloc( NULL, xSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+	}
+
+	if( pvReturn == NULL )
+	{
+		/* Fall back to normal pages. */
+		xAllAllocationsUsedLargePages = pdFALSE;
+		pvReturn = VirtualAlloc( NULL, xSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+	}
+
+	configASSERT( pvReturn );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLargePagesInUse( void )
+{
+	return ( xPrivilegeChecked != pdFALSE ) && ( xAllAllocationsUsedLargePages != pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvEnableLockMemoryPrivilege( void )
+{
+HANDLE xToken;
+TOKEN_PRIVILEGES xPrivileges;
+BaseType_t xReturn = pdFALSE;
+
+	if( OpenProcessToken( GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &xToken ) != 0 )
+	{
+		xPrivileges.PrivilegeCount = 1;
+		xPrivileges.Privileges[ 0 ].Attributes = SE_PRIVILEGE_ENABLED;
+
+		if( LookupPrivilegeValue( NULL, SE_LOCK_MEMORY_NAME, &( xPrivileges.Privileges[ 0 ].Luid ) ) != 0 )
+		{
+			/* AdjustTokenPrivileges() succeeds even when the account does not
+			hold the privilege, in which case GetLastError() says so. */
+			if( ( AdjustTokenPrivileges( xToken, FALSE, &xPrivileges, 0, NULL, NULL ) != 0 ) && ( GetLastError() == ERROR_SUCCESS ) )
+			{
+				xReturn = pdTRUE;
+			}
+		}
+
+		CloseHandle( xToken );
+	}
+
+	if( xReturn == pdFALSE )
+	{
+		printf( "Large pages unavailable - grant the \"Lock pages in memory\" user right to use them.\r\n" );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
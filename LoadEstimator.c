@@ -0,0 +1,447 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of LoadEstimator.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Demo includes. */
+#include "LoadEstimator.h"
+
+/* The number of samples in one second, and the number of one second totals
+ * kept for the longest window. */
+#define loadestSAMPLES_PER_SECOND    ( 1000 / loadestSAMPLE_PERIOD_MS )
+#define loadestSECONDS               ( 60 )
+
+/* The averages are held scaled up by this much to keep their precision. */
+#define loadestAVERAGE_SCALE         ( 256UL )
+
+/*
+ * The run time accumulated by one counter - the elapsed time, the idle task,
+ * or one task - over each window.
+ */
+typedef struct xLOAD_WINDOWS
+{
+    uint32_t ulSamples[ loadestSAMPLES_PER_SECOND ];   /* The time in each of the last second's samples. */
+    uint32_t ulSeconds[ loadestSECONDS ];              /* The time in each of the last minute's seconds. */
+    uint32_t ulSum1s;
+    uint32_t ulSum10s;
+    uint32_t ulSum60s;
+    uint32_t ulAverage;                                /* Scaled by loadestAVERAGE_SCALE. */
+    BaseType_t xAverageStarted;                        /* Clear until the first sample. */
+} LoadWindows_t;
+
+typedef struct xTASK_LOAD
+{
+    TaskHandle_t xHandle;               /* NULL if the entry is free. */
+    UBaseType_t uxTaskNumber;           /* Distinguishes a new task that reuses a deleted task's handle. */
+    char cName[ configMAX_TASK_NAME_LEN ];
+    configRUN_TIME_COUNTER_TYPE xLastRunTime;
+    BaseType_t xSeen;                   /* Set when the task is found in a sample. */
+    LoadWindows_t xWindows;
+} TaskLoad_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The sampling timer's callback.
+ */
+static void prvSampleTimerCallback( TimerHandle_t xTimer );
+
+/*
+ * Add one sample's time to pxWindows.  ulSampleLoad is the load the time
+ * represents, in tenths of a percent, and is used for the average.
+ */
+static void prvAddSample( LoadWindows_t * pxWindows,
+                          uint32_t ulTime,
+                          uint32_t ulSampleLoad );
+
+/*
+ * Calculate the load of the time in pxWindows as a share of the elapsed time.
+ */
+static void prvCalculateLoad( const LoadWindows_t * pxWindows,
+                              LoadStats_t * pxStats );
+
+/*
+ * Find the entry for xTask, returning NULL if there is none.
+ */
+static TaskLoad_t * prvFindTask( TaskHandle_t xTask,
+                                 UBaseType_t uxTaskNumber );
+
+/*
+ * Returns ulPart as a share of ulWhole, in tenths of a percent.
+ */
+static uint32_t prvPerMille( uint32_t ulPart,
+                             uint32_t ulWhole );
+
+/*-----------------------------------------------------------*/
+
+/* The elapsed time, idle time and each task's time. */
+static LoadWindows_t xElapsed;
+static LoadWindows_t xIdle;
+static TaskLoad_t xTasks[ loadestMAX_TASKS ];
+
+/* The counters at the last sample. */
+static configRUN_TIME_COUNTER_TYPE xLastElapsed = 0;
+static configRUN_TIME_COUNTER_TYPE xLastIdle = 0;
+
+/* The position of the next sample in LoadWindows_t.ulSamples, and of the next
+ * second in LoadWindows_t.ulSeconds. */
+static UBaseType_t uxSampleIndex = 0;
+static UBaseType_t uxSecondIndex = 0;
+
+/* The system load calculated at the last sample. */
+static LoadStats_t xSystemLoad = { 0 };
+
+/* The threshold callback. */
+static LoadThresholdCallback_t pxThresholdCallback = NULL;
+static uint32_t ulHigh = 0;
+static uint32_t ulLow = 0;
+static BaseType_t xOverloaded = pdFALSE;
+
+/* Written by the timer callback only.  Too large for the timer task's
+ * stack. */
+static TaskStatus_t xTaskStatus[ loadestMAX_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoadEstimatorStart( void )
+{
+    TimerHandle_t xTimer;
+    BaseType_t xReturn = pdFAIL;
+
+    xTimer = xTimerCreate( "Load", pdMS_TO_TICKS( loadestSAMPLE_PERIOD_MS ), pdTRUE, NULL, prvSampleTimerCallback );
+
+    if( xTimer != NULL )
+    {
+        xLastElapsed = portGET_RUN_TIME_COUNTER_VALUE();
+        xReturn = xTimerStart( xTimer, 0 );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadEstimatorGetSystemLoad( LoadStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xSystemLoad;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoadEstimatorGetTaskLoad( TaskHandle_t xTask,
+                                      LoadStats_t * pxStats )
+{
+    TaskLoad_t * pxTask;
+    BaseType_t xReturn = pdFAIL;
+
+    taskENTER_CRITICAL();
+    {
+        pxTask = prvFindTask( xTask, 0 );
+
+        if( pxTask != NULL )
+        {
+            prvCalculateLoad( &( pxTask->xWindows ), pxStats );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadEstimatorSetThresholdCallback( uint32_t ulHighThreshold,
+                                         uint32_t ulLowThreshold,
+                                         LoadThresholdCallback_t pxCallback )
+{
+    configASSERT( ( pxCallback == NULL ) || ( ulLowThreshold < ulHighThreshold ) );
+
+    taskENTER_CRITICAL();
+    {
+        ulHigh = ulHighThreshold;
+        ulLow = ulLowThreshold;
+        xOverloaded = pdFALSE;
+        pxThresholdCallback = pxCallback;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vLoadEstimatorPrint( void )
+{
+    LoadStats_t xStats;
+    UBaseType_t uxIndex;
+
+    printf( "\r\n%-16s %7s %7s %7s %7s\r\n", "Load (%)", "1s", "10s", "60s", "Avg" );
+    printf( "%-16s %5lu.%lu %5lu.%lu %5lu.%lu %5lu.%lu\r\n", "System",
+            ( unsigned long ) ( xSystemLoad.ulLoad1s / 10 ), ( unsigned long ) ( xSystemLoad.ulLoad1s % 10 ),
+            ( unsigned long ) ( xSystemLoad.ulLoad10s / 10 ), ( unsigned long ) ( xSystemLoad.ulLoad10s % 10 ),
+            ( unsigned long ) ( xSystemLoad.ulLoad60s / 10 ), ( unsigned long ) ( xSystemLoad.ulLoad60s % 10 ),
+            ( unsigned long ) ( xSystemLoad.ulLoadAverage / 10 ), ( unsigned long ) ( xSystemLoad.ulLoadAverage % 10 ) );
+
+    for( uxIndex = 0; uxIndex < loadestMAX_TASKS; uxIndex++ )
+    {
+        if( xTasks[ uxIndex ].xHandle != NULL )
+        {
+            prvCalculateLoad( &( xTasks[ uxIndex ].xWindows ), &xStats );
+
+            printf( "%-16s %5lu.%lu %5lu.%lu %5lu.%lu %5lu.%lu\r\n", xTasks[ uxIndex ].cName,
+                    ( unsigned long ) ( xStats.ulLoad1s / 10 ), ( unsigned long ) ( xStats.ulLoad1s % 10 ),
+                    ( unsigned long ) ( xStats.ulLoad10s / 10 ), ( unsigned long ) ( xStats.ulLoad10s % 10 ),
+                    ( unsigned long ) ( xStats.ulLoad60s / 10 ), ( unsigned long ) ( xStats.ulLoad60s % 10 ),
+                    ( unsigned long ) ( xStats.ulLoadAverage / 10 ), ( unsigned long ) ( xStats.ulLoadAverage % 10 ) );
+        }
+    }
+
+    printf( "\r\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSampleTimerCallback( TimerHandle_t xTimer )
+{
+    configRUN_TIME_COUNTER_TYPE xNow, xIdleNow, xTotalRunTime;
+    uint32_t ulElapsed, ulTime;
+    UBaseType_t uxTasks, uxIndex, uxFree;
+    TaskLoad_t * pxTask;
+    LoadStats_t xLoad;
+    LoadThresholdCallback_t pxCallback = NULL;
+    BaseType_t xCallbackOverloaded = pdFALSE;
+
+    ( void ) xTimer;
+
+    /* Returns 0 if there are more tasks than entries, in which case only the
+     * system load is estimated. */
+    uxTasks = uxTaskGetSystemState( xTaskStatus, loadestMAX_TASKS, &xTotalRunTime );
+
+    xNow = portGET_RUN_TIME_COUNTER_VALUE();
+    xIdleNow = ulTaskGetIdleRunTimeCounter();
+    ulElapsed = ( uint32_t ) ( xNow - xLastElapsed );
+    ulTime = ( uint32_t ) ( xIdleNow - xLastIdle );
+    xLastElapsed = xNow;
+    xLastIdle = xIdleNow;
+
+    if( ulElapsed == 0 )
+    {
+        /* The run time counter has not moved, so there is nothing to
+         * measure. */
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        prvAddSample( &xElapsed, ulElapsed, 1000 );
+        prvAddSample( &xIdle, ulTime, prvPerMille( ulTime, ulElapsed ) );
+
+        for( uxIndex = 0; uxIndex < loadestMAX_TASKS; uxIndex++ )
+        {
+            xTasks[ uxIndex ].xSeen = pdFALSE;
+        }
+
+        for( uxIndex = 0; uxIndex < uxTasks; uxIndex++ )
+        {
+            pxTask = prvFindTask( xTaskStatus[ uxIndex ].xHandle, xTaskStatus[ uxIndex ].xTaskNumber );
+
+            if( pxTask == NULL )
+            {
+                /* A new task.  Its time so far is not part of this sample. */
+                for( uxFree = 0; ( uxFree < loadestMAX_TASKS ) && ( xTasks[ uxFree ].xHandle != NULL ); uxFree++ )
+                {
+                }
+
+                if( uxFree < loadestMAX_TASKS )
+                {
+                    pxTask = &( xTasks[ uxFree ] );
+                    memset( pxTask, 0x00, sizeof( TaskLoad_t ) );
+                    pxTask->xHandle = xTaskStatus[ uxIndex ].xHandle;
+                    pxTask->uxTaskNumber = xTaskStatus[ uxIndex ].xTaskNumber;
+                    strncpy( pxTask->cName, xTaskStatus[ uxIndex ].pcTaskName, sizeof( pxTask->cName ) - 1 );
+                    pxTask->xLastRunTime = xTaskStatus[ uxIndex ].ulRunTimeCounter;
+                    pxTask->xSeen = pdTRUE;
+                }
+            }
+            else
+            {
+                ulTime = ( uint32_t ) ( xTaskStatus[ uxIndex ].ulRunTimeCounter - pxTask->xLastRunTime );
+                pxTask->xLastRunTime = xTaskStatus[ uxIndex ].ulRunTimeCounter;
+                pxTask->xSeen = pdTRUE;
+                prvAddSample( &( pxTask->xWindows ), ulTime, prvPerMille( ulTime, ulElapsed ) );
+            }
+        }
+
+        /* Free the entries of tasks that have been deleted, unless the tasks
+         * could not be sampled at all. */
+        if( uxTasks != 0 )
+        {
+            for( uxIndex = 0; uxIndex < loadestMAX_TASKS; uxIndex++ )
+            {
+                if( xTasks[ uxIndex ].xSeen == pdFALSE )
+                {
+                    xTasks[ uxIndex ].xHandle = NULL;
+                }
+            }
+        }
+
+        uxSampleIndex++;
+
+        if( uxSampleIndex == loadestSAMPLES_PER_SECOND )
+        {
+            uxSampleIndex = 0;
+            uxSecondIndex = ( uxSecondIndex + 1 ) % loadestSECONDS;
+        }
+
+        /* The system load is everything but the idle time. */
+        prvCalculateLoad( &xIdle, &xLoad );
+        xSystemLoad.ulLoad1s = 1000 - xLoad.ulLoad1s;
+        xSystemLoad.ulLoad10s = 1000 - xLoad.ulLoad10s;
+        xSystemLoad.ulLoad60s = 1000 - xLoad.ulLoad60s;
+        xSystemLoad.ulLoadAverage = 1000 - xLoad.ulLoadAverage;
+
+        if( pxThresholdCallback != NULL )
+        {
+            if( ( xOverloaded == pdFALSE ) && ( xSystemLoad.ulLoadAverage > ulHigh ) )
+            {
+                xOverloaded = pdTRUE;
+                pxCallback = pxThresholdCallback;
+            }
+            else if( ( xOverloaded != pdFALSE ) && ( xSystemLoad.ulLoadAverage < ulLow ) )
+            {
+                xOverloaded = pdFALSE;
+                pxCallback = pxThresholdCallback;
+            }
+
+            xCallbackOverloaded = xOverloaded;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( pxCallback != NULL )
+    {
+        pxCallback( xSystemLoad.ulLoadAverage, xCallbackOverloaded );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddSample( LoadWindows_t * pxWindows,
+                          uint32_t ulTime,
+                          uint32_t ulSampleLoad )
+{
+    pxWindows->ulSum1s += ulTime - pxWindows->ulSamples[ uxSampleIndex ];
+    pxWindows->ulSamples[ uxSampleIndex ] = ulTime;
+
+    if( uxSampleIndex == 0 )
+    {
+        /* A new second.  The second 10 seconds ago leaves the 10 second
+         * window, and the second 60 seconds ago, whose entry this second
+         * reuses, leaves the 60 second window. */
+        pxWindows->ulSum10s -= pxWindows->ulSeconds[ ( uxSecondIndex + loadestSECONDS - 10 ) % loadestSECONDS ];
+        pxWindows->ulSum60s -= pxWindows->ulSeconds[ uxSecondIndex ];
+        pxWindows->ulSeconds[ uxSecondIndex ] = 0;
+    }
+
+    /* The current second is included as far as it has gone, so the longer
+     * windows move on every sample too. */
+    pxWindows->ulSeconds[ uxSecondIndex ] += ulTime;
+    pxWindows->ulSum10s += ulTime;
+    pxWindows->ulSum60s += ulTime;
+
+    /* Integer arithmetic, so move at least one step towards the sample.  The
+     * first sample starts the average, rather than it rising from zero. */
+    if( pxWindows->xAverageStarted == pdFALSE )
+    {
+        pxWindows->ulAverage = ulSampleLoad * loadestAVERAGE_SCALE;
+        pxWindows->xAverageStarted = pdTRUE;
+    }
+    else if( ( ulSampleLoad * loadestAVERAGE_SCALE ) >= pxWindows->ulAverage )
+    {
+        pxWindows->ulAverage += ( ( ulSampleLoad * loadestAVERAGE_SCALE ) - pxWindows->ulAverage + ( ( 1UL << loadestAVERAGE_SHIFT ) - 1 ) ) >> loadestAVERAGE_SHIFT;
+    }
+    else
+    {
+        pxWindows->ulAverage -= ( pxWindows->ulAverage - ( ulSampleLoad * loadestAVERAGE_SCALE ) + ( ( 1UL << loadestAVERAGE_SHIFT ) - 1 ) ) >> loadestAVERAGE_SHIFT;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCalculateLoad( const LoadWindows_t * pxWindows,
+                              LoadStats_t * pxStats )
+{
+    pxStats->ulLoad1s = prvPerMille( pxWindows->ulSum1s, xElapsed.ulSum1s );
+    pxStats->ulLoad10s = prvPerMille( pxWindows->ulSum10s, xElapsed.ulSum10s );
+    pxStats->ulLoad60s = prvPerMille( pxWindows->ulSum60s, xElapsed.ulSum60s );
+    pxStats->ulLoadAverage = ( pxWindows->ulAverage + ( loadestAVERAGE_SCALE / 2 ) ) / loadestAVERAGE_SCALE;
+}
+/*-----------------------------------------------------------*/
+
+static TaskLoad_t * prvFindTask( TaskHandle_t xTask,
+                                 UBaseType_t uxTaskNumber )
+{
+    UBaseType_t uxIndex;
+
+    for( uxIndex = 0; uxIndex < loadestMAX_TASKS; uxIndex++ )
+    {
+        if( ( xTasks[ uxIndex ].xHandle == xTask ) &&
+            ( ( uxTaskNumber == 0 ) || ( xTasks[ uxIndex ].uxTaskNumber == uxTaskNumber ) ) )
+        {
+            return &( xTasks[ uxIndex ] );
+        }
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPerMille( uint32_t ulPart,
+                             uint32_t ulWhole )
+{
+    uint32_t ulReturn = 0;
+
+    if( ulWhole != 0 )
+    {
+        ulReturn = ( uint32_t ) ( ( ( uint64_t ) ulPart * 1000ULL ) / ulWhole );
+
+        /* Counters are sampled at slightly different times. */
+        if( ulReturn > 1000 )
+        {
+            ulReturn = 1000;
+        }
+    }
+
+    return ulReturn;
+}
+/*-----------------------------------------------------------*/
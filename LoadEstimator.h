@@ -0,0 +1,126 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Windowed CPU load estimation.
+ *
+ * ulTaskGetIdleRunTimePercent() returns the idle time since the scheduler
+ * started, so the longer the demo runs the more slowly it reflects a change in
+ * load.  Instead, a software timer samples the run time counters every
+ * loadestSAMPLE_PERIOD_MS milliseconds and keeps, for the system as a whole and
+ * for each task:
+ *
+ * - The load over the last 1, 10 and 60 seconds.
+ * - An exponentially weighted moving average of the load, which follows
+ *   changes quickly while smoothing out single samples.
+ *
+ * The system load is the share of time not spent in the idle task.  Loads are
+ * in tenths of a percent, so 1000 is 100%.  Queries return the values
+ * calculated at the last sample, so are cheap.
+ *
+ * A callback can be installed that is called when the average system load
+ * rises above one threshold, and again when it falls back below another.
+ */
+
+#ifndef LOAD_ESTIMATOR_H
+#define LOAD_ESTIMATOR_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The interval between samples.  Must divide evenly into one second. */
+#ifndef loadestSAMPLE_PERIOD_MS
+    #define loadestSAMPLE_PERIOD_MS    ( 100 )
+#endif
+
+/* The most tasks whose load is estimated.  The system load is estimated
+ * however many tasks there are. */
+#ifndef loadestMAX_TASKS
+    #define loadestMAX_TASKS    ( 96 )
+#endif
+
+/* Each sample moves the average 1 / ( 2 ^ loadestAVERAGE_SHIFT ) of the way
+ * towards the sampled load. */
+#ifndef loadestAVERAGE_SHIFT
+    #define loadestAVERAGE_SHIFT    ( 4 )
+#endif
+
+#if ( ( 1000 % loadestSAMPLE_PERIOD_MS ) != 0 )
+    #error loadestSAMPLE_PERIOD_MS must divide evenly into 1000
+#endif
+
+typedef struct xLOAD_STATS
+{
+    uint32_t ulLoad1s;          /* Tenths of a percent over the last second... */
+    uint32_t ulLoad10s;         /* ...the last 10 seconds... */
+    uint32_t ulLoad60s;         /* ...and the last 60 seconds. */
+    uint32_t ulLoadAverage;     /* The exponentially weighted moving average, in tenths of a percent. */
+} LoadStats_t;
+
+/*
+ * Called from the timer service task when the average system load rises above
+ * the high threshold (xOverloaded is pdTRUE), or falls back below the low
+ * threshold (xOverloaded is pdFALSE).  Must not block.
+ */
+typedef void (* LoadThresholdCallback_t)( uint32_t ulLoadAverage,
+                                          BaseType_t xOverloaded );
+
+/*
+ * Create and start the sampling timer.  Returns pdFAIL if the timer could not
+ * be created.
+ */
+BaseType_t xLoadEstimatorStart( void );
+
+/*
+ * Copy the load of the system as a whole into pxStats.
+ */
+void vLoadEstimatorGetSystemLoad( LoadStats_t * pxStats );
+
+/*
+ * Copy the load of xTask into pxStats.  Returns pdFAIL if the task has not yet
+ * been sampled, or there were more than loadestMAX_TASKS tasks when it was
+ * created.
+ */
+BaseType_t xLoadEstimatorGetTaskLoad( TaskHandle_t xTask,
+                                      LoadStats_t * pxStats );
+
+/*
+ * Install pxCallback, which is called as described above.  The thresholds are
+ * in tenths of a percent, and ulLowThreshold must be below ulHighThreshold so
+ * the callback is not called on every sample when the load is close to a
+ * threshold.  Pass NULL to remove the callback.
+ */
+void vLoadEstimatorSetThresholdCallback( uint32_t ulHighThreshold,
+                                         uint32_t ulLowThreshold,
+                                         LoadThresholdCallback_t pxCallback );
+
+/*
+ * Print the load of the system and of each task.  Makes Windows system calls,
+ * so must be called from a critical section.
+ */
+void vLoadEstimatorPrint( void );
+
+#endif /* LOAD_ESTIMATOR_H */
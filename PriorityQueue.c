@@ -0,0 +1,398 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of PriorityQueue.h.
+ *
+ * The queue's storage area is split into three arrays of uxLength entries:
+ * the heap, a stack of free message slots, and the message slots themselves.
+ * pxHeap[ 0 ] is always the next message to deliver.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "PriorityQueue.h"
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns pdTRUE if pxA should be delivered before pxB.
+ */
+static BaseType_t prvIsHigher( const PriorityQueueEntry_t * pxA,
+                               const PriorityQueueEntry_t * pxB );
+
+/*
+ * Add a message to, or remove the highest priority message from, a queue that
+ * is known not to be full or empty respectively.  Must be called from a
+ * critical section.
+ */
+static void prvPush( PriorityQueueHandle_t xQueue,
+                     const void * pvItemToQueue,
+                     UBaseType_t uxPriority );
+static void prvPop( PriorityQueueHandle_t xQueue,
+                    void * pvBuffer,
+                    UBaseType_t * puxPriority );
+
+/*
+ * Initialise the state of a newly created queue.
+ */
+static void prvInitialiseQueue( PriorityQueueHandle_t xQueue,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxItemSize,
+                                uint8_t * pucStorage );
+
+/*-----------------------------------------------------------*/
+
+PriorityQueueHandle_t xPriorityQueueCreate( UBaseType_t uxLength,
+                                            UBaseType_t uxItemSize )
+{
+    PriorityQueueHandle_t xQueue;
+
+    /* The state and the storage area are allocated in one block. */
+    xQueue = ( PriorityQueueHandle_t ) pvPortMalloc( sizeof( StaticPriorityQueue_t ) + priorityqueueSTORAGE_BYTES( uxLength, uxItemSize ) );
+
+    if( xQueue != NULL )
+    {
+        prvInitialiseQueue( xQueue, uxLength, uxItemSize, ( uint8_t * ) ( xQueue + 1 ) );
+        xQueue->ucStaticallyAllocated = pdFALSE;
+    }
+
+    return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+PriorityQueueHandle_t xPriorityQueueCreateStatic( UBaseType_t uxLength,
+                                                  UBaseType_t uxItemSize,
+                                                  uint8_t * pucQueueStorage,
+                                                  StaticPriorityQueue_t * pxStaticQueue )
+{
+    configASSERT( pxStaticQueue );
+    configASSERT( pucQueueStorage );
+    configASSERT( ( ( ( size_t ) pucQueueStorage ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+    prvInitialiseQueue( pxStaticQueue, uxLength, uxItemSize, pucQueueStorage );
+    pxStaticQueue->ucStaticallyAllocated = pdTRUE;
+
+    return pxStaticQueue;
+}
+/*-----------------------------------------------------------*/
+
+void vPriorityQueueDelete( PriorityQueueHandle_t xQueue )
+{
+    configASSERT( xWaitListIsEmpty( &( xQueue->xTasksWaitingToSend ) ) );
+    configASSERT( xWaitListIsEmpty( &( xQueue->xTasksWaitingToReceive ) ) );
+
+    if( xQueue->ucStaticallyAllocated == pdFALSE )
+    {
+        vPortFree( xQueue );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueSend( PriorityQueueHandle_t xQueue,
+                               const void * pvItemToQueue,
+                               UBaseType_t uxPriority,
+                               TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    TaskHandle_t xTaskToWake;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+            {
+                prvPush( xQueue, pvItemToQueue, uxPriority );
+                xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+                taskEXIT_CRITICAL();
+
+                vWaitListNotify( xTaskToWake );
+                return pdPASS;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xQueue->xTasksWaitingToSend ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xQueue->xTasksWaitingToSend ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueReceive( PriorityQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  UBaseType_t * puxPriority,
+                                  TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    TaskHandle_t xTaskToWake;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                prvPop( xQueue, pvBuffer, puxPriority );
+                xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+                taskEXIT_CRITICAL();
+
+                vWaitListNotify( xTaskToWake );
+                return pdPASS;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xQueue->xTasksWaitingToReceive ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xQueue->xTasksWaitingToReceive ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueSendFromISR( PriorityQueueHandle_t xQueue,
+                                      const void * pvItemToQueue,
+                                      UBaseType_t uxPriority,
+                                      BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    TaskHandle_t xTaskToWake = NULL;
+    BaseType_t xReturn = errQUEUE_FULL;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+        {
+            prvPush( xQueue, pvItemToQueue, uxPriority );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    vWaitListNotifyFromISR( xTaskToWake, pxHigherPriorityTaskWoken );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPriorityQueueReceiveFromISR( PriorityQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         UBaseType_t * puxPriority,
+                                         BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    TaskHandle_t xTaskToWake = NULL;
+    BaseType_t xReturn = errQUEUE_EMPTY;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            prvPop( xQueue, pvBuffer, puxPriority );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    vWaitListNotifyFromISR( xTaskToWake, pxHigherPriorityTaskWoken );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPriorityQueueMessagesWaiting( PriorityQueueHandle_t xQueue )
+{
+    return xQueue->uxMessagesWaiting;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsHigher( const PriorityQueueEntry_t * pxA,
+                               const PriorityQueueEntry_t * pxB )
+{
+    BaseType_t xReturn;
+
+    if( pxA->uxPriority != pxB->uxPriority )
+    {
+        xReturn = ( pxA->uxPriority > pxB->uxPriority ) ? pdTRUE : pdFALSE;
+    }
+    else
+    {
+        /* The sequence number is compared as a signed difference so the
+         * order is still correct after the counter wraps. */
+        xReturn = ( ( int32_t ) ( pxA->ulSequence - pxB->ulSequence ) < 0 ) ? pdTRUE : pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPush( PriorityQueueHandle_t xQueue,
+                     const void * pvItemToQueue,
+                     UBaseType_t uxPriority )
+{
+    PriorityQueueEntry_t xNew;
+    UBaseType_t uxIndex, uxParent;
+
+    /* Take a free slot from the top of the free slot stack and copy the
+     * message into it. */
+    xNew.uxSlot = xQueue->puxFreeSlots[ xQueue->uxLength - xQueue->uxMessagesWaiting - 1 ];
+    xNew.uxPriority = uxPriority;
+    xNew.ulSequence = xQueue->ulNextSequence++;
+    memcpy( &( xQueue->pucItems[ xNew.uxSlot * xQueue->uxItemSize ] ), pvItemToQueue, xQueue->uxItemSize );
+
+    /* Sift the new entry up from the end of the heap. */
+    uxIndex = xQueue->uxMessagesWaiting;
+
+    while( uxIndex > 0 )
+    {
+        uxParent = ( uxIndex - 1 ) / 2;
+
+        if( prvIsHigher( &xNew, &( xQueue->pxHeap[ uxParent ] ) ) == pdFALSE )
+        {
+            break;
+        }
+
+        xQueue->pxHeap[ uxIndex ] = xQueue->pxHeap[ uxParent ];
+        uxIndex = uxParent;
+    }
+
+    xQueue->pxHeap[ uxIndex ] = xNew;
+    xQueue->uxMessagesWaiting++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPop( PriorityQueueHandle_t xQueue,
+                    void * pvBuffer,
+                    UBaseType_t * puxPriority )
+{
+    PriorityQueueEntry_t xLast;
+    UBaseType_t uxIndex = 0, uxChild, uxCount;
+
+    memcpy( pvBuffer, &( xQueue->pucItems[ xQueue->pxHeap[ 0 ].uxSlot * xQueue->uxItemSize ] ), xQueue->uxItemSize );
+
+    if( puxPriority != NULL )
+    {
+        *puxPriority = xQueue->pxHeap[ 0 ].uxPriority;
+    }
+
+    /* Return the slot to the free slot stack. */
+    uxCount = --( xQueue->uxMessagesWaiting );
+    xQueue->puxFreeSlots[ xQueue->uxLength - uxCount - 1 ] = xQueue->pxHeap[ 0 ].uxSlot;
+
+    /* Sift the last entry down from the root to fill the gap. */
+    xLast = xQueue->pxHeap[ uxCount ];
+
+    for( ; ; )
+    {
+        uxChild = ( 2 * uxIndex ) + 1;
+
+        if( uxChild >= uxCount )
+        {
+            break;
+        }
+
+        if( ( ( uxChild + 1 ) < uxCount ) && ( prvIsHigher( &( xQueue->pxHeap[ uxChild + 1 ] ), &( xQueue->pxHeap[ uxChild ] ) ) != pdFALSE ) )
+        {
+            uxChild++;
+        }
+
+        if( prvIsHigher( &( xQueue->pxHeap[ uxChild ] ), &xLast ) == pdFALSE )
+        {
+            break;
+        }
+
+        xQueue->pxHeap[ uxIndex ] = xQueue->pxHeap[ uxChild ];
+        uxIndex = uxChild;
+    }
+
+    xQueue->pxHeap[ uxIndex ] = xLast;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseQueue( PriorityQueueHandle_t xQueue,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxItemSize,
+                                uint8_t * pucStorage )
+{
+    UBaseType_t uxSlot;
+
+    configASSERT( uxLength > ( UBaseType_t ) 0 );
+    configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+    xQueue->pxHeap = ( PriorityQueueEntry_t * ) pucStorage;
+    xQueue->puxFreeSlots = ( UBaseType_t * ) &( xQueue->pxHeap[ uxLength ] );
+    xQueue->pucItems = ( uint8_t * ) &( xQueue->puxFreeSlots[ uxLength ] );
+    xQueue->uxLength = uxLength;
+    xQueue->uxItemSize = uxItemSize;
+    xQueue->uxMessagesWaiting = 0;
+    xQueue->ulNextSequence = 0;
+    vWaitListInitialise( &( xQueue->xTasksWaitingToSend ) );
+    vWaitListInitialise( &( xQueue->xTasksWaitingToReceive ) );
+
+    for( uxSlot = 0; uxSlot < uxLength; uxSlot++ )
+    {
+        xQueue->puxFreeSlots[ uxSlot ] = uxSlot;
+    }
+}
+/*-----------------------------------------------------------*/
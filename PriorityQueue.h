@@ -0,0 +1,138 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A queue that delivers the highest priority message it holds first, and
+ * messages of equal priority in the order they were sent.
+ *
+ * xQueueSendToFront() and xQueueSendToBack() only give two delivery positions.
+ * Here every message carries its own priority, so urgent commands can overtake
+ * any number of levels of bulk traffic.  Messages are kept in a binary heap,
+ * so sending and receiving are both O(log n) in the number of messages held.
+ * Only the small heap entries move as the heap is reordered - each message is
+ * copied in once and out once.
+ *
+ * Blocking behaves as for the kernel's queues, see WaitList.h.  Priority
+ * queues cannot be members of a queue set and are not seen by the trace
+ * recorder.
+ */
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include "FreeRTOS.h"
+#include "WaitList.h"
+
+/* One heap entry, which orders a message held in the queue's storage area. */
+typedef struct xPRIORITY_QUEUE_ENTRY
+{
+    UBaseType_t uxPriority;
+    uint32_t ulSequence;    /* Orders messages of equal priority. */
+    UBaseType_t uxSlot;     /* Where the message is held. */
+} PriorityQueueEntry_t;
+
+/* The number of bytes of storage a statically allocated queue that holds
+ * uxLength messages of uxItemSize bytes needs. */
+#define priorityqueueSTORAGE_BYTES( uxLength, uxItemSize ) \
+    ( ( uxLength ) * ( sizeof( PriorityQueueEntry_t ) + sizeof( UBaseType_t ) + ( uxItemSize ) ) )
+
+/* The structure is only visible so queues can be statically allocated - its
+ * members must not be accessed directly. */
+typedef struct xPRIORITY_QUEUE
+{
+    PriorityQueueEntry_t * pxHeap;
+    UBaseType_t * puxFreeSlots;
+    uint8_t * pucItems;
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    volatile UBaseType_t uxMessagesWaiting;
+    uint32_t ulNextSequence;
+    WaitList_t xTasksWaitingToSend;
+    WaitList_t xTasksWaitingToReceive;
+    uint8_t ucStaticallyAllocated;
+} StaticPriorityQueue_t;
+
+typedef StaticPriorityQueue_t * PriorityQueueHandle_t;
+
+/*
+ * Create a queue that can hold uxLength messages of uxItemSize bytes each.
+ * Returns NULL if there is not enough heap.
+ */
+PriorityQueueHandle_t xPriorityQueueCreate( UBaseType_t uxLength,
+                                            UBaseType_t uxItemSize );
+
+/*
+ * As xPriorityQueueCreate(), but using pucQueueStorage, which must be at least
+ * priorityqueueSTORAGE_BYTES( uxLength, uxItemSize ) bytes and aligned to
+ * portBYTE_ALIGNMENT, to hold the messages and pxStaticQueue to hold the
+ * queue's state.
+ */
+PriorityQueueHandle_t xPriorityQueueCreateStatic( UBaseType_t uxLength,
+                                                  UBaseType_t uxItemSize,
+                                                  uint8_t * pucQueueStorage,
+                                                  StaticPriorityQueue_t * pxStaticQueue );
+
+/*
+ * Delete a queue.  No tasks can be blocked on the queue when it is deleted.
+ */
+void vPriorityQueueDelete( PriorityQueueHandle_t xQueue );
+
+/*
+ * Send a message of priority uxPriority.  Larger numbers are higher
+ * priorities, as with task priorities.  Equivalent to xQueueSend() and
+ * xQueueSendFromISR() in every other respect.
+ */
+BaseType_t xPriorityQueueSend( PriorityQueueHandle_t xQueue,
+                               const void * pvItemToQueue,
+                               UBaseType_t uxPriority,
+                               TickType_t xTicksToWait );
+
+BaseType_t xPriorityQueueSendFromISR( PriorityQueueHandle_t xQueue,
+                                      const void * pvItemToQueue,
+                                      UBaseType_t uxPriority,
+                                      BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Receive the highest priority message.  If puxPriority is not NULL the
+ * message's priority is written to it.  Equivalent to xQueueReceive() and
+ * xQueueReceiveFromISR() in every other respect.
+ */
+BaseType_t xPriorityQueueReceive( PriorityQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  UBaseType_t * puxPriority,
+                                  TickType_t xTicksToWait );
+
+BaseType_t xPriorityQueueReceiveFromISR( PriorityQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         UBaseType_t * puxPriority,
+                                         BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Returns the number of messages in the queue.
+ */
+UBaseType_t uxPriorityQueueMessagesWaiting( PriorityQueueHandle_t xQueue );
+
+#endif /* PRIORITY_QUEUE_H */
@@ -0,0 +1,441 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of QueuePolicy.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "QueuePolicy.h"
+
+typedef struct xQUEUE_POLICY
+{
+    QueueHandle_t xQueue;
+    const char * pcName;
+    eQueuePolicy ePolicy;
+    TickType_t xBlockTime;
+    UBaseType_t uxLength;
+    QueuePolicyStats_t xStats;
+    configRUN_TIME_COUNTER_TYPE xFullSince;    /* When the queue last became full, if xIsFull is pdTRUE. */
+    BaseType_t xIsFull;
+    BaseType_t xSampleUnread;                  /* Sample-and-hold only. */
+    uint8_t * pucDiscarded;                    /* Drop-oldest only - where the discarded message is received to. */
+    struct xQUEUE_POLICY * pxNext;             /* The next policy queue in the list searched by xQueuePolicyFind(). */
+} QueuePolicy_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Update the counters after a send.  xSent is pdTRUE if the new message was
+ * placed in the queue, xDiscarded is pdTRUE if an older message was lost to
+ * make room for it, and uxMessagesWaiting is the queue's depth after the send.
+ * Must be called from a critical section.
+ */
+static void prvRecordSend( QueuePolicy_t * pxPolicyQueue,
+                           BaseType_t xSent,
+                           BaseType_t xDiscarded,
+                           UBaseType_t uxMessagesWaiting );
+
+/*
+ * Receive from, or for sample-and-hold peek, the underlying queue and update
+ * the counters.  May only be called with the scheduler suspended when
+ * xTicksToWait is 0.
+ */
+static BaseType_t prvReceive( QueuePolicy_t * pxPolicyQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait );
+
+/*-----------------------------------------------------------*/
+
+/* All the policy queues, most recently created first. */
+static QueuePolicy_t * pxPolicyQueues = NULL;
+
+/*-----------------------------------------------------------*/
+
+QueuePolicyHandle_t xQueuePolicyCreate( const char * pcName,
+                                        UBaseType_t uxLength,
+                                        UBaseType_t uxItemSize,
+                                        eQueuePolicy ePolicy,
+                                        TickType_t xBlockTime )
+{
+    QueuePolicy_t * pxPolicyQueue;
+
+    configASSERT( pcName );
+    configASSERT( ( ePolicy != eQueuePolicySampleAndHold ) || ( uxLength == 1 ) );
+
+    /* The structure and the buffer for discarded messages are allocated in
+     * one block. */
+    pxPolicyQueue = ( QueuePolicy_t * ) pvPortMalloc( sizeof( QueuePolicy_t ) + uxItemSize );
+
+    if( pxPolicyQueue != NULL )
+    {
+        memset( pxPolicyQueue, 0x00, sizeof( QueuePolicy_t ) );
+        pxPolicyQueue->xQueue = xQueueCreate( uxLength, uxItemSize );
+
+        if( pxPolicyQueue->xQueue != NULL )
+        {
+            pxPolicyQueue->pcName = pcName;
+            pxPolicyQueue->ePolicy = ePolicy;
+            pxPolicyQueue->xBlockTime = xBlockTime;
+            pxPolicyQueue->uxLength = uxLength;
+            pxPolicyQueue->pucDiscarded = ( uint8_t * ) ( pxPolicyQueue + 1 );
+
+            vQueueAddToRegistry( pxPolicyQueue->xQueue, pcName );
+
+            taskENTER_CRITICAL();
+            {
+                pxPolicyQueue->pxNext = pxPolicyQueues;
+                pxPolicyQueues = pxPolicyQueue;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            vPortFree( pxPolicyQueue );
+            pxPolicyQueue = NULL;
+        }
+    }
+
+    return pxPolicyQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePolicySend( QueuePolicyHandle_t xPolicyQueue,
+                             const void * pvItemToQueue )
+{
+    QueuePolicy_t * pxPolicyQueue = xPolicyQueue;
+    BaseType_t xReturn, xDiscarded = pdFALSE, xMustBlock = pdFALSE;
+
+    /* The send and the accounting are done with the scheduler suspended, so
+     * a higher priority receiver cannot run between them and leave the
+     * counters describing a queue that no longer exists.  The queue calls
+     * must not block, so only a send that has to block is made with the
+     * scheduler running. */
+    vTaskSuspendAll();
+    {
+        switch( pxPolicyQueue->ePolicy )
+        {
+            case eQueuePolicyDropOldest:
+                xReturn = xQueueSend( pxPolicyQueue->xQueue, pvItemToQueue, 0 );
+
+                if( ( xReturn != pdPASS ) && ( xQueueReceive( pxPolicyQueue->xQueue, pxPolicyQueue->pucDiscarded, 0 ) == pdPASS ) )
+                {
+                    xDiscarded = pdTRUE;
+                    xReturn = xQueueSend( pxPolicyQueue->xQueue, pvItemToQueue, 0 );
+                }
+
+                break;
+
+            case eQueuePolicySampleAndHold:
+                xReturn = xQueueOverwrite( pxPolicyQueue->xQueue, pvItemToQueue );
+                break;
+
+            case eQueuePolicyBlock:
+                xReturn = xQueueSend( pxPolicyQueue->xQueue, pvItemToQueue, 0 );
+
+                if( ( xReturn != pdPASS ) && ( pxPolicyQueue->xBlockTime != 0 ) )
+                {
+                    xMustBlock = pdTRUE;
+                }
+
+                break;
+
+            case eQueuePolicyDropNewest:
+            default:
+                xReturn = xQueueSend( pxPolicyQueue->xQueue, pvItemToQueue, 0 );
+                break;
+        }
+
+        /* Interrupts can still send, so the counters are updated in a
+         * critical section. */
+        if( xMustBlock == pdFALSE )
+        {
+            taskENTER_CRITICAL();
+            {
+                prvRecordSend( pxPolicyQueue, xReturn, xDiscarded, uxQueueMessagesWaiting( pxPolicyQueue->xQueue ) );
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    if( xMustBlock != pdFALSE )
+    {
+        /* The queue was full, so wait for space.  A receiver may run before
+         * the counters are updated, in which case the high-water mark and the
+         * time full use the depth after it ran. */
+        xReturn = xQueueSend( pxPolicyQueue->xQueue, pvItemToQueue, pxPolicyQueue->xBlockTime );
+
+        taskENTER_CRITICAL();
+        {
+            prvRecordSend( pxPolicyQueue, xReturn, pdFALSE, uxQueueMessagesWaiting( pxPolicyQueue->xQueue ) );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePolicySendFromISR( QueuePolicyHandle_t xPolicyQueue,
+                                    const void * pvItemToQueue,
+                                    BaseType_t * pxHigherPriorityTaskWoken )
+{
+    QueuePolicy_t * pxPolicyQueue = xPolicyQueue;
+    BaseType_t xReturn, xDiscarded = pdFALSE;
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        switch( pxPolicyQueue->ePolicy )
+        {
+            case eQueuePolicyDropOldest:
+                xReturn = xQueueSendFromISR( pxPolicyQueue->xQueue, pvItemToQueue, pxHigherPriorityTaskWoken );
+
+                if( ( xReturn != pdPASS ) && ( xQueueReceiveFromISR( pxPolicyQueue->xQueue, pxPolicyQueue->pucDiscarded, pxHigherPriorityTaskWoken ) == pdPASS ) )
+                {
+                    xDiscarded = pdTRUE;
+                    xReturn = xQueueSendFromISR( pxPolicyQueue->xQueue, pvItemToQueue, pxHigherPriorityTaskWoken );
+                }
+
+                break;
+
+            case eQueuePolicySampleAndHold:
+                xReturn = xQueueOverwriteFromISR( pxPolicyQueue->xQueue, pvItemToQueue, pxHigherPriorityTaskWoken );
+                break;
+
+            case eQueuePolicyBlock:
+            case eQueuePolicyDropNewest:
+            default:
+                /* Interrupts cannot block, so eQueuePolicyBlock drops the new
+                 * message too. */
+                xReturn = xQueueSendFromISR( pxPolicyQueue->xQueue, pvItemToQueue, pxHigherPriorityTaskWoken );
+                break;
+        }
+
+        prvRecordSend( pxPolicyQueue, xReturn, xDiscarded, uxQueueMessagesWaitingFromISR( pxPolicyQueue->xQueue ) );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePolicyReceive( QueuePolicyHandle_t xPolicyQueue,
+                                void * pvBuffer,
+                                TickType_t xTicksToWait )
+{
+    QueuePolicy_t * pxPolicyQueue = xPolicyQueue;
+    BaseType_t xReturn;
+
+    /* As in xQueuePolicySend(), a receive that does not have to wait is made
+     * with the scheduler suspended until the accounting is done. */
+    vTaskSuspendAll();
+    {
+        xReturn = prvReceive( pxPolicyQueue, pvBuffer, 0 );
+    }
+    ( void ) xTaskResumeAll();
+
+    if( ( xReturn != pdPASS ) && ( xTicksToWait != 0 ) )
+    {
+        xReturn = prvReceive( pxPolicyQueue, pvBuffer, xTicksToWait );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReceive( QueuePolicy_t * pxPolicyQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait )
+{
+    BaseType_t xReturn;
+
+    /* A sample-and-hold queue is peeked, so the sample is still there to be
+     * read again if nothing newer has been written by the next read. */
+    if( pxPolicyQueue->ePolicy == eQueuePolicySampleAndHold )
+    {
+        xReturn = xQueuePeek( pxPolicyQueue->xQueue, pvBuffer, xTicksToWait );
+    }
+    else
+    {
+        xReturn = xQueueReceive( pxPolicyQueue->xQueue, pvBuffer, xTicksToWait );
+    }
+
+    if( xReturn == pdPASS )
+    {
+        taskENTER_CRITICAL();
+        {
+            pxPolicyQueue->xSampleUnread = pdFALSE;
+
+            if( pxPolicyQueue->xIsFull != pdFALSE )
+            {
+                pxPolicyQueue->xStats.xTimeFull += portGET_RUN_TIME_COUNTER_VALUE() - pxPolicyQueue->xFullSince;
+                pxPolicyQueue->xIsFull = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vQueuePolicyGetStats( QueuePolicyHandle_t xPolicyQueue,
+                           QueuePolicyStats_t * pxStats )
+{
+    QueuePolicy_t * pxPolicyQueue = xPolicyQueue;
+
+    taskENTER_CRITICAL();
+    {
+        *pxStats = pxPolicyQueue->xStats;
+
+        /* Include the time the queue has been full so far if it is full
+         * now. */
+        if( pxPolicyQueue->xIsFull != pdFALSE )
+        {
+            pxStats->xTimeFull += portGET_RUN_TIME_COUNTER_VALUE() - pxPolicyQueue->xFullSince;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+eQueuePolicy eQueuePolicyGet( QueuePolicyHandle_t xPolicyQueue )
+{
+    return xPolicyQueue->ePolicy;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcQueuePolicyToString( eQueuePolicy ePolicy )
+{
+    const char * pcReturn;
+
+    switch( ePolicy )
+    {
+        case eQueuePolicyBlock:
+            pcReturn = "block";
+            break;
+
+        case eQueuePolicyDropNewest:
+            pcReturn = "drop-newest";
+            break;
+
+        case eQueuePolicyDropOldest:
+            pcReturn = "drop-oldest";
+            break;
+
+        case eQueuePolicySampleAndHold:
+            pcReturn = "sample-and-hold";
+            break;
+
+        default:
+            pcReturn = "unknown";
+            break;
+    }
+
+    return pcReturn;
+}
+/*-----------------------------------------------------------*/
+
+QueuePolicyHandle_t xQueuePolicyFind( const char * pcName )
+{
+    QueuePolicy_t * pxPolicyQueue;
+
+    /* Queues are only ever added to the front of the list, so it can be
+     * walked without a critical section once the head has been read. */
+    taskENTER_CRITICAL();
+    {
+        pxPolicyQueue = pxPolicyQueues;
+    }
+    taskEXIT_CRITICAL();
+
+    while( ( pxPolicyQueue != NULL ) && ( strcmp( pxPolicyQueue->pcName, pcName ) != 0 ) )
+    {
+        pxPolicyQueue = pxPolicyQueue->pxNext;
+    }
+
+    return pxPolicyQueue;
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueuePolicyGetQueue( QueuePolicyHandle_t xPolicyQueue )
+{
+    return xPolicyQueue->xQueue;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordSend( QueuePolicy_t * pxPolicyQueue,
+                           BaseType_t xSent,
+                           BaseType_t xDiscarded,
+                           UBaseType_t uxMessagesWaiting )
+{
+    if( xSent == pdPASS )
+    {
+        pxPolicyQueue->xStats.ulSent++;
+    }
+    else
+    {
+        pxPolicyQueue->xStats.ulDropped++;
+    }
+
+    if( xDiscarded != pdFALSE )
+    {
+        pxPolicyQueue->xStats.ulDropped++;
+    }
+
+    if( uxMessagesWaiting > pxPolicyQueue->xStats.uxHighWaterMark )
+    {
+        pxPolicyQueue->xStats.uxHighWaterMark = uxMessagesWaiting;
+    }
+
+    if( pxPolicyQueue->ePolicy == eQueuePolicySampleAndHold )
+    {
+        /* A sample-and-hold queue is always full once the first sample has
+         * been written, so full time is not measured.  Instead count samples
+         * that were overwritten before anybody read them. */
+        if( ( xSent == pdPASS ) && ( pxPolicyQueue->xSampleUnread != pdFALSE ) )
+        {
+            pxPolicyQueue->xStats.ulDropped++;
+        }
+
+        pxPolicyQueue->xSampleUnread = pdTRUE;
+    }
+    else if( ( uxMessagesWaiting >= pxPolicyQueue->uxLength ) && ( pxPolicyQueue->xIsFull == pdFALSE ) )
+    {
+        pxPolicyQueue->xIsFull = pdTRUE;
+        pxPolicyQueue->xFullSince = portGET_RUN_TIME_COUNTER_VALUE();
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,138 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Kernel queues with an explicit policy for what happens when a message is
+ * sent to a full queue, and counters that record when it happened.
+ *
+ * A send with a block time of 0 that fails because the queue is full is easy
+ * to ignore, and the message is then lost without trace.  Sending through a
+ * policy queue makes the choice explicit and always counts the loss:
+ *
+ * eQueuePolicyBlock:         Block for up to the block time given when the
+ *                            queue was created, then drop the new message.
+ *                            From an interrupt the new message is dropped
+ *                            immediately.
+ * eQueuePolicyDropNewest:    Drop the new message.
+ * eQueuePolicyDropOldest:    Discard the oldest message to make room, so the
+ *                            queue acts as a ring that holds the most recent
+ *                            messages.  Works for any queue length.
+ * eQueuePolicySampleAndHold: The queue holds one message, which each send
+ *                            overwrites and each receive reads without
+ *                            removing, so receivers always see the latest
+ *                            sample.  A sample that is overwritten before it
+ *                            was read counts as a drop.
+ *
+ * Each policy queue is created with a name, which is also added to the queue
+ * registry so the kernel aware debugger and trace tools show it, and can be
+ * found again by that name with xQueuePolicyFind().
+ *
+ * Receives should also go through xQueuePolicyReceive(), so the time the
+ * queue spends full can be measured and sample-and-hold queues are peeked
+ * rather than emptied.
+ */
+
+#ifndef QUEUE_POLICY_H
+#define QUEUE_POLICY_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+typedef enum
+{
+    eQueuePolicyBlock = 0,
+    eQueuePolicyDropNewest,
+    eQueuePolicyDropOldest,
+    eQueuePolicySampleAndHold
+} eQueuePolicy;
+
+typedef struct xQUEUE_POLICY_STATS
+{
+    uint32_t ulSent;                          /* Messages successfully placed in the queue. */
+    uint32_t ulDropped;                       /* Messages lost, as defined by the queue's policy. */
+    UBaseType_t uxHighWaterMark;              /* The most messages the queue has held at once. */
+    configRUN_TIME_COUNTER_TYPE xTimeFull;    /* Time spent full, in run time stats counter units. */
+} QueuePolicyStats_t;
+
+typedef struct xQUEUE_POLICY * QueuePolicyHandle_t;
+
+/*
+ * Create a queue that can hold uxLength items of uxItemSize bytes each, and
+ * that handles overflow as ePolicy says.  xBlockTime is only used by
+ * eQueuePolicyBlock, and uxLength must be 1 for eQueuePolicySampleAndHold.
+ * pcName must remain valid for the life of the queue.  Returns NULL if there
+ * is not enough heap.
+ */
+QueuePolicyHandle_t xQueuePolicyCreate( const char * pcName,
+                                        UBaseType_t uxLength,
+                                        UBaseType_t uxItemSize,
+                                        eQueuePolicy ePolicy,
+                                        TickType_t xBlockTime );
+
+/*
+ * Send a message, applying the queue's policy if the queue is full.  Returns
+ * pdPASS if the new message was placed in the queue, even if an older message
+ * had to be discarded to make room for it.
+ */
+BaseType_t xQueuePolicySend( QueuePolicyHandle_t xPolicyQueue,
+                             const void * pvItemToQueue );
+BaseType_t xQueuePolicySendFromISR( QueuePolicyHandle_t xPolicyQueue,
+                                    const void * pvItemToQueue,
+                                    BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Equivalent to xQueueReceive(), except that sample-and-hold queues are
+ * peeked.
+ */
+BaseType_t xQueuePolicyReceive( QueuePolicyHandle_t xPolicyQueue,
+                                void * pvBuffer,
+                                TickType_t xTicksToWait );
+
+/*
+ * Copy the queue's counters into pxStats.
+ */
+void vQueuePolicyGetStats( QueuePolicyHandle_t xPolicyQueue,
+                           QueuePolicyStats_t * pxStats );
+
+/*
+ * Returns the queue's policy, or a printable name for a policy.
+ */
+eQueuePolicy eQueuePolicyGet( QueuePolicyHandle_t xPolicyQueue );
+const char * pcQueuePolicyToString( eQueuePolicy ePolicy );
+
+/*
+ * Returns the policy queue created with the name pcName, or NULL if there is
+ * none.
+ */
+QueuePolicyHandle_t xQueuePolicyFind( const char * pcName );
+
+/*
+ * Returns the underlying kernel queue, for example so it can be added to a
+ * queue set.  Sending to it directly bypasses the policy and counters.
+ */
+QueueHandle_t xQueuePolicyGetQueue( QueuePolicyHandle_t xPolicyQueue );
+
+#endif /* QUEUE_POLICY_H */
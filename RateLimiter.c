@@ -0,0 +1,214 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of RateLimiter.h.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "RateLimiter.h"
+
+/* The number of credits that make one token.  Each tick adds
+ * ulEventsPerSecond credits, so the bucket gains ulEventsPerSecond tokens a
+ * second without any division. */
+#define ratelimitCREDITS_PER_TOKEN    ( ( uint32_t ) configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Add the credits earned since the bucket was last refilled, then, if there
+ * are events pending and a token is available, spend the token to deliver
+ * them.  Returns pdTRUE if the task should be woken.  Must be called from a
+ * critical section.
+ */
+static BaseType_t prvRefillAndDeliver( RateLimiter_t * pxLimiter );
+
+/*-----------------------------------------------------------*/
+
+/* All the initialised limiters, for vRateLimiterTickHook(). */
+static RateLimiter_t * pxRateLimiters = NULL;
+
+/*-----------------------------------------------------------*/
+
+void vRateLimiterInitialise( RateLimiter_t * pxLimiter,
+                             TaskHandle_t xTaskToNotify,
+                             UBaseType_t uxIndexToNotify,
+                             uint32_t ulEventsPerSecond,
+                             uint32_t ulBurst )
+{
+    configASSERT( xTaskToNotify );
+    configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+    configASSERT( ulEventsPerSecond > 0 );
+    configASSERT( ulBurst > 0 );
+
+    pxLimiter->xTaskToNotify = xTaskToNotify;
+    pxLimiter->uxIndexToNotify = uxIndexToNotify;
+    pxLimiter->ulEventsPerSecond = ulEventsPerSecond;
+    pxLimiter->ulCreditLimit = ulBurst * ratelimitCREDITS_PER_TOKEN;
+    pxLimiter->ulCredit = pxLimiter->ulCreditLimit;
+    pxLimiter->xLastRefillTime = xTaskGetTickCount();
+    pxLimiter->ulPending = 0;
+    pxLimiter->ulDelivered = 0;
+    pxLimiter->xStats.ulEvents = 0;
+    pxLimiter->xStats.ulWakeUps = 0;
+    pxLimiter->xStats.ulCoalesced = 0;
+    pxLimiter->xStats.ulLargestBatch = 0;
+
+    taskENTER_CRITICAL();
+    {
+        pxLimiter->pxNext = pxRateLimiters;
+        pxRateLimiters = pxLimiter;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRateLimiterEventFromISR( RateLimiter_t * pxLimiter,
+                                     BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xWake;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pxLimiter->xStats.ulEvents++;
+        pxLimiter->ulPending++;
+        xWake = prvRefillAndDeliver( pxLimiter );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xWake != pdFALSE )
+    {
+        vTaskNotifyGiveIndexedFromISR( pxLimiter->xTaskToNotify, pxLimiter->uxIndexToNotify, pxHigherPriorityTaskWoken );
+    }
+
+    return xWake;
+}
+/*-----------------------------------------------------------*/
+
+void vRateLimiterTickHook( void )
+{
+    RateLimiter_t * pxLimiter;
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xWake;
+
+    for( pxLimiter = pxRateLimiters; pxLimiter != NULL; pxLimiter = pxLimiter->pxNext )
+    {
+        /* Nothing to do unless events are waiting for a token. */
+        if( pxLimiter->ulPending != 0 )
+        {
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                xWake = prvRefillAndDeliver( pxLimiter );
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+            if( xWake != pdFALSE )
+            {
+                /* Passing NULL makes the kernel perform any context switch
+                 * needed when the tick interrupt exits. */
+                vTaskNotifyGiveIndexedFromISR( pxLimiter->xTaskToNotify, pxLimiter->uxIndexToNotify, NULL );
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulRateLimiterWait( RateLimiter_t * pxLimiter,
+                            TickType_t xTicksToWait )
+{
+    uint32_t ulEvents;
+
+    ( void ) ulTaskNotifyTakeIndexed( pxLimiter->uxIndexToNotify, pdTRUE, xTicksToWait );
+
+    /* Collect everything delivered so far, which may include events delivered
+     * after the notification was sent. */
+    taskENTER_CRITICAL();
+    {
+        ulEvents = pxLimiter->ulDelivered;
+        pxLimiter->ulDelivered = 0;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulEvents;
+}
+/*-----------------------------------------------------------*/
+
+void vRateLimiterGetStats( RateLimiter_t * pxLimiter,
+                           RateLimiterStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = pxLimiter->xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvRefillAndDeliver( RateLimiter_t * pxLimiter )
+{
+    TickType_t xNow, xElapsed;
+    uint64_t ullCredit;
+    BaseType_t xReturn = pdFALSE;
+
+    xNow = xTaskGetTickCountFromISR();
+    xElapsed = xNow - pxLimiter->xLastRefillTime;
+    pxLimiter->xLastRefillTime = xNow;
+
+    /* Calculated in 64 bits so a long idle period cannot overflow. */
+    ullCredit = ( uint64_t ) pxLimiter->ulCredit + ( ( uint64_t ) xElapsed * pxLimiter->ulEventsPerSecond );
+
+    if( ullCredit > pxLimiter->ulCreditLimit )
+    {
+        ullCredit = pxLimiter->ulCreditLimit;
+    }
+
+    pxLimiter->ulCredit = ( uint32_t ) ullCredit;
+
+    if( ( pxLimiter->ulPending != 0 ) && ( pxLimiter->ulCredit >= ratelimitCREDITS_PER_TOKEN ) )
+    {
+        pxLimiter->ulCredit -= ratelimitCREDITS_PER_TOKEN;
+
+        pxLimiter->xStats.ulWakeUps++;
+        pxLimiter->xStats.ulCoalesced += pxLimiter->ulPending - 1;
+
+        if( pxLimiter->ulPending > pxLimiter->xStats.ulLargestBatch )
+        {
+            pxLimiter->xStats.ulLargestBatch = pxLimiter->ulPending;
+        }
+
+        pxLimiter->ulDelivered += pxLimiter->ulPending;
+        pxLimiter->ulPending = 0;
+        xReturn = pdTRUE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,114 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A token bucket that limits how often an interrupt can wake the task that
+ * handles its events.
+ *
+ * Without a limit every interrupt wakes the handling task, so an interrupt
+ * storm becomes a storm of context switches that can starve every task of
+ * lower priority.  An interrupt that reports its events through
+ * xRateLimiterEventFromISR() instead only wakes the task while the bucket
+ * holds a token.  The bucket refills at ulEventsPerSecond tokens per second,
+ * measured in ticks, and holds at most ulBurst tokens.  Events that arrive
+ * while the bucket is empty are not lost - they are counted, and the count is
+ * delivered with the next wake up the bucket allows.  vRateLimiterTickHook(),
+ * which is called from the tick hook, delivers counts left pending when the
+ * events stop.
+ *
+ * The handling task calls ulRateLimiterWait(), which returns the number of
+ * events that have occurred since it last returned.
+ */
+
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct xRATE_LIMITER_STATS
+{
+    uint32_t ulEvents;          /* Events reported by the interrupt. */
+    uint32_t ulWakeUps;         /* Times the handling task was woken. */
+    uint32_t ulCoalesced;       /* Events delivered with another event's wake up. */
+    uint32_t ulLargestBatch;    /* The most events delivered by one wake up. */
+} RateLimiterStats_t;
+
+/* The structure is only visible so rate limiters can be statically
+ * allocated - its members must not be accessed directly. */
+typedef struct xRATE_LIMITER
+{
+    TaskHandle_t xTaskToNotify;
+    UBaseType_t uxIndexToNotify;
+    uint32_t ulEventsPerSecond;
+    uint32_t ulCreditLimit;
+    uint32_t ulCredit;          /* One token is configTICK_RATE_HZ credits. */
+    TickType_t xLastRefillTime;
+    uint32_t ulPending;         /* Events waiting for a token. */
+    uint32_t ulDelivered;       /* Events delivered but not yet collected by the task. */
+    RateLimiterStats_t xStats;
+    struct xRATE_LIMITER * pxNext;
+} RateLimiter_t;
+
+/*
+ * Initialise pxLimiter to wake xTaskToNotify, using task notification index
+ * uxIndexToNotify, no more than ulEventsPerSecond times a second on average
+ * and no more than ulBurst times in quick succession.  The bucket starts full.
+ * pxLimiter must remain valid for as long as the scheduler runs.
+ */
+void vRateLimiterInitialise( RateLimiter_t * pxLimiter,
+                             TaskHandle_t xTaskToNotify,
+                             UBaseType_t uxIndexToNotify,
+                             uint32_t ulEventsPerSecond,
+                             uint32_t ulBurst );
+
+/*
+ * Report one event from an interrupt.  Returns pdTRUE if the task was woken,
+ * or pdFALSE if the event was coalesced into a later wake up.
+ */
+BaseType_t xRateLimiterEventFromISR( RateLimiter_t * pxLimiter,
+                                     BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Called from the tick hook to deliver events that are waiting for a token.
+ */
+void vRateLimiterTickHook( void );
+
+/*
+ * Called by the handling task to wait up to xTicksToWait for events.  Returns
+ * the number of events delivered since the previous call, which is 0 if the
+ * wait timed out.
+ */
+uint32_t ulRateLimiterWait( RateLimiter_t * pxLimiter,
+                            TickType_t xTicksToWait );
+
+/*
+ * Copy the limiter's counters into pxStats.
+ */
+void vRateLimiterGetStats( RateLimiter_t * pxLimiter,
+                           RateLimiterStats_t * pxStats );
+
+#endif /* RATE_LIMITER_H */
@@ -61,7 +61,7 @@ LARGE_INTEGER liPerformanceCounterFrequency, liInitialRunTimeValue;
 	{
 		/* How many times does the performance counter increment in 1/100th
 		millisecond. */
-		llTicksPerHundedthMillisecond = liPerformanceCounterFrequency.QuadPart / 100000LL;
+		llTicksPerHundedthMillisecond = liPerformanceCounterFrequency.QuadPart / ( 1000000LL / ( long long ) configUS_PER_RUN_TIME_COUNT );
 
 		/* What is the performance counter value now, this will be subtracted
 		from readings taken at run time. */
@@ -0,0 +1,506 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of SamplingProfiler.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Windows includes.  FreeRTOS.h includes windows.h through portmacro.h. */
+#include <dbghelp.h>
+
+/* Demo includes. */
+#include "SamplingProfiler.h"
+
+#define profilerSTACK_MASK        ( profilerMAX_STACKS - 1U )
+
+/* The values of lState. */
+#define profilerIDLE              ( 0 )
+#define profilerRUNNING           ( 1 )
+#define profilerSTOPPING          ( 2 )
+
+/* The root frame of stacks sampled while the simulator was processing an
+ * interrupt. */
+#define profilerISR_NAME          "[ISR]"
+
+/* The longest function name written to the output. */
+#define profilerMAX_SYMBOL_NAME   ( 256 )
+
+#if ( ( profilerMAX_STACKS & profilerSTACK_MASK ) != 0 )
+    #error profilerMAX_STACKS must be a power of 2
+#endif
+
+/* The Windows port keeps the handle of the thread that executes each task in
+ * this structure, which it places at the top of the task's stack.  The first
+ * member of the TCB points to it.  This must match ThreadState_t in the port's
+ * port.c. */
+typedef struct xPROFILER_THREAD_STATE
+{
+    void * pvThread;
+    void * pvYieldEvent;
+} ProfilerThreadState_t;
+
+/* A distinct stack and the number of times it was sampled.  The frames are
+ * innermost first. */
+typedef struct xPROFILER_STACK
+{
+    uint32_t ulCount;                       /* 0 if the entry is unused. */
+    uint32_t ulHash;
+    UBaseType_t uxDepth;
+    char cTaskName[ configMAX_TASK_NAME_LEN ];
+    void * pvFrames[ profilerMAX_DEPTH ];
+} ProfilerStack_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The Windows thread that takes the samples and writes the output.
+ */
+static DWORD WINAPI prvProfilerThread( void * pvParam );
+
+/*
+ * Take one sample, if the scheduler is running.
+ */
+static void prvTakeSample( void );
+
+/*
+ * Walk the stack of the suspended thread whose registers are in pxContext,
+ * writing up to profilerMAX_DEPTH return addresses to pvFrames.  Returns the
+ * number written.
+ */
+static UBaseType_t prvWalkStack( CONTEXT * pxContext,
+                                 void * pvFrames[ profilerMAX_DEPTH ] );
+
+/*
+ * Count one sample of the given stack.
+ */
+static void prvCountStack( const char * pcTaskName,
+                           void * const pvFrames[ profilerMAX_DEPTH ],
+                           UBaseType_t uxDepth );
+
+/*
+ * Write the counted stacks to profilerOUTPUT_FILE_NAME.
+ */
+static void prvWriteProfile( void );
+
+/*
+ * Write the name of the function that contains pvAddress to pxOutputFile.
+ * xReturnAddress is pdTRUE if pvAddress is a return address rather than the
+ * address of the instruction being executed.
+ */
+static void prvWriteFrame( FILE * pxOutputFile,
+                           void * pvAddress,
+                           BaseType_t xReturnAddress );
+
+/*-----------------------------------------------------------*/
+
+/* The thread that processes the simulated interrupts, which is the thread that
+ * called xProfilerInit(). */
+static HANDLE xInterruptThread = NULL;
+
+/* Set to wake the profiler thread when it is idle. */
+static HANDLE xProfilerEvent = NULL;
+
+static volatile LONG lState = profilerIDLE;
+static volatile LONG lResetRequested = pdFALSE;
+
+/* Only the profiler thread accesses the stacks. */
+static ProfilerStack_t xStacks[ profilerMAX_STACKS ];
+static volatile ProfilerStats_t xStats = { 0 };
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xProfilerInit( void )
+{
+    HANDLE xThread;
+    BaseType_t xReturn = pdFAIL;
+
+    /* GetCurrentThread() returns a pseudo handle that means "the calling
+     * thread", so make a real one. */
+    if( DuplicateHandle( GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &xInterruptThread, 0, FALSE, DUPLICATE_SAME_ACCESS ) != FALSE )
+    {
+        xProfilerEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+        if( xProfilerEvent != NULL )
+        {
+            xThread = CreateThread( NULL, 0, prvProfilerThread, NULL, 0, NULL );
+
+            if( xThread != NULL )
+            {
+                /* Use the cores that are not used by the FreeRTOS tasks, so
+                 * the profiler samples the simulator while it runs. */
+                SetThreadAffinityMask( xThread, ~0x01u );
+                SetThreadPriority( xThread, THREAD_PRIORITY_HIGHEST );
+                xReturn = pdPASS;
+            }
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerStart( void )
+{
+    lResetRequested = pdTRUE;
+    InterlockedExchange( &lState, profilerRUNNING );
+    SetEvent( xProfilerEvent );
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerStop( void )
+{
+    if( InterlockedCompareExchange( &lState, profilerSTOPPING, profilerRUNNING ) == profilerRUNNING )
+    {
+        SetEvent( xProfilerEvent );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xProfilerIsRunning( void )
+{
+    return ( lState == profilerRUNNING ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vProfilerGetStats( ProfilerStats_t * pxStats )
+{
+    pxStats->ulSamples = xStats.ulSamples;
+    pxStats->ulStacks = xStats.ulStacks;
+    pxStats->ulDropped = xStats.ulDropped;
+    pxStats->ulMissed = xStats.ulMissed;
+}
+/*-----------------------------------------------------------*/
+
+static DWORD WINAPI prvProfilerThread( void * pvParam )
+{
+    ( void ) pvParam;
+
+    for( ; ; )
+    {
+        if( lState == profilerRUNNING )
+        {
+            if( lResetRequested != pdFALSE )
+            {
+                lResetRequested = pdFALSE;
+                memset( xStacks, 0x00, sizeof( xStacks ) );
+                xStats.ulSamples = 0;
+                xStats.ulStacks = 0;
+                xStats.ulDropped = 0;
+                xStats.ulMissed = 0;
+            }
+
+            prvTakeSample();
+            Sleep( profilerSAMPLE_PERIOD_MS );
+        }
+        else if( lState == profilerSTOPPING )
+        {
+            prvWriteProfile();
+
+            /* Unless the profiler was restarted while the file was being
+             * written. */
+            InterlockedCompareExchange( &lState, profilerIDLE, profilerSTOPPING );
+        }
+        else
+        {
+            WaitForSingleObject( xProfilerEvent, INFINITE );
+        }
+    }
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeSample( void )
+{
+    TaskHandle_t xTask = NULL;
+    HANDLE xThread;
+    BaseType_t xInsideInterrupt, xValid = pdFALSE;
+    CONTEXT xContext;
+    void * pvFrames[ profilerMAX_DEPTH ];
+    UBaseType_t uxDepth = 0;
+    char cTaskName[ configMAX_TASK_NAME_LEN ];
+
+    if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+    {
+        return;
+    }
+
+    /* Both of these only read a kernel variable, so can be called from outside
+     * the simulator. */
+    xInsideInterrupt = xPortIsInsideInterrupt();
+
+    if( xInsideInterrupt != pdFALSE )
+    {
+        xThread = xInterruptThread;
+        strncpy( cTaskName, profilerISR_NAME, sizeof( cTaskName ) );
+    }
+    else
+    {
+        xTask = xTaskGetCurrentTaskHandle();
+        xThread = ( HANDLE ) ( ( *( ProfilerThreadState_t ** ) xTask )->pvThread );
+        strncpy( cTaskName, pcTaskGetName( xTask ), sizeof( cTaskName ) );
+    }
+
+    cTaskName[ sizeof( cTaskName ) - 1 ] = '\0';
+
+    if( SuspendThread( xThread ) != ( DWORD ) -1 )
+    {
+        /* The simulator may have switched to another task, or into or out of
+         * an interrupt, between the checks above and the thread being
+         * suspended, in which case the sample would be counted against the
+         * wrong task. */
+        if( ( xPortIsInsideInterrupt() == xInsideInterrupt ) &&
+            ( ( xInsideInterrupt != pdFALSE ) || ( xTaskGetCurrentTaskHandle() == xTask ) ) )
+        {
+            memset( &xContext, 0x00, sizeof( xContext ) );
+            xContext.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+
+            if( GetThreadContext( xThread, &xContext ) != FALSE )
+            {
+                uxDepth = prvWalkStack( &xContext, pvFrames );
+                xValid = pdTRUE;
+            }
+        }
+
+        ResumeThread( xThread );
+    }
+
+    if( xValid != pdFALSE )
+    {
+        prvCountStack( cTaskName, pvFrames, uxDepth );
+    }
+    else
+    {
+        xStats.ulMissed++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvWalkStack( CONTEXT * pxContext,
+                                 void * pvFrames[ profilerMAX_DEPTH ] )
+{
+    UBaseType_t uxDepth = 0;
+
+    #if defined( _M_X64 ) || defined( __x86_64__ )
+    {
+        DWORD64 ullImageBase, ullEstablisherFrame;
+        PRUNTIME_FUNCTION pxFunction;
+        PVOID pvHandlerData;
+
+        /* Unwind using the unwind data that every x64 function other than a
+         * leaf function has.  Neither call takes a lock that the suspended
+         * thread could be holding. */
+        while( ( uxDepth < profilerMAX_DEPTH ) && ( pxContext->Rip != 0 ) )
+        {
+            pvFrames[ uxDepth++ ] = ( void * ) pxContext->Rip;
+            pxFunction = RtlLookupFunctionEntry( pxContext->Rip, &ullImageBase, NULL );
+
+            if( pxFunction == NULL )
+            {
+                /* A leaf function does not move the stack pointer, so the
+                 * return address is on the top of the stack. */
+                pxContext->Rip = *( DWORD64 * ) pxContext->Rsp;
+                pxContext->Rsp += sizeof( DWORD64 );
+            }
+            else
+            {
+                RtlVirtualUnwind( UNW_FLAG_NHANDLER, ullImageBase, pxContext->Rip, pxFunction, pxContext, &pvHandlerData, &ullEstablisherFrame, NULL );
+            }
+        }
+    }
+    #else /* if defined( _M_X64 ) || defined( __x86_64__ ) */
+    {
+        void ** ppvFrame = ( void ** ) pxContext->Ebp;
+        void ** ppvNextFrame;
+
+        pvFrames[ uxDepth++ ] = ( void * ) pxContext->Eip;
+
+        /* Follow the saved frame pointers.  Each frame must be above the last,
+         * which also ends the walk at the base of the stack. */
+        while( ( uxDepth < profilerMAX_DEPTH ) && ( ppvFrame != NULL ) && ( IsBadReadPtr( ppvFrame, 2 * sizeof( void * ) ) == FALSE ) )
+        {
+            pvFrames[ uxDepth++ ] = ppvFrame[ 1 ];
+            ppvNextFrame = ( void ** ) ppvFrame[ 0 ];
+
+            if( ppvNextFrame <= ppvFrame )
+            {
+                break;
+            }
+
+            ppvFrame = ppvNextFrame;
+        }
+    }
+    #endif /* if defined( _M_X64 ) || defined( __x86_64__ ) */
+
+    return uxDepth;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCountStack( const char * pcTaskName,
+                           void * const pvFrames[ profilerMAX_DEPTH ],
+                           UBaseType_t uxDepth )
+{
+    uint32_t ulHash = 2166136261UL, ulProbe, ulIndex;
+    UBaseType_t uxFrame;
+    const char * pcChar;
+    ProfilerStack_t * pxStack;
+
+    /* FNV-1a over the task name and the frame addresses. */
+    for( pcChar = pcTaskName; *pcChar != '\0'; pcChar++ )
+    {
+        ulHash = ( ulHash ^ ( uint8_t ) *pcChar ) * 16777619UL;
+    }
+
+    for( uxFrame = 0; uxFrame < uxDepth; uxFrame++ )
+    {
+        ulHash = ( ulHash ^ ( uint32_t ) ( ( uintptr_t ) pvFrames[ uxFrame ] >> 2 ) ) * 16777619UL;
+    }
+
+    for( ulProbe = 0; ulProbe < profilerMAX_STACKS; ulProbe++ )
+    {
+        ulIndex = ( ulHash + ulProbe ) & profilerSTACK_MASK;
+        pxStack = &( xStacks[ ulIndex ] );
+
+        if( pxStack->ulCount == 0 )
+        {
+            pxStack->ulHash = ulHash;
+            pxStack->uxDepth = uxDepth;
+            memcpy( pxStack->cTaskName, pcTaskName, sizeof( pxStack->cTaskName ) );
+            memcpy( pxStack->pvFrames, pvFrames, uxDepth * sizeof( void * ) );
+            pxStack->ulCount = 1;
+            xStats.ulStacks++;
+            xStats.ulSamples++;
+            return;
+        }
+
+        if( ( pxStack->ulHash == ulHash ) &&
+            ( pxStack->uxDepth == uxDepth ) &&
+            ( strcmp( pxStack->cTaskName, pcTaskName ) == 0 ) &&
+            ( memcmp( pxStack->pvFrames, pvFrames, uxDepth * sizeof( void * ) ) == 0 ) )
+        {
+            pxStack->ulCount++;
+            xStats.ulSamples++;
+            return;
+        }
+    }
+
+    xStats.ulDropped++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteProfile( void )
+{
+    static BaseType_t xSymbolsLoaded = pdFALSE;
+    FILE * pxOutputFile;
+    uint32_t ulIndex;
+    UBaseType_t uxFrame;
+    const ProfilerStack_t * pxStack;
+
+    /* The symbols are loaded on first use, which can take a while. */
+    if( xSymbolsLoaded == pdFALSE )
+    {
+        SymSetOptions( SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS );
+        xSymbolsLoaded = ( SymInitialize( GetCurrentProcess(), NULL, TRUE ) != FALSE ) ? pdTRUE : pdFALSE;
+    }
+
+    pxOutputFile = fopen( profilerOUTPUT_FILE_NAME, "w" );
+
+    if( pxOutputFile == NULL )
+    {
+        printf( "\r\nCould not create %s\r\n", profilerOUTPUT_FILE_NAME );
+        return;
+    }
+
+    for( ulIndex = 0; ulIndex < profilerMAX_STACKS; ulIndex++ )
+    {
+        pxStack = &( xStacks[ ulIndex ] );
+
+        if( pxStack->ulCount != 0 )
+        {
+            fprintf( pxOutputFile, "%s", pxStack->cTaskName );
+
+            /* Outermost frame first.  Only the innermost frame is the address
+             * of the instruction being executed. */
+            for( uxFrame = pxStack->uxDepth; uxFrame > 0; uxFrame-- )
+            {
+                fputc( ';', pxOutputFile );
+                prvWriteFrame( pxOutputFile, pxStack->pvFrames[ uxFrame - 1 ], ( uxFrame > 1 ) ? pdTRUE : pdFALSE );
+            }
+
+            fprintf( pxOutputFile, " %lu\n", ( unsigned long ) pxStack->ulCount );
+        }
+    }
+
+    fclose( pxOutputFile );
+
+    printf( "\r\nProfile of %lu samples (%lu stacks, %lu dropped, %lu missed) saved to %s\r\n",
+            ( unsigned long ) xStats.ulSamples,
+            ( unsigned long ) xStats.ulStacks,
+            ( unsigned long ) xStats.ulDropped,
+            ( unsigned long ) xStats.ulMissed,
+            profilerOUTPUT_FILE_NAME );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteFrame( FILE * pxOutputFile,
+                           void * pvAddress,
+                           BaseType_t xReturnAddress )
+{
+    /* SYMBOL_INFO ends with the first character of the name. */
+    static uint8_t ucSymbolBuffer[ sizeof( SYMBOL_INFO ) + profilerMAX_SYMBOL_NAME ];
+    SYMBOL_INFO * pxSymbol = ( SYMBOL_INFO * ) ucSymbolBuffer;
+    DWORD64 ullAddress = ( DWORD64 ) ( uintptr_t ) pvAddress;
+    DWORD64 ullDisplacement;
+
+    /* A return address can be the first instruction after the end of the
+     * calling function, so look up the call instruction instead. */
+    if( xReturnAddress != pdFALSE )
+    {
+        ullAddress--;
+    }
+
+    memset( pxSymbol, 0x00, sizeof( SYMBOL_INFO ) );
+    pxSymbol->SizeOfStruct = sizeof( SYMBOL_INFO );
+    pxSymbol->MaxNameLen = profilerMAX_SYMBOL_NAME;
+
+    if( SymFromAddr( GetCurrentProcess(), ullAddress, &ullDisplacement, pxSymbol ) != FALSE )
+    {
+        fprintf( pxOutputFile, "%s", pxSymbol->Name );
+    }
+    else
+    {
+        fprintf( pxOutputFile, "%p", pvAddress );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,121 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sampling profiler that attributes host CPU time to tasks and functions.
+ *
+ * The run time stats say which task is busy, but not where inside the task the
+ * time goes.  While the profiler is running, a Windows thread wakes every
+ * profilerSAMPLE_PERIOD_MS milliseconds and:
+ *
+ * 1. Decides what the simulator is executing - an interrupt handler (including
+ *    the tick hook) if xPortIsInsideInterrupt() returns pdTRUE, otherwise the
+ *    task that xTaskGetCurrentTaskHandle() returns.
+ * 2. Suspends the Windows thread that executes it, walks the thread's call
+ *    stack, and resumes it.
+ * 3. Counts the stack against the task name, or "[ISR]".
+ *
+ * When the profiler is stopped the counted stacks are written, with function
+ * names, to profilerOUTPUT_FILE_NAME in the "collapsed" format read by
+ * flamegraph.pl and speedscope - one line per distinct stack, outermost
+ * function first, with the task name as the root frame:
+ *
+ *   Rx;prvQueueReceiveTask;xQueuePolicyReceive;xQueueReceive 12
+ *
+ * so each task has its own tower in the flame graph.  The profiler runs on
+ * the cores not used by the FreeRTOS tasks, and all its work other than the
+ * stack walk happens while the simulator runs.
+ *
+ * The Windows timer limits the sample rate, normally to about one sample every
+ * 1 to 15 milliseconds.  Samples are only meaningful in builds with symbols
+ * (the Debug configuration).  On 32-bit builds the stack is walked through the
+ * frame pointer chain, so frames of functions compiled without frame pointers
+ * are missed.
+ */
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include "FreeRTOS.h"
+
+#ifndef profilerSAMPLE_PERIOD_MS
+    #define profilerSAMPLE_PERIOD_MS    ( 1 )
+#endif
+
+/* The most frames recorded for each sample.  Deeper stacks lose their
+ * outermost frames. */
+#ifndef profilerMAX_DEPTH
+    #define profilerMAX_DEPTH    ( 32 )
+#endif
+
+/* The most distinct stacks counted.  Samples with a new stack are dropped once
+ * this many have been seen.  Must be a power of 2. */
+#ifndef profilerMAX_STACKS
+    #define profilerMAX_STACKS    ( 2048 )
+#endif
+
+#ifndef profilerOUTPUT_FILE_NAME
+    #define profilerOUTPUT_FILE_NAME    "Profile.folded"
+#endif
+
+typedef struct xPROFILER_STATS
+{
+    uint32_t ulSamples;     /* Samples counted. */
+    uint32_t ulStacks;      /* Distinct stacks seen. */
+    uint32_t ulDropped;     /* Samples dropped because profilerMAX_STACKS stacks were already seen. */
+    uint32_t ulMissed;      /* Samples discarded because the simulator switched context while they were taken. */
+} ProfilerStats_t;
+
+/*
+ * Create the profiler's Windows thread.  Must be called from main(), before the
+ * scheduler is started, as the thread that calls it goes on to process the
+ * simulated interrupts.  Returns pdFAIL if the thread could not be created.
+ */
+BaseType_t xProfilerInit( void );
+
+/*
+ * Discard any previous samples and start sampling.
+ */
+void vProfilerStart( void );
+
+/*
+ * Stop sampling.  The Windows thread then writes profilerOUTPUT_FILE_NAME and
+ * reports that it has done so on the console, so the caller does not wait for
+ * the file to be written.
+ */
+void vProfilerStop( void );
+
+/*
+ * Returns pdTRUE if the profiler is sampling.
+ */
+BaseType_t xProfilerIsRunning( void );
+
+/*
+ * Copy the profiler's counters into pxStats.
+ */
+void vProfilerGetStats( ProfilerStats_t * pxStats );
+
+#endif /* SAMPLING_PROFILER_H */
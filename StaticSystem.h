@@ -0,0 +1,170 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Statically allocated systems described in one place.
+ *
+ * Creating tasks, queues and timers one call at a time through the heap makes
+ * startup slower than it needs to be, and leaves the RAM they use unknown
+ * until the program runs.  Instead a file can describe the objects it creates
+ * as a list macro that takes one macro parameter per kind of object:
+ *
+ *   #define mainSYSTEM( TASK, QUEUE, TIMER )                                 \
+ *       QUEUE( xQueue, 4, sizeof( uint32_t ) )                               \
+ *       TASK( xRxTask, prvRxTask, "Rx", configMINIMAL_STACK_SIZE, NULL, 2 )  \
+ *       TIMER( xTimer, "Tmr", pdMS_TO_TICKS( 100 ), pdTRUE, NULL, prvTmr, pdTRUE )
+ *
+ * The arguments are those of xTaskCreateStatic(), xQueueCreateStatic() and
+ * xTimerCreateStatic(), with the handle first and the buffers left out, and
+ * with TIMER()'s last argument saying whether the timer is started as soon as
+ * it is created.  Then, at file scope:
+ *
+ *   staticsysDEFINE_OBJECTS( mainSYSTEM )
+ *
+ * defines a handle with each given name plus the object's buffers, all
+ * statically allocated, and:
+ *
+ *   staticsysDEFINE_INIT( mainSYSTEM, prvCreateSystem )
+ *
+ * defines prvCreateSystem(), which creates every object without touching the
+ * heap.  Queues are created first, then timers, then tasks, so a task never
+ * runs before the objects it uses exist.  staticsysRAM_BYTES( mainSYSTEM ) is
+ * a constant expression giving the bytes the objects occupy, and:
+ *
+ *   staticsysASSERT_RAM_BYTES( mainSYSTEM, 4096 )
+ *
+ * fails to compile if they occupy more than 4096 bytes, so a change that grows
+ * a stack or a queue past the file's budget is caught by the build.
+ *
+ * Only kernel tasks, queues and timers can be described.  The demo's own
+ * wrappers - WordQueue, PriorityQueue, QueuePolicy, Topic, Arena, BasicTask,
+ * TimerStats and the frame scheduler - have no static create functions, so
+ * objects created through them, and by the standard demo tasks, still come
+ * from the heap.  A demo that uses this file is therefore not heap free; what
+ * it gains is that the objects it describes are allocated, and their RAM
+ * known, when it is linked.
+ *
+ * Everything is generated by the preprocessor, so the handles and buffers are
+ * static to the file that includes the description, the functions the
+ * description names can be too, and the description can use the file's
+ * constants.  Each handle is used as a prefix for its buffers' names, so must
+ * be unique within the file.
+ */
+
+#ifndef STATIC_SYSTEM_H
+#define STATIC_SYSTEM_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#if ( configSUPPORT_STATIC_ALLOCATION != 1 )
+    #error StaticSystem.h requires configSUPPORT_STATIC_ALLOCATION to be set to 1
+#endif
+
+/* Define the handles and buffers of every object in xSystem. */
+#define staticsysDEFINE_OBJECTS( xSystem ) \
+    xSystem( staticsysDEFINE_TASK, staticsysDEFINE_QUEUE, staticsysDEFINE_TIMER )
+
+/* Define pxInitFunction(), which creates every object in xSystem. */
+#define staticsysDEFINE_INIT( xSystem, pxInitFunction )                               \
+    static void pxInitFunction( void )                                                \
+    {                                                                                 \
+        xSystem( staticsysIGNORE, staticsysCREATE_QUEUE, staticsysIGNORE )            \
+        xSystem( staticsysIGNORE, staticsysIGNORE, staticsysCREATE_TIMER )            \
+        xSystem( staticsysCREATE_TASK, staticsysIGNORE, staticsysIGNORE )             \
+    }
+
+/* The bytes occupied by every object in xSystem. */
+#define staticsysRAM_BYTES( xSystem ) \
+    ( ( size_t ) 0 xSystem( staticsysTASK_BYTES, staticsysQUEUE_BYTES, staticsysTIMER_BYTES ) )
+
+/* Fail to compile if the objects in xSystem occupy more than xMaxBytes.  The
+ * compiler does not support C11's _Static_assert, so an array with a negative
+ * size stands in for it. */
+#define staticsysASSERT_RAM_BYTES( xSystem, xMaxBytes ) \
+    typedef char xSystem##_ucRamBytesCheck[ ( staticsysRAM_BYTES( xSystem ) <= ( size_t ) ( xMaxBytes ) ) ? 1 : -1 ];
+
+/*-----------------------------------------------------------*/
+
+/* The expansions used by the macros above. */
+
+#define staticsysIGNORE( ... )
+
+/* An array cannot have zero length, so queues of zero sized items, which hold
+ * no data, are given one unused byte. */
+#define staticsysQUEUE_STORAGE_BYTES( uxLength, uxItemSize ) \
+    ( ( ( uxItemSize ) == 0 ) ? 1 : ( ( uxLength ) * ( uxItemSize ) ) )
+
+#define staticsysDEFINE_TASK( xHandle, pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority ) \
+    static StaticTask_t xHandle##_xTaskBuffer;                                                     \
+    static StackType_t xHandle##_uxStack[ uxStackDepth ];                                          \
+    static TaskHandle_t xHandle = NULL;
+
+#define staticsysDEFINE_QUEUE( xHandle, uxLength, uxItemSize )                               \
+    static StaticQueue_t xHandle##_xQueueBuffer;                                             \
+    static uint8_t xHandle##_ucStorage[ staticsysQUEUE_STORAGE_BYTES( uxLength, uxItemSize ) ]; \
+    static QueueHandle_t xHandle = NULL;
+
+#define staticsysDEFINE_TIMER( xHandle, pcName, xPeriod, xAutoReload, pvTimerID, pxCallback, xStart ) \
+    static StaticTimer_t xHandle##_xTimerBuffer;                                                     \
+    static TimerHandle_t xHandle = NULL;
+
+#define staticsysCREATE_TASK( xHandle, pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority )                      \
+    xHandle = xTaskCreateStatic( pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority,                              \
+                                 xHandle##_uxStack, &( xHandle##_xTaskBuffer ) );                                         \
+    configASSERT( xHandle );
+
+/* xQueueCreateStatic() requires the storage of a queue of zero sized items to
+ * be NULL. */
+#define staticsysCREATE_QUEUE( xHandle, uxLength, uxItemSize )                                        \
+    xHandle = xQueueCreateStatic( uxLength, uxItemSize,                                               \
+                                  ( ( uxItemSize ) == 0 ) ? NULL : xHandle##_ucStorage,               \
+                                  &( xHandle##_xQueueBuffer ) );                                      \
+    configASSERT( xHandle );
+
+#define staticsysCREATE_TIMER( xHandle, pcName, xPeriod, xAutoReload, pvTimerID, pxCallback, xStart )  \
+    xHandle = xTimerCreateStatic( pcName, xPeriod, xAutoReload, pvTimerID, pxCallback,                 \
+                                  &( xHandle##_xTimerBuffer ) );                                       \
+    configASSERT( xHandle );                                                                           \
+                                                                                                       \
+    if( ( xStart ) != pdFALSE )                                                                        \
+    {                                                                                                  \
+        /* The scheduler may not have started, so do not block. */                                     \
+        ( void ) xTimerStart( xHandle, 0 );                                                            \
+    }
+
+#define staticsysTASK_BYTES( xHandle, pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority ) \
+    + sizeof( StaticTask_t ) + ( ( uxStackDepth ) * sizeof( StackType_t ) )
+
+#define staticsysQUEUE_BYTES( xHandle, uxLength, uxItemSize ) \
+    + sizeof( StaticQueue_t ) + staticsysQUEUE_STORAGE_BYTES( uxLength, uxItemSize )
+
+#define staticsysTIMER_BYTES( xHandle, pcName, xPeriod, xAutoReload, pvTimerID, pxCallback, xStart ) \
+    + sizeof( StaticTimer_t )
+
+#endif /* STATIC_SYSTEM_H */
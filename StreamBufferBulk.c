@@ -0,0 +1,345 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of StreamBufferBulk.h.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+/* Demo includes. */
+#include "StreamBufferBulk.h"
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the number of bytes xStreamBuffer can hold.
+ */
+static size_t prvGetCapacity( StreamBufferHandle_t xStreamBuffer );
+
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferBulkSend( StreamBufferHandle_t xStreamBuffer,
+                              const StreamBufferVector_t * pxVectors,
+                              size_t xVectorCount,
+                              TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    size_t xVector = 0, xOffset = 0, xSent = 0, xSpace, xBytes, xCapacity;
+    const uint8_t * pucData;
+
+    configASSERT( xStreamBuffer );
+    configASSERT( ( pxVectors != NULL ) || ( xVectorCount == 0 ) );
+
+    xCapacity = prvGetCapacity( xStreamBuffer );
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        /* Copy as much as fits now.  With the scheduler suspended, a reader
+         * waiting for data is made ready by the first send but cannot run
+         * until every block that fits has been copied. */
+        vTaskSuspendAll();
+        {
+            xSpace = xStreamBufferSpacesAvailable( xStreamBuffer );
+
+            while( xVector < xVectorCount )
+            {
+                xBytes = pxVectors[ xVector ].xLength - xOffset;
+
+                if( xBytes > xSpace )
+                {
+                    xBytes = xSpace;
+                }
+
+                if( xBytes > 0 )
+                {
+                    pucData = ( const uint8_t * ) pxVectors[ xVector ].pvData;
+                    xBytes = xStreamBufferSend( xStreamBuffer, &( pucData[ xOffset ] ), xBytes, 0 );
+                    xSpace -= xBytes;
+                    xOffset += xBytes;
+                    xSent += xBytes;
+                }
+
+                if( xOffset < pxVectors[ xVector ].xLength )
+                {
+                    /* Out of space. */
+                    break;
+                }
+
+                xVector++;
+                xOffset = 0;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( ( xVector == xVectorCount ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+        {
+            break;
+        }
+
+        /* The buffer is full, so block in the kernel until there is room for
+         * the rest of the current block, or as much of it as the buffer can
+         * ever hold, then go back to copying with the scheduler suspended. */
+        xBytes = pxVectors[ xVector ].xLength - xOffset;
+
+        if( xBytes > xCapacity )
+        {
+            xBytes = xCapacity;
+        }
+
+        pucData = ( const uint8_t * ) pxVectors[ xVector ].pvData;
+        xBytes = xStreamBufferSend( xStreamBuffer, &( pucData[ xOffset ] ), xBytes, xTicksToWait );
+        xOffset += xBytes;
+        xSent += xBytes;
+
+        if( xOffset == pxVectors[ xVector ].xLength )
+        {
+            xVector++;
+            xOffset = 0;
+        }
+    }
+
+    return xSent;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferBulkReceive( StreamBufferHandle_t xStreamBuffer,
+                                 const StreamBufferVector_t * pxVectors,
+                                 size_t xVectorCount,
+                                 TickType_t xTicksToWait )
+{
+    size_t xVector = 0, xReceived = 0, xBytes;
+
+    configASSERT( xStreamBuffer );
+    configASSERT( ( pxVectors != NULL ) || ( xVectorCount == 0 ) );
+
+    /* Skip empty blocks, so the kernel is never asked for zero bytes. */
+    while( ( xVector < xVectorCount ) && ( pxVectors[ xVector ].xLength == 0 ) )
+    {
+        xVector++;
+    }
+
+    if( xVector == xVectorCount )
+    {
+        return 0;
+    }
+
+    /* Wait for data by receiving into the first block, as a call to
+     * xStreamBufferReceive() would. */
+    if( xTicksToWait != 0 )
+    {
+        xReceived = xStreamBufferReceive( xStreamBuffer, pxVectors[ xVector ].pvData, pxVectors[ xVector ].xLength, xTicksToWait );
+
+        if( xReceived < pxVectors[ xVector ].xLength )
+        {
+            return xReceived;
+        }
+
+        xVector++;
+    }
+
+    /* As for sending, a writer waiting for space is made ready by the first
+     * receive but cannot run until all the blocks have been filled. */
+    vTaskSuspendAll();
+    {
+        for( ; xVector < xVectorCount; xVector++ )
+        {
+            if( pxVectors[ xVector ].xLength > 0 )
+            {
+                xBytes = xStreamBufferReceive( xStreamBuffer, pxVectors[ xVector ].pvData, pxVectors[ xVector ].xLength, 0 );
+                xReceived += xBytes;
+
+                if( xBytes < pxVectors[ xVector ].xLength )
+                {
+                    /* The buffer is empty. */
+                    break;
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveBatch( StreamBufferHandle_t xStreamBuffer,
+                                  void * pvRxData,
+                                  size_t xBufferLengthBytes,
+                                  size_t xMinimumBatch,
+                                  TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    uint8_t * pucRxData = ( uint8_t * ) pvRxData;
+    size_t xReceived = 0;
+
+    configASSERT( xStreamBuffer );
+    configASSERT( xMinimumBatch > 0 );
+    configASSERT( xMinimumBatch <= xBufferLengthBytes );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        xReceived += xStreamBufferReceive( xStreamBuffer, &( pucRxData[ xReceived ] ), xBufferLengthBytes - xReceived, 0 );
+
+        if( ( xReceived >= xMinimumBatch ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+        {
+            break;
+        }
+
+        /* The buffer is now empty.  Only have the writer wake this task once
+         * the rest of the batch is available.  Setting the trigger level fails,
+         * leaving it unchanged, if the rest of the batch is more than the
+         * buffer can hold, in which case each write wakes this task. */
+        ( void ) xStreamBufferSetTriggerLevel( xStreamBuffer, xMinimumBatch - xReceived );
+        xReceived += xStreamBufferReceive( xStreamBuffer, &( pucRxData[ xReceived ] ), xBufferLengthBytes - xReceived, xTicksToWait );
+    }
+
+    ( void ) xStreamBufferSetTriggerLevel( xStreamBuffer, 1 );
+
+    return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMessageBufferBulkSend( MessageBufferHandle_t xMessageBuffer,
+                               const StreamBufferVector_t * pxVectors,
+                               size_t xVectorCount,
+                               TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    size_t xSent = 0;
+
+    configASSERT( xMessageBuffer );
+    configASSERT( ( pxVectors != NULL ) || ( xVectorCount == 0 ) );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    while( xSent < xVectorCount )
+    {
+        /* Send every message that fits with the scheduler suspended, as for
+         * stream buffers. */
+        vTaskSuspendAll();
+        {
+            while( xSent < xVectorCount )
+            {
+                configASSERT( pxVectors[ xSent ].xLength > 0 );
+
+                if( xMessageBufferSend( xMessageBuffer, pxVectors[ xSent ].pvData, pxVectors[ xSent ].xLength, 0 ) == 0 )
+                {
+                    break;
+                }
+
+                xSent++;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        if( ( xSent == xVectorCount ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+        {
+            break;
+        }
+
+        /* Block until the next message fits. */
+        if( xMessageBufferSend( xMessageBuffer, pxVectors[ xSent ].pvData, pxVectors[ xSent ].xLength, xTicksToWait ) == 0 )
+        {
+            break;
+        }
+
+        xSent++;
+    }
+
+    return xSent;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMessageBufferBulkReceive( MessageBufferHandle_t xMessageBuffer,
+                                  const StreamBufferVector_t * pxVectors,
+                                  size_t xVectorCount,
+                                  size_t * pxMessageLengths,
+                                  TickType_t xTicksToWait )
+{
+    size_t xReceived = 0, xLength;
+
+    configASSERT( xMessageBuffer );
+    configASSERT( ( ( pxVectors != NULL ) && ( pxMessageLengths != NULL ) ) || ( xVectorCount == 0 ) );
+
+    if( xVectorCount == 0 )
+    {
+        return 0;
+    }
+
+    /* Wait for the first message. */
+    xLength = xMessageBufferReceive( xMessageBuffer, pxVectors[ 0 ].pvData, pxVectors[ 0 ].xLength, xTicksToWait );
+
+    if( xLength == 0 )
+    {
+        return 0;
+    }
+
+    pxMessageLengths[ xReceived++ ] = xLength;
+
+    /* Then take the rest of the messages that are already waiting. */
+    vTaskSuspendAll();
+    {
+        while( xReceived < xVectorCount )
+        {
+            xLength = xMessageBufferReceive( xMessageBuffer, pxVectors[ xReceived ].pvData, pxVectors[ xReceived ].xLength, 0 );
+
+            if( xLength == 0 )
+            {
+                break;
+            }
+
+            pxMessageLengths[ xReceived++ ] = xLength;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return xReceived;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetCapacity( StreamBufferHandle_t xStreamBuffer )
+{
+    size_t xCapacity;
+
+    /* The reader can move bytes from one count to the other between the two
+     * calls. */
+    taskENTER_CRITICAL();
+    {
+        xCapacity = xStreamBufferSpacesAvailable( xStreamBuffer ) + xStreamBufferBytesAvailable( xStreamBuffer );
+    }
+    taskEXIT_CRITICAL();
+
+    return xCapacity;
+}
+/*-----------------------------------------------------------*/
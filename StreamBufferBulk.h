@@ -0,0 +1,127 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Bulk transfers through stream and message buffers.
+ *
+ * Each call to xStreamBufferSend() or xStreamBufferReceive() copies one block
+ * and, if the task at the other end is blocked and enough data (or space) is
+ * now available, wakes it.  A writer that produces its data in several pieces -
+ * a header and a payload, say - therefore makes several calls, and can wake the
+ * reader, and switch to it, after each one.
+ *
+ * The functions here instead take a list of blocks ("vectors", as in the
+ * scatter/gather lists used by writev() and readv()), and transfer as many as
+ * they can with the scheduler suspended.  The task at the other end is made
+ * ready at most once per call, and runs after the whole list has been copied.
+ * Copies into and out of the buffer still wrap around the end of its storage
+ * as usual.
+ *
+ * On the receive side, xStreamBufferReceiveBatch() waits until at least a
+ * minimum batch of bytes has arrived, or a timeout expires, so a reader fed by
+ * a stream of small writes is woken once per batch rather than once per write.
+ *
+ * As with the kernel's own functions, each stream or message buffer must have
+ * only one writer and one reader at a time.
+ */
+
+#ifndef STREAM_BUFFER_BULK_H
+#define STREAM_BUFFER_BULK_H
+
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+typedef struct xSTREAM_BUFFER_VECTOR
+{
+    void * pvData;
+    size_t xLength;
+} StreamBufferVector_t;
+
+/*
+ * Send the xVectorCount blocks in pxVectors, in order, as one contiguous
+ * stream of bytes.  Blocks for up to xTicksToWait for space, and returns the
+ * number of bytes sent - less than the total length of the blocks only if the
+ * timeout expired.
+ */
+size_t xStreamBufferBulkSend( StreamBufferHandle_t xStreamBuffer,
+                              const StreamBufferVector_t * pxVectors,
+                              size_t xVectorCount,
+                              TickType_t xTicksToWait );
+
+/*
+ * Fill the xVectorCount blocks in pxVectors, in order, from the stream.  Blocks
+ * for up to xTicksToWait if the stream buffer is empty, then receives whatever
+ * is available up to the total length of the blocks, as xStreamBufferReceive()
+ * does.  Returns the number of bytes received.
+ */
+size_t xStreamBufferBulkReceive( StreamBufferHandle_t xStreamBuffer,
+                                 const StreamBufferVector_t * pxVectors,
+                                 size_t xVectorCount,
+                                 TickType_t xTicksToWait );
+
+/*
+ * Receive up to xBufferLengthBytes bytes into pvRxData, returning once at
+ * least xMinimumBatch bytes have been received or xTicksToWait has passed.
+ * Returns the number of bytes received, which is less than xMinimumBatch only
+ * if the timeout expired.
+ *
+ * While waiting, the stream buffer's trigger level is set to the number of
+ * bytes still needed, so the writer only wakes this task when the batch is
+ * complete.  The trigger level is 1 when the function returns.
+ */
+size_t xStreamBufferReceiveBatch( StreamBufferHandle_t xStreamBuffer,
+                                  void * pvRxData,
+                                  size_t xBufferLengthBytes,
+                                  size_t xMinimumBatch,
+                                  TickType_t xTicksToWait );
+
+/*
+ * Send each of the xVectorCount blocks in pxVectors as a separate message.
+ * Blocks for up to xTicksToWait for space, and returns the number of messages
+ * sent.  The blocks must not be empty, as the kernel does not distinguish a
+ * zero length message from a failed send.
+ */
+size_t xMessageBufferBulkSend( MessageBufferHandle_t xMessageBuffer,
+                               const StreamBufferVector_t * pxVectors,
+                               size_t xVectorCount,
+                               TickType_t xTicksToWait );
+
+/*
+ * Receive up to xVectorCount messages, one into each block in pxVectors, and
+ * write the length of each to the matching entry of pxMessageLengths.  Blocks
+ * for up to xTicksToWait if the message buffer is empty, then receives the
+ * messages that are available.  Stops early at a message that is too long for
+ * its block, which is left in the message buffer.  Returns the number of
+ * messages received.
+ */
+size_t xMessageBufferBulkReceive( MessageBufferHandle_t xMessageBuffer,
+                                  const StreamBufferVector_t * pxVectors,
+                                  size_t xVectorCount,
+                                  size_t * pxMessageLengths,
+                                  TickType_t xTicksToWait );
+
+#endif /* STREAM_BUFFER_BULK_H */
@@ -0,0 +1,267 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of TickMonitor.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "TickMonitor.h"
+
+#define tickmonTICK_PERIOD_US           ( 1000000UL / configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that calls xTaskCatchUpTicks() when notified by the tick hook.
+ */
+static void prvCatchUpTask( void * pvParameters );
+
+/*
+ * Returns the histogram bucket for a deviation from the tick period.
+ */
+static UBaseType_t prvGetBucket( uint32_t ulDeviationUs );
+
+/*-----------------------------------------------------------*/
+
+/* Set by xTickMonitorStart(). */
+static volatile BaseType_t xStarted = pdFALSE;
+
+/* The time and tick count of the first tick measured, from which the absolute
+ * deadlines are calculated, and the time of the last tick measured. */
+static BaseType_t xHaveOrigin = pdFALSE;
+static configRUN_TIME_COUNTER_TYPE xOriginTime;
+static TickType_t xOriginTickCount;
+static configRUN_TIME_COUNTER_TYPE xLastTickTime;
+
+static TickMonitorStats_t xStats;
+static uint64_t ullDeviationSumUs = 0;
+
+/* The catch up task, and the ticks the tick hook has asked it to add.  Zero
+ * when no request is outstanding. */
+static TaskHandle_t xCatchUpTask = NULL;
+static volatile TickType_t xTicksToCatchUp = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTickMonitorStart( BaseType_t xCatchUp )
+{
+    BaseType_t xReturn = pdPASS;
+
+    memset( &xStats, 0x00, sizeof( xStats ) );
+    xStats.ulMinIntervalUs = UINT32_MAX;
+
+    if( xCatchUp != pdFALSE )
+    {
+        xReturn = xTaskCreate( prvCatchUpTask, "TickCatchUp", configMINIMAL_STACK_SIZE, NULL, tickmonCATCH_UP_TASK_PRIORITY, &xCatchUpTask );
+    }
+
+    xStarted = pdTRUE;
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTickMonitorTickHook( void )
+{
+    configRUN_TIME_COUNTER_TYPE xNow;
+    TickType_t xTickCount;
+    uint32_t ulIntervalUs, ulDeviationUs, ulPeriods;
+    int64_t llLagUs;
+
+    if( xStarted == pdFALSE )
+    {
+        return;
+    }
+
+    xNow = portGET_RUN_TIME_COUNTER_VALUE();
+    xTickCount = xTaskGetTickCountFromISR();
+
+    if( xHaveOrigin == pdFALSE )
+    {
+        xOriginTime = xNow;
+        xOriginTickCount = xTickCount;
+        xLastTickTime = xNow;
+        xHaveOrigin = pdTRUE;
+        return;
+    }
+
+    /* The interval since the last tick. */
+    ulIntervalUs = ( uint32_t ) ( ( xNow - xLastTickTime ) * configUS_PER_RUN_TIME_COUNT );
+    xLastTickTime = xNow;
+
+    ulDeviationUs = ( ulIntervalUs > tickmonTICK_PERIOD_US ) ? ( ulIntervalUs - tickmonTICK_PERIOD_US ) : ( tickmonTICK_PERIOD_US - ulIntervalUs );
+    ullDeviationSumUs += ulDeviationUs;
+    xStats.ulTicks++;
+    xStats.ulHistogram[ prvGetBucket( ulDeviationUs ) ]++;
+
+    if( ulIntervalUs < xStats.ulMinIntervalUs )
+    {
+        xStats.ulMinIntervalUs = ulIntervalUs;
+    }
+
+    if( ulIntervalUs > xStats.ulMaxIntervalUs )
+    {
+        xStats.ulMaxIntervalUs = ulIntervalUs;
+    }
+
+    /* Every whole period beyond the first, rounding to the nearest period, is
+     * a tick that was never generated. */
+    ulPeriods = ( ulIntervalUs + ( tickmonTICK_PERIOD_US / 2UL ) ) / tickmonTICK_PERIOD_US;
+
+    if( ulPeriods > 1UL )
+    {
+        xStats.ulMissedTicks += ulPeriods - 1UL;
+    }
+
+    /* The ticks pended while the scheduler is suspended are not yet in the
+     * tick count, so the lag is only known while it is running. */
+    if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+    {
+        llLagUs = ( int64_t ) ( ( xNow - xOriginTime ) * configUS_PER_RUN_TIME_COUNT ) -
+                  ( ( int64_t ) ( xTickCount - xOriginTickCount ) * ( int64_t ) tickmonTICK_PERIOD_US );
+        xStats.lLagUs = ( int32_t ) llLagUs;
+
+        if( xStats.lLagUs > xStats.lMaxLagUs )
+        {
+            xStats.lMaxLagUs = xStats.lLagUs;
+        }
+
+        if( ( xCatchUpTask != NULL ) && ( xTicksToCatchUp == 0 ) && ( llLagUs >= ( int64_t ) tickmonTICK_PERIOD_US ) )
+        {
+            xTicksToCatchUp = ( TickType_t ) ( llLagUs / ( int64_t ) tickmonTICK_PERIOD_US );
+
+            /* Passing NULL makes the kernel perform any context switch
+             * needed when the tick interrupt exits. */
+            vTaskNotifyGiveFromISR( xCatchUpTask, NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vTickMonitorGetStats( TickMonitorStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+        pxStats->ulMeanDeviationUs = ( xStats.ulTicks == 0 ) ? 0 : ( uint32_t ) ( ullDeviationSumUs / xStats.ulTicks );
+
+        if( xStats.ulTicks == 0 )
+        {
+            pxStats->ulMinIntervalUs = 0;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTickMonitorPrint( void )
+{
+    TickMonitorStats_t xCopy;
+    UBaseType_t uxBucket;
+    uint32_t ulLimitUs = tickmonFIRST_BUCKET_US;
+
+    vTickMonitorGetStats( &xCopy );
+
+    printf( "\r\nTick period %luus, %lu ticks measured, %lu missed, %lu caught up\r\n",
+            ( unsigned long ) tickmonTICK_PERIOD_US, ( unsigned long ) xCopy.ulTicks,
+            ( unsigned long ) xCopy.ulMissedTicks, ( unsigned long ) xCopy.ulCaughtUpTicks );
+    printf( "Interval min %luus max %luus, mean deviation %luus\r\n",
+            ( unsigned long ) xCopy.ulMinIntervalUs, ( unsigned long ) xCopy.ulMaxIntervalUs,
+            ( unsigned long ) xCopy.ulMeanDeviationUs );
+    printf( "Lag behind absolute deadlines %ldus, max %ldus\r\n",
+            ( long ) xCopy.lLagUs, ( long ) xCopy.lMaxLagUs );
+    printf( "%-16s %10s\r\n", "Deviation", "Ticks" );
+
+    for( uxBucket = 0; uxBucket < tickmonHISTOGRAM_BUCKETS; uxBucket++ )
+    {
+        if( uxBucket < ( tickmonHISTOGRAM_BUCKETS - 1 ) )
+        {
+            printf( "< %8luus     %10lu\r\n", ( unsigned long ) ulLimitUs, ( unsigned long ) xCopy.ulHistogram[ uxBucket ] );
+            ulLimitUs *= 2UL;
+        }
+        else
+        {
+            printf( ">= %7luus     %10lu\r\n", ( unsigned long ) ( ulLimitUs / 2UL ), ( unsigned long ) xCopy.ulHistogram[ uxBucket ] );
+        }
+    }
+
+    printf( "\r\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCatchUpTask( void * pvParameters )
+{
+    TickType_t xTicks;
+
+    /* Prevent the compiler warning about the unused parameter. */
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        xTicks = xTicksToCatchUp;
+
+        if( xTicks != 0 )
+        {
+            ( void ) xTaskCatchUpTicks( xTicks );
+
+            taskENTER_CRITICAL();
+            {
+                xStats.ulCaughtUpTicks += ( uint32_t ) xTicks;
+
+                /* Allow the tick hook to make another request. */
+                xTicksToCatchUp = 0;
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetBucket( uint32_t ulDeviationUs )
+{
+    UBaseType_t uxBucket = 0;
+    uint32_t ulLimitUs = tickmonFIRST_BUCKET_US;
+
+    while( ( uxBucket < ( tickmonHISTOGRAM_BUCKETS - 1 ) ) && ( ulDeviationUs >= ulLimitUs ) )
+    {
+        uxBucket++;
+        ulLimitUs *= 2UL;
+    }
+
+    return uxBucket;
+}
+/*-----------------------------------------------------------*/
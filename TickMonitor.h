@@ -0,0 +1,114 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Tick jitter and drift monitoring, with optional catch up.
+ *
+ * The Windows port generates the tick interrupt from a Windows thread that
+ * sleeps between ticks, so the tick is paced by the Windows scheduler.  Each
+ * sleep is relative to when the previous one ended, so lateness accumulates,
+ * and when the thread is not run for a while whole ticks are never generated.
+ * Timing measured in ticks is then neither steady nor accurate.
+ *
+ * The tick monitor is called from the tick hook, and measures each tick
+ * against the run time stats counter (see Run-time-stats-utils.c, which has a
+ * 10us resolution):
+ *
+ * - The interval between consecutive ticks - its minimum, maximum, mean
+ *   deviation from the tick period, and a histogram of the deviations.
+ * - Missed ticks - the periods that elapsed with no tick interrupt.
+ * - Lag - how far the tick count is behind the absolute deadline of the
+ *   current tick, which is the time of the first tick measured plus one tick
+ *   period for each tick counted since.  Lag is not measured while the
+ *   scheduler is suspended, as the ticks pended then are not yet counted.
+ *
+ * If catch up is enabled, each time the lag reaches a whole tick a task
+ * created by the monitor calls xTaskCatchUpTicks() to add the missing ticks,
+ * so the tick count follows the absolute deadlines - the time between ticks
+ * still varies, but the errors no longer accumulate.  Caught up ticks are
+ * processed together, so any timeouts they cover expire at once.
+ */
+
+#ifndef TICK_MONITOR_H
+#define TICK_MONITOR_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The histogram has one bucket for deviations below tickmonFIRST_BUCKET_US,
+ * then each bucket's limit is double the previous one's, with the last bucket
+ * holding everything above. */
+#ifndef tickmonHISTOGRAM_BUCKETS
+    #define tickmonHISTOGRAM_BUCKETS    ( 8 )
+#endif
+
+#ifndef tickmonFIRST_BUCKET_US
+    #define tickmonFIRST_BUCKET_US    ( 50UL )
+#endif
+
+/* The priority of the task that catches up missed ticks.  It must run before
+ * the tasks whose timing it corrects. */
+#ifndef tickmonCATCH_UP_TASK_PRIORITY
+    #define tickmonCATCH_UP_TASK_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+typedef struct xTICK_MONITOR_STATS
+{
+    uint32_t ulTicks;                   /* Tick intervals measured. */
+    uint32_t ulMissedTicks;             /* Tick periods that passed with no tick interrupt. */
+    uint32_t ulCaughtUpTicks;           /* Ticks added by xTaskCatchUpTicks(). */
+    uint32_t ulMinIntervalUs;
+    uint32_t ulMaxIntervalUs;
+    uint32_t ulMeanDeviationUs;         /* The mean difference between the interval and the tick period. */
+    int32_t lLagUs;                     /* The lag at the last tick measured.  Negative if the tick count is ahead. */
+    int32_t lMaxLagUs;
+    uint32_t ulHistogram[ tickmonHISTOGRAM_BUCKETS ];
+} TickMonitorStats_t;
+
+/*
+ * Start measuring from the next tick.  If xCatchUp is not pdFALSE, also
+ * create the task that catches up missed ticks.  Returns pdFAIL if the task
+ * could not be created.
+ */
+BaseType_t xTickMonitorStart( BaseType_t xCatchUp );
+
+/*
+ * Must be called from the tick hook.
+ */
+void vTickMonitorTickHook( void );
+
+/*
+ * Copy the measurements into pxStats.
+ */
+void vTickMonitorGetStats( TickMonitorStats_t * pxStats );
+
+/*
+ * Print the measurements.  Makes Windows system calls, so must be called from
+ * a critical section.
+ */
+void vTickMonitorPrint( void );
+
+#endif /* TICK_MONITOR_H */
@@ -0,0 +1,246 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of TimerStats.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+/* Demo includes. */
+#include "TimerStats.h"
+
+/* The record held in the timer ID of each timer created by
+ * xTimerStatsCreate(). */
+typedef struct xTIMER_STATS_RECORD
+{
+    TimerCallbackFunction_t pxCallbackFunction;
+    void * pvTimerID;
+    TimerHandle_t xTimer;
+    configRUN_TIME_COUNTER_TYPE xBudget;        /* In run time counter units, 0 for no budget. */
+    configRUN_TIME_COUNTER_TYPE xTotalTime;
+    configRUN_TIME_COUNTER_TYPE xMaxTime;
+    uint32_t ulCalls;
+    uint32_t ulLateCalls;
+    uint32_t ulOverruns;
+    TickType_t xMaxLateness;
+    struct xTIMER_STATS_RECORD * pxNext;
+} TimerStatsRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The callback of every timer created by xTimerStatsCreate().  Measures the
+ * call to the timer's own callback.
+ */
+static void prvMeasuredCallback( TimerHandle_t xTimer );
+
+/*
+ * Returns the tick at which the expiry being processed was due.
+ */
+static TickType_t prvGetDueTime( TimerHandle_t xTimer,
+                                 TickType_t xTimeNow );
+
+/*-----------------------------------------------------------*/
+
+/* All the records, most recently created first. */
+static TimerStatsRecord_t * pxTimerStatsRecords = NULL;
+
+/*-----------------------------------------------------------*/
+
+TimerHandle_t xTimerStatsCreate( const char * const pcTimerName,
+                                 const TickType_t xTimerPeriodInTicks,
+                                 const BaseType_t xAutoReload,
+                                 void * const pvTimerID,
+                                 TimerCallbackFunction_t pxCallbackFunction,
+                                 uint32_t ulBudgetUs )
+{
+    TimerStatsRecord_t * pxRecord;
+    TimerHandle_t xTimer = NULL;
+
+    pxRecord = ( TimerStatsRecord_t * ) pvPortMalloc( sizeof( TimerStatsRecord_t ) );
+
+    if( pxRecord != NULL )
+    {
+        pxRecord->pxCallbackFunction = pxCallbackFunction;
+        pxRecord->pvTimerID = pvTimerID;
+        pxRecord->xBudget = ( configRUN_TIME_COUNTER_TYPE ) ( ulBudgetUs / configUS_PER_RUN_TIME_COUNT );
+        pxRecord->xTotalTime = 0;
+        pxRecord->xMaxTime = 0;
+        pxRecord->ulCalls = 0;
+        pxRecord->ulLateCalls = 0;
+        pxRecord->ulOverruns = 0;
+        pxRecord->xMaxLateness = 0;
+
+        xTimer = xTimerCreate( pcTimerName, xTimerPeriodInTicks, xAutoReload, pxRecord, prvMeasuredCallback );
+
+        if( xTimer != NULL )
+        {
+            pxRecord->xTimer = xTimer;
+
+            taskENTER_CRITICAL();
+            {
+                pxRecord->pxNext = pxTimerStatsRecords;
+                pxTimerStatsRecords = pxRecord;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            vPortFree( pxRecord );
+        }
+    }
+
+    return xTimer;
+}
+/*-----------------------------------------------------------*/
+
+void * pvTimerStatsGetTimerID( TimerHandle_t xTimer )
+{
+    TimerStatsRecord_t * pxRecord = ( TimerStatsRecord_t * ) pvTimerGetTimerID( xTimer );
+
+    return pxRecord->pvTimerID;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerStatsGet( TimerHandle_t xTimer,
+                     TimerCallbackStats_t * pxStats )
+{
+    TimerStatsRecord_t * pxRecord = ( TimerStatsRecord_t * ) pvTimerGetTimerID( xTimer );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulCalls = pxRecord->ulCalls;
+        pxStats->ulLateCalls = pxRecord->ulLateCalls;
+        pxStats->ulOverruns = pxRecord->ulOverruns;
+        pxStats->ulMaxTimeUs = ( uint32_t ) ( pxRecord->xMaxTime * configUS_PER_RUN_TIME_COUNT );
+        pxStats->ulMeanTimeUs = 0;
+        pxStats->xMaxLateness = pxRecord->xMaxLateness;
+
+        if( pxRecord->ulCalls != 0 )
+        {
+            pxStats->ulMeanTimeUs = ( uint32_t ) ( ( pxRecord->xTotalTime * configUS_PER_RUN_TIME_COUNT ) / pxRecord->ulCalls );
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTimerStatsPrint( void )
+{
+    TimerStatsRecord_t * pxRecord;
+    TimerCallbackStats_t xStats;
+
+    printf( "\r\n%-16s %8s %10s %10s %8s %8s %9s\r\n", "Timer", "Calls", "Mean(us)", "Max(us)", "Late", "MaxLate", "Overruns" );
+
+    for( pxRecord = pxTimerStatsRecords; pxRecord != NULL; pxRecord = pxRecord->pxNext )
+    {
+        vTimerStatsGet( pxRecord->xTimer, &xStats );
+
+        printf( "%-16s %8lu %10lu %10lu %8lu %8lu %9lu%s\r\n",
+                pcTimerGetName( pxRecord->xTimer ),
+                ( unsigned long ) xStats.ulCalls,
+                ( unsigned long ) xStats.ulMeanTimeUs,
+                ( unsigned long ) xStats.ulMaxTimeUs,
+                ( unsigned long ) xStats.ulLateCalls,
+                ( unsigned long ) xStats.xMaxLateness,
+                ( unsigned long ) xStats.ulOverruns,
+                ( xStats.ulOverruns != 0 ) ? " <- over budget" : "" );
+    }
+
+    printf( "\r\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasuredCallback( TimerHandle_t xTimer )
+{
+    TimerStatsRecord_t * pxRecord = ( TimerStatsRecord_t * ) pvTimerGetTimerID( xTimer );
+    TickType_t xTimeNow, xLateness;
+    configRUN_TIME_COUNTER_TYPE xStart, xElapsed;
+
+    xTimeNow = xTaskGetTickCount();
+    xLateness = xTimeNow - prvGetDueTime( xTimer, xTimeNow );
+
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+    pxRecord->pxCallbackFunction( xTimer );
+    xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+    /* Only the timer service task writes to the record, but other tasks read
+     * it. */
+    taskENTER_CRITICAL();
+    {
+        pxRecord->ulCalls++;
+        pxRecord->xTotalTime += xElapsed;
+
+        if( xElapsed > pxRecord->xMaxTime )
+        {
+            pxRecord->xMaxTime = xElapsed;
+        }
+
+        if( ( pxRecord->xBudget != 0 ) && ( xElapsed > pxRecord->xBudget ) )
+        {
+            pxRecord->ulOverruns++;
+        }
+
+        if( xLateness != 0 )
+        {
+            pxRecord->ulLateCalls++;
+
+            if( xLateness > pxRecord->xMaxLateness )
+            {
+                pxRecord->xMaxLateness = xLateness;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetDueTime( TimerHandle_t xTimer,
+                                 TickType_t xTimeNow )
+{
+    TickType_t xExpiryTime = xTimerGetExpiryTime( xTimer );
+
+    /* The timer service reloads an auto-reload timer before calling its
+     * callback, so the expiry time is then the next expiry, one period after
+     * the one being processed.  The exception is when the service is catching
+     * up on expiries it missed, in which case the expiry time is the one being
+     * processed and is not in the future.  A one-shot timer's expiry time is
+     * left unchanged. */
+    if( ( xTimerGetReloadMode( xTimer ) != pdFALSE ) && ( ( BaseType_t ) ( xExpiryTime - xTimeNow ) > 0 ) )
+    {
+        xExpiryTime -= xTimerGetPeriod( xTimer );
+    }
+
+    return xExpiryTime;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,96 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Execution time and lateness accounting for software timer callbacks.
+ *
+ * Every timer callback runs in the timer service (daemon) task, one after
+ * another, so a slow callback delays every timer that expires after it.  A
+ * timer created with xTimerStatsCreate() instead of xTimerCreate() has its
+ * callback called through a function that measures, for every call:
+ *
+ * - How long the callback ran, using the run time stats counter.
+ * - How many ticks after the timer's expiry time the callback started.  A
+ *   callback that starts after the tick on which its timer expired was held
+ *   up by the callbacks before it, or by a higher priority task.
+ *
+ * Each timer can also be given a budget.  A call that runs for longer than the
+ * budget is counted as an overrun, identifying the callback that is delaying
+ * the others.
+ *
+ * The timer ID is used to hold the statistics, so callbacks of timers created
+ * by xTimerStatsCreate() must use pvTimerStatsGetTimerID() in place of
+ * pvTimerGetTimerID(), and must not call vTimerSetTimerID().
+ */
+
+#ifndef TIMER_STATS_H
+#define TIMER_STATS_H
+
+#include "FreeRTOS.h"
+#include "timers.h"
+
+typedef struct xTIMER_CALLBACK_STATS
+{
+    uint32_t ulCalls;               /* Times the callback has been called. */
+    uint32_t ulLateCalls;           /* Calls that started after the expiry tick. */
+    uint32_t ulOverruns;            /* Calls that ran for longer than the budget. */
+    uint32_t ulMeanTimeUs;          /* Mean execution time in microseconds. */
+    uint32_t ulMaxTimeUs;           /* Longest execution time in microseconds. */
+    TickType_t xMaxLateness;        /* Most ticks a call started after its expiry. */
+} TimerCallbackStats_t;
+
+/*
+ * As xTimerCreate(), but the callback is measured as described at the top of
+ * this file.  ulBudgetUs is the longest the callback should run for, in
+ * microseconds, or 0 if it has no budget.  Returns NULL if there is not enough
+ * heap.
+ */
+TimerHandle_t xTimerStatsCreate( const char * const pcTimerName,
+                                 const TickType_t xTimerPeriodInTicks,
+                                 const BaseType_t xAutoReload,
+                                 void * const pvTimerID,
+                                 TimerCallbackFunction_t pxCallbackFunction,
+                                 uint32_t ulBudgetUs );
+
+/*
+ * Returns the pvTimerID that was passed to xTimerStatsCreate().
+ */
+void * pvTimerStatsGetTimerID( TimerHandle_t xTimer );
+
+/*
+ * Copy the statistics of a timer created by xTimerStatsCreate() into pxStats.
+ */
+void vTimerStatsGet( TimerHandle_t xTimer,
+                     TimerCallbackStats_t * pxStats );
+
+/*
+ * Print a table of the statistics of every timer created by
+ * xTimerStatsCreate().  Makes Windows system calls, so must be called from a
+ * critical section.
+ */
+void vTimerStatsPrint( void );
+
+#endif /* TIMER_STATS_H */
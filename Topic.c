@@ -0,0 +1,531 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of Topic.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "Topic.h"
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the number of messages published since the subscriber's next
+ * message, including any that have been overwritten.  Must be called from a
+ * critical section.
+ */
+static uint32_t prvGetBacklog( const TopicSubscriber_t * pxSubscriber );
+
+/*
+ * Move the subscriber's cursor past any messages that have been overwritten,
+ * counting them as dropped.  Must be called from a critical section.
+ */
+static void prvSkipOverwritten( TopicSubscriber_t * pxSubscriber );
+
+/*
+ * Write a message to the ring and notify the subscribers that asked for a
+ * notification.  Must be called from a critical section, or from an interrupt
+ * in a critical section if pxHigherPriorityTaskWoken is not NULL.
+ */
+static void prvWriteMessage( TopicHandle_t xTopic,
+                             const void * pvMessage,
+                             BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Returns pdTRUE if the publisher can write a message without overwriting one
+ * a subscriber has yet to read, or the policy allows it to.  Must be called
+ * from a critical section.
+ */
+static BaseType_t prvCanPublish( TopicHandle_t xTopic );
+
+/*
+ * Unblock every task in pxList.
+ */
+static void prvWakeAll( WaitList_t * pxList );
+static void prvWakeAllFromISR( WaitList_t * pxList,
+                               BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Initialise the state of a newly created topic.
+ */
+static void prvInitialiseTopic( TopicHandle_t xTopic,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxMessageSize,
+                                eTopicPolicy ePolicy,
+                                uint8_t * pucStorage );
+
+/*-----------------------------------------------------------*/
+
+TopicHandle_t xTopicCreate( UBaseType_t uxLength,
+                            UBaseType_t uxMessageSize,
+                            eTopicPolicy ePolicy )
+{
+    TopicHandle_t xTopic;
+
+    /* The state and the ring are allocated in one block. */
+    xTopic = ( TopicHandle_t ) pvPortMalloc( sizeof( StaticTopic_t ) + ( uxLength * uxMessageSize ) );
+
+    if( xTopic != NULL )
+    {
+        prvInitialiseTopic( xTopic, uxLength, uxMessageSize, ePolicy, ( uint8_t * ) ( xTopic + 1 ) );
+        xTopic->ucStaticallyAllocated = pdFALSE;
+    }
+
+    return xTopic;
+}
+/*-----------------------------------------------------------*/
+
+TopicHandle_t xTopicCreateStatic( UBaseType_t uxLength,
+                                  UBaseType_t uxMessageSize,
+                                  eTopicPolicy ePolicy,
+                                  uint8_t * pucStorage,
+                                  StaticTopic_t * pxStaticTopic )
+{
+    configASSERT( pxStaticTopic );
+    configASSERT( pucStorage );
+
+    prvInitialiseTopic( pxStaticTopic, uxLength, uxMessageSize, ePolicy, pucStorage );
+    pxStaticTopic->ucStaticallyAllocated = pdTRUE;
+
+    return pxStaticTopic;
+}
+/*-----------------------------------------------------------*/
+
+void vTopicDelete( TopicHandle_t xTopic )
+{
+    configASSERT( xTopic->pxSubscribers == NULL );
+    configASSERT( xWaitListIsEmpty( &( xTopic->xPublishersWaiting ) ) );
+
+    if( xTopic->ucStaticallyAllocated == pdFALSE )
+    {
+        vPortFree( xTopic );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vTopicSubscribe( TopicHandle_t xTopic,
+                      TopicSubscriber_t * pxSubscriber,
+                      TaskHandle_t xNotifyTask,
+                      UBaseType_t uxNotifyIndex )
+{
+    configASSERT( pxSubscriber );
+
+    pxSubscriber->pxTopic = xTopic;
+    pxSubscriber->ulDropped = 0;
+    pxSubscriber->xNotifyTask = xNotifyTask;
+    pxSubscriber->uxNotifyIndex = uxNotifyIndex;
+
+    taskENTER_CRITICAL();
+    {
+        pxSubscriber->ulReadSequence = xTopic->ulWriteSequence;
+        pxSubscriber->uxReadIndex = xTopic->uxWriteIndex;
+        pxSubscriber->pxNext = xTopic->pxSubscribers;
+        xTopic->pxSubscribers = pxSubscriber;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vTopicUnsubscribe( TopicSubscriber_t * pxSubscriber )
+{
+    TopicHandle_t xTopic = pxSubscriber->pxTopic;
+    TopicSubscriber_t ** ppxLink;
+
+    taskENTER_CRITICAL();
+    {
+        for( ppxLink = &( xTopic->pxSubscribers ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNext ) )
+        {
+            if( *ppxLink == pxSubscriber )
+            {
+                *ppxLink = pxSubscriber->pxNext;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    /* The subscriber may have been the one holding the publishers up. */
+    prvWakeAll( &( xTopic->xPublishersWaiting ) );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicPublish( TopicHandle_t xTopic,
+                          const void * pvMessage,
+                          TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( prvCanPublish( xTopic ) != pdFALSE )
+            {
+                prvWriteMessage( xTopic, pvMessage, NULL );
+                taskEXIT_CRITICAL();
+
+                prvWakeAll( &( xTopic->xSubscribersWaiting ) );
+                return pdPASS;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xTopic->xPublishersWaiting ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xTopic->xPublishersWaiting ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicPublishFromISR( TopicHandle_t xTopic,
+                                 const void * pvMessage,
+                                 BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xReturn = errQUEUE_FULL;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( prvCanPublish( xTopic ) != pdFALSE )
+        {
+            prvWriteMessage( xTopic, pvMessage, pxHigherPriorityTaskWoken );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xReturn == pdPASS )
+    {
+        prvWakeAllFromISR( &( xTopic->xSubscribersWaiting ), pxHigherPriorityTaskWoken );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+const void * pvTopicPeek( TopicSubscriber_t * pxSubscriber,
+                          TickType_t xTicksToWait )
+{
+    TopicHandle_t xTopic = pxSubscriber->pxTopic;
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    const void * pvMessage;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            prvSkipOverwritten( pxSubscriber );
+
+            if( pxSubscriber->ulReadSequence != xTopic->ulWriteSequence )
+            {
+                pvMessage = &( xTopic->pucStorage[ pxSubscriber->uxReadIndex * xTopic->uxMessageSize ] );
+                taskEXIT_CRITICAL();
+
+                return pvMessage;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return NULL;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xTopic->xSubscribersWaiting ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xTopic->xSubscribersWaiting ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicRelease( TopicSubscriber_t * pxSubscriber )
+{
+    TopicHandle_t xTopic = pxSubscriber->pxTopic;
+    TaskHandle_t xTaskToWake = NULL;
+    BaseType_t xReturn = pdPASS;
+    uint32_t ulBacklog;
+
+    taskENTER_CRITICAL();
+    {
+        ulBacklog = prvGetBacklog( pxSubscriber );
+        configASSERT( ulBacklog > 0 );
+
+        if( ulBacklog > xTopic->uxLength )
+        {
+            /* The message was overwritten while it was being read, which
+             * counts as dropping it. */
+            prvSkipOverwritten( pxSubscriber );
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            pxSubscriber->ulReadSequence++;
+            pxSubscriber->uxReadIndex++;
+
+            if( pxSubscriber->uxReadIndex == xTopic->uxLength )
+            {
+                pxSubscriber->uxReadIndex = 0;
+            }
+
+            /* Only a subscriber a whole ring behind can be holding up the
+             * publishers. */
+            if( ( xTopic->ePolicy == eTopicBlockPublisher ) && ( ulBacklog == xTopic->uxLength ) )
+            {
+                xTaskToWake = xWaitListRemoveHighest( &( xTopic->xPublishersWaiting ) );
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    vWaitListNotify( xTaskToWake );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicReceive( TopicSubscriber_t * pxSubscriber,
+                          void * pvBuffer,
+                          TickType_t xTicksToWait )
+{
+    const void * pvMessage;
+
+    do
+    {
+        pvMessage = pvTopicPeek( pxSubscriber, xTicksToWait );
+
+        if( pvMessage == NULL )
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        memcpy( pvBuffer, pvMessage, pxSubscriber->pxTopic->uxMessageSize );
+    } while( xTopicRelease( pxSubscriber ) != pdPASS );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicMessagesWaiting( const TopicSubscriber_t * pxSubscriber )
+{
+    uint32_t ulBacklog;
+
+    taskENTER_CRITICAL();
+    {
+        ulBacklog = prvGetBacklog( pxSubscriber );
+    }
+    taskEXIT_CRITICAL();
+
+    return ( ulBacklog > pxSubscriber->pxTopic->uxLength ) ? pxSubscriber->pxTopic->uxLength : ( UBaseType_t ) ulBacklog;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTopicGetDropped( const TopicSubscriber_t * pxSubscriber )
+{
+    uint32_t ulDropped;
+
+    taskENTER_CRITICAL();
+    {
+        /* Include the messages overwritten since the subscriber last read. */
+        ulDropped = pxSubscriber->ulDropped;
+
+        if( prvGetBacklog( pxSubscriber ) > pxSubscriber->pxTopic->uxLength )
+        {
+            ulDropped += prvGetBacklog( pxSubscriber ) - pxSubscriber->pxTopic->uxLength;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return ulDropped;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetBacklog( const TopicSubscriber_t * pxSubscriber )
+{
+    /* Unsigned arithmetic gives the right answer when the sequence numbers
+     * wrap. */
+    return pxSubscriber->pxTopic->ulWriteSequence - pxSubscriber->ulReadSequence;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSkipOverwritten( TopicSubscriber_t * pxSubscriber )
+{
+    TopicHandle_t xTopic = pxSubscriber->pxTopic;
+    uint32_t ulBacklog = prvGetBacklog( pxSubscriber );
+
+    if( ulBacklog > xTopic->uxLength )
+    {
+        /* The oldest message still held is the one the publisher will
+         * overwrite next. */
+        pxSubscriber->ulDropped += ulBacklog - xTopic->uxLength;
+        pxSubscriber->ulReadSequence = xTopic->ulWriteSequence - xTopic->uxLength;
+        pxSubscriber->uxReadIndex = xTopic->uxWriteIndex;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteMessage( TopicHandle_t xTopic,
+                             const void * pvMessage,
+                             BaseType_t * pxHigherPriorityTaskWoken )
+{
+    TopicSubscriber_t * pxSubscriber;
+
+    memcpy( &( xTopic->pucStorage[ xTopic->uxWriteIndex * xTopic->uxMessageSize ] ), pvMessage, xTopic->uxMessageSize );
+
+    xTopic->uxWriteIndex++;
+
+    if( xTopic->uxWriteIndex == xTopic->uxLength )
+    {
+        xTopic->uxWriteIndex = 0;
+    }
+
+    xTopic->ulWriteSequence++;
+
+    /* Notifying a task from a critical section is safe - any context switch
+     * it causes is held until the critical section is exited. */
+    for( pxSubscriber = xTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+    {
+        if( pxSubscriber->xNotifyTask != NULL )
+        {
+            if( pxHigherPriorityTaskWoken == NULL )
+            {
+                xTaskNotifyGiveIndexed( pxSubscriber->xNotifyTask, pxSubscriber->uxNotifyIndex );
+            }
+            else
+            {
+                vTaskNotifyGiveIndexedFromISR( pxSubscriber->xNotifyTask, pxSubscriber->uxNotifyIndex, pxHigherPriorityTaskWoken );
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCanPublish( TopicHandle_t xTopic )
+{
+    const TopicSubscriber_t * pxSubscriber;
+
+    if( xTopic->ePolicy == eTopicBlockPublisher )
+    {
+        for( pxSubscriber = xTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+        {
+            if( prvGetBacklog( pxSubscriber ) >= xTopic->uxLength )
+            {
+                return pdFALSE;
+            }
+        }
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeAll( WaitList_t * pxList )
+{
+    TaskHandle_t xTaskToWake;
+
+    do
+    {
+        taskENTER_CRITICAL();
+        {
+            xTaskToWake = xWaitListRemoveHighest( pxList );
+        }
+        taskEXIT_CRITICAL();
+
+        vWaitListNotify( xTaskToWake );
+    } while( xTaskToWake != NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeAllFromISR( WaitList_t * pxList,
+                               BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    TaskHandle_t xTaskToWake;
+
+    do
+    {
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            xTaskToWake = xWaitListRemoveHighest( pxList );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        vWaitListNotifyFromISR( xTaskToWake, pxHigherPriorityTaskWoken );
+    } while( xTaskToWake != NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseTopic( TopicHandle_t xTopic,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxMessageSize,
+                                eTopicPolicy ePolicy,
+                                uint8_t * pucStorage )
+{
+    configASSERT( uxLength > ( UBaseType_t ) 0 );
+    configASSERT( uxMessageSize > ( UBaseType_t ) 0 );
+
+    xTopic->pucStorage = pucStorage;
+    xTopic->uxLength = uxLength;
+    xTopic->uxMessageSize = uxMessageSize;
+    xTopic->ePolicy = ePolicy;
+    xTopic->ulWriteSequence = 0;
+    xTopic->uxWriteIndex = 0;
+    xTopic->pxSubscribers = NULL;
+    vWaitListInitialise( &( xTopic->xSubscribersWaiting ) );
+    vWaitListInitialise( &( xTopic->xPublishersWaiting ) );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,183 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A publish/subscribe topic - one ring of messages read by any number of
+ * subscribers, each at its own pace.
+ *
+ * Sending the same message to several tasks through kernel queues means
+ * copying it into one queue per task.  A topic holds each message once.  Every
+ * subscriber has its own read cursor into the topic's ring, so a message is
+ * written once by the publisher and read in place by each subscriber, using
+ * pvTopicPeek() and xTopicRelease(), or copied out with xTopicReceive().
+ *
+ * What happens when the slowest subscriber falls a whole ring behind is set
+ * when the topic is created:
+ *
+ * - eTopicDropOldest: the publisher never waits.  The oldest message is
+ *   overwritten, and the subscribers that had not yet read it skip it and
+ *   count it as dropped.
+ * - eTopicBlockPublisher: the publisher waits, as it would for a full queue,
+ *   until the slowest subscriber reads a message.  No messages are lost.
+ *
+ * Subscribers can block in pvTopicPeek() or xTopicReceive() until a message is
+ * published, see WaitList.h.  Alternatively a subscriber can ask for a task
+ * notification on each publish, so a task can wait on a topic and other
+ * events together.
+ *
+ * A new subscriber sees the messages published after it subscribed.  Topics
+ * are not seen by the trace recorder.
+ */
+
+#ifndef TOPIC_H
+#define TOPIC_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "WaitList.h"
+
+typedef enum
+{
+    eTopicDropOldest = 0,
+    eTopicBlockPublisher
+} eTopicPolicy;
+
+/* The structures are only visible so topics and subscribers can be statically
+ * allocated - their members must not be accessed directly. */
+typedef struct xTOPIC_SUBSCRIBER
+{
+    struct xTOPIC * pxTopic;
+    struct xTOPIC_SUBSCRIBER * pxNext;
+    uint32_t ulReadSequence;        /* The sequence number of the next message to read... */
+    UBaseType_t uxReadIndex;        /* ...and where it is in the ring. */
+    uint32_t ulDropped;
+    TaskHandle_t xNotifyTask;
+    UBaseType_t uxNotifyIndex;
+} TopicSubscriber_t;
+
+typedef struct xTOPIC
+{
+    uint8_t * pucStorage;
+    UBaseType_t uxLength;
+    UBaseType_t uxMessageSize;
+    eTopicPolicy ePolicy;
+    volatile uint32_t ulWriteSequence;  /* The sequence number of the next message to publish... */
+    UBaseType_t uxWriteIndex;           /* ...and where it will go in the ring. */
+    TopicSubscriber_t * pxSubscribers;
+    WaitList_t xSubscribersWaiting;
+    WaitList_t xPublishersWaiting;
+    uint8_t ucStaticallyAllocated;
+} StaticTopic_t;
+
+typedef StaticTopic_t * TopicHandle_t;
+
+/*
+ * Create a topic that holds uxLength messages of uxMessageSize bytes each.
+ * Returns NULL if there is not enough heap.
+ */
+TopicHandle_t xTopicCreate( UBaseType_t uxLength,
+                            UBaseType_t uxMessageSize,
+                            eTopicPolicy ePolicy );
+
+/*
+ * As xTopicCreate(), but using pucStorage, which must be at least
+ * uxLength * uxMessageSize bytes, to hold the messages and pxStaticTopic to
+ * hold the topic's state.
+ */
+TopicHandle_t xTopicCreateStatic( UBaseType_t uxLength,
+                                  UBaseType_t uxMessageSize,
+                                  eTopicPolicy ePolicy,
+                                  uint8_t * pucStorage,
+                                  StaticTopic_t * pxStaticTopic );
+
+/*
+ * Delete a topic.  The topic must have no subscribers.
+ */
+void vTopicDelete( TopicHandle_t xTopic );
+
+/*
+ * Subscribe to a topic, using pxSubscriber to hold the subscription.  If
+ * xNotifyTask is not NULL, xTaskNotifyGiveIndexed( xNotifyTask, uxNotifyIndex )
+ * is called each time a message is published.  A subscriber is normally used
+ * by one task only.
+ */
+void vTopicSubscribe( TopicHandle_t xTopic,
+                      TopicSubscriber_t * pxSubscriber,
+                      TaskHandle_t xNotifyTask,
+                      UBaseType_t uxNotifyIndex );
+
+/*
+ * End a subscription.  No task can be blocked on the subscription.
+ */
+void vTopicUnsubscribe( TopicSubscriber_t * pxSubscriber );
+
+/*
+ * Publish a message, copying it into the topic once.  Under
+ * eTopicBlockPublisher, waits up to xTicksToWait for the slowest subscriber
+ * and returns errQUEUE_FULL if it times out.  Under eTopicDropOldest, always
+ * succeeds.  The FromISR version never waits.
+ */
+BaseType_t xTopicPublish( TopicHandle_t xTopic,
+                          const void * pvMessage,
+                          TickType_t xTicksToWait );
+
+BaseType_t xTopicPublishFromISR( TopicHandle_t xTopic,
+                                 const void * pvMessage,
+                                 BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Return a pointer to the subscriber's next message in the topic's ring,
+ * waiting up to xTicksToWait for one to be published, or NULL if none was.
+ * The message stays in the ring, and the pointer stays valid, until
+ * xTopicRelease() is called.
+ */
+const void * pvTopicPeek( TopicSubscriber_t * pxSubscriber,
+                          TickType_t xTicksToWait );
+
+/*
+ * Finish with the message returned by pvTopicPeek() and move on to the next.
+ * Under eTopicDropOldest the publisher does not wait for subscribers, so
+ * returns pdFAIL if the message was overwritten while it was being read, in
+ * which case whatever was read must be discarded.  Otherwise returns pdPASS.
+ */
+BaseType_t xTopicRelease( TopicSubscriber_t * pxSubscriber );
+
+/*
+ * Copy the subscriber's next message into pvBuffer, waiting up to
+ * xTicksToWait for one to be published.  Returns errQUEUE_EMPTY if none was.
+ */
+BaseType_t xTopicReceive( TopicSubscriber_t * pxSubscriber,
+                          void * pvBuffer,
+                          TickType_t xTicksToWait );
+
+/*
+ * Return the number of messages the subscriber has not yet read, and the
+ * number it has lost because the oldest message was overwritten.
+ */
+UBaseType_t uxTopicMessagesWaiting( const TopicSubscriber_t * pxSubscriber );
+uint32_t ulTopicGetDropped( const TopicSubscriber_t * pxSubscriber );
+
+#endif /* TOPIC_H */
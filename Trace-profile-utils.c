@@ -0,0 +1,182 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Utility functions that size the snapshot trace recorder from a previous run.
+ *
+ * The recorder's object property table holds one slot per live kernel object
+ * of each class, and by default reserves room for far more objects than the
+ * demos ever create.  vTraceSaveObjectProfile() inspects the table of the
+ * current recording, works out how many slots of each class were actually
+ * used, and writes the result (plus headroom) to a header file.  Setting
+ * TRC_CFG_USE_OBJECT_PROFILE to 1 in trcConfig.h then builds the recorder with
+ * those capacities instead of the defaults.
+ *
+ * The recorder keeps a high-water mark of the handles in use for each class,
+ * which is the peak number of objects of that class that were alive at the
+ * same time - which is what the table has to hold.  Objects are counted
+ * whether or not they were given a name.
+ *
+ * Note that this must be called with the recording stopped, and as it makes
+ * Windows system calls, from within a critical section.
+*/
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include <FreeRTOS.h>
+
+/* Percentage added to the measured object counts so the next run can create a
+few more objects than the profiled run without the recorder running out of
+handles. */
+#define trcprofileHEADROOM_PERCENT		25U
+
+/* Never size a table below this, as a zero sized table gives the recorder
+nowhere to store an object that was not seen during the profiled run. */
+#define trcprofileMINIMUM_OBJECTS		2U
+
+/* The smallest symbol table the recorder recommends. */
+#define trcprofileMINIMUM_SYMBOL_BYTES	4U
+
+/* The recorder's object handle allocator, defined in trcSnapshotRecorder.c. */
+extern objectHandleStackType objectHandleStacks;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the number of slots of class ulClass that have been used in the
+ * current recording.
+ */
+static uint32_t prvGetUsedObjectSlots( uint32_t ulClass );
+
+/*
+ * Adds the headroom to a measured count.
+ */
+static uint32_t prvAddHeadroom( uint32_t ulMeasured, uint32_t ulMinimum );
+
+/*-----------------------------------------------------------*/
+
+/* The class indexes used by the snapshot recorder, in the order the
+corresponding TRC_CFG_Nxxx definitions are written to the profile. */
+static const struct
+{
+	uint32_t ulClass;
+	const char *pcDefinition;
+	uint32_t ulCurrentCapacity;
+} xProfiledClasses[] =
+{
+	{ TRACE_CLASS_TASK,				"TRC_CFG_NTASK",			TRC_CFG_NTASK },
+	{ TRACE_CLASS_ISR,				"TRC_CFG_NISR",				TRC_CFG_NISR },
+	{ TRACE_CLASS_QUEUE,			"TRC_CFG_NQUEUE",			TRC_CFG_NQUEUE },
+	{ TRACE_CLASS_SEMAPHORE,		"TRC_CFG_NSEMAPHORE",		TRC_CFG_NSEMAPHORE },
+	{ TRACE_CLASS_MUTEX,			"TRC_CFG_NMUTEX",			TRC_CFG_NMUTEX },
+	{ TRACE_CLASS_TIMER,			"TRC_CFG_NTIMER",			TRC_CFG_NTIMER },
+	{ TRACE_CLASS_EVENTGROUP,		"TRC_CFG_NEVENTGROUP",		TRC_CFG_NEVENTGROUP },
+	{ TRACE_CLASS_STREAMBUFFER,		"TRC_CFG_NSTREAMBUFFER",	TRC_CFG_NSTREAMBUFFER },
+	{ TRACE_CLASS_MESSAGEBUFFER,	"TRC_CFG_NMESSAGEBUFFER",	TRC_CFG_NMESSAGEBUFFER }
+};
+
+/*-----------------------------------------------------------*/
+
+void vTraceSaveObjectProfile( const char *pcFileName )
+{
+FILE *pxOutputFile;
+uint32_t ulClass, ulUsed, ulSymbolBytes;
+
+	fopen_s( &pxOutputFile, pcFileName, "w" );
+
+	if( pxOutputFile == NULL )
+	{
+		printf( "\r\nFailed to create trace object profile file\r\n\r\n" );
+		return;
+	}
+
+	fprintf( pxOutputFile,
+			 "/*\n"
+			 " * Trace recorder object profile generated by vTraceSaveObjectProfile().\n"
+			 " * Used when TRC_CFG_USE_OBJECT_PROFILE is set to 1 in trcConfig.h.\n"
+			 " * The figures are the peak usage seen in the profiled run plus %u%%.\n"
+			 " */\n\n"
+			 "#ifndef TRC_OBJECT_PROFILE_H\n"
+			 "#define TRC_OBJECT_PROFILE_H\n\n",
+			 trcprofileHEADROOM_PERCENT );
+
+	for( ulClass = 0; ulClass < ( sizeof( xProfiledClasses ) / sizeof( xProfiledClasses[ 0 ] ) ); ulClass++ )
+	{
+		ulUsed = prvGetUsedObjectSlots( xProfiledClasses[ ulClass ].ulClass );
+
+		fprintf( pxOutputFile, "#define %-28s %lu", xProfiledClasses[ ulClass ].pcDefinition, ( unsigned long ) prvAddHeadroom( ulUsed, trcprofileMINIMUM_OBJECTS ) );
+
+		/* If every slot was used then the recorder probably ran out of handles
+		and the real peak is unknown, so flag it in the generated file. */
+		if( ulUsed >= xProfiledClasses[ ulClass ].ulCurrentCapacity )
+		{
+			fprintf( pxOutputFile, " /* Table was full when profiled - real usage may be higher. */" );
+		}
+
+		fprintf( pxOutputFile, "\n" );
+	}
+
+	/* The symbol table fills from the start, so the index of the next free
+	byte is the number of bytes used. */
+	ulSymbolBytes = RecorderDataPtr->SymbolTable.nextFreeSymbolIndex;
+	fprintf( pxOutputFile, "\n#define %-28s %lu\n", "TRC_CFG_SYMBOL_TABLE_SIZE", ( unsigned long ) prvAddHeadroom( ulSymbolBytes, trcprofileMINIMUM_SYMBOL_BYTES ) );
+
+	fprintf( pxOutputFile, "\n#endif /* TRC_OBJECT_PROFILE_H */\n" );
+	fclose( pxOutputFile );
+
+	printf( "Trace object profile saved to %s\r\n\r\n", pcFileName );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetUsedObjectSlots( uint32_t ulClass )
+{
+	if( ulClass >= RecorderDataPtr->ObjectPropertyTable.NumberOfObjectClasses )
+	{
+		return 0;
+	}
+
+	/* Updated each time a handle is allocated, so unnamed objects, such as
+	most queues and semaphores, are counted too. */
+	return ( uint32_t ) objectHandleStacks.handleCountWaterMarksOfClass[ ulClass ];
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvAddHeadroom( uint32_t ulMeasured, uint32_t ulMinimum )
+{
+uint32_t ulReturn;
+
+	ulReturn = ulMeasured + ( ( ulMeasured * trcprofileHEADROOM_PERCENT ) + 99U ) / 100U;
+
+	if( ulReturn < ulMinimum )
+	{
+		ulReturn = ulMinimum;
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
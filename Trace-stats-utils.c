@@ -0,0 +1,338 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Utility functions that save the statistics gathered by the demo's
+ * instrumentation alongside each trace recording.
+ *
+ * Comparing two trace recordings in a viewer shows what happened differently
+ * in their last few seconds, but not which tasks and objects have become
+ * slower overall.  Each time the trace is saved, xTraceSaveStats() also writes
+ * a JSON file of:
+ *
+ * - Each task's run time and share of the processor, for the tasks
+ *   recorded by ContextSwitch.h that have not been deleted.
+ * - Each task's context switches by cause, and its switch in latency
+ *   histogram, see ContextSwitch.h.
+ * - Each task's wake ups, and those that did no work, see WakeupStats.h.
+ * - Each task and object pair's calls that could have blocked, the calls that
+ *   did, and the time spent blocked, see BlockedTime.h.
+ * - Each sampled queue's mean depth and time full, see DepthSampler.h.
+ *
+ * The statistics cover the time since the scheduler started, where the trace
+ * recording only covers its most recent events.  tools/trace_stats_diff.py
+ * compares two files and ranks the biggest regressions.
+ *
+ * Note that this makes Windows system calls, so must be called from within a
+ * critical section.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "BlockedTime.h"
+#include "ContextSwitch.h"
+#include "DepthSampler.h"
+#include "WakeupStats.h"
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Write pcString as a JSON string, escaping the characters that need it.
+ */
+static void prvWriteString( FILE * pxFile,
+                            const char * pcString );
+
+/*
+ * Write one section of the file.  Each returns nothing if the statistics are
+ * not being gathered.
+ */
+static void prvWriteTasks( FILE * pxFile );
+static void prvWriteSwitches( FILE * pxFile );
+static void prvWriteWakeups( FILE * pxFile );
+static void prvWriteBlocking( FILE * pxFile );
+static void prvWriteQueues( FILE * pxFile );
+
+/*-----------------------------------------------------------*/
+
+/* Too large for the stack of the task or interrupt saving the trace. */
+#if ( configUSE_BLOCKED_TIME_STATS == 1 )
+    static BlockedTimeStats_t xBlockedStats[ blockedMAX_RECORDS ];
+#endif
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTraceSaveStats( const char * pcFileName )
+{
+    FILE * pxFile;
+
+    fopen_s( &pxFile, pcFileName, "w" );
+
+    if( pxFile == NULL )
+    {
+        return pdFAIL;
+    }
+
+    fprintf( pxFile, "{\n\"elapsedUs\":%llu,\n\"tick\":%lu,\n\"freeHeap\":%lu,\n\"minFreeHeap\":%lu,\n",
+             ( unsigned long long ) ( portGET_RUN_TIME_COUNTER_VALUE() * configUS_PER_RUN_TIME_COUNT ),
+             ( unsigned long ) xTaskGetTickCountFromISR(),
+             ( unsigned long ) xPortGetFreeHeapSize(),
+             ( unsigned long ) xPortGetMinimumEverFreeHeapSize() );
+
+    prvWriteTasks( pxFile );
+    prvWriteSwitches( pxFile );
+    prvWriteWakeups( pxFile );
+    prvWriteBlocking( pxFile );
+    prvWriteQueues( pxFile );
+
+    /* Every section ends with a comma, so end with a member that does not. */
+    fprintf( pxFile, "\"version\":1\n}\n" );
+    fclose( pxFile );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteString( FILE * pxFile,
+                            const char * pcString )
+{
+    fputc( '"', pxFile );
+
+    for( ; *pcString != '\0'; pcString++ )
+    {
+        if( ( *pcString == '"' ) || ( *pcString == '\\' ) )
+        {
+            fprintf( pxFile, "\\%c", *pcString );
+        }
+        else if( ( unsigned char ) *pcString < 0x20U )
+        {
+            fprintf( pxFile, "\\u%04x", ( unsigned int ) ( unsigned char ) *pcString );
+        }
+        else
+        {
+            fputc( *pcString, pxFile );
+        }
+    }
+
+    fputc( '"', pxFile );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteTasks( FILE * pxFile )
+{
+    #if ( configUSE_CONTEXT_SWITCH_STATS == 1 )
+    {
+        ContextSwitchStats_t xStats;
+        UBaseType_t uxIndex;
+        const char * pcSeparator = "";
+
+        /* The trace is saved from the handlers of simulated interrupts, where
+         * uxTaskGetSystemState() cannot be used as it suspends and resumes the
+         * scheduler.  Instead the tasks are those ContextSwitch.c has
+         * recorded, whose counters can be read without either.  Tasks that
+         * have not run yet are left out. */
+        fprintf( pxFile, "\"tasks\":[" );
+
+        for( uxIndex = 0; xContextSwitchGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+        {
+            if( xStats.xTask == NULL )
+            {
+                continue;
+            }
+
+            fprintf( pxFile, "%s\n{\"name\":", pcSeparator );
+            prvWriteString( pxFile, xStats.acTaskName );
+            fprintf( pxFile, ",\"priority\":%lu,\"runTimeUs\":%llu,\"stackHighWaterMark\":%lu}",
+                     ( unsigned long ) uxTaskPriorityGetFromISR( xStats.xTask ),
+                     ( unsigned long long ) ( ulTaskGetRunTimeCounter( xStats.xTask ) * configUS_PER_RUN_TIME_COUNT ),
+                     ( unsigned long ) uxTaskGetStackHighWaterMark( xStats.xTask ) );
+            pcSeparator = ",";
+        }
+
+        fprintf( pxFile, "],\n" );
+    }
+    #else /* if ( configUSE_CONTEXT_SWITCH_STATS == 1 ) */
+    {
+        ( void ) pxFile;
+    }
+    #endif /* if ( configUSE_CONTEXT_SWITCH_STATS == 1 ) */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteSwitches( FILE * pxFile )
+{
+    #if ( configUSE_CONTEXT_SWITCH_STATS == 1 )
+    {
+        ContextSwitchStats_t xStats;
+        UBaseType_t uxIndex, uxBucket;
+        eContextSwitchCause eCause;
+        uint32_t ulLimitUs = ctxswitchFIRST_LATENCY_BUCKET_US;
+
+        /* The upper limit of each latency bucket but the last, which has
+         * none. */
+        fprintf( pxFile, "\"latencyBucketsUs\":[" );
+
+        for( uxBucket = 0; uxBucket < ( ctxswitchLATENCY_BUCKETS - 1 ); uxBucket++ )
+        {
+            fprintf( pxFile, "%s%lu", ( uxBucket == 0 ) ? "" : ",", ( unsigned long ) ulLimitUs );
+            ulLimitUs *= 2UL;
+        }
+
+        fprintf( pxFile, "],\n\"switches\":[" );
+
+        for( uxIndex = 0; xContextSwitchGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+        {
+            fprintf( pxFile, "%s\n{\"name\":", ( uxIndex == 0 ) ? "" : "," );
+            prvWriteString( pxFile, xStats.acTaskName );
+            fprintf( pxFile, ",\"switchIns\":%lu,\"switchOuts\":{", ( unsigned long ) xStats.ulSwitchIns );
+
+            for( eCause = eSwitchPreempted; eCause < eSwitchCauseCount; eCause++ )
+            {
+                fprintf( pxFile, "%s\"%s\":%lu", ( eCause == eSwitchPreempted ) ? "" : ",",
+                         pcContextSwitchCauseName( eCause ), ( unsigned long ) xStats.ulSwitchOuts[ eCause ] );
+            }
+
+            fprintf( pxFile, "},\"meanLatencyUs\":%lu,\"maxLatencyUs\":%lu,\"latencyHistogram\":[",
+                     ( unsigned long ) xStats.ulMeanLatencyUs, ( unsigned long ) xStats.ulMaxLatencyUs );
+
+            for( uxBucket = 0; uxBucket < ctxswitchLATENCY_BUCKETS; uxBucket++ )
+            {
+                fprintf( pxFile, "%s%lu", ( uxBucket == 0 ) ? "" : ",", ( unsigned long ) xStats.ulLatencyHistogram[ uxBucket ] );
+            }
+
+            fprintf( pxFile, "]}" );
+        }
+
+        fprintf( pxFile, "],\n" );
+    }
+    #else /* if ( configUSE_CONTEXT_SWITCH_STATS == 1 ) */
+    {
+        ( void ) pxFile;
+    }
+    #endif /* if ( configUSE_CONTEXT_SWITCH_STATS == 1 ) */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteWakeups( FILE * pxFile )
+{
+    #if ( configUSE_WAKEUP_STATS == 1 )
+    {
+        WakeupStats_t xStats;
+        UBaseType_t uxIndex;
+        eWakeupReason eReason;
+
+        fprintf( pxFile, "\"wakeups\":[" );
+
+        for( uxIndex = 0; xWakeupStatsGet( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+        {
+            fprintf( pxFile, "%s\n{\"name\":", ( uxIndex == 0 ) ? "" : "," );
+            prvWriteString( pxFile, xStats.acTaskName );
+            fprintf( pxFile, ",\"reasons\":{" );
+
+            for( eReason = eWakeupTimeout; eReason < eWakeupReasonCount; eReason++ )
+            {
+                fprintf( pxFile, "%s\"%s\":%lu", ( eReason == eWakeupTimeout ) ? "" : ",",
+                         pcWakeupStatsReasonName( eReason ), ( unsigned long ) xStats.ulWakeups[ eReason ] );
+            }
+
+            fprintf( pxFile, "},\"blockedWakeups\":%lu,\"idleWakeups\":%lu,\"polling\":%s}",
+                     ( unsigned long ) xStats.ulBlockedWakeups, ( unsigned long ) xStats.ulIdleWakeups,
+                     ( xStats.xPolling != pdFALSE ) ? "true" : "false" );
+        }
+
+        fprintf( pxFile, "],\n" );
+    }
+    #else /* if ( configUSE_WAKEUP_STATS == 1 ) */
+    {
+        ( void ) pxFile;
+    }
+    #endif /* if ( configUSE_WAKEUP_STATS == 1 ) */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteBlocking( FILE * pxFile )
+{
+    #if ( configUSE_BLOCKED_TIME_STATS == 1 )
+    {
+        UBaseType_t uxRecords, uxIndex;
+
+        uxRecords = uxBlockedTimeGetRanking( xBlockedStats, blockedMAX_RECORDS );
+
+        fprintf( pxFile, "\"blocking\":[" );
+
+        for( uxIndex = 0; uxIndex < uxRecords; uxIndex++ )
+        {
+            fprintf( pxFile, "%s\n{\"task\":", ( uxIndex == 0 ) ? "" : "," );
+            prvWriteString( pxFile, xBlockedStats[ uxIndex ].acTaskName );
+            fprintf( pxFile, ",\"object\":" );
+            prvWriteString( pxFile, xBlockedStats[ uxIndex ].acObjectName );
+            fprintf( pxFile, ",\"type\":\"%s\",\"calls\":%lu,\"blocked\":%lu,\"totalMs\":%lu,\"maxMs\":%lu,\"inversionMs\":%lu}",
+                     pcBlockedTimeObjectTypeName( xBlockedStats[ uxIndex ].ulObjectType ),
+                     ( unsigned long ) xBlockedStats[ uxIndex ].ulCalls,
+                     ( unsigned long ) xBlockedStats[ uxIndex ].ulBlocked,
+                     ( unsigned long ) xBlockedStats[ uxIndex ].ulTotalMs,
+                     ( unsigned long ) xBlockedStats[ uxIndex ].ulMaxMs,
+                     ( unsigned long ) xBlockedStats[ uxIndex ].ulInversionMs );
+        }
+
+        fprintf( pxFile, "],\n" );
+    }
+    #else /* if ( configUSE_BLOCKED_TIME_STATS == 1 ) */
+    {
+        ( void ) pxFile;
+    }
+    #endif /* if ( configUSE_BLOCKED_TIME_STATS == 1 ) */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteQueues( FILE * pxFile )
+{
+    DepthStats_t xStats;
+    UBaseType_t uxIndex;
+
+    fprintf( pxFile, "\"queues\":[" );
+
+    for( uxIndex = 0; xDepthSamplerGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        fprintf( pxFile, "%s\n{\"name\":", ( uxIndex == 0 ) ? "" : "," );
+        prvWriteString( pxFile, xStats.pcName );
+        fprintf( pxFile, ",\"length\":%lu,\"meanDepthTenths\":%lu,\"highWaterMark\":%lu,\"samples\":%lu,\"ticksFull\":%lu,\"ticksEmpty\":%lu}",
+                 ( unsigned long ) xStats.xLength,
+                 ( unsigned long ) xStats.ulMeanDepth,
+                 ( unsigned long ) xStats.xHighWaterMark,
+                 ( unsigned long ) xStats.ulSamples,
+                 ( unsigned long ) xStats.ulTicksFull,
+                 ( unsigned long ) xStats.ulTicksEmpty );
+    }
+
+    fprintf( pxFile, "],\n" );
+}
+/*-----------------------------------------------------------*/
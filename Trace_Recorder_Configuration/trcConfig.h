@@ -228,8 +228,15 @@ extern "C" {
  * (static) or in runtime (malloc).
  * The custom mode allows you to control how and where the allocation is made,
  * for details see TRC_ALLOC_CUSTOM_BUFFER and vTraceSetRecorderDataBuffer().
+ *
+ * This demo uses the custom mode when configUSE_LARGE_PAGES is 1, so main()
+ * can place the buffer in large pages.
  */
-#define TRC_CFG_RECORDER_BUFFER_ALLOCATION    TRC_RECORDER_BUFFER_ALLOCATION_STATIC
+#if ( configUSE_LARGE_PAGES == 1 )
+    #define TRC_CFG_RECORDER_BUFFER_ALLOCATION    TRC_RECORDER_BUFFER_ALLOCATION_CUSTOM
+#else
+    #define TRC_CFG_RECORDER_BUFFER_ALLOCATION    TRC_RECORDER_BUFFER_ALLOCATION_STATIC
+#endif
 
 /**
  * @def TRC_CFG_MAX_ISR_NESTING
@@ -305,6 +312,25 @@ extern "C" {
  */
 #define TRC_CFG_RECORDER_DATA_ATTRIBUTE
 
+/**
+ * @def TRC_CFG_USE_OBJECT_PROFILE
+ * @brief Macro which should be defined as either zero (0) or one (1).
+ *
+ * If this is zero (0), the snapshot object table capacities (TRC_CFG_NTASK,
+ * TRC_CFG_NQUEUE, ...) and TRC_CFG_SYMBOL_TABLE_SIZE are the fixed values in
+ * trcKernelPortSnapshotConfig.h and trcSnapshotConfig.h.
+ *
+ * If this is one (1), those values are instead taken from trcObjectProfile.h,
+ * which the demo writes next to the trace file each time the trace is saved.
+ * The profile records how many objects of each class were actually in use,
+ * plus some headroom, so recorder RAM scales with the application rather
+ * than with worst-case guesses.  Run once with this set to 0, save a trace,
+ * then rebuild with this set to 1.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_USE_OBJECT_PROFILE            0
+
 /**
  * @def TRC_CFG_USE_TRACE_ASSERT
  * @brief Enable or disable debug asserts. Information regarding any assert that is
@@ -35,16 +35,23 @@
  * unless you are very confident on these numbers. Then do a recording and
  * check the actual usage by selecting View menu -> Trace Details ->
  * Resource Usage -> Object Table.
+ *
+ * When TRC_CFG_USE_OBJECT_PROFILE is 1 these values come from
+ * trcObjectProfile.h instead, see trcConfig.h.
  */
-#define TRC_CFG_NTASK                     150
-#define TRC_CFG_NISR                      90
-#define TRC_CFG_NQUEUE                    90
-#define TRC_CFG_NSEMAPHORE                90
-#define TRC_CFG_NMUTEX                    90
-#define TRC_CFG_NTIMER                    250
-#define TRC_CFG_NEVENTGROUP               90
-#define TRC_CFG_NSTREAMBUFFER             50
-#define TRC_CFG_NMESSAGEBUFFER            50
+#if ( TRC_CFG_USE_OBJECT_PROFILE == 1 )
+    #include "trcObjectProfile.h"
+#else
+    #define TRC_CFG_NTASK                 150
+    #define TRC_CFG_NISR                  90
+    #define TRC_CFG_NQUEUE                90
+    #define TRC_CFG_NSEMAPHORE            90
+    #define TRC_CFG_NMUTEX                90
+    #define TRC_CFG_NTIMER                250
+    #define TRC_CFG_NEVENTGROUP           90
+    #define TRC_CFG_NSTREAMBUFFER         50
+    #define TRC_CFG_NMESSAGEBUFFER        50
+#endif /* TRC_CFG_USE_OBJECT_PROFILE */
 
 /**
  * @def TRC_CFG_NAME_LEN_TASK, TRC_CFG_NAME_LEN_QUEUE, ...
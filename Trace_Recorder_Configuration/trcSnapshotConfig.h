@@ -78,8 +78,15 @@
  * 32-bit pointer, i.e., using 4 bytes rather than 0.
  *
  * Default value is 800.
+ *
+ * When TRC_CFG_USE_OBJECT_PROFILE is 1 this value comes from
+ * trcObjectProfile.h instead, see trcConfig.h.
  */
-#define TRC_CFG_SYMBOL_TABLE_SIZE        8000
+#if ( TRC_CFG_USE_OBJECT_PROFILE == 1 )
+    #include "trcObjectProfile.h"
+#else
+    #define TRC_CFG_SYMBOL_TABLE_SIZE    8000
+#endif /* TRC_CFG_USE_OBJECT_PROFILE */
 
 #if ( TRC_CFG_SYMBOL_TABLE_SIZE == 0 )
     #error "TRC_CFG_SYMBOL_TABLE_SIZE may not be zero!"
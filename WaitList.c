@@ -0,0 +1,156 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of WaitList.h.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Demo includes. */
+#include "WaitList.h"
+
+/*-----------------------------------------------------------*/
+
+void vWaitListInitialise( WaitList_t * pxList )
+{
+    pxList->pxHead = NULL;
+}
+/*-----------------------------------------------------------*/
+
+void vWaitListInsert( WaitList_t * pxList,
+                      WaitListItem_t * pxItem )
+{
+    WaitListItem_t ** ppxPrevious = &( pxList->pxHead );
+
+    pxItem->xTask = xTaskGetCurrentTaskHandle();
+    pxItem->uxPriority = uxTaskPriorityGet( NULL );
+
+    /* Waiters of equal priority are unblocked in the order they blocked, as
+     * with the kernel's own event lists. */
+    while( ( *ppxPrevious != NULL ) && ( ( *ppxPrevious )->uxPriority >= pxItem->uxPriority ) )
+    {
+        ppxPrevious = &( ( *ppxPrevious )->pxNext );
+    }
+
+    pxItem->pxNext = *ppxPrevious;
+    *ppxPrevious = pxItem;
+}
+/*-----------------------------------------------------------*/
+
+void vWaitListRemove( WaitList_t * pxList,
+                      WaitListItem_t * pxItem )
+{
+    WaitListItem_t ** ppxPrevious = &( pxList->pxHead );
+
+    while( *ppxPrevious != NULL )
+    {
+        if( *ppxPrevious == pxItem )
+        {
+            *ppxPrevious = pxItem->pxNext;
+            break;
+        }
+
+        ppxPrevious = &( ( *ppxPrevious )->pxNext );
+    }
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xWaitListRemoveHighest( WaitList_t * pxList )
+{
+    TaskHandle_t xReturn = NULL;
+
+    if( pxList->pxHead != NULL )
+    {
+        /* The handle is copied out because the item is on the waiting task's
+         * stack, and may go out of scope as soon as the critical section is
+         * exited. */
+        xReturn = pxList->pxHead->xTask;
+        pxList->pxHead = pxList->pxHead->pxNext;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitListIsEmpty( const WaitList_t * pxList )
+{
+    return ( pxList->pxHead == NULL ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vWaitListNotify( TaskHandle_t xTask )
+{
+    if( xTask != NULL )
+    {
+        ( void ) xTaskNotifyGiveIndexed( xTask, waitlistNOTIFICATION_INDEX );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vWaitListNotifyFromISR( TaskHandle_t xTask,
+                             BaseType_t * pxHigherPriorityTaskWoken )
+{
+    if( xTask != NULL )
+    {
+        vTaskNotifyGiveIndexedFromISR( xTask, waitlistNOTIFICATION_INDEX, pxHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWaitListWait( WaitList_t * pxList,
+                          WaitListItem_t * pxItem,
+                          TimeOut_t * pxTimeOut,
+                          TickType_t * pxTicksToWait )
+{
+    BaseType_t xReturn = pdTRUE;
+
+    if( xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait ) == pdFALSE )
+    {
+        /* A notification sent between the task inserting itself into the
+         * list and getting here is latched, so is not missed.  Equally a
+         * notification sent after a previous wait timed out may still be
+         * latched, which is why the caller must re-test its condition. */
+        ( void ) ulTaskNotifyTakeIndexed( waitlistNOTIFICATION_INDEX, pdTRUE, *pxTicksToWait );
+    }
+    else
+    {
+        xReturn = pdFALSE;
+    }
+
+    /* The item is still in the list if the task was not woken by the
+     * object. */
+    taskENTER_CRITICAL();
+    {
+        vWaitListRemove( pxList, pxItem );
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,119 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A list of tasks blocked on an application defined object, kept in priority
+ * order, that the objects in this demo (WordQueue.c and others) use to get the
+ * same blocking semantics as the kernel's own queues.
+ *
+ * A task blocks by inserting a WaitListItem_t, which lives on its own stack,
+ * then waiting on task notification index waitlistNOTIFICATION_INDEX.  Waking
+ * a task removes its item and notifies it.  Wake ups can be spurious, so the
+ * object must re-test its condition each time xWaitListWait() returns, as
+ * shown in WordQueue.c.
+ */
+
+#ifndef WAIT_LIST_H
+#define WAIT_LIST_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The notification index used to block and unblock tasks.  The last index is
+ * used so application use of the default index 0 is not disturbed. */
+#ifndef waitlistNOTIFICATION_INDEX
+    #define waitlistNOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#if ( configTASK_NOTIFICATION_ARRAY_ENTRIES < 2 )
+    #error WaitList.c requires configTASK_NOTIFICATION_ARRAY_ENTRIES to be at least 2
+#endif
+
+typedef struct xWAIT_LIST_ITEM
+{
+    TaskHandle_t xTask;                 /* The blocked task. */
+    UBaseType_t uxPriority;             /* The task's priority when it blocked. */
+    struct xWAIT_LIST_ITEM * pxNext;    /* The next, equal or lower priority, waiter. */
+} WaitListItem_t;
+
+typedef struct xWAIT_LIST
+{
+    WaitListItem_t * pxHead;            /* The highest priority waiter, or NULL. */
+} WaitList_t;
+
+/*
+ * Initialise an empty list.
+ */
+void vWaitListInitialise( WaitList_t * pxList );
+
+/*
+ * Add the calling task to the list, behind any waiters of the same or higher
+ * priority.  Must be called from a critical section.
+ */
+void vWaitListInsert( WaitList_t * pxList,
+                      WaitListItem_t * pxItem );
+
+/*
+ * Remove pxItem from the list if it is still in it.  Must be called from a
+ * critical section.
+ */
+void vWaitListRemove( WaitList_t * pxList,
+                      WaitListItem_t * pxItem );
+
+/*
+ * Remove the highest priority waiter from the list and return its handle, or
+ * NULL if the list is empty.  Must be called from a critical section.  Pass
+ * the returned handle to vWaitListNotify() or vWaitListNotifyFromISR() once
+ * the critical section has been exited.
+ */
+TaskHandle_t xWaitListRemoveHighest( WaitList_t * pxList );
+
+/*
+ * Returns pdTRUE if no tasks are waiting.
+ */
+BaseType_t xWaitListIsEmpty( const WaitList_t * pxList );
+
+/*
+ * Unblock a task returned by xWaitListRemoveHighest().  xTask may be NULL, in
+ * which case nothing happens.
+ */
+void vWaitListNotify( TaskHandle_t xTask );
+void vWaitListNotifyFromISR( TaskHandle_t xTask,
+                             BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Block the calling task, which has already inserted itself into pxList, until
+ * it is notified or the timeout held in pxTimeOut and pxTicksToWait expires,
+ * then make sure it is no longer in the list.  Returns pdFALSE if the timeout
+ * has expired, in which case the caller should test its condition one last
+ * time and then give up.
+ */
+BaseType_t xWaitListWait( WaitList_t * pxList,
+                          WaitListItem_t * pxItem,
+                          TimeOut_t * pxTimeOut,
+                          TickType_t * pxTicksToWait );
+
+#endif /* WAIT_LIST_H */
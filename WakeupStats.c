@@ -0,0 +1,458 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of WakeupStats.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "WakeupStats.h"
+
+#if ( configUSE_WAKEUP_STATS != 1 )
+    #error configUSE_WAKEUP_STATS must be 1 in FreeRTOSConfig.h to build WakeupStats.c
+#endif
+
+/* The thread local storage pointer that points to the task's record.  Index 0
+ * is used by BlockedTime.c. */
+#define wakeupTLS_INDEX              ( 1 )
+
+typedef struct xWAKEUP_RECORD
+{
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    BaseType_t xDeleted;                            /* pdTRUE once the task has been deleted, so the record can be reused. */
+    BaseType_t xInCall;                             /* pdTRUE while the task is in a call that can block... */
+    uint32_t ulObjectType;                          /* ...on this type of object... */
+    BaseType_t xBlocked;                            /* ...and pdTRUE if the call has blocked. */
+    BaseType_t xPreempted;                          /* pdTRUE if the task was switched out while Ready. */
+    BaseType_t xAwaitingWork;                       /* pdTRUE from a wake up from blocking until the task next makes a call that can block... */
+    configRUN_TIME_COUNTER_TYPE xWokenRunTime;      /* ...and the task's run time when it woke. */
+    configRUN_TIME_COUNTER_TYPE xRunTime;           /* The task's run time, not including the time since... */
+    configRUN_TIME_COUNTER_TYPE xSwitchedInAt;      /* ...it was last switched in. */
+    uint32_t ulWakeups[ eWakeupReasonCount ];
+    uint32_t ulBlockedWakeups;
+    uint32_t ulIdleWakeups;
+} WakeupRecord_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the record of the running task, creating it if it does not exist.  A
+ * new task takes the record of a deleted task with the same name, so the wake
+ * ups of tasks that are created and deleted repeatedly are added together,
+ * then an unused record, then the record of any deleted task.  Returns NULL if
+ * there is no record free.  Must be called from a critical section, or from
+ * vTaskSwitchContext().
+ */
+static WakeupRecord_t * prvGetRecord( void );
+
+/*
+ * Return the run time of the running task, whose record is pxRecord, at xNow.
+ */
+static configRUN_TIME_COUNTER_TYPE prvGetRunTime( const WakeupRecord_t * pxRecord,
+                                                  configRUN_TIME_COUNTER_TYPE xNow );
+
+/*-----------------------------------------------------------*/
+
+static WakeupRecord_t xRecords[ wakeupMAX_TASKS ];
+static UBaseType_t uxRecordCount = 0;
+
+/* The record of the task being switched out by vTaskSwitchContext(), and
+ * whether it was still Ready. */
+static WakeupRecord_t * pxSwitchingOut = NULL;
+static TaskHandle_t xSwitchingOutTask = NULL;
+static BaseType_t xSwitchingOutReady = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int iWakeupStatsEnter( uint32_t ulObjectType,
+                       const void * pvObject,
+                       int iMayBlock )
+{
+    WakeupRecord_t * pxRecord;
+    uint8_t ucQueueType;
+    configRUN_TIME_COUNTER_TYPE xNow;
+    int iCall = 0;
+
+    if( ( iMayBlock == 0 ) || ( xTaskGetSchedulerState() != taskSCHEDULER_RUNNING ) )
+    {
+        return 0;
+    }
+
+    if( ulObjectType == blockedOBJECT_QUEUE )
+    {
+        ucQueueType = ucQueueGetQueueType( ( QueueHandle_t ) pvObject );
+
+        if( ( ucQueueType == queueQUEUE_TYPE_MUTEX ) || ( ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX ) ||
+            ( ucQueueType == queueQUEUE_TYPE_COUNTING_SEMAPHORE ) || ( ucQueueType == queueQUEUE_TYPE_BINARY_SEMAPHORE ) )
+        {
+            ulObjectType = blockedOBJECT_SEMAPHORE;
+        }
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = prvGetRecord();
+
+        /* Calls made from within another call, such as the notification a
+         * stream buffer waits on, are accounted as part of the outer call. */
+        if( ( pxRecord != NULL ) && ( pxRecord->xInCall == pdFALSE ) )
+        {
+            xNow = portGET_RUN_TIME_COUNTER_VALUE();
+
+            if( pxRecord->xAwaitingWork != pdFALSE )
+            {
+                pxRecord->xAwaitingWork = pdFALSE;
+
+                if( ( ( prvGetRunTime( pxRecord, xNow ) - pxRecord->xWokenRunTime ) * configUS_PER_RUN_TIME_COUNT ) < wakeupMIN_WORK_US )
+                {
+                    pxRecord->ulIdleWakeups++;
+                }
+            }
+
+            pxRecord->xInCall = pdTRUE;
+            pxRecord->ulObjectType = ulObjectType;
+            pxRecord->xBlocked = pdFALSE;
+            iCall = 1;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return iCall;
+}
+/*-----------------------------------------------------------*/
+
+void vWakeupStatsReturn( int iCall,
+                         int iSucceeded )
+{
+    WakeupRecord_t * pxRecord;
+    eWakeupReason eReason;
+
+    if( iCall == 0 )
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = ( WakeupRecord_t * ) pvTaskGetThreadLocalStoragePointer( NULL, wakeupTLS_INDEX );
+        configASSERT( pxRecord );
+        pxRecord->xInCall = pdFALSE;
+
+        /* The call only woke the task if the task blocked in it.  A call that
+         * yielded to a task it woke only preempted the task. */
+        if( pxRecord->xBlocked != pdFALSE )
+        {
+            if( iSucceeded == 0 )
+            {
+                eReason = eWakeupTimeout;
+            }
+            else
+            {
+                switch( pxRecord->ulObjectType )
+                {
+                    case blockedOBJECT_SEMAPHORE:
+                    case blockedOBJECT_MUTEX:
+                        eReason = eWakeupSemaphore;
+                        break;
+
+                    case blockedOBJECT_EVENT_GROUP:
+                        eReason = eWakeupEventGroup;
+                        break;
+
+                    case blockedOBJECT_STREAM_BUFFER:
+                        eReason = eWakeupStreamBuffer;
+                        break;
+
+                    case blockedOBJECT_NOTIFICATION:
+                        eReason = eWakeupNotification;
+                        break;
+
+                    case blockedOBJECT_DELAY:
+                        eReason = eWakeupTimeout;
+                        break;
+
+                    default:
+                        eReason = eWakeupQueue;
+                        break;
+                }
+            }
+
+            pxRecord->ulWakeups[ eReason ]++;
+            pxRecord->ulBlockedWakeups++;
+            pxRecord->xAwaitingWork = pdTRUE;
+            pxRecord->xWokenRunTime = prvGetRunTime( pxRecord, portGET_RUN_TIME_COUNTER_VALUE() );
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vWakeupStatsSwitchContextEnter( int iStillReady )
+{
+    /* Called by vTaskSwitchContext() before it selects the next task. */
+    xSwitchingOutTask = xTaskGetCurrentTaskHandle();
+    xSwitchingOutReady = ( iStillReady != 0 ) ? pdTRUE : pdFALSE;
+    pxSwitchingOut = ( WakeupRecord_t * ) pvTaskGetThreadLocalStoragePointer( NULL, wakeupTLS_INDEX );
+}
+/*-----------------------------------------------------------*/
+
+void vWakeupStatsSwitchContextReturn( void )
+{
+    WakeupRecord_t * pxRecord;
+    configRUN_TIME_COUNTER_TYPE xNow;
+
+    /* vTaskSwitchContext() does not switch tasks while the scheduler is
+     * suspended, and may select the task that was already running. */
+    if( xTaskGetCurrentTaskHandle() == xSwitchingOutTask )
+    {
+        return;
+    }
+
+    xNow = portGET_RUN_TIME_COUNTER_VALUE();
+
+    if( pxSwitchingOut != NULL )
+    {
+        pxSwitchingOut->xRunTime += xNow - pxSwitchingOut->xSwitchedInAt;
+
+        /* A task that is switched out while still in its ready list was
+         * preempted, even if it was in a call that can block. */
+        if( xSwitchingOutReady != pdFALSE )
+        {
+            pxSwitchingOut->xPreempted = pdTRUE;
+        }
+        else if( pxSwitchingOut->xInCall != pdFALSE )
+        {
+            pxSwitchingOut->xBlocked = pdTRUE;
+        }
+    }
+
+    pxRecord = prvGetRecord();
+
+    if( pxRecord != NULL )
+    {
+        pxRecord->xSwitchedInAt = xNow;
+
+        if( pxRecord->xPreempted != pdFALSE )
+        {
+            pxRecord->xPreempted = pdFALSE;
+            pxRecord->ulWakeups[ eWakeupPreemption ]++;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vWakeupStatsTaskDeleted( void * pvTask )
+{
+    WakeupRecord_t * pxRecord;
+
+    taskENTER_CRITICAL();
+    {
+        pxRecord = ( WakeupRecord_t * ) pvTaskGetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, wakeupTLS_INDEX );
+
+        /* The record keeps its counts until prvGetRecord() reuses it.  The
+         * pointer is cleared so the task's last switch out is not recorded in
+         * a record another task may have taken by then. */
+        if( pxRecord != NULL )
+        {
+            pxRecord->xDeleted = pdTRUE;
+            vTaskSetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, wakeupTLS_INDEX, NULL );
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWakeupStatsGet( UBaseType_t uxIndex,
+                            WakeupStats_t * pxStats )
+{
+    const WakeupRecord_t * pxRecord;
+    uint32_t ulBlocked;
+
+    if( uxIndex >= uxRecordCount )
+    {
+        return pdFAIL;
+    }
+
+    pxRecord = &( xRecords[ uxIndex ] );
+
+    taskENTER_CRITICAL();
+    {
+        memcpy( pxStats->acTaskName, pxRecord->acTaskName, sizeof( pxStats->acTaskName ) );
+        memcpy( pxStats->ulWakeups, pxRecord->ulWakeups, sizeof( pxStats->ulWakeups ) );
+        pxStats->ulBlockedWakeups = pxRecord->ulBlockedWakeups;
+        pxStats->ulIdleWakeups = pxRecord->ulIdleWakeups;
+    }
+    taskEXIT_CRITICAL();
+
+    ulBlocked = pxStats->ulBlockedWakeups;
+    pxStats->xPolling = ( ( ulBlocked >= wakeupPOLLING_MIN_WAKEUPS ) &&
+                          ( ( pxStats->ulWakeups[ eWakeupTimeout ] * 100UL ) >= ( ulBlocked * wakeupPOLLING_PERCENT ) ) &&
+                          ( ( pxStats->ulIdleWakeups * 100UL ) >= ( ulBlocked * wakeupPOLLING_PERCENT ) ) ) ? pdTRUE : pdFALSE;
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcWakeupStatsReasonName( eWakeupReason eReason )
+{
+    static const char * const pcNames[] = { "Timeout", "Notify", "Queue", "Semaphore", "EventGroup", "StreamBuf", "Preempt" };
+
+    return ( ( UBaseType_t ) eReason < ( sizeof( pcNames ) / sizeof( pcNames[ 0 ] ) ) ) ? pcNames[ eReason ] : "?";
+}
+/*-----------------------------------------------------------*/
+
+void vWakeupStatsPrint( void )
+{
+    WakeupStats_t xStats;
+    UBaseType_t uxIndex;
+    eWakeupReason eReason;
+    uint32_t ulTotal, ulBlocked = 0, ulIdle = 0, ulPolling = 0;
+
+    printf( "\r\n%-*s %8s", configMAX_TASK_NAME_LEN, "Task", "Wakeups" );
+
+    for( eReason = eWakeupTimeout; eReason < eWakeupReasonCount; eReason++ )
+    {
+        printf( " %10s", pcWakeupStatsReasonName( eReason ) );
+    }
+
+    printf( " %8s %5s\r\n", "NoWork", "%" );
+
+    for( uxIndex = 0; xWakeupStatsGet( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        ulTotal = xStats.ulBlockedWakeups + xStats.ulWakeups[ eWakeupPreemption ];
+
+        if( ulTotal == 0 )
+        {
+            continue;
+        }
+
+        printf( "%-*s %8lu", configMAX_TASK_NAME_LEN, xStats.acTaskName, ( unsigned long ) ulTotal );
+
+        for( eReason = eWakeupTimeout; eReason < eWakeupReasonCount; eReason++ )
+        {
+            printf( " %10lu", ( unsigned long ) xStats.ulWakeups[ eReason ] );
+        }
+
+        printf( " %8lu %5lu%s\r\n",
+                ( unsigned long ) xStats.ulIdleWakeups,
+                ( unsigned long ) ( ( xStats.ulBlockedWakeups == 0 ) ? 0 : ( ( xStats.ulIdleWakeups * 100UL ) / xStats.ulBlockedWakeups ) ),
+                ( xStats.xPolling != pdFALSE ) ? " polling" : "" );
+
+        ulBlocked += xStats.ulBlockedWakeups;
+        ulIdle += xStats.ulIdleWakeups;
+
+        if( xStats.xPolling != pdFALSE )
+        {
+            ulPolling++;
+        }
+    }
+
+    printf( "%lu of %lu wake ups from blocking did no work, %lu tasks polling\r\n\r\n",
+            ( unsigned long ) ulIdle, ( unsigned long ) ulBlocked, ( unsigned long ) ulPolling );
+}
+/*-----------------------------------------------------------*/
+
+static WakeupRecord_t * prvGetRecord( void )
+{
+    WakeupRecord_t * pxRecord, * pxDeleted = NULL;
+    const char * pcTaskName;
+    UBaseType_t uxIndex;
+
+    pxRecord = ( WakeupRecord_t * ) pvTaskGetThreadLocalStoragePointer( NULL, wakeupTLS_INDEX );
+
+    if( pxRecord != NULL )
+    {
+        return pxRecord;
+    }
+
+    pcTaskName = pcTaskGetName( NULL );
+
+    for( uxIndex = 0; uxIndex < uxRecordCount; uxIndex++ )
+    {
+        if( xRecords[ uxIndex ].xDeleted != pdFALSE )
+        {
+            if( strcmp( xRecords[ uxIndex ].acTaskName, pcTaskName ) == 0 )
+            {
+                pxRecord = &( xRecords[ uxIndex ] );
+                break;
+            }
+
+            if( pxDeleted == NULL )
+            {
+                pxDeleted = &( xRecords[ uxIndex ] );
+            }
+        }
+    }
+
+    if( pxRecord == NULL )
+    {
+        if( uxRecordCount < wakeupMAX_TASKS )
+        {
+            pxRecord = &( xRecords[ uxRecordCount ] );
+            uxRecordCount++;
+        }
+        else if( pxDeleted != NULL )
+        {
+            pxRecord = pxDeleted;
+            memset( pxRecord, 0x00, sizeof( *pxRecord ) );
+        }
+        else
+        {
+            return NULL;
+        }
+
+        snprintf( pxRecord->acTaskName, sizeof( pxRecord->acTaskName ), "%s", pcTaskName );
+    }
+
+    /* A reused record keeps its counts, but not the state of the deleted
+     * task.  The task is running, so its run time is counted from now. */
+    pxRecord->xDeleted = pdFALSE;
+    pxRecord->xInCall = pdFALSE;
+    pxRecord->xBlocked = pdFALSE;
+    pxRecord->xPreempted = pdFALSE;
+    pxRecord->xAwaitingWork = pdFALSE;
+    pxRecord->xSwitchedInAt = portGET_RUN_TIME_COUNTER_VALUE();
+    vTaskSetThreadLocalStoragePointer( NULL, wakeupTLS_INDEX, pxRecord );
+
+    return pxRecord;
+}
+/*-----------------------------------------------------------*/
+
+static configRUN_TIME_COUNTER_TYPE prvGetRunTime( const WakeupRecord_t * pxRecord,
+                                                  configRUN_TIME_COUNTER_TYPE xNow )
+{
+    return pxRecord->xRunTime + ( xNow - pxRecord->xSwitchedInAt );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,131 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Accounting of why tasks wake up, to find polling loops.
+ *
+ * A task that wakes up only to find there is nothing to do, such as
+ * prvMonitorTask() in main_integer.c, which wakes every 50 ms to check a flag,
+ * costs two context switches and a tick wake up each time for no benefit.
+ * When configUSE_WAKEUP_STATS is 1 the traceENTER_ and traceRETURN_ macros of
+ * the API functions that can block, and those of vTaskSwitchContext(), are
+ * defined in FreeRTOSConfig.h to record, for each task:
+ *
+ * - The number of times it woke up, by reason - a timeout (including the end
+ *   of a delay), a notification, a queue, a semaphore or mutex, an event
+ *   group, a stream or message buffer, or resuming after being preempted.
+ * - How many of the wake ups from blocking ended with the task blocking again
+ *   having run for less than wakeupMIN_WORK_US - the ones that did no
+ *   measurable work.
+ *
+ * A task whose wake ups are mostly timeouts, and mostly do no work, is
+ * reported as polling.  It would be better woken by the event it is waiting
+ * for, such as a notification.
+ *
+ * A wake up from blocking is only counted for a call in which the kernel
+ * blocked the task - one in which the task was switched out after leaving its
+ * ready list.  A call that yields to a higher priority task it woke counts as
+ * a preemption.
+ *
+ * A task is recorded from the first time it is switched in or makes a call
+ * that can block.  The traceENTER_ macro of vTaskDelete() calls
+ * vWakeupStatsTaskDeleted(), after which the record of the deleted task is
+ * kept until it is needed.  A new task takes the record of a deleted task of
+ * the same name, adding to its counts, so tasks that are created and deleted
+ * repeatedly do not fill the wakeupMAX_TASKS records.
+ */
+
+#ifndef WAKEUP_STATS_H
+#define WAKEUP_STATS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The most tasks that can be recorded. */
+#ifndef wakeupMAX_TASKS
+    #define wakeupMAX_TASKS    ( 96 )
+#endif
+
+/* A wake up after which the task runs for less than this before blocking
+ * again did no measurable work.  The run time counter has a resolution of
+ * 10 us. */
+#ifndef wakeupMIN_WORK_US
+    #define wakeupMIN_WORK_US    ( 50UL )
+#endif
+
+/* A task is polling if it has woken from blocking at least this many times,
+ * and at least wakeupPOLLING_PERCENT of those wake ups were timeouts, and at
+ * least wakeupPOLLING_PERCENT did no work. */
+#ifndef wakeupPOLLING_MIN_WAKEUPS
+    #define wakeupPOLLING_MIN_WAKEUPS    ( 10UL )
+#endif
+
+#ifndef wakeupPOLLING_PERCENT
+    #define wakeupPOLLING_PERCENT    ( 50UL )
+#endif
+
+/* The reasons a task wakes up. */
+typedef enum
+{
+    eWakeupTimeout = 0,
+    eWakeupNotification,
+    eWakeupQueue,
+    eWakeupSemaphore,           /* Including mutexes. */
+    eWakeupEventGroup,
+    eWakeupStreamBuffer,
+    eWakeupPreemption,          /* Resumed after being preempted or yielding, rather than woken from blocking. */
+    eWakeupReasonCount
+} eWakeupReason;
+
+typedef struct xWAKEUP_STATS
+{
+    char acTaskName[ configMAX_TASK_NAME_LEN ];
+    uint32_t ulWakeups[ eWakeupReasonCount ];
+    uint32_t ulBlockedWakeups;      /* The wake ups from blocking - all but eWakeupPreemption... */
+    uint32_t ulIdleWakeups;         /* ...and those that did no measurable work. */
+    BaseType_t xPolling;            /* pdTRUE if the task is polling, as described above. */
+} WakeupStats_t;
+
+/*
+ * Copy the statistics of the uxIndex'th task recorded into pxStats.  Returns
+ * pdFAIL if there is no such task.
+ */
+BaseType_t xWakeupStatsGet( UBaseType_t uxIndex,
+                            WakeupStats_t * pxStats );
+
+/*
+ * Return the name of a wake up reason, such as "Timeout".
+ */
+const char * pcWakeupStatsReasonName( eWakeupReason eReason );
+
+/*
+ * Print the wake ups of each task that has woken, marking those that are
+ * polling.  Makes Windows system calls, so must be called from a critical
+ * section.
+ */
+void vWakeupStatsPrint( void );
+
+#endif /* WAKEUP_STATS_H */
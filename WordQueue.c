@@ -0,0 +1,472 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * See the comments at the top of WordQueue.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Demo includes. */
+#include "WordQueue.h"
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Copy one item.  The item size is only known at run time, so this is not a
+ * compile time specialisation - but it can only be one of three values, and
+ * each case has a constant length, so the compiler replaces each memcpy() with
+ * moves of that size.  A copy therefore costs one switch on the size rather
+ * than a call to a general memcpy().  The typed functions, such as
+ * xWordQueueSend32(), avoid the switch too.  memcpy() is used rather than a cast so
+ * the caller's buffer does not have to be aligned.
+ */
+static void prvCopyItem( void * pvDestination,
+                         const void * pvSource,
+                         UBaseType_t uxItemSize );
+
+/*
+ * Write an item to, or read an item from, a queue that is known not to be
+ * full or empty respectively.  Must be called from a critical section.
+ */
+static void prvWriteItem( WordQueueHandle_t xQueue,
+                          const void * pvItemToQueue );
+static void prvReadItem( WordQueueHandle_t xQueue,
+                         void * pvBuffer );
+
+/*
+ * Move the write or read index past the item just copied to or from
+ * xQueue->pucStorage, and count it.  Must be called from a critical section.
+ */
+static void prvItemWritten( WordQueueHandle_t xQueue );
+static void prvItemRead( WordQueueHandle_t xQueue );
+
+/*
+ * Initialise the state of a newly created queue.
+ */
+static void prvInitialiseQueue( WordQueueHandle_t xQueue,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxItemSize,
+                                uint8_t * pucStorage );
+
+/*-----------------------------------------------------------*/
+
+WordQueueHandle_t xWordQueueCreate( UBaseType_t uxLength,
+                                    UBaseType_t uxItemSize )
+{
+    WordQueueHandle_t xQueue;
+
+    /* The state and the storage area are allocated in one block. */
+    xQueue = ( WordQueueHandle_t ) pvPortMalloc( sizeof( StaticWordQueue_t ) + ( uxLength * uxItemSize ) );
+
+    if( xQueue != NULL )
+    {
+        prvInitialiseQueue( xQueue, uxLength, uxItemSize, ( uint8_t * ) ( xQueue + 1 ) );
+        xQueue->ucStaticallyAllocated = pdFALSE;
+    }
+
+    return xQueue;
+}
+/*-----------------------------------------------------------*/
+
+WordQueueHandle_t xWordQueueCreateStatic( UBaseType_t uxLength,
+                                          UBaseType_t uxItemSize,
+                                          uint8_t * pucQueueStorage,
+                                          StaticWordQueue_t * pxStaticQueue )
+{
+    configASSERT( pxStaticQueue );
+    configASSERT( ( pucQueueStorage != NULL ) || ( uxItemSize == 0 ) );
+
+    prvInitialiseQueue( pxStaticQueue, uxLength, uxItemSize, pucQueueStorage );
+    pxStaticQueue->ucStaticallyAllocated = pdTRUE;
+
+    return pxStaticQueue;
+}
+/*-----------------------------------------------------------*/
+
+void vWordQueueDelete( WordQueueHandle_t xQueue )
+{
+    configASSERT( xWaitListIsEmpty( &( xQueue->xTasksWaitingToSend ) ) );
+    configASSERT( xWaitListIsEmpty( &( xQueue->xTasksWaitingToReceive ) ) );
+
+    if( xQueue->ucStaticallyAllocated == pdFALSE )
+    {
+        vPortFree( xQueue );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueSend( WordQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    TaskHandle_t xTaskToWake;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+            {
+                prvWriteItem( xQueue, pvItemToQueue );
+                xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+                taskEXIT_CRITICAL();
+
+                vWaitListNotify( xTaskToWake );
+                return pdPASS;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_FULL;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xQueue->xTasksWaitingToSend ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xQueue->xTasksWaitingToSend ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueReceive( WordQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    WaitListItem_t xWaitItem;
+    TaskHandle_t xTaskToWake;
+    BaseType_t xEntryTimeSet = pdFALSE, xCanWait = pdTRUE;
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                prvReadItem( xQueue, pvBuffer );
+                xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+                taskEXIT_CRITICAL();
+
+                vWaitListNotify( xTaskToWake );
+                return pdPASS;
+            }
+
+            if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xCanWait == pdFALSE ) )
+            {
+                taskEXIT_CRITICAL();
+                return errQUEUE_EMPTY;
+            }
+
+            if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+
+            vWaitListInsert( &( xQueue->xTasksWaitingToReceive ), &xWaitItem );
+        }
+        taskEXIT_CRITICAL();
+
+        xCanWait = xWaitListWait( &( xQueue->xTasksWaitingToReceive ), &xWaitItem, &xTimeOut, &xTicksToWait );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueSendFromISR( WordQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    TaskHandle_t xTaskToWake = NULL;
+    BaseType_t xReturn = errQUEUE_FULL;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+        {
+            prvWriteItem( xQueue, pvItemToQueue );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    vWaitListNotifyFromISR( xTaskToWake, pxHigherPriorityTaskWoken );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueReceiveFromISR( WordQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    TaskHandle_t xTaskToWake = NULL;
+    BaseType_t xReturn = errQUEUE_EMPTY;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            prvReadItem( xQueue, pvBuffer );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+            xReturn = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    vWaitListNotifyFromISR( xTaskToWake, pxHigherPriorityTaskWoken );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueSend32( WordQueueHandle_t xQueue,
+                             uint32_t ulItemToQueue,
+                             TickType_t xTicksToWait )
+{
+    TaskHandle_t xTaskToWake;
+
+    configASSERT( xQueue->uxItemSize == sizeof( uint32_t ) );
+
+    taskENTER_CRITICAL();
+    {
+        if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+        {
+            /* memcpy() of a constant size compiles to a single move, without
+             * requiring the storage to be aligned. */
+            memcpy( &( xQueue->pucStorage[ xQueue->uxWriteIndex * sizeof( uint32_t ) ] ), &ulItemToQueue, sizeof( uint32_t ) );
+            prvItemWritten( xQueue );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+            taskEXIT_CRITICAL();
+
+            vWaitListNotify( xTaskToWake );
+            return pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    /* The queue is full, so wait as any other send does. */
+    return xWordQueueSend( xQueue, &ulItemToQueue, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueReceive32( WordQueueHandle_t xQueue,
+                                uint32_t * pulBuffer,
+                                TickType_t xTicksToWait )
+{
+    TaskHandle_t xTaskToWake;
+
+    configASSERT( xQueue->uxItemSize == sizeof( uint32_t ) );
+
+    taskENTER_CRITICAL();
+    {
+        if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            memcpy( pulBuffer, &( xQueue->pucStorage[ xQueue->uxReadIndex * sizeof( uint32_t ) ] ), sizeof( uint32_t ) );
+            prvItemRead( xQueue );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+            taskEXIT_CRITICAL();
+
+            vWaitListNotify( xTaskToWake );
+            return pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xWordQueueReceive( xQueue, pulBuffer, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueSend64( WordQueueHandle_t xQueue,
+                             uint64_t ullItemToQueue,
+                             TickType_t xTicksToWait )
+{
+    TaskHandle_t xTaskToWake;
+
+    configASSERT( xQueue->uxItemSize == sizeof( uint64_t ) );
+
+    taskENTER_CRITICAL();
+    {
+        if( xQueue->uxMessagesWaiting < xQueue->uxLength )
+        {
+            memcpy( &( xQueue->pucStorage[ xQueue->uxWriteIndex * sizeof( uint64_t ) ] ), &ullItemToQueue, sizeof( uint64_t ) );
+            prvItemWritten( xQueue );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToReceive ) );
+            taskEXIT_CRITICAL();
+
+            vWaitListNotify( xTaskToWake );
+            return pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xWordQueueSend( xQueue, &ullItemToQueue, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWordQueueReceive64( WordQueueHandle_t xQueue,
+                                uint64_t * pullBuffer,
+                                TickType_t xTicksToWait )
+{
+    TaskHandle_t xTaskToWake;
+
+    configASSERT( xQueue->uxItemSize == sizeof( uint64_t ) );
+
+    taskENTER_CRITICAL();
+    {
+        if( xQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            memcpy( pullBuffer, &( xQueue->pucStorage[ xQueue->uxReadIndex * sizeof( uint64_t ) ] ), sizeof( uint64_t ) );
+            prvItemRead( xQueue );
+            xTaskToWake = xWaitListRemoveHighest( &( xQueue->xTasksWaitingToSend ) );
+            taskEXIT_CRITICAL();
+
+            vWaitListNotify( xTaskToWake );
+            return pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xWordQueueReceive( xQueue, pullBuffer, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxWordQueueMessagesWaiting( WordQueueHandle_t xQueue )
+{
+    /* A single read of a naturally aligned word is atomic. */
+    return xQueue->uxMessagesWaiting;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyItem( void * pvDestination,
+                         const void * pvSource,
+                         UBaseType_t uxItemSize )
+{
+    switch( uxItemSize )
+    {
+        case sizeof( uint32_t ):
+            memcpy( pvDestination, pvSource, sizeof( uint32_t ) );
+            break;
+
+        case sizeof( uint64_t ):
+            memcpy( pvDestination, pvSource, sizeof( uint64_t ) );
+            break;
+
+        case ( 2 * sizeof( uint64_t ) ):
+            memcpy( pvDestination, pvSource, 2 * sizeof( uint64_t ) );
+            break;
+
+        default:
+            /* Zero sized items carry no data. */
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteItem( WordQueueHandle_t xQueue,
+                          const void * pvItemToQueue )
+{
+    prvCopyItem( &( xQueue->pucStorage[ xQueue->uxWriteIndex * xQueue->uxItemSize ] ), pvItemToQueue, xQueue->uxItemSize );
+    prvItemWritten( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvItemWritten( WordQueueHandle_t xQueue )
+{
+    xQueue->uxWriteIndex++;
+
+    if( xQueue->uxWriteIndex == xQueue->uxLength )
+    {
+        xQueue->uxWriteIndex = 0;
+    }
+
+    xQueue->uxMessagesWaiting++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReadItem( WordQueueHandle_t xQueue,
+                         void * pvBuffer )
+{
+    prvCopyItem( pvBuffer, &( xQueue->pucStorage[ xQueue->uxReadIndex * xQueue->uxItemSize ] ), xQueue->uxItemSize );
+    prvItemRead( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvItemRead( WordQueueHandle_t xQueue )
+{
+    xQueue->uxReadIndex++;
+
+    if( xQueue->uxReadIndex == xQueue->uxLength )
+    {
+        xQueue->uxReadIndex = 0;
+    }
+
+    xQueue->uxMessagesWaiting--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseQueue( WordQueueHandle_t xQueue,
+                                UBaseType_t uxLength,
+                                UBaseType_t uxItemSize,
+                                uint8_t * pucStorage )
+{
+    /* Only the sizes prvCopyItem() has a fast path for are supported. */
+    configASSERT( ( uxItemSize == 0 ) ||
+                  ( uxItemSize == sizeof( uint32_t ) ) ||
+                  ( uxItemSize == sizeof( uint64_t ) ) ||
+                  ( uxItemSize == ( 2 * sizeof( uint64_t ) ) ) );
+    configASSERT( uxLength > ( UBaseType_t ) 0 );
+
+    xQueue->pucStorage = pucStorage;
+    xQueue->uxLength = uxLength;
+    xQueue->uxItemSize = uxItemSize;
+    xQueue->uxReadIndex = 0;
+    xQueue->uxWriteIndex = 0;
+    xQueue->uxMessagesWaiting = 0;
+    vWaitListInitialise( &( xQueue->xTasksWaitingToSend ) );
+    vWaitListInitialise( &( xQueue->xTasksWaitingToReceive ) );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,141 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A FIFO queue for items of 0, 4, 8 or 16 bytes - the sizes most queues in
+ * this demo actually carry.
+ *
+ * The kernel's queues copy every item with a memcpy() of run time length and
+ * maintain trace and queue set state on every access.  A word queue only
+ * supports a few item sizes, so each copy is a switch on the size followed by
+ * one or two register sized moves, and a zero sized item is not copied at all
+ * (the queue is then a counting semaphore).  Queues of 4 and 8 byte items can
+ * also be used through typed functions, such as xWordQueueSend32(), that pass
+ * the item by value and copy it with a move whose size is fixed at compile
+ * time, so not even the switch is needed.  Blocking behaves as for the
+ * kernel's queues: the highest priority waiter is unblocked first, and
+ * waiters of equal priority are unblocked in the order they blocked.  See
+ * WaitList.h.
+ *
+ * Word queues cannot be members of a queue set and are not seen by the trace
+ * recorder.  Use a kernel queue when either is needed, or when the item size
+ * is not one of the sizes listed above.
+ */
+
+#ifndef WORD_QUEUE_H
+#define WORD_QUEUE_H
+
+#include "FreeRTOS.h"
+#include "WaitList.h"
+
+/* The structure is only visible so queues can be statically allocated - its
+ * members must not be accessed directly. */
+typedef struct xWORD_QUEUE
+{
+    uint8_t * pucStorage;
+    UBaseType_t uxLength;
+    UBaseType_t uxItemSize;
+    UBaseType_t uxReadIndex;
+    UBaseType_t uxWriteIndex;
+    volatile UBaseType_t uxMessagesWaiting;
+    WaitList_t xTasksWaitingToSend;
+    WaitList_t xTasksWaitingToReceive;
+    uint8_t ucStaticallyAllocated;
+} StaticWordQueue_t;
+
+typedef StaticWordQueue_t * WordQueueHandle_t;
+
+/*
+ * Create a queue that can hold uxLength items of uxItemSize bytes each.
+ * uxItemSize must be 0, 4, 8 or 16.  Returns NULL if there is not enough heap.
+ */
+WordQueueHandle_t xWordQueueCreate( UBaseType_t uxLength,
+                                    UBaseType_t uxItemSize );
+
+/*
+ * As xWordQueueCreate(), but using pucQueueStorage, which must be at least
+ * uxLength * uxItemSize bytes (NULL when uxItemSize is 0), to hold the items
+ * and pxStaticQueue to hold the queue's state.
+ */
+WordQueueHandle_t xWordQueueCreateStatic( UBaseType_t uxLength,
+                                          UBaseType_t uxItemSize,
+                                          uint8_t * pucQueueStorage,
+                                          StaticWordQueue_t * pxStaticQueue );
+
+/*
+ * Delete a queue.  No tasks can be blocked on the queue when it is deleted.
+ */
+void vWordQueueDelete( WordQueueHandle_t xQueue );
+
+/*
+ * Equivalent to xQueueSend(), xQueueReceive(), xQueueSendFromISR() and
+ * xQueueReceiveFromISR() respectively.  pvItemToQueue and pvBuffer can be NULL
+ * when the item size is 0.
+ */
+BaseType_t xWordQueueSend( WordQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait );
+
+BaseType_t xWordQueueReceive( WordQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait );
+
+BaseType_t xWordQueueSendFromISR( WordQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * pxHigherPriorityTaskWoken );
+
+BaseType_t xWordQueueReceiveFromISR( WordQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Equivalent to xWordQueueSend() and xWordQueueReceive() for queues created
+ * with an item size of 4 (the 32 functions) or 8 (the 64 functions) bytes.
+ * The item is passed by value, and is copied with a fixed size move unless
+ * the call has to wait.
+ */
+BaseType_t xWordQueueSend32( WordQueueHandle_t xQueue,
+                             uint32_t ulItemToQueue,
+                             TickType_t xTicksToWait );
+
+BaseType_t xWordQueueReceive32( WordQueueHandle_t xQueue,
+                                uint32_t * pulBuffer,
+                                TickType_t xTicksToWait );
+
+BaseType_t xWordQueueSend64( WordQueueHandle_t xQueue,
+                             uint64_t ullItemToQueue,
+                             TickType_t xTicksToWait );
+
+BaseType_t xWordQueueReceive64( WordQueueHandle_t xQueue,
+                                uint64_t * pullBuffer,
+                                TickType_t xTicksToWait );
+
+/*
+ * Returns the number of items in the queue.
+ */
+UBaseType_t uxWordQueueMessagesWaiting( WordQueueHandle_t xQueue );
+
+#endif /* WORD_QUEUE_H */
@@ -50,6 +50,7 @@
 /* Standard includes. */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <conio.h>
 
 #ifdef WIN32_LEAN_AND_MEAN
@@ -66,6 +67,22 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* Demo includes. */
+#include "BasicTask.h"
+#include "BlockedTime.h"
+#include "ContextSwitch.h"
+#include "ControlSocket.h"
+#include "DepthSampler.h"
+#include "FrameScheduler.h"
+#include "HostIO.h"
+#include "InterruptController.h"
+#include "LoadEstimator.h"
+#include "RateLimiter.h"
+#include "SamplingProfiler.h"
+#include "TickMonitor.h"
+#include "TimerStats.h"
+#include "WakeupStats.h"
+
 /* FreeRTOS+Trace includes. */
 //#include "trcRecorder.h"
 
@@ -81,6 +98,18 @@
  * implemented and described in main_full.c. */
 #define mainCREATE_SIMPLE_BLINKY_DEMO_ONLY    1
 
+/* If mainRUN_BENCHMARKS is 1 then neither demo is built.  Instead the
+ * benchmarks implemented and described in main_benchmark.c are run, and
+ * mainCREATE_SIMPLE_BLINKY_DEMO_ONLY is ignored. */
+#define mainRUN_BENCHMARKS                    0
+
+/* The tick is always measured, see TickMonitor.h.  If
+ * mainCATCH_UP_MISSED_TICKS is 1 the ticks the Windows port fails to generate
+ * are also caught up, so the tick count keeps to wall clock time.  Ticks are
+ * then caught up in bursts, which the timing tolerances of some standard demo
+ * tasks do not allow for, so it is off by default. */
+#define mainCATCH_UP_MISSED_TICKS             0
+
 /* This demo uses heap_5.c, and these constants define the sizes of the regions
  * that make up the total heap.  heap_5 is only used for test and example purposes
  * as this demo could easily create one large heap region instead of multiple
@@ -93,19 +122,51 @@
 /* This demo allows for users to perform actions with the keyboard. */
 #define mainNO_KEY_PRESS_VALUE                -1
 #define mainOUTPUT_TRACE_KEY                  't'
+#define mainOUTPUT_TIMER_STATS_KEY            'c'
+#define mainOUTPUT_FRAME_STATS_KEY            'f'
+#define mainOUTPUT_LOAD_KEY                   'l'
+#define mainOUTPUT_DEPTH_KEY                  'q'
+#define mainPROFILER_KEY                      'p'
+#define mainOUTPUT_INTERRUPTS_KEY             'i'
+#define mainOUTPUT_BLOCKED_TIME_KEY           'w'
+#define mainOUTPUT_BASIC_TASKS_KEY            'b'
+#define mainOUTPUT_WAKEUPS_KEY                'u'
+#define mainOUTPUT_SWITCHES_KEY               'x'
+#define mainOUTPUT_TICK_JITTER_KEY            'j'
 #define mainINTERRUPT_NUMBER_KEYBOARD         3
 
 /* This demo allows to save a trace file. */
 #define mainTRACE_FILE_NAME                   "Trace.dump"
 
+/* Each time the trace is saved the recorder's object usage is also written
+ * here, see TRC_CFG_USE_OBJECT_PROFILE in trcConfig.h.  The project directory
+ * is on the include path, so the file is picked up by the next build. */
+#define mainTRACE_PROFILE_FILE_NAME           "trcObjectProfile.h"
+
+/* Each time the trace is saved the statistics gathered since the scheduler
+ * started are also written here, so two runs can be compared with
+ * tools/trace_stats_diff.py. */
+#define mainTRACE_STATS_FILE_NAME             "Trace.stats.json"
+
+/* The queue and stream buffer depth timeline is saved here, see
+ * DepthSampler.h. */
+#define mainDEPTH_TIMELINE_FILE_NAME          "Depth-timeline.csv"
+
+/* The records the "blocked" control command returns by default, and the most
+ * that fit in a result. */
+#define mainBLOCKED_COMMAND_DEFAULT_RECORDS   ( 4 )
+#define mainBLOCKED_COMMAND_MAX_RECORDS       ( 5 )
+
 /*-----------------------------------------------------------*/
 
 /*
  * main_blinky() is used when mainCREATE_SIMPLE_BLINKY_DEMO_ONLY is set to 1.
  * main_full() is used when mainCREATE_SIMPLE_BLINKY_DEMO_ONLY is set to 0.
+ * main_benchmark() is used when mainRUN_BENCHMARKS is set to 1.
  */
 extern void main_blinky( void );
 extern void main_full( void );
+extern void main_benchmark( void );
 
 /*
  * Only the comprehensive demo uses application hook (callback) functions.  See
@@ -122,6 +183,13 @@ extern void vFullDemoIdleFunction( void );
  */
 static void prvInitialiseHeap( void );
 
+/*
+ * Allocate memory backed by large pages, falling back to normal pages.  Used
+ * when configUSE_LARGE_PAGES is set to 1.  Implemented in Large-page-utils.c.
+ */
+extern void * pvLargePageAlloc( size_t xSize );
+extern BaseType_t xLargePagesInUse( void );
+
 /*
  * Prototypes for the standard FreeRTOS application hook (callback) functions
  * implemented within this file.  See http://www.freertos.org/a00016.html .
@@ -141,8 +209,31 @@ void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
 /*
  * Writes trace data to a disk file when the trace recording is stopped.
  * This function will simply overwrite any trace files that already exist.
+ * Returns pdFAIL if the file could not be created.
  */
-static void prvSaveTraceFile( void );
+static BaseType_t prvSaveTraceFile( void );
+
+/*
+ * The control socket commands implemented in this file.  See ControlSocket.h.
+ */
+static BaseType_t prvTraceDumpCommand( const char * pcArguments,
+                                       char * pcResult,
+                                       size_t xResultLength );
+static BaseType_t prvTraceFilterCommand( const char * pcArguments,
+                                         char * pcResult,
+                                         size_t xResultLength );
+static BaseType_t prvStatsCommand( const char * pcArguments,
+                                   char * pcResult,
+                                   size_t xResultLength );
+static BaseType_t prvDepthCommand( const char * pcArguments,
+                                   char * pcResult,
+                                   size_t xResultLength );
+static BaseType_t prvProfileCommand( const char * pcArguments,
+                                     char * pcResult,
+                                     size_t xResultLength );
+static BaseType_t prvBlockedCommand( const char * pcArguments,
+                                     char * pcResult,
+                                     size_t xResultLength );
 
 /*
  * Windows thread function to capture keyboard input from outside of the
@@ -161,6 +252,20 @@ static uint32_t prvKeyboardInterruptHandler( void );
  */
 extern void vBlinkyKeyboardInterruptHandler( int xKeyPressed );
 
+/*
+ * Writes the trace recorder's object table usage to a header file that can be
+ * used to size the recorder for the next build.  Implemented in
+ * Trace-profile-utils.c.
+ */
+extern void vTraceSaveObjectProfile( const char * pcFileName );
+
+/*
+ * Writes the task, object and queue statistics gathered by the demo to a JSON
+ * file.  Returns pdFAIL if the file could not be created.  Implemented in
+ * Trace-stats-utils.c.
+ */
+extern BaseType_t xTraceSaveStats( const char * pcFileName );
+
 /*-----------------------------------------------------------*/
 
 /* When configSUPPORT_STATIC_ALLOCATION is set to 1 the application writer can
@@ -171,6 +276,17 @@ extern void vBlinkyKeyboardInterruptHandler( int xKeyPressed );
 StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
 
 
+/* The control socket commands that apply to every demo. */
+static const ControlCommand_t xMainCommands[] =
+{
+    { "trace-dump",   "Save the trace to " mainTRACE_FILE_NAME,                                     prvTraceDumpCommand   },
+    { "trace-filter", "trace-filter <mask> - only record objects in the filter groups in mask",     prvTraceFilterCommand },
+    { "stats",        "Tick count, heap, idle time, load, frame scheduler and host I/O statistics", prvStatsCommand       },
+    { "depth",        "Depth, high water mark and ticks full and empty of each sampled queue",      prvDepthCommand       },
+    { "profile",      "profile <start|stop|status> - sample call stacks for a flame graph file",    prvProfileCommand     },
+    { "blocked",      "blocked [count] - the task and object pairs with the most blocked time",    prvBlockedCommand     }
+};
+
 /* Thread handle for the keyboard input Windows thread. */
 static HANDLE xWindowsKeyboardInputThreadHandle = NULL;
 
@@ -180,10 +296,16 @@ static HANDLE xWindowsKeyboardInputThreadHandle = NULL;
  * task and handled appropriately. */
 static int xKeyPressed = mainNO_KEY_PRESS_VALUE;
 
+/* Set by prvSaveTraceFile() to say whether the statistics were saved along
+ * with the trace. */
+static BaseType_t xTraceStatsSaved = pdFALSE;
+
 /*-----------------------------------------------------------*/
 
 int main( void )
 {
+    UBaseType_t uxCommand;
+
     /* This demo uses heap_5.c, so start by defining some heap regions.  heap_5
      * is only used for test and example reasons.  Heap_4 is more appropriate.  See
      * http://www.freertos.org/a00111.html for an explanation. */
@@ -191,6 +313,14 @@ int main( void )
 
     /* Initialise the trace recorder.  Use of the trace recorder is optional.
      * See http://www.FreeRTOS.org/trace for more information. */
+    #if ( configUSE_LARGE_PAGES == 1 )
+    {
+        /* The recorder uses a custom buffer in this case, see trcConfig.h. */
+        vTraceSetRecorderDataBuffer( pvLargePageAlloc( sizeof( RecorderDataType ) ) );
+
+        printf( "Heap and trace buffer use %s pages.\r\n", ( xLargePagesInUse() != pdFALSE ) ? "large" : "normal" );
+    }
+    #endif /* configUSE_LARGE_PAGES */
 
     configASSERT( xTraceInitialize() == TRC_SUCCESS );
 
@@ -201,8 +331,22 @@ int main( void )
         "The trace will be dumped to the file \"%s\" whenever a call to configASSERT()\r\n"
         "fails or the \'%c\' key is pressed.\r\n"
         "Note that the trace output uses the ring buffer mode, meaning that the output trace\r\n"
-        "will only be the most recent data able to fit within the trace recorder buffer.\r\n",
-        mainTRACE_FILE_NAME, mainOUTPUT_TRACE_KEY );
+        "will only be the most recent data able to fit within the trace recorder buffer.\r\n"
+        "Press the \'%c\' key to print timer callback execution statistics.\r\n"
+        "Press the \'%c\' key to print frame scheduler statistics.\r\n"
+        "Press the \'%c\' key to print the CPU load.\r\n"
+        "Press the \'%c\' key to print queue depths and save their timeline to \"%s\".\r\n"
+        "Press the \'%c\' key to start the sampling profiler, and again to save the profile to \"%s\".\r\n"
+        "Press the \'%c\' key to print interrupt controller statistics.\r\n"
+        "Press the \'%c\' key to print what the tasks spend longest waiting for.\r\n"
+        "Press the \'%c\' key to print basic task statistics.\r\n"
+        "Press the \'%c\' key to print why the tasks wake up, and which are polling.\r\n"
+        "Press the \'%c\' key to print why the tasks are switched out.\r\n"
+        "Press the \'%c\' key to print tick jitter and missed ticks.\r\n",
+        mainTRACE_FILE_NAME, mainOUTPUT_TRACE_KEY, mainOUTPUT_TIMER_STATS_KEY, mainOUTPUT_FRAME_STATS_KEY, mainOUTPUT_LOAD_KEY,
+        mainOUTPUT_DEPTH_KEY, mainDEPTH_TIMELINE_FILE_NAME, mainPROFILER_KEY, profilerOUTPUT_FILE_NAME, mainOUTPUT_INTERRUPTS_KEY,
+        mainOUTPUT_BLOCKED_TIME_KEY, mainOUTPUT_BASIC_TASKS_KEY, mainOUTPUT_WAKEUPS_KEY,
+        mainOUTPUT_SWITCHES_KEY, mainOUTPUT_TICK_JITTER_KEY );
 
     configASSERT( xTraceEnable( TRC_START ) == TRC_SUCCESS );
 
@@ -221,9 +365,53 @@ int main( void )
     /* Use the cores that are not used by the FreeRTOS tasks for the Windows thread. */
     SetThreadAffinityMask( xWindowsKeyboardInputThreadHandle, ~0x01u );
 
-    /* The mainCREATE_SIMPLE_BLINKY_DEMO_ONLY setting is described at the top
-     * of this file. */
-    #if ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 1 )
+    /* Start the thread that performs host I/O on behalf of the tasks. */
+    configASSERT( xHostIOStart() == pdPASS );
+
+    /* Create the sampling profiler's thread, which waits until the profiler
+     * is started.  This thread goes on to process the simulated interrupts,
+     * so the profiler must be initialised from here. */
+    configASSERT( xProfilerInit() == pdPASS );
+
+    /* Install the interrupt controller that the demos use to model the
+     * interrupt load of a device, see InterruptController.h. */
+    vIntCtrlInit();
+
+    /* Start the control socket, through which scripts can send the commands
+     * that apply to every demo, and those registered by the demo itself. */
+    for( uxCommand = 0; uxCommand < ( sizeof( xMainCommands ) / sizeof( xMainCommands[ 0 ] ) ); uxCommand++ )
+    {
+        xControlSocketRegister( &( xMainCommands[ uxCommand ] ) );
+    }
+
+    if( xControlSocketStart() == pdPASS )
+    {
+        printf( "Accepting commands on the control socket \"%s\".\r\n", ctrlSOCKET_PATH );
+    }
+    else
+    {
+        printf( "Could not create the control socket.\r\n" );
+    }
+
+    /* Measure how steady the tick is, see TickMonitor.h. */
+    configASSERT( xTickMonitorStart( mainCATCH_UP_MISSED_TICKS ) == pdPASS );
+
+    #if ( mainRUN_BENCHMARKS != 1 )
+    {
+        /* Estimate the recent CPU load, see LoadEstimator.h.  The benchmarks
+         * measure their own run time, so are not disturbed by the sampling. */
+        configASSERT( xLoadEstimatorStart() == pdPASS );
+    }
+    #endif
+
+    /* The mainCREATE_SIMPLE_BLINKY_DEMO_ONLY and mainRUN_BENCHMARKS settings
+     * are described at the top of this file. */
+    #if ( mainRUN_BENCHMARKS == 1 )
+    {
+        printf( "\nStarting the benchmarks.\r\n" );
+        main_benchmark();
+    }
+    #elif ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 1 )
     {
         printf( "\nStarting the blinky demo.\r\n" );
         main_blinky();
@@ -233,7 +421,7 @@ int main( void )
         printf( "\nStarting the full demo.\r\n" );
         main_full();
     }
-    #endif /* if ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 1 ) */
+    #endif /* if ( mainRUN_BENCHMARKS == 1 ) */
 
     return 0;
 }
@@ -269,7 +457,7 @@ void vApplicationIdleHook( void )
      * because it is the responsibility of the idle task to clean up memory
      * allocated by the kernel to any task that has since deleted itself. */
 
-    #if ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY != 1 )
+    #if ( ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY != 1 ) && ( mainRUN_BENCHMARKS != 1 ) )
     {
         /* Call the idle task processing used by the full demo.  The simple
          * blinky demo does not use the idle task hook. */
@@ -303,7 +491,17 @@ void vApplicationTickHook( void )
     * code must not attempt to block, and only the interrupt safe FreeRTOS API
     * functions can be used (those that end in FromISR()). */
 
-    #if ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY != 1 )
+    /* Deliver events that rate limiters are holding back, see
+     * RateLimiter.h. */
+    vRateLimiterTickHook();
+
+    /* Sample the depth of queues and stream buffers, see DepthSampler.h. */
+    vDepthSamplerTickHook();
+
+    /* Measure the tick's jitter, see TickMonitor.h. */
+    vTickMonitorTickHook();
+
+    #if ( ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY != 1 ) && ( mainRUN_BENCHMARKS != 1 ) )
     {
         vFullDemoTickHookFunction();
     }
@@ -359,9 +557,10 @@ void vAssertCalled( unsigned long ulLine,
 }
 /*-----------------------------------------------------------*/
 
-static void prvSaveTraceFile( void )
+static BaseType_t prvSaveTraceFile( void )
 {
     FILE * pxOutputFile;
+    BaseType_t xReturn = pdFAIL;
 
     fopen_s( &pxOutputFile, mainTRACE_FILE_NAME, "wb" );
 
@@ -370,11 +569,256 @@ static void prvSaveTraceFile( void )
         fwrite( RecorderDataPtr, sizeof( RecorderDataType ), 1, pxOutputFile );
         fclose( pxOutputFile );
         printf( "\r\nTrace output saved to %s\r\n\r\n", mainTRACE_FILE_NAME );
+
+        vTraceSaveObjectProfile( mainTRACE_PROFILE_FILE_NAME );
+
+        xTraceStatsSaved = xTraceSaveStats( mainTRACE_STATS_FILE_NAME );
+
+        if( xTraceStatsSaved == pdPASS )
+        {
+            printf( "Statistics saved to %s\r\n\r\n", mainTRACE_STATS_FILE_NAME );
+        }
+
+        xReturn = pdPASS;
     }
     else
     {
         printf( "\r\nFailed to create trace dump file\r\n\r\n" );
     }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTraceDumpCommand( const char * pcArguments,
+                                       char * pcResult,
+                                       size_t xResultLength )
+{
+    BaseType_t xReturn;
+
+    ( void ) pcArguments;
+
+    /* As for the trace key, the file is written from a critical section. */
+    portENTER_CRITICAL();
+    {
+        ( void ) xTraceDisable();
+        xReturn = prvSaveTraceFile();
+        ( void ) xTraceEnable( TRC_START );
+    }
+    portEXIT_CRITICAL();
+
+    /* The trace can be saved without its statistics, in which case there is
+     * no statistics file to report. */
+    if( ( xReturn == pdPASS ) && ( xTraceStatsSaved == pdPASS ) )
+    {
+        snprintf( pcResult, xResultLength, "{\"file\":\"%s\",\"stats\":\"%s\"}", mainTRACE_FILE_NAME, mainTRACE_STATS_FILE_NAME );
+    }
+    else if( xReturn == pdPASS )
+    {
+        snprintf( pcResult, xResultLength, "{\"file\":\"%s\",\"stats\":null}", mainTRACE_FILE_NAME );
+    }
+    else
+    {
+        snprintf( pcResult, xResultLength, "could not create %s", mainTRACE_FILE_NAME );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTraceFilterCommand( const char * pcArguments,
+                                         char * pcResult,
+                                         size_t xResultLength )
+{
+    char * pcEnd;
+    unsigned long ulMask;
+
+    ulMask = strtoul( pcArguments, &pcEnd, 0 );
+
+    if( ( pcEnd == pcArguments ) || ( ulMask > 0xFFFFUL ) )
+    {
+        snprintf( pcResult, xResultLength, "expected a 16-bit filter mask" );
+        return pdFAIL;
+    }
+
+    vTraceSetFilterMask( ( uint16_t ) ulMask );
+    snprintf( pcResult, xResultLength, "{\"mask\":%lu}", ulMask );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStatsCommand( const char * pcArguments,
+                                   char * pcResult,
+                                   size_t xResultLength )
+{
+    HostIOStats_t xHostIOStats;
+    LoadStats_t xLoad;
+
+    ( void ) pcArguments;
+
+    vHostIOGetStats( &xHostIOStats );
+    vLoadEstimatorGetSystemLoad( &xLoad );
+
+    snprintf( pcResult, xResultLength,
+              "{\"tick\":%lu,\"tasks\":%lu,\"freeHeap\":%lu,\"minFreeHeap\":%lu,\"idlePercent\":%lu,"
+              "\"load\":{\"1s\":%lu,\"10s\":%lu,\"60s\":%lu,\"average\":%lu},"
+              "\"frames\":%lu,\"frameOverruns\":%lu,"
+              "\"hostIO\":{\"requests\":%lu,\"writeCalls\":%lu,\"logBytesDropped\":%lu}}",
+              ( unsigned long ) xTaskGetTickCountFromISR(),
+              ( unsigned long ) uxTaskGetNumberOfTasks(),
+              ( unsigned long ) xPortGetFreeHeapSize(),
+              ( unsigned long ) xPortGetMinimumEverFreeHeapSize(),
+              ( unsigned long ) ulTaskGetIdleRunTimePercent(),
+              ( unsigned long ) xLoad.ulLoad1s,
+              ( unsigned long ) xLoad.ulLoad10s,
+              ( unsigned long ) xLoad.ulLoad60s,
+              ( unsigned long ) xLoad.ulLoadAverage,
+              ( unsigned long ) ulFrameSchedulerGetFrameCount(),
+              ( unsigned long ) ulFrameSchedulerGetOverrunCount(),
+              ( unsigned long ) xHostIOStats.ulRequests,
+              ( unsigned long ) xHostIOStats.ulWriteCalls,
+              ( unsigned long ) xHostIOStats.ulLogBytesDropped );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDepthCommand( const char * pcArguments,
+                                   char * pcResult,
+                                   size_t xResultLength )
+{
+    UBaseType_t uxIndex;
+    DepthStats_t xStats;
+    size_t xUsed = 0;
+    int iWritten;
+
+    ( void ) pcArguments;
+
+    pcResult[ xUsed++ ] = '[';
+
+    for( uxIndex = 0; xDepthSamplerGetStats( uxIndex, &xStats ) == pdPASS; uxIndex++ )
+    {
+        iWritten = snprintf( &( pcResult[ xUsed ] ), xResultLength - xUsed,
+                             "%s{\"name\":\"%s\",\"length\":%lu,\"depth\":%lu,\"highWaterMark\":%lu,\"ticksFull\":%lu,\"ticksEmpty\":%lu}",
+                             ( uxIndex == 0 ) ? "" : ",",
+                             xStats.pcName,
+                             ( unsigned long ) xStats.xLength,
+                             ( unsigned long ) xStats.xDepth,
+                             ( unsigned long ) xStats.xHighWaterMark,
+                             ( unsigned long ) xStats.ulTicksFull,
+                             ( unsigned long ) xStats.ulTicksEmpty );
+
+        /* Leave room for the closing bracket. */
+        if( ( iWritten < 0 ) || ( ( size_t ) iWritten >= ( xResultLength - xUsed - 1 ) ) )
+        {
+            snprintf( pcResult, xResultLength, "too many objects for the result" );
+            return pdFAIL;
+        }
+
+        xUsed += ( size_t ) iWritten;
+    }
+
+    pcResult[ xUsed++ ] = ']';
+    pcResult[ xUsed ] = '\0';
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvProfileCommand( const char * pcArguments,
+                                     char * pcResult,
+                                     size_t xResultLength )
+{
+    ProfilerStats_t xStats;
+
+    /* Starting and stopping the profiler signals its Windows thread. */
+    if( strcmp( pcArguments, "start" ) == 0 )
+    {
+        portENTER_CRITICAL();
+        {
+            vProfilerStart();
+        }
+        portEXIT_CRITICAL();
+    }
+    else if( strcmp( pcArguments, "stop" ) == 0 )
+    {
+        portENTER_CRITICAL();
+        {
+            vProfilerStop();
+        }
+        portEXIT_CRITICAL();
+    }
+    else if( strcmp( pcArguments, "status" ) != 0 )
+    {
+        snprintf( pcResult, xResultLength, "expected start, stop or status" );
+        return pdFAIL;
+    }
+
+    vProfilerGetStats( &xStats );
+    snprintf( pcResult, xResultLength, "{\"running\":%s,\"file\":\"%s\",\"samples\":%lu,\"stacks\":%lu,\"dropped\":%lu,\"missed\":%lu}",
+              ( xProfilerIsRunning() != pdFALSE ) ? "true" : "false",
+              profilerOUTPUT_FILE_NAME,
+              ( unsigned long ) xStats.ulSamples,
+              ( unsigned long ) xStats.ulStacks,
+              ( unsigned long ) xStats.ulDropped,
+              ( unsigned long ) xStats.ulMissed );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBlockedCommand( const char * pcArguments,
+                                     char * pcResult,
+                                     size_t xResultLength )
+{
+    static BlockedTimeStats_t xStats[ mainBLOCKED_COMMAND_MAX_RECORDS ];
+    UBaseType_t uxCount, uxIndex;
+    unsigned long ulRequested = mainBLOCKED_COMMAND_DEFAULT_RECORDS;
+    size_t xUsed = 0;
+    int iWritten;
+
+    if( ( *pcArguments != '\0' ) && ( ( sscanf( pcArguments, "%lu", &ulRequested ) != 1 ) || ( ulRequested == 0 ) || ( ulRequested > mainBLOCKED_COMMAND_MAX_RECORDS ) ) )
+    {
+        snprintf( pcResult, xResultLength, "expected a count from 1 to %d", mainBLOCKED_COMMAND_MAX_RECORDS );
+        return pdFAIL;
+    }
+
+    uxCount = uxBlockedTimeGetRanking( xStats, ( UBaseType_t ) ulRequested );
+
+    pcResult[ xUsed++ ] = '[';
+
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        iWritten = snprintf( &( pcResult[ xUsed ] ), xResultLength - xUsed,
+                             "%s{\"task\":\"%s\",\"object\":\"%s\",\"type\":\"%s\",\"calls\":%lu,\"blocked\":%lu,\"totalMs\":%lu,\"maxMs\":%lu,\"inversions\":%lu,\"inversionMs\":%lu,\"holder\":\"%s\",\"waiting\":%s}",
+                             ( uxIndex == 0 ) ? "" : ",",
+                             xStats[ uxIndex ].acTaskName,
+                             xStats[ uxIndex ].acObjectName,
+                             pcBlockedTimeObjectTypeName( xStats[ uxIndex ].ulObjectType ),
+                             ( unsigned long ) xStats[ uxIndex ].ulCalls,
+                             ( unsigned long ) xStats[ uxIndex ].ulBlocked,
+                             ( unsigned long ) xStats[ uxIndex ].ulTotalMs,
+                             ( unsigned long ) xStats[ uxIndex ].ulMaxMs,
+                             ( unsigned long ) xStats[ uxIndex ].ulInversions,
+                             ( unsigned long ) xStats[ uxIndex ].ulInversionMs,
+                             xStats[ uxIndex ].acHolderName,
+                             ( xStats[ uxIndex ].xWaiting != pdFALSE ) ? "true" : "false" );
+
+        /* Leave room for the closing bracket. */
+        if( ( iWritten < 0 ) || ( ( size_t ) iWritten >= ( xResultLength - xUsed - 1 ) ) )
+        {
+            snprintf( pcResult, xResultLength, "too many records for the result, ask for fewer" );
+            return pdFAIL;
+        }
+
+        xUsed += ( size_t ) iWritten;
+    }
+
+    pcResult[ xUsed++ ] = ']';
+    pcResult[ xUsed ] = '\0';
+
+    return pdPASS;
 }
 /*-----------------------------------------------------------*/
 
@@ -390,7 +834,11 @@ static void prvInitialiseHeap( void )
  * order, so this just creates one big array, then populates the structure with
  * offsets into the array - with gaps in between and messy alignment just for test
  * purposes. */
-    static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+    #if ( configUSE_LARGE_PAGES == 1 )
+        uint8_t * ucHeap = ( uint8_t * ) pvLargePageAlloc( configTOTAL_HEAP_SIZE );
+    #else
+        static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+    #endif
     volatile uint32_t ulAdditionalOffset = 19; /* Just to prevent 'condition is always true' warnings in configASSERT(). */
     const HeapRegion_t xHeapRegions[] =
     {
@@ -490,8 +938,140 @@ static uint32_t prvKeyboardInterruptHandler( void )
             portEXIT_CRITICAL();
             break;
 
+        case mainOUTPUT_TIMER_STATS_KEY:
+
+            /* Print the execution time of each timer callback, see
+             * TimerStats.h.  Printing requires Windows system calls, so again
+             * enter a critical section. */
+            portENTER_CRITICAL();
+            {
+                vTimerStatsPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_FRAME_STATS_KEY:
+
+            /* Print the frame overruns and the execution time of each frame
+             * scheduler runnable, see FrameScheduler.h. */
+            portENTER_CRITICAL();
+            {
+                vFrameSchedulerPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_LOAD_KEY:
+
+            /* Print the recent CPU load of the system and each task, see
+             * LoadEstimator.h. */
+            portENTER_CRITICAL();
+            {
+                vLoadEstimatorPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_DEPTH_KEY:
+
+            /* Print the occupancy of each sampled queue and stream buffer,
+             * and save the timeline of their depths, see DepthSampler.h. */
+            portENTER_CRITICAL();
+            {
+                vDepthSamplerPrint();
+
+                if( xDepthSamplerSaveTimeline( mainDEPTH_TIMELINE_FILE_NAME ) == pdPASS )
+                {
+                    printf( "Depth timeline saved to %s\r\n", mainDEPTH_TIMELINE_FILE_NAME );
+                }
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainPROFILER_KEY:
+
+            /* Start or stop the sampling profiler, see SamplingProfiler.h.
+             * The profile is written by the profiler's own thread. */
+            portENTER_CRITICAL();
+            {
+                if( xProfilerIsRunning() == pdFALSE )
+                {
+                    vProfilerStart();
+                    printf( "Profiler started\r\n" );
+                }
+                else
+                {
+                    vProfilerStop();
+                }
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_BLOCKED_TIME_KEY:
+
+            /* Print the tasks and objects with the most blocked time, see
+             * BlockedTime.h. */
+            portENTER_CRITICAL();
+            {
+                vBlockedTimePrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_BASIC_TASKS_KEY:
+
+            /* Print the activations of the basic tasks and the stack RAM they
+             * save, see BasicTask.h. */
+            portENTER_CRITICAL();
+            {
+                vBasicTaskPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_WAKEUPS_KEY:
+
+            /* Print the wake ups of each task, see WakeupStats.h. */
+            portENTER_CRITICAL();
+            {
+                vWakeupStatsPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_SWITCHES_KEY:
+
+            /* Print the context switches of each task, see ContextSwitch.h. */
+            portENTER_CRITICAL();
+            {
+                vContextSwitchPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_TICK_JITTER_KEY:
+
+            /* Print the tick measurements, see TickMonitor.h. */
+            portENTER_CRITICAL();
+            {
+                vTickMonitorPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
+        case mainOUTPUT_INTERRUPTS_KEY:
+
+            /* Print the counters of each interrupt controller line, see
+             * InterruptController.h. */
+            portENTER_CRITICAL();
+            {
+                vIntCtrlPrint();
+            }
+            portEXIT_CRITICAL();
+            break;
+
         default:
-            #if ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 1 )
+            #if ( ( mainCREATE_SIMPLE_BLINKY_DEMO_ONLY == 1 ) && ( mainRUN_BENCHMARKS != 1 ) )
                 /* Call the keyboard interrupt handler for the blinky demo. */
                 vBlinkyKeyboardInterruptHandler( xKeyPressed );
             #endif
@@ -0,0 +1,1336 @@
+/*
+ * FreeRTOS V202212.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/******************************************************************************
+ * NOTE: Windows will not be running the FreeRTOS demo threads continuously, so
+ * do not expect to get real time behaviour from the FreeRTOS Windows port, or
+ * this demo application.  The figures produced here are only meaningful when
+ * compared against figures produced by another build on the same host.
+ *
+ * NOTE 2:  This file implements the benchmark application, which is built in
+ * place of the blinky and full demos when mainRUN_BENCHMARKS is set to 1 in
+ * main.c.  Generic functions, such FreeRTOS hook functions, are defined in
+ * main.c.
+ ******************************************************************************
+ *
+ * main_benchmark() creates one task, then starts the scheduler.  The task runs
+ * each benchmark in turn, prints one result line per benchmark variant, and
+ * repeats the whole set mainBENCHMARK_RUNS times before deleting itself.
+ *
+ * Each result line gives the benchmark name, the variant measured, the number
+ * of operations performed and the mean cost of one operation in nanoseconds.
+ * The hooks that configUSE_BLOCKED_TIME_STATS, configUSE_WAKEUP_STATS,
+ * configUSE_CONTEXT_SWITCH_STATS and configUSE_ARENAS add to the kernel are
+ * measured too, so set them to 0 in FreeRTOSConfig.h to measure the kernel
+ * alone - a warning is printed if any is 1.
+ * Time is measured using the run time stats counter, see
+ * Run-time-stats-utils.c, so each benchmark performs enough operations for the
+ * counter's 10us resolution not to matter.
+ *
+ * Each result is also appended, as one line of JSON, to
+ * mainBENCHMARK_RESULTS_FILE_NAME, together with the git revision the demo was
+ * built from, a description of the configuration that affects the results,
+ * and the time the benchmarks started, which identifies the session.  The
+ * revision is marked "-dirty" if tracked files, such as FreeRTOSConfig.h or
+ * the project file that selects the heap implementation, have been changed
+ * since it was committed, in which case the session tells apart the results of
+ * different changes.
+ * The file is written through the host I/O thread (see HostIO.h), so the
+ * benchmark task blocks while the host writes it rather than holding a
+ * critical section.  tools/benchmark_compare.py compares the runs of two
+ * revisions or configurations, and reports the changes that are larger than
+ * the noise between runs.
+ *
+ * The benchmarks are:
+ *
+ * Heap:
+ * Keeps a set of live blocks of random size, allocated from the heap
+ * implementation the project builds (heap_5.c), freeing and replacing a
+ * random one on each operation and touching every page of the new block.  Run
+ * it with configUSE_LARGE_PAGES set to 0 and then 1 to see the effect of large
+ * pages on an allocator heavy workload.
+ *
+ * Trace:
+ * Sends to and receives from a queue with the trace recorder enabled, then
+ * again with it disabled, so the difference is the cost of writing to the
+ * recorder's event buffer.  Again compare runs with configUSE_LARGE_PAGES set
+ * to 0 and 1.
+ *
+ * Word queue:
+ * Sends to and receives from a kernel queue and then a word queue (see
+ * WordQueue.h) for each of the item sizes word queues support, with the trace
+ * recorder disabled so only the cost of the queues themselves is measured.
+ * For 4 and 8 byte items the word queue is measured again through its typed
+ * functions, such as xWordQueueSend32(), whose fixed size copies are compared
+ * with the size switch of xWordQueueSend().
+ *
+ * Priority queue:
+ * Sends bursts of messages with random priorities, then receives the whole
+ * burst in priority order, first using a priority queue (see PriorityQueue.h)
+ * and then using one kernel queue per priority level plus a queue set, which
+ * is the usual way of getting the same ordering from kernel objects.  Again
+ * the trace recorder is disabled.
+ *
+ * Stream buffer:
+ * Moves data through a stream buffer in chunks of 1 byte to 64KB, first with
+ * one xStreamBufferSend() and one xStreamBufferReceive() call per chunk, then
+ * with one xStreamBufferBulkSend() and one xStreamBufferBulkReceive() call per
+ * group of chunks (see StreamBufferBulk.h).  Each operation is one chunk sent
+ * and received, so the throughput is the chunk size divided by the time per
+ * operation.  Again the trace recorder is disabled.
+ *
+ * Stream buffer reader:
+ * The benefit of bulk transfers is fewer wake ups of a blocked reader, which a
+ * single task cannot show.  Here a reader task, with a higher priority than the
+ * benchmark task, blocks on the buffer while the benchmark task writes groups
+ * of small chunks.  The reader receives with xStreamBufferReceive(), with
+ * xStreamBufferBulkReceive() while the writer uses xStreamBufferBulkSend(),
+ * and with xStreamBufferReceiveBatch(), then the same is repeated for a message
+ * buffer with xMessageBufferReceive() and then the bulk message buffer
+ * functions.  Each operation is one chunk written and read, and the number of
+ * times the reader was woken is printed after each result.
+ *
+ * Arena:
+ * Handles a series of requests, each of which allocates a number of small
+ * objects of random size and frees them all when the request completes, first
+ * with one pvPortMalloc() and one vPortFree() call per object, then with one
+ * pvArenaAlloc() call per object and one vArenaReset() call per request (see
+ * Arena.h).  Each operation is one object allocated and freed.  The arena is
+ * created and deleted by each run of the benchmark.
+ *
+ * Topic:
+ * Delivers bursts of messages to 1, 2, 4, 8 and then 16 readers, first
+ * through a topic (see Topic.h), which each reader reads in place, and then
+ * by copying each message into one kernel queue per reader.  Each operation
+ * is one message delivered to every reader, so the results show how the cost
+ * of each grows with the number of readers.  Again the trace recorder is
+ * disabled.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* Demo includes. */
+#include "WordQueue.h"
+#include "PriorityQueue.h"
+#include "StreamBufferBulk.h"
+#include "Arena.h"
+#include "Topic.h"
+#include "HostIO.h"
+
+/* The benchmark task runs above all the tasks it creates or communicates
+ * with, but below the timer task. */
+#define mainBENCHMARK_TASK_PRIORITY        ( configMAX_PRIORITIES - 2 )
+
+/* The number of times the whole set of benchmarks is run, so the variation
+ * between runs can be measured. */
+#define mainBENCHMARK_RUNS                 ( 5 )
+
+/* The file each result is appended to, see the comments at the top of this
+ * file. */
+#define mainBENCHMARK_RESULTS_FILE_NAME    "BenchmarkResults.jsonl"
+
+/* The git revision recorded with the results is read from the repository the
+ * demo is run in, unless mainBENCHMARK_REVISION is defined.  Any output from
+ * mainGIT_STATUS_COMMAND means tracked files have been changed. */
+#define mainGIT_DIRECTORY                  ".git/"
+#define mainGIT_STATUS_COMMAND             "git status --porcelain --untracked-files=no 2>NUL"
+#define mainMAX_REVISION_LENGTH            ( 72 )
+#define mainMAX_SESSION_LENGTH             ( 16 )
+#define mainMAX_CONFIGURATION_LENGTH       ( 192 )
+#define mainMAX_RESULT_LENGTH              ( 384 )
+
+/* The seed of the pseudo random number generator at the start of each run. */
+#define mainRAND_SEED                      ( 0x12345678UL )
+
+/* Parameters for the heap benchmark. */
+#define mainHEAP_BENCHMARK_OPERATIONS      ( 200000UL )
+#define mainHEAP_BENCHMARK_LIVE_BLOCKS     ( 64 )
+#define mainHEAP_BENCHMARK_MIN_BLOCK       ( 16 )
+#define mainHEAP_BENCHMARK_MAX_BLOCK       ( 4096 )
+#define mainHEAP_BENCHMARK_PAGE_SIZE       ( 4096 )
+
+/* Parameters for the trace benchmark. */
+#define mainTRACE_BENCHMARK_OPERATIONS     ( 200000UL )
+
+/* Parameters for the word queue benchmark. */
+#define mainWORD_QUEUE_BENCHMARK_OPERATIONS    ( 500000UL )
+#define mainWORD_QUEUE_BENCHMARK_LENGTH        ( 8 )
+#define mainWORD_QUEUE_MAX_ITEM_SIZE           ( 16 )
+
+/* Parameters for the priority queue benchmark. */
+#define mainPRIORITY_QUEUE_BENCHMARK_BURSTS    ( 20000UL )
+#define mainPRIORITY_QUEUE_BURST_LENGTH        ( 16 )
+#define mainPRIORITY_QUEUE_LEVELS              ( 4 )
+
+/* Parameters for the stream buffer benchmark.  Each size moves at least
+ * mainSTREAM_BENCHMARK_BYTES bytes, in at least
+ * mainSTREAM_BENCHMARK_MIN_TRANSFERS groups of up to
+ * mainSTREAM_BENCHMARK_VECTORS chunks.  The buffer must fit in the largest
+ * heap region defined in main.c. */
+#define mainSTREAM_BENCHMARK_BYTES             ( 1024UL * 1024UL )
+#define mainSTREAM_BENCHMARK_MIN_TRANSFERS     ( 1000UL )
+#define mainSTREAM_BENCHMARK_VECTORS           ( 8 )
+#define mainSTREAM_BENCHMARK_MAX_CHUNK         ( 64 * 1024 )
+#define mainSTREAM_BENCHMARK_BUFFER_SIZE       ( 2 * mainSTREAM_BENCHMARK_MAX_CHUNK )
+
+/* Parameters for the stream buffer reader benchmark.  Each group is
+ * mainSTREAM_BENCHMARK_VECTORS chunks.  The reader runs above the benchmark
+ * task, so runs as soon as it is woken, and uses its own notification index
+ * for the start and end of each variant so the notifications the stream
+ * buffers use are not disturbed. */
+#define mainSTREAM_READER_GROUPS               ( 5000UL )
+#define mainSTREAM_READER_CHUNK                ( 16 )
+#define mainSTREAM_READER_GROUP_BYTES          ( mainSTREAM_BENCHMARK_VECTORS * mainSTREAM_READER_CHUNK )
+#define mainSTREAM_READER_BUFFER_SIZE          ( 4 * mainSTREAM_READER_GROUP_BYTES )
+#define mainSTREAM_READER_PRIORITY             ( mainBENCHMARK_TASK_PRIORITY + 1 )
+#define mainSTREAM_READER_NOTIFICATION_INDEX   ( 1 )
+
+/* How the reader task receives, see prvStreamBufferReaderTask(). */
+#define mainREAD_STREAM                        ( 0 )
+#define mainREAD_STREAM_BULK                   ( 1 )
+#define mainREAD_STREAM_BATCH                  ( 2 )
+#define mainREAD_MESSAGE                       ( 3 )
+#define mainREAD_MESSAGE_BULK                  ( 4 )
+
+/* Parameters for the arena benchmark.  The arena is sized to hold the largest
+ * possible request. */
+#define mainARENA_BENCHMARK_REQUESTS           ( 20000UL )
+#define mainARENA_BENCHMARK_OBJECTS            ( 32 )
+#define mainARENA_BENCHMARK_MIN_OBJECT         ( 8 )
+#define mainARENA_BENCHMARK_MAX_OBJECT         ( 256 )
+#define mainARENA_BENCHMARK_ARENA_SIZE         ( mainARENA_BENCHMARK_OBJECTS * mainARENA_BENCHMARK_MAX_OBJECT )
+
+/* Parameters for the topic benchmark.  A burst fills the topic and the
+ * queues, so nothing is dropped and nothing waits. */
+#define mainTOPIC_BENCHMARK_BURSTS             ( 10000UL )
+#define mainTOPIC_BENCHMARK_BURST_LENGTH       ( 8 )
+#define mainTOPIC_BENCHMARK_MESSAGE_SIZE       ( 64 )
+#define mainTOPIC_BENCHMARK_MAX_READERS        ( 16 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs the benchmarks, as described at the top of this file.
+ */
+static void prvBenchmarkTask( void * pvParameters );
+
+/*
+ * The individual benchmarks.
+ */
+static void prvHeapBenchmark( void );
+static void prvTraceBenchmark( void );
+static void prvWordQueueBenchmark( void );
+static void prvPriorityQueueBenchmark( void );
+static void prvStreamBufferBenchmark( void );
+static void prvStreamBufferReaderBenchmark( void );
+static void prvArenaBenchmark( void );
+static void prvTopicBenchmark( void );
+
+/*
+ * The reader used by the stream buffer reader benchmark.  Waits to be told to
+ * start, then receives mainSTREAM_READER_GROUPS groups of bytes or messages as
+ * ulReaderMode says, counts how many receive calls it made, and tells the
+ * benchmark task it has finished.
+ */
+static void prvStreamBufferReaderTask( void * pvParameters );
+
+/*
+ * Print one result line.  xElapsed is in run time stats counter units.
+ */
+static void prvReportResult( const char * pcBenchmark,
+                             const char * pcVariant,
+                             uint32_t ulOperations,
+                             configRUN_TIME_COUNTER_TYPE xElapsed );
+
+/*
+ * Find the revision the demo was built from, describe the configuration, and
+ * name the session from the time it started, as recorded with each result.
+ * Make Windows system calls, so must be called from a critical section.
+ */
+static void prvGetRevision( char * pcRevision,
+                            size_t xLength );
+static void prvGetConfiguration( char * pcConfiguration,
+                                 size_t xLength );
+static void prvGetSession( char * pcSession,
+                           size_t xLength );
+
+/*
+ * Returns pdTRUE if git reports that tracked files in the working tree differ
+ * from the revision checked out.  Makes Windows system calls, so must be
+ * called from a critical section.
+ */
+static BaseType_t prvWorkingTreeChanged( void );
+
+/*
+ * Read the first line of a file in the git directory, without the line ending.
+ * Returns pdFAIL if the file cannot be read.
+ */
+static BaseType_t prvReadGitFile( const char * pcFileName,
+                                  char * pcLine,
+                                  size_t xLength );
+
+/*
+ * A simple pseudo random number generator, so every run performs the same
+ * sequence of operations.
+ */
+static uint32_t prvRand( void );
+
+/*
+ * Returns a description of the memory backing the heap and trace buffer, which
+ * is the variant the heap and trace benchmarks measure.
+ */
+static const char * prvMemoryBacking( void );
+
+/*
+ * Implemented in Large-page-utils.c.
+ */
+extern BaseType_t xLargePagesInUse( void );
+
+/*-----------------------------------------------------------*/
+
+/* The state of the pseudo random number generator. */
+static uint32_t ulNextRand = mainRAND_SEED;
+
+/* The run in progress, and what is recorded with each of its results. */
+static uint32_t ulRun = 0;
+static HostIOFile_t xResultsFile = NULL;
+static char cRevision[ mainMAX_REVISION_LENGTH ];
+static char cConfiguration[ mainMAX_CONFIGURATION_LENGTH ];
+static char cSession[ mainMAX_SESSION_LENGTH ];
+
+/* Shared by the stream buffer reader benchmark and its reader task.  Each is
+ * only written by one side while the other waits for a notification. */
+static StreamBufferHandle_t xReaderStreamBuffer = NULL;
+static MessageBufferHandle_t xReaderMessageBuffer = NULL;
+static TaskHandle_t xBenchmarkTask = NULL;
+static volatile uint32_t ulReaderMode = mainREAD_STREAM;
+static volatile uint32_t ulReaderWakes = 0;
+
+/*-----------------------------------------------------------*/
+
+/*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
+void main_benchmark( void )
+{
+    xTaskCreate( prvBenchmarkTask,            /* The function that implements the task. */
+                 "Bench",                     /* The text name assigned to the task - for debug only as it is not used by the kernel. */
+                 configMINIMAL_STACK_SIZE,    /* The size of the stack to allocate to the task. */
+                 NULL,                        /* The parameter passed to the task - not used in this case. */
+                 mainBENCHMARK_TASK_PRIORITY, /* The priority assigned to the task. */
+                 NULL );                      /* The task handle is not required, so NULL is passed. */
+
+    /* Start the benchmark task running. */
+    vTaskStartScheduler();
+
+    /* If all is well, the scheduler will now be running, and the following
+     * line will never be reached.  If the following line does execute, then
+     * there was insufficient FreeRTOS heap memory available for the idle and/or
+     * timer tasks to be created.  See the memory management section on the
+     * FreeRTOS web site for more details. */
+    for( ; ; )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    /* Prevent the compiler warning about the unused parameter. */
+    ( void ) pvParameters;
+
+    taskENTER_CRITICAL();
+    {
+        prvGetRevision( cRevision, sizeof( cRevision ) );
+        prvGetConfiguration( cConfiguration, sizeof( cConfiguration ) );
+        prvGetSession( cSession, sizeof( cSession ) );
+
+        printf( "\r\nRevision %s, configuration %s, session %s\r\n", cRevision, cConfiguration, cSession );
+
+        #if ( ( configUSE_BLOCKED_TIME_STATS == 1 ) || ( configUSE_WAKEUP_STATS == 1 ) || ( configUSE_CONTEXT_SWITCH_STATS == 1 ) || ( configUSE_ARENAS == 1 ) )
+        {
+            printf( "Warning: the blocked time, wake up, context switch or arena hooks are enabled in FreeRTOSConfig.h, so their cost is included in the results.\r\n" );
+        }
+        #endif
+    }
+    taskEXIT_CRITICAL();
+
+    if( xHostIOOpen( &xResultsFile, mainBENCHMARK_RESULTS_FILE_NAME, pdTRUE ) != pdPASS )
+    {
+        xResultsFile = NULL;
+
+        taskENTER_CRITICAL();
+        {
+            printf( "Could not open \"%s\", so the results will not be saved.\r\n", mainBENCHMARK_RESULTS_FILE_NAME );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    for( ulRun = 0; ulRun < mainBENCHMARK_RUNS; ulRun++ )
+    {
+        taskENTER_CRITICAL();
+        {
+            printf( "\r\nRun %lu of %lu\r\n", ( unsigned long ) ( ulRun + 1UL ), ( unsigned long ) mainBENCHMARK_RUNS );
+        }
+        taskEXIT_CRITICAL();
+
+        /* Every run performs the same sequence of operations. */
+        ulNextRand = mainRAND_SEED;
+
+        prvHeapBenchmark();
+        prvTraceBenchmark();
+        prvWordQueueBenchmark();
+        prvPriorityQueueBenchmark();
+        prvStreamBufferBenchmark();
+        prvStreamBufferReaderBenchmark();
+        prvArenaBenchmark();
+        prvTopicBenchmark();
+    }
+
+    if( xResultsFile != NULL )
+    {
+        vHostIOClose( xResultsFile );
+    }
+
+    taskENTER_CRITICAL();
+    {
+        if( xResultsFile != NULL )
+        {
+            xResultsFile = NULL;
+            printf( "\r\nBenchmarks complete.  Results appended to \"%s\".\r\n", mainBENCHMARK_RESULTS_FILE_NAME );
+        }
+        else
+        {
+            printf( "\r\nBenchmarks complete.\r\n" );
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapBenchmark( void )
+{
+    uint8_t * pucBlocks[ mainHEAP_BENCHMARK_LIVE_BLOCKS ] = { NULL };
+    size_t xSize, xOffset;
+    uint32_t ulOperation, ulBlock;
+    configRUN_TIME_COUNTER_TYPE xStart;
+
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulOperation = 0; ulOperation < mainHEAP_BENCHMARK_OPERATIONS; ulOperation++ )
+    {
+        ulBlock = prvRand() % mainHEAP_BENCHMARK_LIVE_BLOCKS;
+        vPortFree( pucBlocks[ ulBlock ] );
+
+        xSize = mainHEAP_BENCHMARK_MIN_BLOCK + ( prvRand() % ( mainHEAP_BENCHMARK_MAX_BLOCK - mainHEAP_BENCHMARK_MIN_BLOCK ) );
+        pucBlocks[ ulBlock ] = ( uint8_t * ) pvPortMalloc( xSize );
+
+        /* Touch every page of the new block, as a real user of the memory
+         * would.  The malloc failed hook traps failed allocations. */
+        for( xOffset = 0; xOffset < xSize; xOffset += mainHEAP_BENCHMARK_PAGE_SIZE )
+        {
+            pucBlocks[ ulBlock ][ xOffset ] = ( uint8_t ) ulOperation;
+        }
+
+        pucBlocks[ ulBlock ][ xSize - 1 ] = ( uint8_t ) ulOperation;
+    }
+
+    prvReportResult( "heap-churn", prvMemoryBacking(), mainHEAP_BENCHMARK_OPERATIONS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+    for( ulBlock = 0; ulBlock < mainHEAP_BENCHMARK_LIVE_BLOCKS; ulBlock++ )
+    {
+        vPortFree( pucBlocks[ ulBlock ] );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTraceBenchmark( void )
+{
+    QueueHandle_t xQueue;
+    uint32_t ulOperation, ulValue = 0;
+    configRUN_TIME_COUNTER_TYPE xStart, xTraced, xUntraced;
+
+    xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( xQueue );
+
+    /* Every send and receive writes events to the recorder. */
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulOperation = 0; ulOperation < mainTRACE_BENCHMARK_OPERATIONS; ulOperation++ )
+    {
+        xQueueSend( xQueue, &ulOperation, 0 );
+        xQueueReceive( xQueue, &ulValue, 0 );
+    }
+
+    xTraced = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+    /* Then the same again without the recorder. */
+    ( void ) xTraceDisable();
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulOperation = 0; ulOperation < mainTRACE_BENCHMARK_OPERATIONS; ulOperation++ )
+    {
+        xQueueSend( xQueue, &ulOperation, 0 );
+        xQueueReceive( xQueue, &ulValue, 0 );
+    }
+
+    xUntraced = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+    ( void ) xTraceEnable( TRC_START );
+
+    configASSERT( ulValue == ( mainTRACE_BENCHMARK_OPERATIONS - 1 ) );
+
+    prvReportResult( "queue-traced", prvMemoryBacking(), mainTRACE_BENCHMARK_OPERATIONS, xTraced );
+    prvReportResult( "queue-untraced", prvMemoryBacking(), mainTRACE_BENCHMARK_OPERATIONS, xUntraced );
+
+    vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWordQueueBenchmark( void )
+{
+    static const UBaseType_t uxItemSizes[] = { 0, sizeof( uint32_t ), sizeof( uint64_t ), 2 * sizeof( uint64_t ) };
+    uint8_t ucItem[ mainWORD_QUEUE_MAX_ITEM_SIZE ] = { 0 }, ucReceived[ mainWORD_QUEUE_MAX_ITEM_SIZE ];
+    QueueHandle_t xQueue;
+    WordQueueHandle_t xWordQueue;
+    uint32_t ulOperation, ulReceived = 0;
+    uint64_t ullReceived = 0;
+    size_t xSize;
+    configRUN_TIME_COUNTER_TYPE xStart;
+    char cBenchmark[ 24 ];
+
+    ( void ) xTraceDisable();
+
+    for( xSize = 0; xSize < ( sizeof( uxItemSizes ) / sizeof( uxItemSizes[ 0 ] ) ); xSize++ )
+    {
+        xQueue = xQueueCreate( mainWORD_QUEUE_BENCHMARK_LENGTH, uxItemSizes[ xSize ] );
+        xWordQueue = xWordQueueCreate( mainWORD_QUEUE_BENCHMARK_LENGTH, uxItemSizes[ xSize ] );
+        configASSERT( xQueue );
+        configASSERT( xWordQueue );
+
+        snprintf( cBenchmark, sizeof( cBenchmark ), "queue-%uB", ( unsigned ) uxItemSizes[ xSize ] );
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulOperation = 0; ulOperation < mainWORD_QUEUE_BENCHMARK_OPERATIONS; ulOperation++ )
+        {
+            ucItem[ 0 ] = ( uint8_t ) ulOperation;
+            xQueueSend( xQueue, ucItem, 0 );
+            xQueueReceive( xQueue, ucReceived, 0 );
+        }
+
+        prvReportResult( cBenchmark, "xQueue", mainWORD_QUEUE_BENCHMARK_OPERATIONS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+        configASSERT( ( uxItemSizes[ xSize ] == 0 ) || ( ucReceived[ 0 ] == ucItem[ 0 ] ) );
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulOperation = 0; ulOperation < mainWORD_QUEUE_BENCHMARK_OPERATIONS; ulOperation++ )
+        {
+            ucItem[ 0 ] = ( uint8_t ) ulOperation;
+            xWordQueueSend( xWordQueue, ucItem, 0 );
+            xWordQueueReceive( xWordQueue, ucReceived, 0 );
+        }
+
+        prvReportResult( cBenchmark, "WordQueue", mainWORD_QUEUE_BENCHMARK_OPERATIONS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+        configASSERT( ( uxItemSizes[ xSize ] == 0 ) || ( ucReceived[ 0 ] == ucItem[ 0 ] ) );
+
+        if( uxItemSizes[ xSize ] == sizeof( uint32_t ) )
+        {
+            xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+            for( ulOperation = 0; ulOperation < mainWORD_QUEUE_BENCHMARK_OPERATIONS; ulOperation++ )
+            {
+                xWordQueueSend32( xWordQueue, ulOperation, 0 );
+                xWordQueueReceive32( xWordQueue, &ulReceived, 0 );
+            }
+
+            prvReportResult( cBenchmark, "WordQueue32", mainWORD_QUEUE_BENCHMARK_OPERATIONS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+            configASSERT( ulReceived == ( mainWORD_QUEUE_BENCHMARK_OPERATIONS - 1UL ) );
+        }
+        else if( uxItemSizes[ xSize ] == sizeof( uint64_t ) )
+        {
+            xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+            for( ulOperation = 0; ulOperation < mainWORD_QUEUE_BENCHMARK_OPERATIONS; ulOperation++ )
+            {
+                xWordQueueSend64( xWordQueue, ( uint64_t ) ulOperation, 0 );
+                xWordQueueReceive64( xWordQueue, &ullReceived, 0 );
+            }
+
+            prvReportResult( cBenchmark, "WordQueue64", mainWORD_QUEUE_BENCHMARK_OPERATIONS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+            configASSERT( ullReceived == ( uint64_t ) ( mainWORD_QUEUE_BENCHMARK_OPERATIONS - 1UL ) );
+        }
+
+        vQueueDelete( xQueue );
+        vWordQueueDelete( xWordQueue );
+    }
+
+    ( void ) xTraceEnable( TRC_START );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPriorityQueueBenchmark( void )
+{
+    PriorityQueueHandle_t xPriorityQueue;
+    QueueHandle_t xLevelQueues[ mainPRIORITY_QUEUE_LEVELS ];
+    QueueSetHandle_t xQueueSet;
+    UBaseType_t uxPriority, uxLastPriority;
+    uint32_t ulBurst, ulMessage, ulValue;
+    BaseType_t xLevel;
+    configRUN_TIME_COUNTER_TYPE xStart;
+
+    ( void ) xTraceDisable();
+
+    /* A single priority queue. */
+    xPriorityQueue = xPriorityQueueCreate( mainPRIORITY_QUEUE_BURST_LENGTH, sizeof( uint32_t ) );
+    configASSERT( xPriorityQueue );
+
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulBurst = 0; ulBurst < mainPRIORITY_QUEUE_BENCHMARK_BURSTS; ulBurst++ )
+    {
+        for( ulMessage = 0; ulMessage < mainPRIORITY_QUEUE_BURST_LENGTH; ulMessage++ )
+        {
+            xPriorityQueueSend( xPriorityQueue, &ulMessage, prvRand() % mainPRIORITY_QUEUE_LEVELS, 0 );
+        }
+
+        uxLastPriority = mainPRIORITY_QUEUE_LEVELS;
+
+        while( xPriorityQueueReceive( xPriorityQueue, &ulValue, &uxPriority, 0 ) == pdPASS )
+        {
+            configASSERT( uxPriority <= uxLastPriority );
+            uxLastPriority = uxPriority;
+        }
+    }
+
+    prvReportResult( "priority-queue", "PriorityQueue", mainPRIORITY_QUEUE_BENCHMARK_BURSTS * mainPRIORITY_QUEUE_BURST_LENGTH, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+    vPriorityQueueDelete( xPriorityQueue );
+
+    /* One kernel queue per level, plus a queue set.  Each message added to
+     * the set entitles the receiver to one message, which it takes from the
+     * highest priority queue that is not empty. */
+    xQueueSet = xQueueCreateSet( mainPRIORITY_QUEUE_LEVELS * mainPRIORITY_QUEUE_BURST_LENGTH );
+    configASSERT( xQueueSet );
+
+    for( xLevel = 0; xLevel < mainPRIORITY_QUEUE_LEVELS; xLevel++ )
+    {
+        xLevelQueues[ xLevel ] = xQueueCreate( mainPRIORITY_QUEUE_BURST_LENGTH, sizeof( uint32_t ) );
+        configASSERT( xLevelQueues[ xLevel ] );
+        xQueueAddToSet( xLevelQueues[ xLevel ], xQueueSet );
+    }
+
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulBurst = 0; ulBurst < mainPRIORITY_QUEUE_BENCHMARK_BURSTS; ulBurst++ )
+    {
+        for( ulMessage = 0; ulMessage < mainPRIORITY_QUEUE_BURST_LENGTH; ulMessage++ )
+        {
+            xQueueSend( xLevelQueues[ prvRand() % mainPRIORITY_QUEUE_LEVELS ], &ulMessage, 0 );
+        }
+
+        uxLastPriority = mainPRIORITY_QUEUE_LEVELS;
+
+        while( xQueueSelectFromSet( xQueueSet, 0 ) != NULL )
+        {
+            for( xLevel = mainPRIORITY_QUEUE_LEVELS - 1; xLevel >= 0; xLevel-- )
+            {
+                if( xQueueReceive( xLevelQueues[ xLevel ], &ulValue, 0 ) == pdPASS )
+                {
+                    break;
+                }
+            }
+
+            configASSERT( ( xLevel >= 0 ) && ( ( UBaseType_t ) xLevel <= uxLastPriority ) );
+            uxLastPriority = ( UBaseType_t ) xLevel;
+        }
+    }
+
+    prvReportResult( "priority-queue", "queue-set", mainPRIORITY_QUEUE_BENCHMARK_BURSTS * mainPRIORITY_QUEUE_BURST_LENGTH, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+    for( xLevel = 0; xLevel < mainPRIORITY_QUEUE_LEVELS; xLevel++ )
+    {
+        xQueueRemoveFromSet( xLevelQueues[ xLevel ], xQueueSet );
+        vQueueDelete( xLevelQueues[ xLevel ] );
+    }
+
+    vQueueDelete( xQueueSet );
+
+    ( void ) xTraceEnable( TRC_START );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamBufferBenchmark( void )
+{
+    static const size_t xChunkSizes[] = { 1, 16, 256, 4096, mainSTREAM_BENCHMARK_MAX_CHUNK };
+    static uint8_t ucSource[ mainSTREAM_BENCHMARK_MAX_CHUNK ], ucDestination[ mainSTREAM_BENCHMARK_MAX_CHUNK ];
+    StreamBufferVector_t xSendVectors[ mainSTREAM_BENCHMARK_VECTORS ], xReceiveVectors[ mainSTREAM_BENCHMARK_VECTORS ];
+    StreamBufferHandle_t xStreamBuffer;
+    size_t xSize, xChunk, xVector, xVectors, xMoved;
+    uint32_t ulTransfer, ulTransfers;
+    configRUN_TIME_COUNTER_TYPE xStart;
+    char cBenchmark[ 24 ];
+
+    ( void ) xTraceDisable();
+
+    xStreamBuffer = xStreamBufferCreate( mainSTREAM_BENCHMARK_BUFFER_SIZE, 1 );
+    configASSERT( xStreamBuffer );
+
+    for( xChunk = 0; xChunk < sizeof( ucSource ); xChunk++ )
+    {
+        ucSource[ xChunk ] = ( uint8_t ) prvRand();
+    }
+
+    for( xSize = 0; xSize < ( sizeof( xChunkSizes ) / sizeof( xChunkSizes[ 0 ] ) ); xSize++ )
+    {
+        xChunk = xChunkSizes[ xSize ];
+
+        /* As many chunks per group as fit in the buffer, up to the number of
+         * vectors. */
+        xVectors = mainSTREAM_BENCHMARK_BUFFER_SIZE / xChunk;
+
+        if( xVectors > mainSTREAM_BENCHMARK_VECTORS )
+        {
+            xVectors = mainSTREAM_BENCHMARK_VECTORS;
+        }
+
+        ulTransfers = mainSTREAM_BENCHMARK_BYTES / ( xChunk * xVectors );
+
+        if( ulTransfers < mainSTREAM_BENCHMARK_MIN_TRANSFERS )
+        {
+            ulTransfers = mainSTREAM_BENCHMARK_MIN_TRANSFERS;
+        }
+
+        for( xVector = 0; xVector < xVectors; xVector++ )
+        {
+            xSendVectors[ xVector ].pvData = ucSource;
+            xSendVectors[ xVector ].xLength = xChunk;
+            xReceiveVectors[ xVector ].pvData = ucDestination;
+            xReceiveVectors[ xVector ].xLength = xChunk;
+        }
+
+        snprintf( cBenchmark, sizeof( cBenchmark ), "stream-%luB", ( unsigned long ) xChunk );
+
+        /* One call per chunk. */
+        xMoved = 0;
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulTransfer = 0; ulTransfer < ulTransfers; ulTransfer++ )
+        {
+            for( xVector = 0; xVector < xVectors; xVector++ )
+            {
+                xStreamBufferSend( xStreamBuffer, ucSource, xChunk, 0 );
+            }
+
+            for( xVector = 0; xVector < xVectors; xVector++ )
+            {
+                xMoved += xStreamBufferReceive( xStreamBuffer, ucDestination, xChunk, 0 );
+            }
+        }
+
+        prvReportResult( cBenchmark, "xStreamBuffer", ulTransfers * xVectors, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+        configASSERT( xMoved == ( ulTransfers * xVectors * xChunk ) );
+        configASSERT( ucDestination[ xChunk - 1 ] == ucSource[ xChunk - 1 ] );
+
+        /* One call per group of chunks. */
+        xMoved = 0;
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulTransfer = 0; ulTransfer < ulTransfers; ulTransfer++ )
+        {
+            xStreamBufferBulkSend( xStreamBuffer, xSendVectors, xVectors, 0 );
+            xMoved += xStreamBufferBulkReceive( xStreamBuffer, xReceiveVectors, xVectors, 0 );
+        }
+
+        prvReportResult( cBenchmark, "bulk", ulTransfers * xVectors, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+        configASSERT( xMoved == ( ulTransfers * xVectors * xChunk ) );
+        configASSERT( ucDestination[ xChunk - 1 ] == ucSource[ xChunk - 1 ] );
+    }
+
+    vStreamBufferDelete( xStreamBuffer );
+
+    ( void ) xTraceEnable( TRC_START );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamBufferReaderBenchmark( void )
+{
+    static const struct
+    {
+        const char * pcBenchmark;
+        const char * pcVariant;
+        uint32_t ulMode;
+    } xVariants[] =
+    {
+        { "stream-reader",  "xStreamBuffer", mainREAD_STREAM       },
+        { "stream-reader",  "bulk",          mainREAD_STREAM_BULK  },
+        { "stream-reader",  "batch",         mainREAD_STREAM_BATCH },
+        { "message-reader", "xMessageBuffer", mainREAD_MESSAGE      },
+        { "message-reader", "bulk",          mainREAD_MESSAGE_BULK }
+    };
+    static uint8_t ucSource[ mainSTREAM_READER_GROUP_BYTES ];
+    StreamBufferVector_t xVectors[ mainSTREAM_BENCHMARK_VECTORS ];
+    TaskHandle_t xReaderTask = NULL;
+    size_t xVariant, xVector;
+    uint32_t ulGroup, ulMode;
+    configRUN_TIME_COUNTER_TYPE xStart, xElapsed;
+
+    ( void ) xTraceDisable();
+
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+    xReaderStreamBuffer = xStreamBufferCreate( mainSTREAM_READER_BUFFER_SIZE, 1 );
+    xReaderMessageBuffer = xMessageBufferCreate( mainSTREAM_READER_BUFFER_SIZE );
+    configASSERT( xReaderStreamBuffer );
+    configASSERT( xReaderMessageBuffer );
+
+    xTaskCreate( prvStreamBufferReaderTask, "Reader", configMINIMAL_STACK_SIZE, NULL, mainSTREAM_READER_PRIORITY, &xReaderTask );
+    configASSERT( xReaderTask );
+
+    for( xVector = 0; xVector < mainSTREAM_BENCHMARK_VECTORS; xVector++ )
+    {
+        xVectors[ xVector ].pvData = &( ucSource[ xVector * mainSTREAM_READER_CHUNK ] );
+        xVectors[ xVector ].xLength = mainSTREAM_READER_CHUNK;
+    }
+
+    for( xVariant = 0; xVariant < ( sizeof( xVariants ) / sizeof( xVariants[ 0 ] ) ); xVariant++ )
+    {
+        ulMode = xVariants[ xVariant ].ulMode;
+        ulReaderMode = ulMode;
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        /* The reader runs straight away, and blocks on the empty buffer. */
+        xTaskNotifyGiveIndexed( xReaderTask, mainSTREAM_READER_NOTIFICATION_INDEX );
+
+        for( ulGroup = 0; ulGroup < mainSTREAM_READER_GROUPS; ulGroup++ )
+        {
+            switch( ulMode )
+            {
+                case mainREAD_STREAM_BULK:
+                    xStreamBufferBulkSend( xReaderStreamBuffer, xVectors, mainSTREAM_BENCHMARK_VECTORS, portMAX_DELAY );
+                    break;
+
+                case mainREAD_MESSAGE:
+
+                    for( xVector = 0; xVector < mainSTREAM_BENCHMARK_VECTORS; xVector++ )
+                    {
+                        xMessageBufferSend( xReaderMessageBuffer, xVectors[ xVector ].pvData, mainSTREAM_READER_CHUNK, portMAX_DELAY );
+                    }
+
+                    break;
+
+                case mainREAD_MESSAGE_BULK:
+                    xMessageBufferBulkSend( xReaderMessageBuffer, xVectors, mainSTREAM_BENCHMARK_VECTORS, portMAX_DELAY );
+                    break;
+
+                case mainREAD_STREAM:
+                case mainREAD_STREAM_BATCH:
+                default:
+
+                    /* The batch variant writes one chunk at a time too - the
+                     * difference is only in how the reader waits. */
+                    for( xVector = 0; xVector < mainSTREAM_BENCHMARK_VECTORS; xVector++ )
+                    {
+                        xStreamBufferSend( xReaderStreamBuffer, xVectors[ xVector ].pvData, mainSTREAM_READER_CHUNK, portMAX_DELAY );
+                    }
+
+                    break;
+            }
+        }
+
+        /* Wait for the reader to receive the last group. */
+        ( void ) ulTaskNotifyTakeIndexed( mainSTREAM_READER_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+        xElapsed = portGET_RUN_TIME_COUNTER_VALUE() - xStart;
+
+        prvReportResult( xVariants[ xVariant ].pcBenchmark, xVariants[ xVariant ].pcVariant,
+                         mainSTREAM_READER_GROUPS * mainSTREAM_BENCHMARK_VECTORS, xElapsed );
+
+        taskENTER_CRITICAL();
+        {
+            printf( "%-24s %-16s %10lu reader wake ups\r\n", "", "", ( unsigned long ) ulReaderWakes );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    vTaskDelete( xReaderTask );
+    vStreamBufferDelete( xReaderStreamBuffer );
+    vMessageBufferDelete( xReaderMessageBuffer );
+
+    ( void ) xTraceEnable( TRC_START );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamBufferReaderTask( void * pvParameters )
+{
+    static uint8_t ucDestination[ mainSTREAM_READER_GROUP_BYTES ];
+    StreamBufferVector_t xVectors[ mainSTREAM_BENCHMARK_VECTORS ];
+    size_t xMessageLengths[ mainSTREAM_BENCHMARK_VECTORS ];
+    size_t xVector, xReceived, xMessages;
+    uint32_t ulWakes;
+
+    /* Prevent the compiler warning about the unused parameter. */
+    ( void ) pvParameters;
+
+    for( xVector = 0; xVector < mainSTREAM_BENCHMARK_VECTORS; xVector++ )
+    {
+        xVectors[ xVector ].pvData = &( ucDestination[ xVector * mainSTREAM_READER_CHUNK ] );
+        xVectors[ xVector ].xLength = mainSTREAM_READER_CHUNK;
+    }
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTakeIndexed( mainSTREAM_READER_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+
+        xReceived = 0;
+        ulWakes = 0;
+
+        /* Every call blocks until the writer has written something, so the
+         * number of calls is the number of times the reader was woken. */
+        while( xReceived < ( mainSTREAM_READER_GROUPS * mainSTREAM_READER_GROUP_BYTES ) )
+        {
+            switch( ulReaderMode )
+            {
+                case mainREAD_STREAM_BULK:
+                    xReceived += xStreamBufferBulkReceive( xReaderStreamBuffer, xVectors, mainSTREAM_BENCHMARK_VECTORS, portMAX_DELAY );
+                    break;
+
+                case mainREAD_STREAM_BATCH:
+                    xReceived += xStreamBufferReceiveBatch( xReaderStreamBuffer, ucDestination, sizeof( ucDestination ), mainSTREAM_READER_GROUP_BYTES, portMAX_DELAY );
+                    break;
+
+                case mainREAD_MESSAGE:
+                    xReceived += xMessageBufferReceive( xReaderMessageBuffer, ucDestination, sizeof( ucDestination ), portMAX_DELAY );
+                    break;
+
+                case mainREAD_MESSAGE_BULK:
+                    xMessages = xMessageBufferBulkReceive( xReaderMessageBuffer, xVectors, mainSTREAM_BENCHMARK_VECTORS, xMessageLengths, portMAX_DELAY );
+
+                    for( xVector = 0; xVector < xMessages; xVector++ )
+                    {
+                        xReceived += xMessageLengths[ xVector ];
+                    }
+
+                    break;
+
+                case mainREAD_STREAM:
+                default:
+                    xReceived += xStreamBufferReceive( xReaderStreamBuffer, ucDestination, sizeof( ucDestination ), portMAX_DELAY );
+                    break;
+            }
+
+            ulWakes++;
+        }
+
+        configASSERT( xReceived == ( mainSTREAM_READER_GROUPS * mainSTREAM_READER_GROUP_BYTES ) );
+        ulReaderWakes = ulWakes;
+        xTaskNotifyGiveIndexed( xBenchmarkTask, mainSTREAM_READER_NOTIFICATION_INDEX );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvArenaBenchmark( void )
+{
+    uint8_t * pucObjects[ mainARENA_BENCHMARK_OBJECTS ];
+    size_t xSizes[ mainARENA_BENCHMARK_OBJECTS ];
+    ArenaHandle_t xArena;
+    uint32_t ulRequest, ulObject;
+    configRUN_TIME_COUNTER_TYPE xStart;
+
+    /* Both variants allocate the same sizes. */
+    for( ulObject = 0; ulObject < mainARENA_BENCHMARK_OBJECTS; ulObject++ )
+    {
+        xSizes[ ulObject ] = mainARENA_BENCHMARK_MIN_OBJECT + ( prvRand() % ( mainARENA_BENCHMARK_MAX_OBJECT - mainARENA_BENCHMARK_MIN_OBJECT ) );
+    }
+
+    /* One allocation and one free per object. */
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulRequest = 0; ulRequest < mainARENA_BENCHMARK_REQUESTS; ulRequest++ )
+    {
+        for( ulObject = 0; ulObject < mainARENA_BENCHMARK_OBJECTS; ulObject++ )
+        {
+            pucObjects[ ulObject ] = ( uint8_t * ) pvPortMalloc( xSizes[ ulObject ] );
+            pucObjects[ ulObject ][ 0 ] = ( uint8_t ) ulRequest;
+        }
+
+        for( ulObject = 0; ulObject < mainARENA_BENCHMARK_OBJECTS; ulObject++ )
+        {
+            vPortFree( pucObjects[ ulObject ] );
+        }
+    }
+
+    prvReportResult( "arena", "pvPortMalloc", mainARENA_BENCHMARK_REQUESTS * mainARENA_BENCHMARK_OBJECTS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+    /* One allocation per object and one reset per request. */
+    xArena = xArenaCreate( "Bench", mainARENA_BENCHMARK_ARENA_SIZE, xTaskGetCurrentTaskHandle() );
+    configASSERT( xArena );
+
+    xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+    for( ulRequest = 0; ulRequest < mainARENA_BENCHMARK_REQUESTS; ulRequest++ )
+    {
+        for( ulObject = 0; ulObject < mainARENA_BENCHMARK_OBJECTS; ulObject++ )
+        {
+            pucObjects[ ulObject ] = ( uint8_t * ) pvArenaAlloc( xArena, xSizes[ ulObject ] );
+            pucObjects[ ulObject ][ 0 ] = ( uint8_t ) ulRequest;
+        }
+
+        vArenaReset( xArena );
+    }
+
+    prvReportResult( "arena", "arena", mainARENA_BENCHMARK_REQUESTS * mainARENA_BENCHMARK_OBJECTS, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+    taskENTER_CRITICAL();
+    {
+        vArenaPrint();
+    }
+    taskEXIT_CRITICAL();
+
+    /* The benchmark task runs every benchmark mainBENCHMARK_RUNS times, so
+     * would otherwise leave one arena behind on each run. */
+    vArenaDelete( xArena );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTopicBenchmark( void )
+{
+    TopicHandle_t xTopic;
+    TopicSubscriber_t xSubscribers[ mainTOPIC_BENCHMARK_MAX_READERS ];
+    QueueHandle_t xQueues[ mainTOPIC_BENCHMARK_MAX_READERS ];
+    uint8_t ucMessage[ mainTOPIC_BENCHMARK_MESSAGE_SIZE ] = { 0 };
+    const uint8_t * pucReceived;
+    uint32_t ulBurst, ulMessage, ulReaders, ulReader, ulChecksum = 0;
+    char cBenchmark[ 24 ];
+    configRUN_TIME_COUNTER_TYPE xStart;
+
+    ( void ) xTraceDisable();
+
+    for( ulReaders = 1; ulReaders <= mainTOPIC_BENCHMARK_MAX_READERS; ulReaders *= 2 )
+    {
+        snprintf( cBenchmark, sizeof( cBenchmark ), "fan-out-%lu", ( unsigned long ) ulReaders );
+
+        /* One topic, published to once and read in place by every reader. */
+        xTopic = xTopicCreate( mainTOPIC_BENCHMARK_BURST_LENGTH, mainTOPIC_BENCHMARK_MESSAGE_SIZE, eTopicBlockPublisher );
+        configASSERT( xTopic );
+
+        for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+        {
+            vTopicSubscribe( xTopic, &( xSubscribers[ ulReader ] ), NULL, 0 );
+        }
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulBurst = 0; ulBurst < mainTOPIC_BENCHMARK_BURSTS; ulBurst++ )
+        {
+            for( ulMessage = 0; ulMessage < mainTOPIC_BENCHMARK_BURST_LENGTH; ulMessage++ )
+            {
+                ucMessage[ 0 ] = ( uint8_t ) ulMessage;
+                xTopicPublish( xTopic, ucMessage, 0 );
+            }
+
+            for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+            {
+                while( ( pucReceived = ( const uint8_t * ) pvTopicPeek( &( xSubscribers[ ulReader ] ), 0 ) ) != NULL )
+                {
+                    ulChecksum += pucReceived[ 0 ];
+                    xTopicRelease( &( xSubscribers[ ulReader ] ) );
+                }
+            }
+        }
+
+        prvReportResult( cBenchmark, "topic", mainTOPIC_BENCHMARK_BURSTS * mainTOPIC_BENCHMARK_BURST_LENGTH, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+        for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+        {
+            vTopicUnsubscribe( &( xSubscribers[ ulReader ] ) );
+        }
+
+        vTopicDelete( xTopic );
+
+        /* One kernel queue per reader, each holding its own copy. */
+        for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+        {
+            xQueues[ ulReader ] = xQueueCreate( mainTOPIC_BENCHMARK_BURST_LENGTH, mainTOPIC_BENCHMARK_MESSAGE_SIZE );
+            configASSERT( xQueues[ ulReader ] );
+        }
+
+        xStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulBurst = 0; ulBurst < mainTOPIC_BENCHMARK_BURSTS; ulBurst++ )
+        {
+            for( ulMessage = 0; ulMessage < mainTOPIC_BENCHMARK_BURST_LENGTH; ulMessage++ )
+            {
+                ucMessage[ 0 ] = ( uint8_t ) ulMessage;
+
+                for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+                {
+                    xQueueSend( xQueues[ ulReader ], ucMessage, 0 );
+                }
+            }
+
+            for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+            {
+                while( xQueueReceive( xQueues[ ulReader ], ucMessage, 0 ) == pdPASS )
+                {
+                    ulChecksum -= ucMessage[ 0 ];
+                }
+            }
+        }
+
+        prvReportResult( cBenchmark, "queues", mainTOPIC_BENCHMARK_BURSTS * mainTOPIC_BENCHMARK_BURST_LENGTH, portGET_RUN_TIME_COUNTER_VALUE() - xStart );
+
+        for( ulReader = 0; ulReader < ulReaders; ulReader++ )
+        {
+            vQueueDelete( xQueues[ ulReader ] );
+        }
+    }
+
+    /* Both variants delivered the same messages. */
+    configASSERT( ulChecksum == 0 );
+
+    ( void ) xTraceEnable( TRC_START );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportResult( const char * pcBenchmark,
+                             const char * pcVariant,
+                             uint32_t ulOperations,
+                             configRUN_TIME_COUNTER_TYPE xElapsed )
+{
+    unsigned long long ullNsPerOperation;
+    char cResult[ mainMAX_RESULT_LENGTH ];
+    int iLength = 0;
+
+    ullNsPerOperation = ( ( unsigned long long ) xElapsed * configUS_PER_RUN_TIME_COUNT * 1000ULL ) / ulOperations;
+
+    /* Normally calling printf() from a task is not a good idea, see the
+     * comments in main_blinky.c. */
+    taskENTER_CRITICAL();
+    {
+        printf( "%-24s %-16s %10lu ops %10llu ns/op\r\n", pcBenchmark, pcVariant, ( unsigned long ) ulOperations, ullNsPerOperation );
+
+        if( xResultsFile != NULL )
+        {
+            iLength = snprintf( cResult, sizeof( cResult ),
+                                "{\"revision\":\"%s\",\"config\":\"%s\",\"session\":\"%s\",\"benchmark\":\"%s\",\"variant\":\"%s\",\"run\":%lu,\"operations\":%lu,\"ns_per_op\":%llu}\n",
+                                cRevision, cConfiguration, cSession, pcBenchmark, pcVariant, ( unsigned long ) ulRun, ( unsigned long ) ulOperations, ullNsPerOperation );
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    /* A truncated line would not be valid JSON, so is not written. */
+    if( ( iLength > 0 ) && ( iLength < ( int ) sizeof( cResult ) ) )
+    {
+        ( void ) lHostIOWrite( xResultsFile, cResult, ( size_t ) iLength );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetRevision( char * pcRevision,
+                            size_t xLength )
+{
+    #ifdef mainBENCHMARK_REVISION
+    {
+        snprintf( pcRevision, xLength, "%s", mainBENCHMARK_REVISION );
+    }
+    #else
+    {
+        char cHead[ 128 ], cLine[ 256 ];
+        FILE * pxFile;
+        size_t xRefLength, xRevisionLength;
+
+        if( prvReadGitFile( "HEAD", cHead, sizeof( cHead ) ) == pdFAIL )
+        {
+            snprintf( pcRevision, xLength, "unknown" );
+        }
+        else if( strncmp( cHead, "ref: ", 5 ) != 0 )
+        {
+            /* A detached HEAD holds the revision itself. */
+            snprintf( pcRevision, xLength, "%s", cHead );
+        }
+        else if( prvReadGitFile( &( cHead[ 5 ] ), pcRevision, xLength ) == pdFAIL )
+        {
+            /* The branch is not in its own file, so look for it in the
+             * packed refs, where each line is a revision, a space and a
+             * ref. */
+            snprintf( pcRevision, xLength, "unknown" );
+            xRefLength = strlen( &( cHead[ 5 ] ) );
+            pxFile = fopen( mainGIT_DIRECTORY "packed-refs", "r" );
+
+            if( pxFile != NULL )
+            {
+                while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+                {
+                    cLine[ strcspn( cLine, "\r\n" ) ] = '\0';
+
+                    if( ( strlen( cLine ) > xRefLength ) &&
+                        ( strcmp( &( cLine[ strlen( cLine ) - xRefLength ] ), &( cHead[ 5 ] ) ) == 0 ) &&
+                        ( cLine[ strlen( cLine ) - xRefLength - 1 ] == ' ' ) )
+                    {
+                        cLine[ strlen( cLine ) - xRefLength - 1 ] = '\0';
+                        snprintf( pcRevision, xLength, "%s", cLine );
+                        break;
+                    }
+                }
+
+                fclose( pxFile );
+            }
+        }
+
+        /* Results measured with uncommitted changes must not be mistaken for
+         * those of the revision itself. */
+        if( prvWorkingTreeChanged() != pdFALSE )
+        {
+            xRevisionLength = strlen( pcRevision );
+            snprintf( &( pcRevision[ xRevisionLength ] ), xLength - xRevisionLength, "-dirty" );
+        }
+    }
+    #endif /* ifdef mainBENCHMARK_REVISION */
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWorkingTreeChanged( void )
+{
+    char cLine[ 256 ];
+    FILE * pxPipe;
+    BaseType_t xReturn = pdFALSE;
+
+    /* If git cannot be run nothing is read, and the tree is assumed to be
+     * unchanged. */
+    pxPipe = _popen( mainGIT_STATUS_COMMAND, "r" );
+
+    if( pxPipe != NULL )
+    {
+        if( fgets( cLine, sizeof( cLine ), pxPipe ) != NULL )
+        {
+            xReturn = pdTRUE;
+
+            /* Read the rest so git does not block writing to the pipe. */
+            while( fgets( cLine, sizeof( cLine ), pxPipe ) != NULL )
+            {
+            }
+        }
+
+        ( void ) _pclose( pxPipe );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetConfiguration( char * pcConfiguration,
+                                 size_t xLength )
+{
+    const char * pcBuild;
+
+    #ifdef _DEBUG
+        pcBuild = "debug";
+    #else
+        pcBuild = "release";
+    #endif
+
+    /* Only the settings that change the cost of the operations measured.  The
+     * heap implementation is chosen by the project file, so is part of the
+     * revision. */
+    snprintf( pcConfiguration, xLength,
+              "build=%s large-pages=%d tick-hz=%lu trace=%d blocked-time=%d wakeup=%d ctxswitch=%d arenas=%d",
+              pcBuild, configUSE_LARGE_PAGES, ( unsigned long ) configTICK_RATE_HZ,
+              configUSE_TRACE_FACILITY, configUSE_BLOCKED_TIME_STATS, configUSE_WAKEUP_STATS,
+              configUSE_CONTEXT_SWITCH_STATS, configUSE_ARENAS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetSession( char * pcSession,
+                           size_t xLength )
+{
+    time_t xNow = time( NULL );
+    const struct tm * pxTime = localtime( &xNow );
+
+    if( ( pxTime == NULL ) || ( strftime( pcSession, xLength, "%Y%m%d-%H%M%S", pxTime ) == 0 ) )
+    {
+        snprintf( pcSession, xLength, "unknown" );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadGitFile( const char * pcFileName,
+                                  char * pcLine,
+                                  size_t xLength )
+{
+    char cPath[ 256 ];
+    FILE * pxFile;
+    BaseType_t xReturn = pdFAIL;
+
+    snprintf( cPath, sizeof( cPath ), "%s%s", mainGIT_DIRECTORY, pcFileName );
+    pxFile = fopen( cPath, "r" );
+
+    if( pxFile != NULL )
+    {
+        if( fgets( pcLine, ( int ) xLength, pxFile ) != NULL )
+        {
+            pcLine[ strcspn( pcLine, "\r\n" ) ] = '\0';
+            xReturn = pdPASS;
+        }
+
+        fclose( pxFile );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRand( void )
+{
+    /* Constants from the C standard's example rand() implementation. */
+    ulNextRand = ( ulNextRand * 1103515245UL ) + 12345UL;
+    return ( ulNextRand >> 16 ) & 0x7fffUL;
+}
+/*-----------------------------------------------------------*/
+
+static const char * prvMemoryBacking( void )
+{
+    const char * pcReturn;
+
+    #if ( configUSE_LARGE_PAGES == 1 )
+    {
+        pcReturn = ( xLargePagesInUse() != pdFALSE ) ? "large-pages" : "normal-pages";
+    }
+    #else
+    {
+        pcReturn = "static";
+    }
+    #endif
+
+    return pcReturn;
+}
+/*-----------------------------------------------------------*/
@@ -44,14 +44,15 @@
  * in main.c.
  ******************************************************************************
  *
- * main_blinky() creates one queue, one software timer, and two tasks.  It then
- * starts the scheduler.
+ * main_blinky() creates one queue, one software timer, one task and one frame
+ * scheduler runnable.  It then starts the scheduler.
  *
- * The Queue Send Task:
- * The queue send task is implemented by the prvQueueSendTask() function in
- * this file.  It uses vTaskDelayUntil() to create a periodic task that sends
- * the value 100 to the queue every 200 milliseconds (please read the notes
- * above regarding the accuracy of timing under Windows).
+ * The Queue Send Runnable:
+ * The queue send runnable is implemented by the prvQueueSendRunnable()
+ * function in this file.  It is registered with the frame scheduler (see
+ * FrameScheduler.h), which calls it every second 100 millisecond frame, so it
+ * sends the value 100 to the queue every 200 milliseconds (please read the
+ * notes above regarding the accuracy of timing under Windows).
  *
  * The Queue Send Software Timer:
  * The timer is a one-shot timer that is reset by a key press.  The timer's
@@ -61,20 +62,31 @@
  *
  * The Queue Receive Task:
  * The queue receive task is implemented by the prvQueueReceiveTask() function
- * in this file.  prvQueueReceiveTask() waits for data to arrive on the queue.
- * When data is received, the task checks the value of the data, then outputs a
- * message to indicate if the data came from the queue send task or the queue
- * send software timer.
+ * in this file, and is statically allocated, see StaticSystem.h.
+ * prvQueueReceiveTask() waits for data to arrive on the queue.  When data is
+ * received, the task checks the value of the data, then outputs a message to
+ * indicate if the data came from the queue send runnable or the queue send
+ * software timer.  If any messages were dropped because the queue was
+ * full since the last message was received, the task also outputs how many.
+ * The queue is a policy queue, see QueuePolicy.h, so dropped messages are
+ * counted rather than lost silently.
  *
  * Expected Behaviour:
- * - The queue send task writes to the queue every 200ms, so every 200ms the
+ * - The queue send runnable writes to the queue every 200ms, so every 200ms the
  *   queue receive task will output a message indicating that data was received
- *   on the queue from the queue send task.
+ *   on the queue from the queue send runnable.
  * - The queue send software timer has a period of two seconds, and is reset
  *   each time a key is pressed.  So if two seconds expire without a key being
  *   pressed then the queue receive task will output a message indicating that
  *   data was received on the queue from the queue send software timer.
  *
+ * Control Socket Commands:
+ * The demo registers the following commands with the control socket (see
+ * ControlSocket.h):
+ * - "timer-reset" resets the software timer, as pressing the key does.
+ * - "timer-period <ms>" changes the software timer's period.
+ * - "send <on|off>" starts or stops the queue send runnable sending.
+ *
  * NOTE:  Console input and output relies on Windows system calls, which can
  * interfere with the execution of the FreeRTOS Windows port.  This demo only
  * uses Windows system call occasionally.  Heavier use of Windows system calls
@@ -83,6 +95,8 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <conio.h>
 
 /* Kernel includes. */
@@ -91,19 +105,43 @@
 #include "timers.h"
 #include "semphr.h"
 
+/* Demo includes. */
+#include "ControlSocket.h"
+#include "DepthSampler.h"
+#include "FrameScheduler.h"
+#include "HostIO.h"
+#include "LoadEstimator.h"
+#include "QueuePolicy.h"
+#include "StaticSystem.h"
+#include "TimerStats.h"
+
 /* Priorities at which the tasks are created. */
 #define mainQUEUE_RECEIVE_TASK_PRIORITY    ( tskIDLE_PRIORITY + 2 )
 #define mainQUEUE_SEND_TASK_PRIORITY       ( tskIDLE_PRIORITY + 1 )
 
-/* The rate at which data is sent to the queue.  The times are converted from
- * milliseconds to ticks using the pdMS_TO_TICKS() macro. */
-#define mainTASK_SEND_FREQUENCY_MS         pdMS_TO_TICKS( 200UL )
+/* The frame scheduler's base frame.  The time is converted from milliseconds
+ * to ticks using the pdMS_TO_TICKS() macro. */
+#define mainFRAME_PERIOD_MS                pdMS_TO_TICKS( 100UL )
+
+/* The rate at which data is sent to the queue.  The runnable's rate is in
+ * frames, so it sends every 200ms. */
+#define mainRUNNABLE_SEND_FRAMES           ( 2 )
 #define mainTIMER_SEND_FREQUENCY_MS        pdMS_TO_TICKS( 2000UL )
 
-/* The number of items the queue can hold at once. */
+/* The number of items the queue can hold at once.  The receive task empties the
+ * queue long before the next item is sent, so it rarely holds more than one -
+ * press 'q' to see the occupancy measured by the depth sampler (see
+ * DepthSampler.h) before changing this. */
 #define mainQUEUE_LENGTH                   ( 2 )
 
-/* The values sent to the queue receive task from the queue send task and the
+/* What happens when a message is sent to the queue while it is full. */
+#define mainQUEUE_POLICY                   eQueuePolicyDropNewest
+
+/* The longest the software timer's callback should take to execute, in
+ * microseconds.  See TimerStats.h. */
+#define mainTIMER_CALLBACK_BUDGET_US       ( 500UL )
+
+/* The values sent to the queue receive task from the queue send runnable and the
  * queue send software timer respectively. */
 #define mainVALUE_SENT_FROM_TASK           ( 100UL )
 #define mainVALUE_SENT_FROM_TIMER          ( 200UL )
@@ -115,58 +153,100 @@
 /*-----------------------------------------------------------*/
 
 /*
- * The tasks as described in the comments at the top of this file.
+ * The task and runnable as described in the comments at the top of this file.
  */
 static void prvQueueReceiveTask( void * pvPaframeters );
-static void prvQueueSendTask( void * pvParameters );
+static void prvQueueSendRunnable( void * pvParameter );
 
 /*
  * The callback function executed when the software timer expires.
  */
 static void prvQueueSendTimerCallback( TimerHandle_t xTimerHandle );
 
+/*
+ * The control socket commands described in the comments at the top of this
+ * file.
+ */
+static BaseType_t prvTimerResetCommand( const char * pcArguments,
+                                        char * pcResult,
+                                        size_t xResultLength );
+static BaseType_t prvTimerPeriodCommand( const char * pcArguments,
+                                         char * pcResult,
+                                         size_t xResultLength );
+static BaseType_t prvSendCommand( const char * pcArguments,
+                                  char * pcResult,
+                                  size_t xResultLength );
+
 /*-----------------------------------------------------------*/
 
+/* The objects created by this file that do not need a wrapper's heap state,
+ * see StaticSystem.h. */
+#define mainBLINKY_SYSTEM( TASK, QUEUE, TIMER ) \
+    TASK( xQueueReceiveTask, prvQueueReceiveTask, "Rx", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_RECEIVE_TASK_PRIORITY )
+
+staticsysDEFINE_OBJECTS( mainBLINKY_SYSTEM )
+staticsysDEFINE_INIT( mainBLINKY_SYSTEM, prvCreateStaticObjects )
+
 /* The queue used by both tasks. */
-static QueueHandle_t xQueue = NULL;
+static QueuePolicyHandle_t xQueue = NULL;
 
 /* A software timer that is started from the tick hook. */
 static TimerHandle_t xTimer = NULL;
 
+/* Cleared by the "send off" command to stop the queue send runnable
+ * sending. */
+static volatile BaseType_t xSendEnabled = pdTRUE;
+
+static const ControlCommand_t xBlinkyCommands[] =
+{
+    { "timer-reset",  "Reset the software timer",                            prvTimerResetCommand  },
+    { "timer-period", "timer-period <ms> - change the software timer period", prvTimerPeriodCommand },
+    { "send",         "send <on|off> - start or stop the queue send runnable", prvSendCommand        }
+};
+
 /*-----------------------------------------------------------*/
 
 /*** SEE THE COMMENTS AT THE TOP OF THIS FILE ***/
 void main_blinky( void )
 {
     const TickType_t xTimerPeriod = mainTIMER_SEND_FREQUENCY_MS;
+    UBaseType_t uxCommand;
 
     printf( "\r\nStarting the blinky demo. Press \'%c\' to reset the software timer used in this demo.\r\n\r\n", mainRESET_TIMER_KEY );
 
     /* Create the queue. */
-    xQueue = xQueueCreate( mainQUEUE_LENGTH, sizeof( uint32_t ) );
+    xQueue = xQueuePolicyCreate( "BlinkyQueue", mainQUEUE_LENGTH, sizeof( uint32_t ), mainQUEUE_POLICY, 0U );
 
     if( xQueue != NULL )
     {
-        /* Start the two tasks as described in the comments at the top of this
-         * file. */
-        xTaskCreate( prvQueueReceiveTask,             /* The function that implements the task. */
-                     "Rx",                            /* The text name assigned to the task - for debug only as it is not used by the kernel. */
-                     configMINIMAL_STACK_SIZE,        /* The size of the stack to allocate to the task. */
-                     NULL,                            /* The parameter passed to the task - not used in this simple case. */
-                     mainQUEUE_RECEIVE_TASK_PRIORITY, /* The priority assigned to the task. */
-                     NULL );                          /* The task handle is not required, so NULL is passed. */
+        /* Record how full the queue gets, see DepthSampler.h. */
+        xDepthSamplerAddQueue( "BlinkyQueue", xQueuePolicyGetQueue( xQueue ) );
+
+        /* Start the task and runnable as described in the comments at the top
+         * of this file. */
+        prvCreateStaticObjects();
 
-        xTaskCreate( prvQueueSendTask, "TX", configMINIMAL_STACK_SIZE, NULL, mainQUEUE_SEND_TASK_PRIORITY, NULL );
+        /* The dispatcher only runs the queue send runnable, so takes the
+         * priority the queue send task had. */
+        xFrameSchedulerRegister( "TX", prvQueueSendRunnable, NULL, mainRUNNABLE_SEND_FRAMES );
+        xFrameSchedulerStart( mainFRAME_PERIOD_MS, mainQUEUE_SEND_TASK_PRIORITY );
 
         /* Create the software timer, but don't start it yet. */
-        xTimer = xTimerCreate( "Timer",                     /* The text name assigned to the software timer - for debug only as it is not used by the kernel. */
-                               xTimerPeriod,                /* The period of the software timer in ticks. */
-                               pdTRUE,                      /* xAutoReload is set to pdTRUE, so this timer goes off periodically with a period of xTimerPeriod ticks. */
-                               NULL,                        /* The timer's ID is not used. */
-                               prvQueueSendTimerCallback ); /* The function executed when the timer expires. */
+        xTimer = xTimerStatsCreate( "Timer",                      /* The text name assigned to the software timer - for debug only as it is not used by the kernel. */
+                                    xTimerPeriod,                 /* The period of the software timer in ticks. */
+                                    pdTRUE,                       /* xAutoReload is set to pdTRUE, so this timer goes off periodically with a period of xTimerPeriod ticks. */
+                                    NULL,                         /* The timer's ID is not used. */
+                                    prvQueueSendTimerCallback,    /* The function executed when the timer expires. */
+                                    mainTIMER_CALLBACK_BUDGET_US ); /* The callback's execution time budget. */
 
         xTimerStart( xTimer, 0 );                           /* The scheduler has not started so use a block time of 0. */
 
+        /* Allow the demo to be controlled through the control socket. */
+        for( uxCommand = 0; uxCommand < ( sizeof( xBlinkyCommands ) / sizeof( xBlinkyCommands[ 0 ] ) ); uxCommand++ )
+        {
+            xControlSocketRegister( &( xBlinkyCommands[ uxCommand ] ) );
+        }
+
         /* Start the tasks and timer running. */
         vTaskStartScheduler();
     }
@@ -182,31 +262,21 @@ void main_blinky( void )
 }
 /*-----------------------------------------------------------*/
 
-static void prvQueueSendTask( void * pvParameters )
+static void prvQueueSendRunnable( void * pvParameter )
 {
-    TickType_t xNextWakeTime;
-    const TickType_t xBlockTime = mainTASK_SEND_FREQUENCY_MS;
     const uint32_t ulValueToSend = mainVALUE_SENT_FROM_TASK;
 
     /* Prevent the compiler warning about the unused parameter. */
-    ( void ) pvParameters;
+    ( void ) pvParameter;
 
-    /* Initialise xNextWakeTime - this only needs to be done once. */
-    xNextWakeTime = xTaskGetTickCount();
-
-    for( ; ; )
+    /* Send to the queue - causing the queue receive task to unblock and
+     * write to the console.  Runnables run to completion, and the queue's
+     * policy does not block - it shouldn't need to as the queue should always
+     * have at least one space at this point in the code.  If it does not, the
+     * new message is dropped and the drop is counted. */
+    if( xSendEnabled != pdFALSE )
     {
-        /* Place this task in the blocked state until it is time to run again.
-         *  The block time is specified in ticks, pdMS_TO_TICKS() was used to
-         *  convert a time specified in milliseconds into a time specified in ticks.
-         *  While in the Blocked state this task will not consume any CPU time. */
-        vTaskDelayUntil( &xNextWakeTime, xBlockTime );
-
-        /* Send to the queue - causing the queue receive task to unblock and
-         * write to the console.  0 is used as the block time so the send operation
-         * will not block - it shouldn't need to block as the queue should always
-         * have at least one space at this point in the code. */
-        xQueueSend( xQueue, &ulValueToSend, 0U );
+        xQueuePolicySend( xQueue, &ulValueToSend );
     }
 }
 /*-----------------------------------------------------------*/
@@ -225,14 +295,16 @@ static void prvQueueSendTimerCallback( TimerHandle_t xTimerHandle )
 
     /* Send to the queue - causing the queue receive task to unblock and
      * write out a message.  This function is called from the timer/daemon task, so
-     * must not block.  Hence the block time is set to 0. */
-    xQueueSend( xQueue, &ulValueToSend, 0U );
+     * must not block, which the queue was created not to do. */
+    xQueuePolicySend( xQueue, &ulValueToSend );
 }
 /*-----------------------------------------------------------*/
 
 static void prvQueueReceiveTask( void * pvParameters )
 {
-    uint32_t ulReceivedValue;
+    uint32_t ulReceivedValue, ulDroppedReported = 0;
+    QueuePolicyStats_t xStats;
+    LoadStats_t xLoad;
 
     /* Prevent the compiler warning about the unused parameter. */
     ( void ) pvParameters;
@@ -243,34 +315,34 @@ static void prvQueueReceiveTask( void * pvParameters )
          * indefinitely provided INCLUDE_vTaskSuspend is set to 1 in
          * FreeRTOSConfig.h.  It will not use any CPU time while it is in the
          * Blocked state. */
-        xQueueReceive( xQueue, &ulReceivedValue, portMAX_DELAY );
+        xQueuePolicyReceive( xQueue, &ulReceivedValue, portMAX_DELAY );
+        vQueuePolicyGetStats( xQueue, &xStats );
+
+        /* To get here something must have been received from the queue, but
+         * is it an expected value?  The output is written by the host I/O
+         * thread (see HostIO.h), so no critical section is needed around it and
+         * the other tasks keep running while the console is written. */
+        if( ulReceivedValue == mainVALUE_SENT_FROM_TASK )
+        {
+            vLoadEstimatorGetSystemLoad( &xLoad );
+            vHostIOPrintf( "Message received from runnable - CPU load %lu.%lu%% (average %lu.%lu%%)\r\n",
+                           xLoad.ulLoad1s / 10UL, xLoad.ulLoad1s % 10UL,
+                           xLoad.ulLoadAverage / 10UL, xLoad.ulLoadAverage % 10UL );
+        }
+        else if( ulReceivedValue == mainVALUE_SENT_FROM_TIMER )
+        {
+            vHostIOPrintf( "Message received from software timer\r\n" );
+        }
+        else
+        {
+            vHostIOPrintf( "Unexpected message\r\n" );
+        }
 
-        /* Enter critical section to use printf. Not doing this could potentially cause
-         * a deadlock if the FreeRTOS simulator switches contexts and another task
-         * tries to call printf - it should be noted that use of printf within
-         * the FreeRTOS simulator is unsafe, but used here for simplicity. */
-        taskENTER_CRITICAL();
+        if( xStats.ulDropped != ulDroppedReported )
         {
-            /*  To get here something must have been received from the queue, but
-             * is it an expected value?  Normally calling printf() from a task is not
-             * a good idea.  Here there is lots of stack space and only one task is
-             * using console IO so it is ok.  However, note the comments at the top of
-             * this file about the risks of making Windows system calls (such as
-             * console output) from a FreeRTOS task. */
-            if( ulReceivedValue == mainVALUE_SENT_FROM_TASK )
-            {
-                printf( "Message received from task - idle time %llu%%\r\n", ulTaskGetIdleRunTimePercent() );
-            }
-            else if( ulReceivedValue == mainVALUE_SENT_FROM_TIMER )
-            {
-                printf( "Message received from software timer\r\n" );
-            }
-            else
-            {
-                printf( "Unexpected message\r\n" );
-            }
+            vHostIOPrintf( "%lu message(s) dropped by the %s queue policy\r\n", ( unsigned long ) ( xStats.ulDropped - ulDroppedReported ), pcQueuePolicyToString( mainQUEUE_POLICY ) );
+            ulDroppedReported = xStats.ulDropped;
         }
-        taskEXIT_CRITICAL();
     }
 }
 /*-----------------------------------------------------------*/
@@ -303,3 +375,78 @@ void vBlinkyKeyboardInterruptHandler( int xKeyPressed )
             break;
     }
 }
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTimerResetCommand( const char * pcArguments,
+                                        char * pcResult,
+                                        size_t xResultLength )
+{
+    BaseType_t xReturn;
+
+    ( void ) pcArguments;
+
+    /* Control socket commands execute in a simulated interrupt, so must use
+     * the FromISR API. */
+    xReturn = xTimerResetFromISR( xTimer, NULL );
+
+    if( xReturn != pdPASS )
+    {
+        snprintf( pcResult, xResultLength, "timer command queue full" );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTimerPeriodCommand( const char * pcArguments,
+                                         char * pcResult,
+                                         size_t xResultLength )
+{
+    unsigned long ulPeriodMs;
+    char * pcEnd;
+    TickType_t xPeriod;
+
+    ulPeriodMs = strtoul( pcArguments, &pcEnd, 10 );
+    xPeriod = pdMS_TO_TICKS( ulPeriodMs );
+
+    if( ( pcEnd == pcArguments ) || ( xPeriod == 0 ) )
+    {
+        snprintf( pcResult, xResultLength, "expected a period in milliseconds" );
+        return pdFAIL;
+    }
+
+    if( xTimerChangePeriodFromISR( xTimer, xPeriod, NULL ) != pdPASS )
+    {
+        snprintf( pcResult, xResultLength, "timer command queue full" );
+        return pdFAIL;
+    }
+
+    snprintf( pcResult, xResultLength, "{\"periodMs\":%lu}", ulPeriodMs );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSendCommand( const char * pcArguments,
+                                  char * pcResult,
+                                  size_t xResultLength )
+{
+    if( strcmp( pcArguments, "on" ) == 0 )
+    {
+        xSendEnabled = pdTRUE;
+    }
+    else if( strcmp( pcArguments, "off" ) == 0 )
+    {
+        xSendEnabled = pdFALSE;
+    }
+    else
+    {
+        snprintf( pcResult, xResultLength, "expected on or off" );
+        return pdFAIL;
+    }
+
+    snprintf( pcResult, xResultLength, "{\"sending\":%s}", ( xSendEnabled != pdFALSE ) ? "true" : "false" );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
@@ -57,12 +57,40 @@
  * In addition to the standard demo tasks, the following tasks and tests are
  * defined and/or created within this file:
  *
- * "Check" task - This only executes every five seconds but has a high priority
- * to ensure it gets processor time.  Its main function is to check that all the
- * standard demo tasks are still operational.  While no errors have been
- * discovered the check task will print out "OK" and the current simulated tick
- * time.  If an error is discovered in the execution of a task then the check
- * task will print out an appropriate error message.
+ * "RateLim" task - Receives events generated by the tick hook in bursts far
+ * faster than the task is allowed to be woken.  The events pass through a rate
+ * limiter (see RateLimiter.h), so the task is woken at most
+ * mainRATE_LIMITER_EVENTS_PER_SECOND times a second and receives the events
+ * in batches.  The check runnable verifies that no events are lost and that the
+ * wake up rate stays within the limit.  The tick hook also writes the tick
+ * count of each event to a stream buffer, which the task empties each time it
+ * is woken.  The stream buffer is added to the depth sampler (see
+ * DepthSampler.h), so its timeline shows the data that builds up between wake
+ * ups.
+ *
+ * "QSpace" basic task - Checks the values returned by uxQueueMessagesWaiting()
+ * and uxQueueSpacesAvailable() as it fills a queue.  It is a basic task (see
+ * BasicTask.h), so runs on the stack of its priority's dispatcher task rather
+ * than a stack of its own, and activates itself to repeat.  Press 'b' to see
+ * its activations and the RAM its dispatcher uses against that of an
+ * ordinary task.  As it is the only basic task of its priority, the dispatcher
+ * uses more.
+ *
+ * Interrupt load - The interrupt controller (see InterruptController.h) raises
+ * the lines in xInterruptLoad[] periodically, each with a handler that runs for
+ * a fixed time, to model the interrupt load of a device.  Press 'i' to see how
+ * often each line was handled, preempted and coalesced, and its latency.  The
+ * check runnable also raises a software interrupt line from its task with
+ * vIntCtrlRaise(), and checks the line's handler ran before the raise
+ * returned.
+ *
+ * "Check" runnable - This only executes every five seconds but is called by
+ * the frame scheduler's dispatcher task (see FrameScheduler.h), which has a
+ * high priority, to ensure it gets processor time.  Its main function is to
+ * check that all the standard demo tasks are still operational.  While no
+ * errors have been discovered the check runnable will print out "OK" and the
+ * current simulated tick time.  If an error is discovered in the execution of a
+ * task then the check runnable will print out an appropriate error message.
  *
  */
 
@@ -77,6 +105,7 @@
 #include <queue.h>
 #include <timers.h>
 #include <semphr.h>
+#include <stream_buffer.h>
 
 /* Standard demo includes. */
 #include "BlockQ.h"
@@ -106,8 +135,19 @@
 #include "StreamBufferInterrupt.h"
 #include "MessageBufferAMP.h"
 
+/* Demo includes. */
+#include "BasicTask.h"
+#include "DepthSampler.h"
+#include "FrameScheduler.h"
+#include "HostIO.h"
+#include "InterruptController.h"
+#include "LoadEstimator.h"
+#include "RateLimiter.h"
+#include "StaticSystem.h"
+#include "TimerStats.h"
+
 /* Priorities at which the tasks are created. */
-#define mainCHECK_TASK_PRIORITY         ( configMAX_PRIORITIES - 2 )
+#define mainFRAME_DISPATCHER_PRIORITY   ( configMAX_PRIORITIES - 2 )
 #define mainQUEUE_POLL_PRIORITY         ( tskIDLE_PRIORITY + 1 )
 #define mainSEM_TEST_PRIORITY           ( tskIDLE_PRIORITY + 1 )
 #define mainBLOCK_Q_PRIORITY            ( tskIDLE_PRIORITY + 2 )
@@ -117,11 +157,67 @@
 #define mainGEN_QUEUE_TASK_PRIORITY     ( tskIDLE_PRIORITY )
 #define mainFLOP_TASK_PRIORITY          ( tskIDLE_PRIORITY )
 #define mainQUEUE_OVERWRITE_PRIORITY    ( tskIDLE_PRIORITY )
+#define mainRATE_LIMITED_TASK_PRIORITY  ( tskIDLE_PRIORITY + 2 )
 
 #define mainTIMER_TEST_PERIOD           ( 50 )
 
-/* Task function prototypes. */
-static void prvCheckTask( void * pvParameters );
+/* The execution time budget of the callback of the timer created by
+ * prvDemonstrateTimerQueryFunctions(), in microseconds.  See TimerStats.h. */
+#define mainTEST_TIMER_BUDGET_US        ( 100UL )
+
+/* The tick hook generates an event on every tick for the first
+ * mainRATE_LIMITER_STORM_TICKS ticks of every mainRATE_LIMITER_STORM_PERIOD
+ * ticks.  The rate limiter lets the receiving task be woken far less often. */
+#define mainRATE_LIMITER_STORM_PERIOD          ( 1000U )
+#define mainRATE_LIMITER_STORM_TICKS           ( 200U )
+#define mainRATE_LIMITER_EVENTS_PER_SECOND     ( 20U )
+#define mainRATE_LIMITER_BURST                 ( 4U )
+
+/* The size of the stream buffer the tick hook writes the tick count of each
+ * event to.  Room for twice the events that arrive between two wake ups at the
+ * limited rate. */
+#define mainRATE_LIMITED_DATA_BYTES            ( ( 2U * configTICK_RATE_HZ / mainRATE_LIMITER_EVENTS_PER_SECOND ) * sizeof( TickType_t ) )
+
+/* The frame scheduler's base frame, and the number of frames between each
+ * execution of the check runnable - five seconds. */
+#define mainFRAME_PERIOD_MS                    pdMS_TO_TICKS( 100UL )
+#define mainCHECK_PERIOD_FRAMES                ( 50U )
+
+/* The average CPU load, in tenths of a percent, above which the demo reports
+ * that it is overloaded, and below which it reports it has recovered. */
+#define mainLOAD_HIGH_THRESHOLD                ( 900UL )
+#define mainLOAD_LOW_THRESHOLD                 ( 700UL )
+
+/* The interrupt controller line raised by the check runnable, and its
+ * priority.  The line is not used by xInterruptLoad[]. */
+#define mainSOFTWARE_INTERRUPT_LINE            ( 100U )
+#define mainSOFTWARE_INTERRUPT_PRIORITY        ( 15U )
+
+/* The length of the queue used by the queue space basic task. */
+#define mainQUEUE_SPACE_QUEUE_LENGTH           ( 10U )
+
+/* The most RAM the objects described by mainFULL_SYSTEM can occupy, checked
+ * when the file is compiled. */
+#define mainSTATIC_RAM_BUDGET_BYTES            ( 4096U )
+
+/* The interrupt load modelled by the interrupt controller. */
+typedef struct xINTERRUPT_LOAD
+{
+    uint32_t ulLine;
+    UBaseType_t uxPriority;
+    uint32_t ulPeriodUs;
+    uint32_t ulExecutionUs;
+} InterruptLoad_t;
+
+/* Runnable function prototypes. */
+static void prvCheckRunnable( void * pvParameter );
+
+/*
+ * Called by the load estimator when the average CPU load crosses the
+ * thresholds defined above.
+ */
+static void prvLoadThresholdCallback( uint32_t ulLoadAverage,
+                                      BaseType_t xOverloaded );
 
 /* A task that is created from the idle task to test the functionality of
  * eTaskStateGet(). */
@@ -156,9 +252,10 @@ static void prvDemonstrateTimerQueryFunctions( void );
 static void prvTestTimerCallback( TimerHandle_t xTimer );
 
 /*
- * A task to demonstrate the use of the xQueueSpacesAvailable() function.
+ * A basic task to demonstrate the use of the xQueueSpacesAvailable() function.
+ * pvParameter is the queue it uses.
  */
-static void prvDemoQueueSpaceFunctions( void * pvParameters );
+static void prvDemoQueueSpaceFunctions( void * pvParameter );
 
 /*
  * Tasks that ensure indefinite delays are truly indefinite.
@@ -166,6 +263,23 @@ static void prvDemoQueueSpaceFunctions( void * pvParameters );
 static void prvPermanentlyBlockingSemaphoreTask( void * pvParameters );
 static void prvPermanentlyBlockingNotificationTask( void * pvParameters );
 
+/*
+ * The rate limited task, the tick hook function that generates its events, and
+ * the function the check runnable uses to verify it, as described at the top of
+ * this file.
+ */
+static void prvRateLimitedTask( void * pvParameters );
+static void prvRateLimiterStormFromISR( void );
+static BaseType_t prvCheckRateLimiter( TickType_t xCycleFrequency );
+
+/*
+ * The handler of the software interrupt line, and the function the check
+ * runnable uses to raise the line and verify the handler ran.
+ */
+static void prvSoftwareInterruptHandler( uint32_t ulLine,
+                                         BaseType_t * pxHigherPriorityTaskWoken );
+static BaseType_t prvCheckSoftwareInterrupt( void );
+
 /*-----------------------------------------------------------*/
 
 /* The variable into which error messages are latched. */
@@ -175,12 +289,71 @@ static char * pcStatusMessage = "No errors";
  * semaphore tracing API functions.  It has no other purpose. */
 static SemaphoreHandle_t xMutexToDelete = NULL;
 
+/* The objects created by this file, rather than by the standard demo tasks,
+ * are statically allocated, see StaticSystem.h.  Nothing is actually sent to
+ * or received from the queue used by the queue space basic task, so its item
+ * size is 0. */
+#define mainFULL_SYSTEM( TASK, QUEUE, TIMER )                                                                                                \
+    QUEUE( xQueueSpaceQueue, mainQUEUE_SPACE_QUEUE_LENGTH, 0 )                                                                               \
+    TASK( xBlockingSemaphoreTask, prvPermanentlyBlockingSemaphoreTask, "BlockSem", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY )        \
+    TASK( xBlockingNotificationTask, prvPermanentlyBlockingNotificationTask, "BlockNoti", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY ) \
+    TASK( xRateLimitedTask, prvRateLimitedTask, "RateLim", configMINIMAL_STACK_SIZE, NULL, mainRATE_LIMITED_TASK_PRIORITY )
+
+staticsysDEFINE_OBJECTS( mainFULL_SYSTEM )
+staticsysDEFINE_INIT( mainFULL_SYSTEM, prvCreateStaticObjects )
+staticsysASSERT_RAM_BYTES( mainFULL_SYSTEM, mainSTATIC_RAM_BUDGET_BYTES )
+
+/* The rate limiter between the tick hook and the rate limited task, and the
+ * number of events the task has received. */
+static RateLimiter_t xRateLimiter;
+static volatile uint32_t ulRateLimitedEventsReceived = 0;
+
+/* The stream buffer that carries the tick count of each event from the tick
+ * hook to the rate limited task.  The storage has the extra byte some kernel
+ * versions need for a static stream buffer. */
+static StreamBufferHandle_t xRateLimitedData = NULL;
+static StaticStreamBuffer_t xRateLimitedDataStruct;
+static uint8_t ucRateLimitedDataStorage[ mainRATE_LIMITED_DATA_BYTES + 1U ];
+
+/* The basic task that demonstrates xQueueSpacesAvailable(). */
+static BasicTaskHandle_t xQueueSpaceBasicTask = NULL;
+
+/* A light load, loosely based on a microcontroller's timer, UART and DMA
+ * interrupts.  The lines whose periods are close to the load thread's
+ * resolution are raised late, and are sometimes coalesced, as real interrupts
+ * are when their handlers cannot keep up. */
+/* The times the software interrupt line's handler has run. */
+static volatile uint32_t ulSoftwareInterrupts = 0;
+
+static const InterruptLoad_t xInterruptLoad[] =
+{
+    /* Line, priority, period (us), execution time (us). */
+    { 17,  10, 5000,  50 },
+    { 40,  5,  1000,  20 },
+    { 200, 20, 10000, 10 }
+};
+
 /*-----------------------------------------------------------*/
 
 int main_full( void )
 {
-    /* Start the check task as described at the top of this file. */
-    xTaskCreate( prvCheckTask, "Check", configMINIMAL_STACK_SIZE, NULL, mainCHECK_TASK_PRIORITY, NULL );
+    UBaseType_t uxLoad;
+
+    /* Start the check runnable as described at the top of this file. */
+    xFrameSchedulerRegister( "Check", prvCheckRunnable, NULL, mainCHECK_PERIOD_FRAMES );
+    xFrameSchedulerStart( mainFRAME_PERIOD_MS, mainFRAME_DISPATCHER_PRIORITY );
+
+    /* Report when the demo tasks leave too little time for the idle task. */
+    vLoadEstimatorSetThresholdCallback( mainLOAD_HIGH_THRESHOLD, mainLOAD_LOW_THRESHOLD, prvLoadThresholdCallback );
+
+    /* Start the interrupt load described at the top of this file. */
+    for( uxLoad = 0; uxLoad < ( sizeof( xInterruptLoad ) / sizeof( xInterruptLoad[ 0 ] ) ); uxLoad++ )
+    {
+        xIntCtrlAddLoad( xInterruptLoad[ uxLoad ].ulLine, xInterruptLoad[ uxLoad ].uxPriority,
+                         xInterruptLoad[ uxLoad ].ulPeriodUs, xInterruptLoad[ uxLoad ].ulExecutionUs );
+    }
+
+    xIntCtrlSetHandler( mainSOFTWARE_INTERRUPT_LINE, mainSOFTWARE_INTERRUPT_PRIORITY, prvSoftwareInterruptHandler );
 
     /* Create the standard demo tasks. */
     vStartTaskNotifyTask();
@@ -200,9 +373,22 @@ int main_full( void )
     vStartInterruptSemaphoreTasks();
     vCreateBlockTimeTasks();
     vCreateAbortDelayTasks();
-    xTaskCreate( prvDemoQueueSpaceFunctions, "QSpace", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
-    xTaskCreate( prvPermanentlyBlockingSemaphoreTask, "BlockSem", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
-    xTaskCreate( prvPermanentlyBlockingNotificationTask, "BlockNoti", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+
+    /* Create the queue and tasks described by mainFULL_SYSTEM. */
+    prvCreateStaticObjects();
+    xDepthSamplerAddQueue( "QSpace", xQueueSpaceQueue );
+
+    /* The queue space basic task activates itself each time it completes, so
+     * needs room for a second activation while it is running. */
+    xQueueSpaceBasicTask = xBasicTaskCreate( "QSpace", prvDemoQueueSpaceFunctions, xQueueSpaceQueue, tskIDLE_PRIORITY, 2, configMINIMAL_STACK_SIZE );
+    configASSERT( xQueueSpaceBasicTask );
+    xBasicTaskStart();
+    xBasicTaskActivate( xQueueSpaceBasicTask );
+
+    vRateLimiterInitialise( &xRateLimiter, xRateLimitedTask, 0, mainRATE_LIMITER_EVENTS_PER_SECOND, mainRATE_LIMITER_BURST );
+    xRateLimitedData = xStreamBufferCreateStatic( mainRATE_LIMITED_DATA_BYTES, sizeof( TickType_t ), ucRateLimitedDataStorage, &xRateLimitedDataStruct );
+    configASSERT( xRateLimitedData );
+    xDepthSamplerAddStreamBuffer( "RateLimData", xRateLimitedData );
 
     vStartMessageBufferTasks( configMINIMAL_STACK_SIZE );
     vStartStreamBufferTasks();
@@ -248,156 +434,166 @@ int main_full( void )
 }
 /*-----------------------------------------------------------*/
 
-static void prvCheckTask( void * pvParameters )
+static void prvCheckRunnable( void * pvParameter )
 {
-    TickType_t xNextWakeTime;
-    const TickType_t xCycleFrequency = pdMS_TO_TICKS( 5000UL );
+    const TickType_t xCycleFrequency = mainCHECK_PERIOD_FRAMES * mainFRAME_PERIOD_MS;
     HeapStats_t xHeapStats;
+    LoadStats_t xLoad;
 
     /* Just to remove compiler warning. */
-    ( void ) pvParameters;
+    ( void ) pvParameter;
 
-    /* Initialise xNextWakeTime - this only needs to be done once. */
-    xNextWakeTime = xTaskGetTickCount();
-
-    for( ; ; )
+    /* Check the standard demo tasks are running without error. */
+    #if ( configUSE_PREEMPTION != 0 )
     {
-        /* Place this task in the blocked state until it is time to run again. */
-        vTaskDelayUntil( &xNextWakeTime, xCycleFrequency );
-
-        /* Check the standard demo tasks are running without error. */
-        #if ( configUSE_PREEMPTION != 0 )
+        /* These tasks are only created when preemption is used. */
+        if( xAreTimerDemoTasksStillRunning( xCycleFrequency ) != pdTRUE )
         {
-            /* These tasks are only created when preemption is used. */
-            if( xAreTimerDemoTasksStillRunning( xCycleFrequency ) != pdTRUE )
-            {
-                pcStatusMessage = "Error: TimerDemo";
-            }
+            pcStatusMessage = "Error: TimerDemo";
         }
-        #endif
+    }
+    #endif
 
-        if( xAreStreamBufferTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error:  StreamBuffer";
-        }
-        else if( xAreMessageBufferTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error:  MessageBuffer";
-        }
-        else if( xAreTaskNotificationTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error:  Notification";
-        }
-        else if( xAreTaskNotificationArrayTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error:  NotificationArray";
-        }
-        else if( xAreInterruptSemaphoreTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: IntSem";
-        }
-        else if( xAreEventGroupTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: EventGroup";
-        }
-        else if( xAreIntegerMathsTaskStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: IntMath";
-        }
-        else if( xAreGenericQueueTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: GenQueue";
-        }
-        else if( xAreQueuePeekTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: QueuePeek";
-        }
-        else if( xAreBlockingQueuesStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: BlockQueue";
-        }
-        else if( xAreSemaphoreTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: SemTest";
-        }
-        else if( xArePollingQueuesStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: PollQueue";
-        }
-        else if( xAreMathsTaskStillRunning() != pdPASS )
-        {
-            pcStatusMessage = "Error: Flop";
-        }
-        else if( xAreRecursiveMutexTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: RecMutex";
-        }
-        else if( xAreCountingSemaphoreTasksStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: CountSem";
-        }
-        else if( xIsCreateTaskStillRunning() != pdTRUE )
-        {
-            pcStatusMessage = "Error: Death";
-        }
-        else if( xAreDynamicPriorityTasksStillRunning() != pdPASS )
-        {
-            pcStatusMessage = "Error: Dynamic";
-        }
-        else if( xIsQueueOverwriteTaskStillRunning() != pdPASS )
-        {
-            pcStatusMessage = "Error: Queue overwrite";
-        }
-        else if( xAreBlockTimeTestTasksStillRunning() != pdPASS )
-        {
-            pcStatusMessage = "Error: Block time";
-        }
-        else if( xAreAbortDelayTestTasksStillRunning() != pdPASS )
+    if( xAreStreamBufferTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error:  StreamBuffer";
+    }
+    else if( xAreMessageBufferTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error:  MessageBuffer";
+    }
+    else if( xAreTaskNotificationTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error:  Notification";
+    }
+    else if( xAreTaskNotificationArrayTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error:  NotificationArray";
+    }
+    else if( xAreInterruptSemaphoreTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: IntSem";
+    }
+    else if( xAreEventGroupTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: EventGroup";
+    }
+    else if( xAreIntegerMathsTaskStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: IntMath";
+    }
+    else if( xAreGenericQueueTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: GenQueue";
+    }
+    else if( xAreQueuePeekTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: QueuePeek";
+    }
+    else if( xAreBlockingQueuesStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: BlockQueue";
+    }
+    else if( xAreSemaphoreTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: SemTest";
+    }
+    else if( xArePollingQueuesStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: PollQueue";
+    }
+    else if( xAreMathsTaskStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Flop";
+    }
+    else if( xAreRecursiveMutexTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: RecMutex";
+    }
+    else if( xAreCountingSemaphoreTasksStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: CountSem";
+    }
+    else if( xIsCreateTaskStillRunning() != pdTRUE )
+    {
+        pcStatusMessage = "Error: Death";
+    }
+    else if( xAreDynamicPriorityTasksStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Dynamic";
+    }
+    else if( xIsQueueOverwriteTaskStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Queue overwrite";
+    }
+    else if( xAreBlockTimeTestTasksStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Block time";
+    }
+    else if( xAreAbortDelayTestTasksStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Abort delay";
+    }
+    else if( xIsInterruptStreamBufferDemoStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Stream buffer interrupt";
+    }
+    else if( xAreMessageBufferAMPTasksStillRunning() != pdPASS )
+    {
+        pcStatusMessage = "Error: Message buffer AMP";
+    }
+    else if( prvCheckRateLimiter( xCycleFrequency ) != pdPASS )
+    {
+        pcStatusMessage = "Error: Rate limiter";
+    }
+    else if( prvCheckSoftwareInterrupt() != pdPASS )
+    {
+        pcStatusMessage = "Error: Software interrupt";
+    }
+
+    #if ( configUSE_QUEUE_SETS == 1 )
+        else if( xAreQueueSetTasksStillRunning() != pdPASS )
         {
-            pcStatusMessage = "Error: Abort delay";
+            pcStatusMessage = "Error: Queue set";
         }
-        else if( xIsInterruptStreamBufferDemoStillRunning() != pdPASS )
+        else if( xAreQueueSetPollTasksStillRunning() != pdPASS )
         {
-            pcStatusMessage = "Error: Stream buffer interrupt";
+            pcStatusMessage = "Error: Queue set polling";
         }
-        else if( xAreMessageBufferAMPTasksStillRunning() != pdPASS )
+    #endif
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        else if( xAreStaticAllocationTasksStillRunning() != pdPASS )
         {
-            pcStatusMessage = "Error: Message buffer AMP";
+            pcStatusMessage = "Error: Static allocation";
         }
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+    vPortGetHeapStats( &xHeapStats );
+
+    configASSERT( xHeapStats.xAvailableHeapSpaceInBytes == xPortGetFreeHeapSize() );
+    configASSERT( xHeapStats.xMinimumEverFreeBytesRemaining == xPortGetMinimumEverFreeHeapSize() );
+
+    /* The output is written by the host I/O thread (see HostIO.h), so the
+     * dispatcher does not wait for the console. */
+    vLoadEstimatorGetSystemLoad( &xLoad );
+    vHostIOPrintf( "%s - tick count %zu - free heap %zu - min free heap %zu - largest free block %zu - CPU load %lu.%lu%% (60s %lu.%lu%%)\r\n",
+                   pcStatusMessage,
+                   xTaskGetTickCount(),
+                   xHeapStats.xAvailableHeapSpaceInBytes,
+                   xHeapStats.xMinimumEverFreeBytesRemaining,
+                   xHeapStats.xSizeOfLargestFreeBlockInBytes,
+                   xLoad.ulLoad1s / 10UL, xLoad.ulLoad1s % 10UL,
+                   xLoad.ulLoad60s / 10UL, xLoad.ulLoad60s % 10UL );
+}
+/*-----------------------------------------------------------*/
 
-        #if ( configUSE_QUEUE_SETS == 1 )
-            else if( xAreQueueSetTasksStillRunning() != pdPASS )
-            {
-                pcStatusMessage = "Error: Queue set";
-            }
-            else if( xAreQueueSetPollTasksStillRunning() != pdPASS )
-            {
-                pcStatusMessage = "Error: Queue set polling";
-            }
-        #endif
-
-        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
-            else if( xAreStaticAllocationTasksStillRunning() != pdPASS )
-            {
-                pcStatusMessage = "Error: Static allocation";
-            }
-        #endif /* configSUPPORT_STATIC_ALLOCATION */
-
-        /* This is the only task that uses stdout so its ok to call printf()
-         * directly. */
-        vPortGetHeapStats( &xHeapStats );
-
-        configASSERT( xHeapStats.xAvailableHeapSpaceInBytes == xPortGetFreeHeapSize() );
-        configASSERT( xHeapStats.xMinimumEverFreeBytesRemaining == xPortGetMinimumEverFreeHeapSize() );
-
-        printf( "%s - tick count %zu - free heap %zu - min free heap %zu - largest free block %zu - idle time %llu%%\r\n",
-                pcStatusMessage,
-                xTaskGetTickCount(),
-                xHeapStats.xAvailableHeapSpaceInBytes,
-                xHeapStats.xMinimumEverFreeBytesRemaining,
-                xHeapStats.xSizeOfLargestFreeBlockInBytes,
-                ulTaskGetIdleRunTimePercent() );
-    }
+static void prvLoadThresholdCallback( uint32_t ulLoadAverage,
+                                      BaseType_t xOverloaded )
+{
+    vHostIOPrintf( "CPU load %s - average %lu.%lu%%\r\n",
+                   ( xOverloaded != pdFALSE ) ? "high" : "recovered",
+                   ulLoadAverage / 10UL, ulLoadAverage % 10UL );
 }
 /*-----------------------------------------------------------*/
 
@@ -512,6 +708,10 @@ void vFullDemoTickHookFunction( void )
      * a stream being sent from an interrupt to a task. */
     vBasicStreamBufferSendFromISR();
 
+    /* Generate bursts of events that are passed to a task through a rate
+     * limiter. */
+    prvRateLimiterStormFromISR();
+
     /* For code coverage purposes. */
     xTimerTask = xTimerGetTimerDaemonTaskHandle();
     configASSERT( uxTaskPriorityGetFromISR( xTimerTask ) == configTIMER_TASK_PRIORITY );
@@ -554,7 +754,7 @@ static void prvDemonstrateTimerQueryFunctions( void )
 
     if( xTimer == NULL )
     {
-        xTimer = xTimerCreate( pcTimerName, portMAX_DELAY, pdTRUE, NULL, prvTestTimerCallback );
+        xTimer = xTimerStatsCreate( pcTimerName, portMAX_DELAY, pdTRUE, NULL, prvTestTimerCallback, mainTEST_TIMER_BUDGET_US );
 
         if( xTimer != NULL )
         {
@@ -713,74 +913,65 @@ static void prvDemonstrateTaskStateAndHandleGetFunctions( void )
 }
 /*-----------------------------------------------------------*/
 
-static void prvDemoQueueSpaceFunctions( void * pvParameters )
+static void prvDemoQueueSpaceFunctions( void * pvParameter )
 {
-    QueueHandle_t xQueue = NULL;
-    const unsigned portBASE_TYPE uxQueueLength = 10;
+    QueueHandle_t xQueue = ( QueueHandle_t ) pvParameter;
+    const unsigned portBASE_TYPE uxQueueLength = mainQUEUE_SPACE_QUEUE_LENGTH;
     unsigned portBASE_TYPE uxReturn, x;
 
-    /* Remove compiler warnings. */
-    ( void ) pvParameters;
-
-    /* Create the queue that will be used.  Nothing is actually going to be
-     * sent or received so the queue item size is set to 0. */
-    xQueue = xQueueCreate( uxQueueLength, 0 );
-    configASSERT( xQueue );
-
-    for( ; ; )
+    for( x = 0; x < uxQueueLength; x++ )
     {
-        for( x = 0; x < uxQueueLength; x++ )
-        {
-            /* Ask how many messages are available... */
-            uxReturn = uxQueueMessagesWaiting( xQueue );
-
-            /* Check the number of messages being reported as being available
-             * is as expected, and force an assert if not. */
-            if( uxReturn != x )
-            {
-                /* xQueue cannot be NULL so this is deliberately causing an
-                 * assert to be triggered as there is an error. */
-                configASSERT( xQueue == NULL );
-            }
-
-            /* Ask how many spaces remain in the queue... */
-            uxReturn = uxQueueSpacesAvailable( xQueue );
-
-            /* Check the number of spaces being reported as being available
-             * is as expected, and force an assert if not. */
-            if( uxReturn != ( uxQueueLength - x ) )
-            {
-                /* xQueue cannot be NULL so this is deliberately causing an
-                 * assert to be triggered as there is an error. */
-                configASSERT( xQueue == NULL );
-            }
-
-            /* Fill one more space in the queue. */
-            xQueueSendToBack( xQueue, NULL, 0 );
-        }
-
-        /* Perform the same check while the queue is full. */
+        /* Ask how many messages are available... */
         uxReturn = uxQueueMessagesWaiting( xQueue );
 
-        if( uxReturn != uxQueueLength )
+        /* Check the number of messages being reported as being available
+         * is as expected, and force an assert if not. */
+        if( uxReturn != x )
         {
+            /* xQueue cannot be NULL so this is deliberately causing an
+             * assert to be triggered as there is an error. */
             configASSERT( xQueue == NULL );
         }
 
+        /* Ask how many spaces remain in the queue... */
         uxReturn = uxQueueSpacesAvailable( xQueue );
 
-        if( uxReturn != 0 )
+        /* Check the number of spaces being reported as being available
+         * is as expected, and force an assert if not. */
+        if( uxReturn != ( uxQueueLength - x ) )
         {
+            /* xQueue cannot be NULL so this is deliberately causing an
+             * assert to be triggered as there is an error. */
             configASSERT( xQueue == NULL );
         }
 
-        /* The queue is full, start again. */
-        xQueueReset( xQueue );
+        /* Fill one more space in the queue. */
+        xQueueSendToBack( xQueue, NULL, 0 );
+    }
+
+    /* Perform the same check while the queue is full. */
+    uxReturn = uxQueueMessagesWaiting( xQueue );
 
-        #if ( configUSE_PREEMPTION == 0 )
-            taskYIELD();
-        #endif
+    if( uxReturn != uxQueueLength )
+    {
+        configASSERT( xQueue == NULL );
     }
+
+    uxReturn = uxQueueSpacesAvailable( xQueue );
+
+    if( uxReturn != 0 )
+    {
+        configASSERT( xQueue == NULL );
+    }
+
+    /* The queue is full, start again.  A basic task runs to completion, so
+     * rather than looping it activates itself to run the next cycle. */
+    xQueueReset( xQueue );
+    xBasicTaskActivate( xQueueSpaceBasicTask );
+
+    #if ( configUSE_PREEMPTION == 0 )
+        taskYIELD();
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -819,3 +1010,103 @@ static void prvPermanentlyBlockingNotificationTask( void * pvParameters )
     configASSERT( pvParameters != NULL );
     vTaskDelete( NULL );
 }
+/*-----------------------------------------------------------*/
+
+static void prvRateLimitedTask( void * pvParameters )
+{
+    TickType_t xEventTicks[ 8 ];
+
+    /* Just to remove compiler warnings. */
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* Each wake up delivers every event that occurred since the last one,
+         * however many there were. */
+        ulRateLimitedEventsReceived += ulRateLimiterWait( &xRateLimiter, portMAX_DELAY );
+
+        /* Empty the data the events carried.  The task is woken by the rate
+         * limiter, not by the stream buffer, so the buffer never blocks it. */
+        while( xStreamBufferReceive( xRateLimitedData, xEventTicks, sizeof( xEventTicks ), 0 ) != 0 )
+        {
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRateLimiterStormFromISR( void )
+{
+    /* Only generate events once the rate limiter has a task to wake. */
+    if( ( xRateLimitedTask != NULL ) && ( ( xTaskGetTickCountFromISR() % mainRATE_LIMITER_STORM_PERIOD ) < mainRATE_LIMITER_STORM_TICKS ) )
+    {
+        TickType_t xTick = xTaskGetTickCountFromISR();
+
+        /* No task blocks on the stream buffer, so there is nobody to wake.  If
+         * the buffer is full the tick count is lost, but the event is not. */
+        ( void ) xStreamBufferSendFromISR( xRateLimitedData, &xTick, sizeof( xTick ), NULL );
+        ( void ) xRateLimiterEventFromISR( &xRateLimiter, NULL );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckRateLimiter( TickType_t xCycleFrequency )
+{
+    static RateLimiterStats_t xLastStats = { 0 };
+    static uint32_t ulLastReceived = 0;
+    RateLimiterStats_t xStats;
+    uint32_t ulReceived, ulMaxWakeUps;
+    BaseType_t xReturn = pdPASS;
+
+    /* Read the received count first, so it cannot include events that
+     * occurred after the statistics were read. */
+    ulReceived = ulRateLimitedEventsReceived;
+    vRateLimiterGetStats( &xRateLimiter, &xStats );
+
+    /* The bucket can start the cycle full, then refills at the configured
+     * rate. */
+    ulMaxWakeUps = ( uint32_t ) ( ( ( uint64_t ) mainRATE_LIMITER_EVENTS_PER_SECOND * xCycleFrequency ) / configTICK_RATE_HZ ) + mainRATE_LIMITER_BURST + 1U;
+
+    if( ( xStats.ulEvents == xLastStats.ulEvents ) || ( ulReceived == ulLastReceived ) )
+    {
+        /* Events should have been generated and received in every cycle. */
+        xReturn = pdFAIL;
+    }
+    else if( ( xStats.ulWakeUps - xLastStats.ulWakeUps ) > ulMaxWakeUps )
+    {
+        /* The task was woken more often than the limit allows. */
+        xReturn = pdFAIL;
+    }
+    else if( ( ulReceived > xStats.ulEvents ) || ( ( xStats.ulEvents - ulReceived ) > mainRATE_LIMITER_STORM_TICKS ) )
+    {
+        /* Events were invented, or were held back rather than coalesced. */
+        xReturn = pdFAIL;
+    }
+
+    xLastStats = xStats;
+    ulLastReceived = ulReceived;
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSoftwareInterruptHandler( uint32_t ulLine,
+                                         BaseType_t * pxHigherPriorityTaskWoken )
+{
+    ( void ) ulLine;
+    ( void ) pxHigherPriorityTaskWoken;
+
+    ulSoftwareInterrupts++;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCheckSoftwareInterrupt( void )
+{
+    uint32_t ulBefore = ulSoftwareInterrupts;
+
+    /* vIntCtrlRaise() does not return until the simulated interrupt has been
+     * serviced, so the handler has run by the time it does. */
+    vIntCtrlRaise( mainSOFTWARE_INTERRUPT_LINE );
+
+    return ( ulSoftwareInterrupts == ( ulBefore + 1U ) ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
@@ -42,6 +42,10 @@
 #include "task.h"
 #include "timers.h"
 
+/* Demo includes. */
+#include "StaticSystem.h"
+#include "TimerStats.h"
+
 /* The constants used in the calculation. */
 #define intgCONST1             ( ( long ) 123 )
 #define intgCONST2             ( ( long ) 234567 )
@@ -61,6 +65,9 @@
 /* The rate at which the monitor task checks the integer math tasks. */
 #define mainMONITOR_FREQUENCY_MS           pdMS_TO_TICKS( 2000UL )
 
+/* The longest the monitor timer's callback should take, in microseconds. */
+#define mainMONITOR_TIMER_BUDGET_US        ( 100UL )
+
 /* This demo allows for users to perform actions with the keyboard. */
 #define mainNO_KEY_PRESS_VALUE             ( -1 )
 #define mainSTATUS_KEY                     ( 's' )
@@ -79,6 +86,16 @@ static void prvMonitorTimerCallback(TimerHandle_t xTimerHandle);
 
 /*-----------------------------------------------------------*/
 
+/* The monitor task is statically allocated, see StaticSystem.h.  The integer
+ * math tasks are created by vStartIntegerMathTasks(), which the full demo
+ * also uses with its own priority, and the monitor timer by the TimerStats
+ * wrapper, so both keep their heap state. */
+#define mainINTEGER_SYSTEM( TASK, QUEUE, TIMER ) \
+    TASK( xMonitorTask, prvMonitorTask, "Monitor", configMINIMAL_STACK_SIZE, NULL, mainMONITOR_TASK_PRIORITY )
+
+staticsysDEFINE_OBJECTS( mainINTEGER_SYSTEM )
+staticsysDEFINE_INIT( mainINTEGER_SYSTEM, prvCreateStaticObjects )
+
 /* Variables that are set to true within the calculation task to indicate
  * that the task is still executing.  The check task sets the variable back to
  * false, flagging an error if the variable is still false the next time it
@@ -205,20 +222,16 @@ void main_integer(void)
     /* Start the integer math tasks. */
     vStartIntegerMathTasks(mainINTEGER_TASK_PRIORITY);
 
-    /* Create the monitor task. */
-    xTaskCreate(prvMonitorTask,                    /* The function that implements the task. */
-        "Monitor",                         /* The text name assigned to the task. */
-        configMINIMAL_STACK_SIZE,          /* The size of the stack to allocate to the task. */
-        NULL,                              /* The parameter passed to the task. */
-        mainMONITOR_TASK_PRIORITY,         /* The priority assigned to the task. */
-        NULL);                            /* The task handle is not required. */
+    /* Create the monitor task described by mainINTEGER_SYSTEM. */
+    prvCreateStaticObjects();
 
     /* Create the monitor timer, but don't start it yet. */
-    xMonitorTimer = xTimerCreate("MonitorTimer",           /* Timer name. */
+    xMonitorTimer = xTimerStatsCreate("MonitorTimer",      /* Timer name. */
         xTimerPeriod,             /* Timer period. */
         pdTRUE,                   /* Auto-reload timer. */
         NULL,                     /* Timer ID not used. */
-        prvMonitorTimerCallback);/* Timer callback function. */
+        prvMonitorTimerCallback,  /* Timer callback function. */
+        mainMONITOR_TIMER_BUDGET_US);/* Callback execution time budget. */
 
     if (xMonitorTimer != NULL)
     {
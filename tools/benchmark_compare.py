@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+#
+# FreeRTOS V202212.00
+# Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in
+# the Software without restriction, including without limitation the rights to
+# use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+# the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# https://www.FreeRTOS.org
+# https://github.com/FreeRTOS
+#
+
+"""Compare two sets of benchmark results written by main_benchmark.c.
+
+Each line of the results file is one result of one run, recorded with the git
+revision and the configuration it was measured with, and the session - the
+time the demo started.  A set of results is all the runs of one revision and
+configuration.  A revision marked "-dirty" was measured with uncommitted
+changes, which may differ from session to session, so each session of a dirty
+revision is a set of its own.  For each benchmark variant the
+median cost of the two sets is compared, and a bootstrap confidence interval of
+the change is calculated from the spread of the runs.  A change is only
+reported as a regression or an improvement if the whole interval is beyond the
+threshold, so differences within the noise between runs are not.
+
+By default the candidate is the set written last, and the baseline is the
+most recent other set of the same configuration - normally the previous
+revision.  To measure a configuration change, such as enabling large pages,
+select both sets explicitly.  Revisions may be abbreviated.  A source change,
+such as building another heap, is a change of revision.
+
+Exits with status 1 if any regression is found, so can be used as a check.
+
+Examples:
+    python tools/benchmark_compare.py --list
+    python tools/benchmark_compare.py --baseline 1a2b3c4
+    python tools/benchmark_compare.py --baseline-config "build=release large-pages=0 ..."
+    python tools/benchmark_compare.py --baseline 1a2b3c4-dirty --baseline-session 20260101-120000
+"""
+
+import argparse
+import json
+import math
+import random
+import statistics
+import sys
+
+RESULTS_FILE_NAME = "BenchmarkResults.jsonl"
+MIN_RUNS = 3
+
+
+def load_results(file_name):
+    """Return the results in the order they were written, skipping lines that
+    are not complete results, such as the last line of an interrupted run."""
+    results = []
+    with open(file_name, "r", encoding="utf-8") as results_file:
+        for line in results_file:
+            try:
+                result = json.loads(line)
+                results.append((set_key(result["revision"], result["config"], result.get("session", "")),
+                                result["benchmark"], result["variant"], float(result["ns_per_op"])))
+            except (ValueError, KeyError):
+                continue
+    return results
+
+
+def set_key(revision, config, session):
+    """Return the (revision, config, session) key of the set a result belongs
+    to.  Only the results of dirty revisions are kept apart by session."""
+    return (revision, config, session if revision.endswith("-dirty") else "")
+
+
+def list_sets(results):
+    """Return each set with its number of results, most recently written
+    last."""
+    counts = {}
+    for key, _, _, _ in results:
+        # Move the set to the end, so the order is that of the last write.
+        counts[key] = counts.pop(key, 0) + 1
+    return list(counts.items())
+
+
+def select_set(sets, revision, config, session, exclude=None):
+    """Return the most recent set matching the revision prefix, config and
+    session, any of which may be None to match anything."""
+    for key, _ in reversed(sets):
+        if key == exclude:
+            continue
+        if revision is not None and not key[0].startswith(revision):
+            continue
+        if config is not None and key[1] != config:
+            continue
+        if session is not None and key[2] != session:
+            continue
+        return key
+    return None
+
+
+def samples_by_variant(results, selected):
+    samples = {}
+    for key, benchmark, variant, ns_per_op in results:
+        if key == selected:
+            samples.setdefault((benchmark, variant), []).append(ns_per_op)
+    return samples
+
+
+def relative_change(base, cand):
+    """Return the relative change from base to cand.  Operations that cost less
+    than a nanosecond are reported as 0 ns, so a baseline of 0 is possible:
+    staying at 0 is no change, and any cost above it is an infinite one."""
+    if base > 0:
+        return (cand / base) - 1.0
+    return math.inf if cand > 0 else 0.0
+
+
+def bootstrap_change(baseline, candidate, confidence, iterations, rng):
+    """Return the relative change of the median from baseline to candidate,
+    and its confidence interval."""
+    change = relative_change(statistics.median(baseline), statistics.median(candidate))
+    changes = []
+    for _ in range(iterations):
+        base = statistics.median(rng.choices(baseline, k=len(baseline)))
+        cand = statistics.median(rng.choices(candidate, k=len(candidate)))
+        changes.append(relative_change(base, cand))
+    changes.sort()
+    tail = (1.0 - confidence) / 2.0
+    low = changes[int(tail * (iterations - 1))]
+    high = changes[int((1.0 - tail) * (iterations - 1))]
+    return change, low, high
+
+
+def short_revision(revision):
+    """Return the revision abbreviated, keeping any "-dirty" marker."""
+    if revision.endswith("-dirty"):
+        return revision[:-len("-dirty")][:12] + "-dirty"
+    return revision[:12]
+
+
+def describe(key):
+    session = " session %s" % key[2] if key[2] else ""
+    return "%s [%s]%s" % (short_revision(key[0]), key[1], session)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--results", default=RESULTS_FILE_NAME,
+                        help="the results file (default %(default)s)")
+    parser.add_argument("--list", action="store_true",
+                        help="list the sets of results in the file")
+    parser.add_argument("--baseline", metavar="REVISION", help="the baseline revision")
+    parser.add_argument("--baseline-config", metavar="CONFIG", help="the baseline configuration")
+    parser.add_argument("--baseline-session", metavar="SESSION", help="the baseline session, of a dirty revision")
+    parser.add_argument("--candidate", metavar="REVISION", help="the candidate revision")
+    parser.add_argument("--candidate-config", metavar="CONFIG", help="the candidate configuration")
+    parser.add_argument("--candidate-session", metavar="SESSION", help="the candidate session, of a dirty revision")
+    parser.add_argument("--threshold", type=float, default=2.0,
+                        help="the smallest change reported, in percent (default %(default)s)")
+    parser.add_argument("--confidence", type=float, default=0.95,
+                        help="the confidence level of the intervals (default %(default)s)")
+    parser.add_argument("--iterations", type=int, default=2000,
+                        help="the bootstrap iterations (default %(default)s)")
+    args = parser.parse_args()
+
+    results = load_results(args.results)
+    sets = list_sets(results)
+
+    if not sets:
+        sys.exit("No results in %s" % args.results)
+
+    if args.list:
+        for key, count in sets:
+            print("%-18s %-15s %5d results  %s" % (short_revision(key[0]), key[2], count, key[1]))
+        return 0
+
+    candidate = select_set(sets, args.candidate, args.candidate_config, args.candidate_session)
+    if candidate is None:
+        sys.exit("No candidate results match")
+
+    # Unless told otherwise, compare against the same configuration.
+    baseline_config = args.baseline_config
+    if baseline_config is None and args.baseline is None:
+        baseline_config = candidate[1]
+    baseline = select_set(sets, args.baseline, baseline_config, args.baseline_session, exclude=candidate)
+    if baseline is None:
+        sys.exit("No baseline results match")
+
+    print("Baseline:  %s" % describe(baseline))
+    print("Candidate: %s" % describe(candidate))
+    print()
+
+    base_samples = samples_by_variant(results, baseline)
+    cand_samples = samples_by_variant(results, candidate)
+    rng = random.Random(1)
+    threshold = args.threshold / 100.0
+    regressions = 0
+
+    print("%-24s %-16s %12s %12s %8s %19s  %s" % ("Benchmark", "Variant", "Base ns/op",
+                                                  "Cand ns/op", "Change", "Interval", "Verdict"))
+
+    for key in sorted(set(base_samples) & set(cand_samples)):
+        base, cand = base_samples[key], cand_samples[key]
+
+        if len(base) < MIN_RUNS or len(cand) < MIN_RUNS:
+            verdict = "too few runs"
+            change, low, high = relative_change(statistics.median(base), statistics.median(cand)), None, None
+        else:
+            change, low, high = bootstrap_change(base, cand, args.confidence, args.iterations, rng)
+
+            # The results are costs, so an increase is a regression.
+            if low > threshold:
+                verdict = "REGRESSION"
+                regressions += 1
+            elif high < -threshold:
+                verdict = "improvement"
+            else:
+                verdict = ""
+
+        interval = "" if low is None else "%+7.1f%% .. %+7.1f%%" % (low * 100.0, high * 100.0)
+        print("%-24s %-16s %12.0f %12.0f %+7.1f%% %19s  %s" % (key[0], key[1], statistics.median(base),
+                                                             statistics.median(cand), change * 100.0,
+                                                             interval, verdict))
+
+    for key in sorted(set(base_samples) ^ set(cand_samples)):
+        print("%-24s %-16s only in the %s" % (key[0], key[1],
+                                             "baseline" if key in base_samples else "candidate"))
+
+    print()
+    print("%d regression%s beyond %.1f%% at %.0f%% confidence" % (regressions, "" if regressions == 1 else "s",
+                                                                 args.threshold, args.confidence * 100.0))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+#
+# FreeRTOS V202212.00
+# Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of
+# this software and associated documentation files (the "Software"), to deal in
+# the Software without restriction, including without limitation the rights to
+# use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+# the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# https://www.FreeRTOS.org
+# https://github.com/FreeRTOS
+#
+
+"""Compare the statistics saved with two trace recordings, worst change first.
+
+Each time the demo saves its trace it also writes Trace.stats.json, see
+Trace-stats-utils.c.  Given the file from a baseline run and the file from a
+candidate run, this script works out, for both runs:
+
+- the share of the processor used by all tasks but the idle task, and each
+  other task's share of the processor, context switch rate, switch in latency
+  percentiles and share of wake ups that did no work,
+- each object's rate of calls that could block, and the time tasks spent
+  blocked on it,
+- each sampled queue's share of time full and mean depth,
+
+then ranks the changes from baseline to candidate by how much worse they are.
+The idle task's own share is not ranked, as more idle time is better, and the
+rate of calls to an object is listed for information but not ranked, as more
+calls are only worse if they add to the time blocked, which is ranked.
+Counts are converted to rates and shares first, so runs of different lengths
+can be compared.  Changes to values that are close to zero are measured
+against a floor rather than the value itself, so a task that goes from 0.01%
+to 0.02% of the processor is not reported as a 100% regression.
+
+Exits with status 1 if any regression beyond the threshold is found.
+
+Example:
+    python tools/trace_stats_diff.py baseline.stats.json Trace.stats.json
+"""
+
+import argparse
+import json
+import sys
+
+# The name of the idle task, configIDLE_TASK_NAME.
+IDLE_TASK_NAME = "IDLE"
+
+# Each metric: its name, the unit it is printed in, the smallest baseline value
+# changes are measured against, and +1 if a higher value is worse, -1 if a
+# lower value is worse, or 0 if the change is only listed for information.
+METRICS = {
+    "load": ("non-idle CPU", "%", 1.0, 1),
+    "cpu": ("CPU share", "%", 1.0, 1),
+    "switches": ("switches/s", "/s", 10.0, 1),
+    "latency_mean": ("mean latency", "us", 10.0, 1),
+    "latency_p90": ("p90 latency", "us", 10.0, 1),
+    "latency_p99": ("p99 latency", "us", 10.0, 1),
+    "idle_wakeups": ("no-work wake ups", "%", 5.0, 1),
+    "calls": ("calls/s", "/s", 1.0, 0),
+    "blocked": ("time blocked", "%", 1.0, 1),
+    "full": ("time full", "%", 1.0, 1),
+    "depth": ("mean depth", "", 1.0, 1),
+    "min_free_heap": ("min free heap", "B", 1024.0, -1),
+}
+
+
+def percentile(histogram, limits, max_latency, fraction):
+    """Return the upper limit of the bucket holding the given fraction of the
+    samples.  The last bucket has no limit, so the maximum is used."""
+    total = sum(histogram)
+    if total == 0:
+        return 0.0
+    needed = fraction * total
+    count = 0
+    for bucket, samples in enumerate(histogram):
+        count += samples
+        if count >= needed:
+            return float(limits[bucket]) if bucket < len(limits) else float(max_latency)
+    return float(max_latency)
+
+
+def load_metrics(file_name):
+    """Return {(subject, metric): value} for one statistics file."""
+    with open(file_name, "r", encoding="utf-8") as stats_file:
+        stats = json.load(stats_file)
+
+    elapsed_us = float(stats["elapsedUs"]) or 1.0
+    elapsed_s = elapsed_us / 1e6
+    metrics = {("system", "min_free_heap"): float(stats["minFreeHeap"])}
+
+    def add(subject, metric, value):
+        key = (subject, metric)
+        metrics[key] = metrics.get(key, 0.0) + value
+
+    # Tasks can share a name, in which case they are combined: counts and times
+    # are added before the shares, means and percentiles are worked out.  The
+    # idle task is reported as the load of the rest of the system instead.
+    idle_us = None
+    for task in stats.get("tasks", []):
+        if task["name"] == IDLE_TASK_NAME:
+            idle_us = (idle_us or 0.0) + task["runTimeUs"]
+        else:
+            add("task " + task["name"], "cpu", 100.0 * task["runTimeUs"] / elapsed_us)
+
+    if idle_us is not None:
+        metrics[("system", "load")] = max(0.0, 100.0 - 100.0 * idle_us / elapsed_us)
+
+    limits = stats.get("latencyBucketsUs", [])
+    latencies = {}
+    for task in stats.get("switches", []):
+        subject = "task " + task["name"]
+        add(subject, "switches", task["switchIns"] / elapsed_s)
+        # The histogram counts the same samples as the mean, so weights it.
+        total, histogram, max_latency = latencies.get(subject, (0.0, [0] * len(task["latencyHistogram"]), 0))
+        latencies[subject] = (total + task["meanLatencyUs"] * sum(task["latencyHistogram"]),
+                              [count + more for count, more in zip(histogram, task["latencyHistogram"])],
+                              max(max_latency, task["maxLatencyUs"]))
+
+    for subject, (total, histogram, max_latency) in latencies.items():
+        samples = sum(histogram)
+        metrics[(subject, "latency_mean")] = total / samples if samples else 0.0
+        for metric, fraction in (("latency_p90", 0.90), ("latency_p99", 0.99)):
+            metrics[(subject, metric)] = percentile(histogram, limits, max_latency, fraction)
+
+    wakeups = {}
+    for task in stats.get("wakeups", []):
+        subject = "task " + task["name"]
+        idle, blocked = wakeups.get(subject, (0, 0))
+        wakeups[subject] = (idle + task["idleWakeups"], blocked + task["blockedWakeups"])
+
+    for subject, (idle, blocked) in wakeups.items():
+        if blocked > 0:
+            metrics[(subject, "idle_wakeups")] = 100.0 * idle / blocked
+
+    # Blocking is recorded per task and object pair, and combined per object.
+    for record in stats.get("blocking", []):
+        subject = "%s %s" % (record["type"].lower(), record["object"])
+        add(subject, "calls", record["calls"] / elapsed_s)
+        add(subject, "blocked", 100.0 * record["totalMs"] * 1000.0 / elapsed_us)
+
+    for queue in stats.get("queues", []):
+        subject = "queue " + queue["name"]
+        if queue["samples"] > 0:
+            metrics[(subject, "full")] = 100.0 * queue["ticksFull"] / queue["samples"]
+        metrics[(subject, "depth")] = queue["meanDepthTenths"] / 10.0
+
+    return metrics
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("baseline", help="the statistics of the baseline run")
+    parser.add_argument("candidate", help="the statistics of the candidate run")
+    parser.add_argument("--top", type=int, default=20,
+                        help="the number of regressions listed (default %(default)s)")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="the smallest change listed, in percent (default %(default)s)")
+    parser.add_argument("--improvements", action="store_true",
+                        help="also list the biggest improvements")
+    args = parser.parse_args()
+
+    baseline = load_metrics(args.baseline)
+    candidate = load_metrics(args.candidate)
+    changes = []
+    information = []
+
+    for key in set(baseline) & set(candidate):
+        name, unit, floor, direction = METRICS[key[1]]
+        old, new = baseline[key], candidate[key]
+        change = (new - old) / max(abs(old), floor)
+        if abs(change) * 100.0 >= args.threshold:
+            if direction == 0:
+                information.append((change, key[0], name, unit, old, new))
+            else:
+                changes.append((direction * change, key[0], name, unit, old, new))
+
+    changes.sort(key=lambda change: change[0], reverse=True)
+    information.sort(key=lambda change: abs(change[0]), reverse=True)
+    regressions = [change for change in changes if change[0] > 0][:args.top]
+
+    def print_changes(title, selected, heading="Worse by"):
+        print(title)
+        print("%4s  %-36s %-18s %14s %14s %9s" % ("", "Subject", "Metric", "Baseline", "Candidate", heading))
+        for rank, (score, subject, name, unit, old, new) in enumerate(selected, 1):
+            print("%4d  %-36s %-18s %12.1f%-2s %12.1f%-2s %+8.0f%%" % (rank, subject[:36], name, old, unit,
+                                                                     new, unit, score * 100.0))
+        if not selected:
+            print("      None beyond %.0f%%" % args.threshold)
+        print()
+
+    print_changes("Biggest regressions:", regressions)
+
+    if args.improvements:
+        print_changes("Biggest improvements:", [change for change in reversed(changes) if change[0] < 0][:args.top])
+
+    if information:
+        print_changes("Other changes, not ranked:", information[:args.top], "Change")
+
+    base_subjects = {key[0] for key in baseline}
+    cand_subjects = {key[0] for key in candidate}
+    for title, only in (("Only in the baseline:", base_subjects - cand_subjects),
+                        ("Only in the candidate:", cand_subjects - base_subjects)):
+        if only:
+            print(title, ", ".join(sorted(only)))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())